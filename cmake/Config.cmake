@@ -45,6 +45,42 @@ if(NOT BUILD_TEST_LUA)
     )
 endif()
 
+if(NOT BUILD_TEST_SIZE)
+    set(BUILD_TEST_SIZE FALSE
+        CACHE BOOL "TRUE to add the size_report target (code size per registered member), FALSE otherwise."
+    )
+endif()
+
+if(NOT BUILD_TEST_BENCH)
+    set(BUILD_TEST_BENCH FALSE
+        CACHE BOOL "TRUE to build the benchmarks, FALSE otherwise."
+    )
+endif()
+
+if(NOT PONDER_SINGLE_THREADED)
+    set(PONDER_SINGLE_THREADED FALSE
+        CACHE BOOL "TRUE to use non-atomic reference counts (Ponder must then be used from one thread only)."
+    )
+endif()
+
+if(NOT PONDER_INSTRUMENT)
+    set(PONDER_INSTRUMENT FALSE
+        CACHE BOOL "TRUE to count and time property, function and constructor calls, FALSE otherwise."
+    )
+endif()
+
+if(NOT PONDER_TRACK_INSTANCES)
+    set(PONDER_TRACK_INSTANCES FALSE
+        CACHE BOOL "TRUE to count the live instances of each metaclass, FALSE otherwise."
+    )
+endif()
+
+if(NOT PONDER_NO_EXCEPTIONS)
+    set(PONDER_NO_EXCEPTIONS FALSE
+        CACHE BOOL "TRUE to build Ponder without exceptions (errors go to the error handler), FALSE otherwise."
+    )
+endif()
+
 if(NOT BUILD_TEST_QT)
     set(BUILD_TEST_QT FALSE
         CACHE BOOL "TRUE to build the Qt-specific unit tests (requires Qt 4.5), FALSE otherwise."
@@ -35,6 +35,8 @@
 #include <ponder/userobject.hpp>
 #include <ponder/value.hpp>
 #include <ponder/arrayproperty.hpp>
+#include <ponder/dictionaryproperty.hpp>
+#include <ponder/trace.hpp>
 #include <string>
 
 namespace ponder
@@ -40,28 +40,33 @@ void serialize(const UserObject& object, typename Proxy::NodeType node, const Va
 {
     // Iterate over the object's properties using its metaclass
     const Class& metaclass = object.getClass();
+    PONDER_TRACE_SCOPE(Serialize, metaclass.name().data(), nullptr);
+
+    const std::shared_ptr<const std::vector<bool>> excluded =
+        (exclude != Value::nothing) ? metaclass.propertiesWithTag(exclude) : nullptr;
     for (std::size_t i = 0; i < metaclass.propertyCount(); ++i)
     {
-        const Property& property = metaclass.property(i);
-
         // If the property has the exclude tag, ignore it
-        if ((exclude != Value::nothing) && property.hasTag(exclude))
+        if (excluded && (*excluded)[i])
             continue;
 
+        const Property& property = metaclass.property(i);
+
         // Create a child node for the new property
         typename Proxy::NodeType child = Proxy::addChild(node, property.name());
         if (!Proxy::isValid(child))
             continue;
 
-        if (property.kind() == userType)
+        if (property.kind() == ValueKind::User)
         {
             // The current property is a composed type: serialize it recursively
             serialize<Proxy>(property.get(object).to<UserObject>(), child, exclude);
         }
-        else if (property.kind() == arrayType)
+        else if (property.kind() == ValueKind::Array)
         {
             // The current property is an array
             const ArrayProperty& arrayProperty = static_cast<const ArrayProperty&>(property);
+            PONDER_TRACE_SCOPE(Serialize, metaclass.name().data(), property.name().data());
 
             // Iterate over the array elements
             std::size_t count = arrayProperty.size(object);
@@ -71,7 +76,7 @@ void serialize(const UserObject& object, typename Proxy::NodeType node, const Va
                 typename Proxy::NodeType item = Proxy::addChild(child, "item");
                 if (Proxy::isValid(item))
                 {
-                    if (arrayProperty.elementType() == userType)
+                    if (arrayProperty.elementType() == ValueKind::User)
                     {
                         // The array elements are composed objects: serialize them recursively
                         serialize<Proxy>(arrayProperty.get(object, j).to<UserObject>(), item, exclude);
@@ -84,6 +89,40 @@ void serialize(const UserObject& object, typename Proxy::NodeType node, const Va
                 }
             }
         }
+        else if (property.kind() == ValueKind::Dictionary)
+        {
+            // The current property is a dictionary
+            const DictionaryProperty& dictionaryProperty =
+                static_cast<const DictionaryProperty&>(property);
+            PONDER_TRACE_SCOPE(Serialize, metaclass.name().data(), property.name().data());
+
+            // Iterate over the elements, adding a "key" and a "value" node for each one
+            dictionaryProperty.forEach(object, [&](const Value& key, const Value& value)
+            {
+                typename Proxy::NodeType item = Proxy::addChild(child, "item");
+                if (!Proxy::isValid(item))
+                    return;
+
+                typename Proxy::NodeType keyNode = Proxy::addChild(item, "key");
+                if (Proxy::isValid(keyNode))
+                    Proxy::setText(keyNode, key);
+
+                typename Proxy::NodeType valueNode = Proxy::addChild(item, "value");
+                if (!Proxy::isValid(valueNode))
+                    return;
+
+                if (dictionaryProperty.elementType() == ValueKind::User)
+                {
+                    // The elements are composed objects: serialize them recursively
+                    serialize<Proxy>(value.to<UserObject>(), valueNode, exclude);
+                }
+                else
+                {
+                    // The elements are simple values: write them as the text of their XML node
+                    Proxy::setText(valueNode, value);
+                }
+            });
+        }
         else
         {
             // The current property is a simple property: write its value as the node's text
@@ -97,28 +136,33 @@ void deserialize(const UserObject& object, typename Proxy::NodeType node, const
 {
     // Iterate over the object's properties using its metaclass
     const Class& metaclass = object.getClass();
+    PONDER_TRACE_SCOPE(Deserialize, metaclass.name().data(), nullptr);
+
+    const std::shared_ptr<const std::vector<bool>> excluded =
+        (exclude != Value::nothing) ? metaclass.propertiesWithTag(exclude) : nullptr;
     for (std::size_t i = 0; i < metaclass.propertyCount(); ++i)
     {
-        const Property& property = metaclass.property(i);
-
         // If the property has the exclude tag, ignore it
-        if ((exclude != Value::nothing) && property.hasTag(exclude))
+        if (excluded && (*excluded)[i])
             continue;
 
+        const Property& property = metaclass.property(i);
+
         // Find the child node corresponding to the new property
         typename Proxy::NodeType child = Proxy::findFirstChild(node, property.name());
         if (!Proxy::isValid(child))
             continue;
 
-        if (property.kind() == userType)
+        if (property.kind() == ValueKind::User)
         {
             // The current property is a composed type: deserialize it recursively
             deserialize<Proxy>(property.get(object).to<UserObject>(), child, exclude);
         }
-        else if (property.kind() == arrayType)
+        else if (property.kind() == ValueKind::Array)
         {
             // The current property is an array
             const ArrayProperty& arrayProperty = static_cast<const ArrayProperty&>(property);
+            PONDER_TRACE_SCOPE(Deserialize, metaclass.name().data(), property.name().data());
 
             // Iterate over the child XML node and extract all the array elements
             std::size_t index = 0;
@@ -136,7 +180,7 @@ void deserialize(const UserObject& object, typename Proxy::NodeType node, const
                         break;
                 }
 
-                if (arrayProperty.elementType() == userType)
+                if (arrayProperty.elementType() == ValueKind::User)
                 {
                     // The array elements are composed objects: deserialize them recursively
                     deserialize<Proxy>(arrayProperty.get(object, index).to<UserObject>(), item, exclude);
@@ -150,6 +194,39 @@ void deserialize(const UserObject& object, typename Proxy::NodeType node, const
                 index++;
             }
         }
+        else if (property.kind() == ValueKind::Dictionary)
+        {
+            // The current property is a dictionary
+            const DictionaryProperty& dictionaryProperty =
+                static_cast<const DictionaryProperty&>(property);
+            PONDER_TRACE_SCOPE(Deserialize, metaclass.name().data(), property.name().data());
+
+            // Iterate over the child XML node and extract all the elements
+            for (typename Proxy::NodeType item = Proxy::findFirstChild(child, "item")
+                ; Proxy::isValid(item)
+                ; item = Proxy::findNextSibling(item, "item"))
+            {
+                typename Proxy::NodeType keyNode = Proxy::findFirstChild(item, "key");
+                typename Proxy::NodeType valueNode = Proxy::findFirstChild(item, "value");
+                if (!Proxy::isValid(keyNode) || !Proxy::isValid(valueNode))
+                    continue;
+
+                const Value key = Proxy::getText(keyNode);
+                if (dictionaryProperty.elementType() == ValueKind::User)
+                {
+                    // The elements are composed objects: insert the missing ones (default
+                    // constructed), then deserialize them recursively
+                    if (dictionaryProperty.insert(object, key))
+                        deserialize<Proxy>(dictionaryProperty.get(object, key).to<UserObject>(),
+                                           valueNode, exclude);
+                }
+                else
+                {
+                    // The elements are simple values: read them from the text of their XML node
+                    dictionaryProperty.set(object, key, Proxy::getText(valueNode));
+                }
+            }
+        }
         else
         {
             // The current property is a simple property: read its value from the node's text
@@ -0,0 +1,265 @@
+/****************************************************************************
+**
+** This file is part of the Ponder library, formerly CAMP.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+
+
+#ifndef PONDER_ALLOCATOR_HPP
+#define PONDER_ALLOCATOR_HPP
+
+
+#include <ponder/config.hpp>
+#include <atomic>
+#include <cstddef>
+
+
+namespace ponder
+{
+/**
+ * \brief Functions used by Ponder to allocate its internal objects
+ *
+ * Metaclass members, getters, function callers, holders of objects copied into
+ * UserObjects and the storage of argument lists are allocated through the current
+ * allocator. Identifiers and strings use the standard allocator. Within a ScratchScope,
+ * the temporary blocks of its thread (holders and argument storage) are taken from a
+ * scratch arena instead; long-lived blocks such as metadata and trace buffers are not.
+ *
+ * \sa setAllocator, AllocationCounter, ScratchScope
+ */
+struct Allocator
+{
+    /// Return a block of \a size bytes suitably aligned for any type, or null on failure
+    void* (*allocate)(std::size_t size, void* context);
+
+    /// Release a block returned by allocate, \a size is the size it was allocated with
+    void (*deallocate)(void* pointer, std::size_t size, void* context);
+
+    /// User data passed back to allocate and deallocate
+    void* context;
+};
+
+/**
+ * \brief Get the allocator which uses the global operators new and delete
+ */
+PONDER_API Allocator defaultAllocator();
+
+/**
+ * \brief Get the allocator currently used by Ponder
+ */
+PONDER_API const Allocator& allocator();
+
+/**
+ * \brief Replace the allocator used by Ponder
+ *
+ * Blocks are released with the allocator current at the time, so it must be installed
+ * before anything is declared, and it must release the blocks of the allocator it
+ * replaces. It is not thread-safe: no other thread may use Ponder meanwhile.
+ *
+ * \param allocator New allocator
+ */
+PONDER_API void setAllocator(const Allocator& allocator);
+
+/**
+ * \brief Count the allocations made by Ponder while it is alive
+ *
+ * The counter installs an allocator which forwards to the current one, and restores it
+ * when destroyed. Use it to check that an operation doesn't allocate:
+ *
+ * \code
+ * ponder::AllocationCounter counter;
+ * metaclass.property("x").get(object);
+ * assert(counter.allocations() == 0);
+ * \endcode
+ *
+ * The same restrictions as setAllocator() apply. Counters must be destroyed in the
+ * reverse order of their creation.
+ */
+class PONDER_API AllocationCounter
+{
+public:
+
+    /**
+     * \brief Start counting
+     */
+    AllocationCounter();
+
+    /**
+     * \brief Stop counting, restoring the previous allocator
+     */
+    ~AllocationCounter();
+
+    AllocationCounter(const AllocationCounter&) = delete;
+    AllocationCounter& operator=(const AllocationCounter&) = delete;
+
+    /**
+     * \brief Get the number of blocks allocated since the creation or the last reset
+     */
+    std::size_t allocations() const {return m_allocations;}
+
+    /**
+     * \brief Get the number of blocks released since the creation or the last reset
+     */
+    std::size_t deallocations() const {return m_deallocations;}
+
+    /**
+     * \brief Get the number of bytes allocated since the creation or the last reset
+     */
+    std::size_t bytes() const {return m_bytes;}
+
+    /**
+     * \brief Reset the counts to zero
+     */
+    void reset();
+
+private:
+
+    static void* allocate(std::size_t size, void* context);
+    static void deallocate(void* pointer, std::size_t size, void* context);
+
+    Allocator m_previous; ///< Allocator the counter forwards to
+    std::atomic<std::size_t> m_allocations;
+    std::atomic<std::size_t> m_deallocations;
+    std::atomic<std::size_t> m_bytes;
+};
+
+namespace detail
+{
+/**
+ * \brief Allocate a block with the current allocator, even within a ScratchScope
+ *
+ * \throw std::bad_alloc the allocator failed (without exceptions, the program aborts)
+ */
+PONDER_API void* allocate(std::size_t size);
+
+/**
+ * \brief Release a block returned by allocate()
+ */
+PONDER_API void deallocate(void* pointer, std::size_t size);
+
+/**
+ * \brief Allocate a temporary block, from the scratch arena within a ScratchScope
+ *
+ * Only blocks which are released before the scope, or promoted, may be allocated this way.
+ *
+ * \throw std::bad_alloc the allocator failed (without exceptions, the program aborts)
+ */
+PONDER_API void* allocateTemporary(std::size_t size);
+
+/**
+ * \brief Release a block returned by allocateTemporary()
+ */
+PONDER_API void deallocateTemporary(void* pointer, std::size_t size);
+
+/**
+ * \brief Base of the internal objects allocated with the current allocator
+ *
+ * The sized delete receives the size of the most derived type, as long as the
+ * destructor is virtual.
+ */
+class Allocated
+{
+public:
+
+    static void* operator new(std::size_t size) {return allocate(size);}
+    static void operator delete(void* pointer, std::size_t size) {deallocate(pointer, size);}
+};
+
+/**
+ * \brief Base of the internal objects which may be taken from the scratch arena
+ */
+class TemporaryAllocated
+{
+public:
+
+    static void* operator new(std::size_t size) {return allocateTemporary(size);}
+    static void operator delete(void* pointer, std::size_t size)
+    {
+        deallocateTemporary(pointer, size);
+    }
+};
+
+/**
+ * \brief Standard allocator adapter, for the containers of the internal objects
+ */
+template <typename T>
+class StdAllocator
+{
+public:
+
+    typedef T value_type;
+
+    StdAllocator() {}
+    template <typename U> StdAllocator(const StdAllocator<U>&) {}
+
+    T* allocate(std::size_t count)
+    {
+        return static_cast<T*>(detail::allocate(count * sizeof(T)));
+    }
+
+    void deallocate(T* pointer, std::size_t count)
+    {
+        detail::deallocate(pointer, count * sizeof(T));
+    }
+
+    template <typename U> bool operator==(const StdAllocator<U>&) const {return true;}
+    template <typename U> bool operator!=(const StdAllocator<U>&) const {return false;}
+};
+
+/**
+ * \brief Standard allocator adapter, for the temporary containers (argument lists)
+ */
+template <typename T>
+class TemporaryStdAllocator
+{
+public:
+
+    typedef T value_type;
+
+    TemporaryStdAllocator() {}
+    template <typename U> TemporaryStdAllocator(const TemporaryStdAllocator<U>&) {}
+
+    T* allocate(std::size_t count)
+    {
+        return static_cast<T*>(detail::allocateTemporary(count * sizeof(T)));
+    }
+
+    void deallocate(T* pointer, std::size_t count)
+    {
+        detail::deallocateTemporary(pointer, count * sizeof(T));
+    }
+
+    template <typename U> bool operator==(const TemporaryStdAllocator<U>&) const {return true;}
+    template <typename U> bool operator!=(const TemporaryStdAllocator<U>&) const {return false;}
+};
+
+} // namespace detail
+
+} // namespace ponder
+
+
+#endif // PONDER_ALLOCATOR_HPP
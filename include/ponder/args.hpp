@@ -33,6 +33,7 @@
 
 
 #include <ponder/config.hpp>
+#include <ponder/allocator.hpp>
 #include <vector>
 #include <initializer_list>
 
@@ -91,8 +92,45 @@ public:
     void init(std::initializer_list<Value> il)
     {
         m_values = il;
+        m_referenced = nullptr;
     }
 
+    /**
+     * \brief Copy constructor
+     *
+     * The copy always owns its values, even if \a other references values of the caller.
+     *
+     * \param other List to copy
+     */
+    Args(const Args& other);
+
+    /**
+     * \brief Move constructor
+     *
+     * \param other List to move
+     */
+    Args(Args&& other);
+
+    /**
+     * \brief Assignment operator, the list then owns its values
+     *
+     * \param other List to copy
+     */
+    Args& operator = (const Args& other);
+
+    /**
+     * \brief Make a list referencing values owned by the caller
+     *
+     * The values aren't copied, so this doesn't allocate. They must outlive the list.
+     * Modifying or copying the list copies them to storage of its own.
+     *
+     * \param values Array of values
+     * \param count Number of values in the array
+     *
+     * \return List referencing \a values
+     */
+    static Args reference(const Value* values, std::size_t count);
+
     /**
      * \brief Return the number of arguments contained in the list
      *
@@ -147,7 +185,14 @@ public:
 
 private:
 
-    std::vector<Value> m_values; ///< List of the values
+    /**
+     * \brief Copy the referenced values into m_values
+     */
+    void own();
+
+    std::vector<Value, detail::TemporaryStdAllocator<Value>> m_values; ///< List of the owned values
+    const Value* m_referenced = nullptr; ///< Values owned by the caller, or null
+    std::size_t m_referencedCount = 0; ///< Number of referenced values
 };
 
 } // namespace ponder
@@ -36,12 +36,21 @@
 #include <ponder/classcast.hpp>
 #include <ponder/property.hpp>
 #include <ponder/function.hpp>
+#include <ponder/constructor.hpp>
+#include <ponder/event.hpp>
 #include <ponder/tagholder.hpp>
+#include <ponder/instances.hpp>
 #include <ponder/userobject.hpp>
 #include <ponder/detail/typeid.hpp>
 #include <ponder/detail/dictionary.hpp>
-#include <string>
+#include <ponder/detail/memberindex.hpp>
+#include <ponder/detail/refcount.hpp>
+#include <atomic>
 #include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace ponder
 {
@@ -50,6 +59,23 @@ template <typename T> class ClassBuilder;
 class Constructor;
 class Args;
 class ClassVisitor;
+
+namespace detail
+{
+class FieldProperty;
+PONDER_API std::atomic<std::size_t>* seqLockCounter(const UserObject& object);
+}
+
+/**
+ * \brief Policy used to access the instances of a metaclass from several threads
+ *
+ * \sa ClassBuilder::concurrency, readConsistent
+ */
+enum class Concurrency
+{
+    None,       ///< No synchronization, the user is responsible for it
+    SeqLock     ///< Writes through UserObject::set are sequenced, see readConsistent
+};
   
 /**
  * \brief ponder::Class represents a metaclass composed of properties and functions
@@ -103,6 +129,10 @@ class ClassVisitor;
  *
  * \remark All function and property names are unique within the metaclass.
  *
+ * \remark Members inherited from base metaclasses are shared with them, not copied. The
+ *         derived metaclass keeps them alive, so they can still be listed and found if a
+ *         base is undeclared; converting instances to the base still requires it.
+ *
  * \sa Enum, TagHolder, ClassBuilder, Function, Property
  */
 class PONDER_API Class : public TagHolder, detail::noncopyable
@@ -116,27 +146,37 @@ class PONDER_API Class : public TagHolder, detail::noncopyable
         int offset;
     };
     
-    // These are shared_ptr as the objects can be inherited. When this happens the
+    // These are shared pointers as the objects can be inherited. When this happens the
     // pointers are copied.
-    typedef std::shared_ptr<Constructor> ConstructorPtr;
-    typedef std::shared_ptr<Property> PropertyPtr;
-    typedef std::shared_ptr<Function> FunctionPtr;
+    typedef detail::RefPtr<Constructor> ConstructorPtr;
+    typedef detail::RefPtr<Property> PropertyPtr;
+    typedef detail::RefPtr<Function> FunctionPtr;
+    typedef detail::RefPtr<Event> EventPtr;
     
     typedef std::vector<BaseInfo> BaseList;
     typedef std::vector<ConstructorPtr> ConstructorList;
     typedef detail::Dictionary<Id, IdRef, PropertyPtr> PropertyTable;
     typedef detail::Dictionary<Id, IdRef, FunctionPtr> FunctionTable;
+    typedef detail::Dictionary<Id, IdRef, EventPtr> EventTable;
+    typedef detail::MemberIndex<Property>::Iterator PropertyIterator;
+    typedef detail::MemberIndex<Function>::Iterator FunctionIterator;
+    typedef detail::MemberIndex<Event>::Iterator EventIterator;
     typedef void (*Destructor)(const UserObject&, bool);
     typedef UserObject (*UserObjectCreator)(void*);
     
     std::size_t m_sizeof;       ///< Size of the class in bytes.
     Id m_id;                    ///< Name of the metaclass
-    FunctionTable m_functions;  ///< Table of metafunctions indexed by ID
-    PropertyTable m_properties; ///< Table of metaproperties indexed by ID
+    FunctionTable m_functions;  ///< Table of the metafunctions declared by this class
+    PropertyTable m_properties; ///< Table of the metaproperties declared by this class
+    EventTable m_events;        ///< Table of the metaevents declared by this class
     BaseList m_bases;           ///< List of base metaclasses
     ConstructorList m_constructors; ///< List of metaconstructors
     Destructor m_destructor;    ///< Destructor (function able to delete an abstract object)
     UserObjectCreator m_userObjectCreator; ///< Convert pointer of class instance to UserObject
+    detail::MetaAllocations m_allocations; ///< Bytes allocated by the declaration of members
+    detail::MemberIndex<Property> m_propertyIndex; ///< Own and inherited properties, for lookups
+    detail::MemberIndex<Function> m_functionIndex; ///< Own and inherited functions, for lookups
+    detail::MemberIndex<Event> m_eventIndex; ///< Own and inherited events, for lookups
 
 public:     // declaration
 
@@ -226,6 +266,7 @@ public:     // reflection
      */
     void destruct(const UserObject &uobj, bool destruct) const
     {
+        PONDER_INSTANCE_DESTROYED(uobj.getClass(), uobj.pointer());
         m_destructor(uobj, destruct);
     }
     
@@ -277,7 +318,7 @@ public:     // reflection
      *     foo(func.name(), func.value());
      * \endcode
      */
-    FunctionTable::Iterator functionIterator() const;
+    FunctionIterator functionIterator() const;
 
     /**
      * \brief Look up a function by name and return success
@@ -295,6 +336,61 @@ public:     // reflection
      */
     bool tryFunction(const IdRef name, const Function*& funcRet) const;
 
+    /**
+     * \brief Return the total number of events of this metaclass
+     *
+     * \return Number of events
+     */
+    std::size_t eventCount() const;
+
+    /**
+     * \brief Check if this metaclass contains the given event
+     *
+     * \param name Name of the event to check
+     *
+     * \return True if the event is in the metaclass, false otherwise
+     */
+    bool hasEvent(IdRef name) const;
+
+    /**
+     * \brief Get an event from its index in this metaclass
+     *
+     * \param index Index of the event to get
+     *
+     * \return Reference to the event
+     *
+     * \throw OutOfRange index is out of range
+     */
+    const Event& event(std::size_t index) const;
+
+    /**
+     * \brief Get an event from its name
+     *
+     * \param name Name of the event to get (case sensitive)
+     *
+     * \return Reference to the event
+     *
+     * \throw EventNotFound \a name is not an event of the metaclass
+     */
+    const Event& event(IdRef name) const;
+
+    /**
+     * \brief Get an event iterator
+     *
+     * \return An iterator that can be used to iterator over all events
+     */
+    EventIterator eventIterator() const;
+
+    /**
+     * \brief Look up an event by name and return success
+     *
+     * \param name Name of the event to get (case sensitive)
+     * \param eventRet Event returned, if return was true
+     *
+     * \return Boolean. True if event found, else if not, false
+     */
+    bool tryEvent(const IdRef name, const Event*& eventRet) const;
+
     /**
      * \brief Return the total number of properties of this metaclass
      *
@@ -343,7 +439,7 @@ public:     // reflection
      *     foo(prop.name(), prop.value());
      * \endcode
      */
-    PropertyTable::Iterator propertyIterator() const;
+    PropertyIterator propertyIterator() const;
     
     /**
      * \brief Look up a property by name and return success
@@ -360,6 +456,27 @@ public:     // reflection
      * \endcode
      */
     bool tryProperty(const IdRef name, const Property*& propRet) const;
+
+    /**
+     * \brief Get the properties carrying a tag
+     *
+     * The result is a bitset indexed like property(std::size_t), so that filtering
+     * properties by tag costs a bit test per property. The bitsets of all the tags are
+     * computed once, when the metaclass is declared; getting one takes no lock.
+     *
+     * \code
+     * const auto hidden = metaclass.propertiesWithTag("hidden");
+     * for (std::size_t i = 0; i < metaclass.propertyCount(); ++i)
+     *     if (!(*hidden)[i])
+     *         ... ;
+     * \endcode
+     *
+     * \param id Identifier of the tag
+     *
+     * \return Bitset of the properties having the tag. It is an immutable snapshot, which
+     *         stays valid if the metaclass is declared again.
+     */
+    std::shared_ptr<const std::vector<bool>> propertiesWithTag(const Value& id) const;
     
     /**
      * \brief Return the memory size of a class instance
@@ -368,6 +485,16 @@ public:     // reflection
      */
     std::size_t sizeOf() const;
 
+    /**
+     * \brief Return the policy used to access the instances of the metaclass from several
+     *        threads
+     *
+     * \return Concurrency policy, declared by this class or inherited from a base
+     *
+     * \sa ClassBuilder::concurrency
+     */
+    Concurrency concurrency() const;
+
     /**
      * \brief Create a UserObject from an opaque user pointer
      *
@@ -408,6 +535,19 @@ public:     // reflection
      */
     void* applyOffset(void* pointer, const Class& target) const;
 
+    /**
+     * \brief Convert a pointer to an object to be compatible with a base or derived metaclass,
+     *        if it is related to this
+     *
+     * \param pointer Pointer to convert, receives the converted pointer on success
+     * \param target Target metaclass to convert to
+     *
+     * \return True on success, false if \a target is not a base nor a derived class of this
+     *
+     * \sa applyOffset
+     */
+    bool tryApplyOffset(void*& pointer, const Class& target) const;
+
     /**
      * \brief Operator == to check equality between two metaclasses
      *
@@ -432,6 +572,12 @@ private:
 
     template <typename T> friend class ClassBuilder;
     friend class detail::ClassManager;
+    friend class detail::MemoryCounter;
+    friend class detail::FieldProperty;
+    friend instances::Stats instances::stats(const Class&);
+    friend void instances::detail::created(const Class&, const void*);
+    friend void instances::detail::destroyed(const Class&, const void*);
+    friend std::atomic<std::size_t>* detail::seqLockCounter(const UserObject&);
 
     /**
      * \brief Construct the metaclass from its name
@@ -448,7 +594,21 @@ private:
      * \return offset between this and base, or -1 if both classes are unrelated
      */
     int baseOffset(const Class& base) const;
-    
+
+    /**
+     * \brief Rebuild the member indexes and the tag index of the properties
+     *
+     * This is called by ClassBuilder when it is destroyed, once the members are declared.
+     */
+    void membersChanged();
+
+    typedef std::shared_ptr<const std::vector<bool>> PropertySet;
+    typedef std::unordered_map<Value, PropertySet> TagIndex;
+
+    TagIndex m_tagIndex; ///< Properties carrying each tag, built with the member indices
+    PropertySet m_untagged; ///< Empty set of properties, for the tags no property carries
+    mutable instances::detail::Counts m_instanceCounts; ///< Live instances (PONDER_TRACK_INSTANCES)
+    const Class* m_seqLockClass; ///< Class whose view of instances is sequenced, if any
 };
 
 } // namespace ponder
@@ -68,36 +68,43 @@ inline void Class::undeclare(IdRef id)
         id.empty() ? detail::StaticTypeId<T>::get(false) : id);
 }
 
-inline Class::FunctionTable::Iterator Class::functionIterator() const
+inline Class::FunctionIterator Class::functionIterator() const
 {
-    return m_functions.getIterator();
+    return m_functionIndex.getIterator();
 }
 
 inline bool Class::tryFunction(const IdRef name, const Function *& funcRet) const
 {
-    FunctionTable::const_iterator it;
-    if (m_functions.tryFind(name, it))
-    {
-        funcRet = it->value().get();
-        return true;
-    }
-    return false;
+    const Function* function = m_functionIndex.find(name);
+    if (function)
+        funcRet = function;
+    return function != nullptr;
 }
 
-inline Class::PropertyTable::Iterator Class::propertyIterator() const
+inline Class::EventIterator Class::eventIterator() const
 {
-    return m_properties.getIterator();
+    return m_eventIndex.getIterator();
+}
+
+inline bool Class::tryEvent(const IdRef name, const Event *& eventRet) const
+{
+    const Event* event = m_eventIndex.find(name);
+    if (event)
+        eventRet = event;
+    return event != nullptr;
+}
+
+inline Class::PropertyIterator Class::propertyIterator() const
+{
+    return m_propertyIndex.getIterator();
 }
 
 inline bool Class::tryProperty(const IdRef name, const Property *& propRet) const
 {
-    PropertyTable::const_iterator it;
-    if (m_properties.tryFind(name, it))
-    {
-        propRet = it->value().get();
-        return true;
-    }
-    return false;
+    const Property* property = m_propertyIndex.find(name);
+    if (property)
+        propRet = property;
+    return property != nullptr;
 }
 
 inline UserObject Class::getUserObjectFromPointer(void* ptr) const
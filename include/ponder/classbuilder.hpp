@@ -38,8 +38,10 @@
 #include <ponder/uses/uses.hpp>
 #include <ponder/detail/functionimpl.hpp>
 #include <ponder/detail/constructorimpl.hpp>
+#include <ponder/detail/eventimpl.hpp>
 #include <ponder/detail/propertyfactory.hpp>
 #include <ponder/pondertype.hpp>
+#include <ponder/staticclass.hpp>
 #include <cassert>
 #include <string>
 
@@ -59,6 +61,9 @@ namespace ponder {
  *
  * This class should never be explicitely instanciated, unless you
  * need to split the metaclass creation in multiple parts.
+ *
+ * The member indices of the metaclass are built when the builder is destroyed, so the
+ * members are found by name once the declaration statement is complete.
  */
 template <typename T>
 class ClassBuilder
@@ -72,6 +77,11 @@ public:
      */
     ClassBuilder(Class& target);
 
+    /**
+     * \brief Destructor, builds the member indices of the metaclass
+     */
+    ~ClassBuilder();
+
     /**
      * \brief Declare a base metaclass
      *
@@ -173,6 +183,34 @@ public:
     template <typename F, typename... P>
     ClassBuilder<T>& function(IdRef name, F function, P... policies);
 
+    /**
+     * \brief Declare a new event
+     *
+     * The subscribers of each object are held by an EventSource member of the class (or of
+     * one of its bases), which the C++ code of the class fires. The parameter types can be
+     * given explicitly, they must match the EventSource and be passed by value or const
+     * reference.
+     *
+     * \code
+     * struct Unit
+     * {
+     *     ponder::EventSource<int> damaged;
+     *     ponder::EventSource<float, float> moved;
+     * };
+     *
+     * ponder::Class::declare<Unit>("Unit")
+     *     .event<int>("damaged", &Unit::damaged)
+     *     .event("moved", &Unit::moved);
+     * \endcode
+     *
+     * \param name Name of the event (must be unique within the metaclass)
+     * \param source Member holding the subscribers of the event
+     *
+     * \return Reference to this, in order to chain other calls
+     */
+    template <typename... A, typename C>
+    ClassBuilder<T>& event(IdRef name, EventSource<A...> C::*source);
+
     /**
      * \brief Declare a new static tag
      *
@@ -292,6 +330,50 @@ public:
     template <template <typename> class U>
     ClassBuilder<T>& external();
 
+    /**
+     * \brief Declare the properties listed in the static description of the class
+     *
+     * This adds one property per field declared with PONDER_STATIC_CLASS, as if each
+     * had been declared with property(name, &T::member). Generic code can then use
+     * either forEachProperty() or the runtime metaclass from the same declaration.
+     *
+     * \code
+     * PONDER_STATIC_CLASS(Point, ponder::field("x", &Point::x), ponder::field("y", &Point::y))
+     *
+     * ponder::Class::declare<Point>("Point")
+     *     .staticProperties()
+     *     .function("length", &Point::length);
+     * \endcode
+     *
+     * \return Reference to this, in order to chain other calls
+     */
+    ClassBuilder<T>& staticProperties();
+
+    /**
+     * \brief Set the policy used to access the instances of the metaclass from several threads
+     *
+     * With Concurrency::SeqLock, each write through UserObject::set or Property::set bumps
+     * a sequence counter associated to the object, and readConsistent() can read several
+     * properties of an object written by another thread without locking it. Each object
+     * must be written by one thread at a time, and only its boolean, number and enum
+     * properties can be read this way. The policy is inherited by the derived metaclasses
+     * which declare this one as a base afterwards.
+     *
+     * \code
+     * ponder::Class::declare<Body>("Body")
+     *     .concurrency(ponder::Concurrency::SeqLock)
+     *     .property("x", &Body::x)
+     *     .property("y", &Body::y);
+     * \endcode
+     *
+     * \param policy Concurrency policy of the metaclass
+     *
+     * \return Reference to this, in order to chain other calls
+     *
+     * \sa readConsistent, SequencedWrite
+     */
+    ClassBuilder<T>& concurrency(Concurrency policy);
+
 private:
 
     /**
@@ -312,10 +394,20 @@ private:
      */
     ClassBuilder<T>& addFunction(Function* function);
 
+    /**
+     * \brief Add a new event to the target class
+     *
+     * \param event Event to add
+     *
+     * \return Reference to this, in order to chain other calls
+     */
+    ClassBuilder<T>& addEvent(Event* event);
+
     Class* m_target; ///< Target metaclass to fill
     TagHolder* m_currentTagHolder; ///< Last tag holder which has been declared
     Property* m_currentProperty; ///< Last metaproperty which has been declared
     Function* m_currentFunction; ///< Last function which has been declared
+    Event* m_currentEvent; ///< Last event which has been declared
 };
 
 } // namespace ponder
@@ -35,9 +35,17 @@ ClassBuilder<T>::ClassBuilder(Class& target)
     , m_currentTagHolder(m_target)
     , m_currentProperty(nullptr)
     , m_currentFunction(nullptr)
+    , m_currentEvent(nullptr)
 {
 }
 
+template <typename T>
+ClassBuilder<T>::~ClassBuilder()
+{
+    // Index the members once, when they are all declared
+    m_target->membersChanged();
+}
+
 template <typename T>   // class
 template <typename U>   // base
 ClassBuilder<T>& ClassBuilder<T>::base()
@@ -70,17 +78,11 @@ ClassBuilder<T>& ClassBuilder<T>::base()
     baseInfos.offset = offset;
     m_target->m_bases.push_back(baseInfos);
 
-    // Copy all properties of the base class into the current class
-    for (auto&& it = baseClass.m_properties.begin(); it != baseClass.m_properties.end(); ++it)
-    {
-        m_target->m_properties.insert(it);
-    }
+    // Instances must be sequenced the same way whatever the metaclass they are written with
+    if (baseClass.m_seqLockClass)
+        m_target->m_seqLockClass = baseClass.m_seqLockClass;
 
-    // Copy all functions of the base class into the current class
-    for (auto&& it = baseClass.m_functions.begin(); it != baseClass.m_functions.end(); ++it)
-    {
-        m_target->m_functions.insert(it);
-    }
+    // The properties and functions of the base class are shared when the class is indexed
 
     return *this;
 }
@@ -94,6 +96,7 @@ ClassBuilder<T>& ClassBuilder<T>::property(IdRef name,
     typedef detail::PropertyFactory1<T, F> Factory;
 
     // Construct and add the metaproperty
+    detail::MetaAllocationScope scope(m_target->m_allocations, MetadataKind::Property);
     return addProperty(Factory::get(name, accessor));
 }
 
@@ -106,6 +109,7 @@ ClassBuilder<T>& ClassBuilder<T>::property(IdRef name,
     typedef detail::PropertyFactory2<T, F1, F2> Factory;
 
     // Construct and add the metaproperty
+    detail::MetaAllocationScope scope(m_target->m_allocations, MetadataKind::Property);
     return addProperty(Factory::get(name, accessor1, accessor2));
 }
 
@@ -114,9 +118,21 @@ template <typename F, typename... P>
 ClassBuilder<T>& ClassBuilder<T>::function(IdRef name, F function, P... policies)
 {
     // Construct and add the metafunction
+    detail::MetaAllocationScope scope(m_target->m_allocations, MetadataKind::Function);
     return addFunction(detail::newFunction(name, function, policies...));
 }
 
+template <typename T>
+template <typename... A, typename C>
+ClassBuilder<T>& ClassBuilder<T>::event(IdRef name, EventSource<A...> C::*source)
+{
+    static_assert(std::is_base_of<C, T>::value, "The event must be a member of T or of a base");
+
+    // Construct and add the metaevent
+    detail::MetaAllocationScope scope(m_target->m_allocations, MetadataKind::Event);
+    return addEvent(new detail::EventImpl<C, A...>(name, source));
+}
+
 template <typename T>
 ClassBuilder<T>& ClassBuilder<T>::tag(const Value& id)
 {
@@ -133,10 +149,15 @@ ClassBuilder<T>& ClassBuilder<T>::tag(const Value& id, const U& value)
     // For the special case of Getter<Value>, the ambiguity between both constructors
     // cannot be automatically solved, so let's do it manually
     typedef typename detail::if_c<detail::FunctionTraits<U>::kind != FunctionKind::None,
-                                  std::function<Value (T&)>, Value>::type Type;
+                                  detail::MetaFunction<MemoryCategory::Accessors, Value (T&)>,
+                                  Value>::type Type;
 
     // Add the new tag (override if already exists)
-    m_currentTagHolder->m_tags[id] = detail::Getter<Value>(Type(value));
+    const MetadataKind kind = m_currentProperty ? MetadataKind::Property
+                            : m_currentFunction ? MetadataKind::Function
+                            : m_currentEvent ? MetadataKind::Event : MetadataKind::Class;
+    detail::MetaAllocationScope scope(m_target->m_allocations, kind);
+    m_currentTagHolder->setTag(id, detail::Getter<Value>(Type(value)));
 
     return *this;
 }
@@ -147,6 +168,7 @@ ClassBuilder<T>& ClassBuilder<T>::readable(bool value)
     // Make sure we have a valid property
     assert(m_currentProperty != nullptr);
 
+    detail::MetaAllocationScope scope(m_target->m_allocations, MetadataKind::Property);
     m_currentProperty->m_readable = detail::Getter<bool>(value);
 
     return *this;
@@ -159,7 +181,9 @@ ClassBuilder<T>& ClassBuilder<T>::readable(F function)
     // Make sure we have a valid property
     assert(m_currentProperty != nullptr);
 
-    m_currentProperty->m_readable = detail::Getter<bool>(std::function<bool (T&)>(function));
+    detail::MetaAllocationScope scope(m_target->m_allocations, MetadataKind::Property);
+    m_currentProperty->m_readable = detail::Getter<bool>(
+        detail::MetaFunction<MemoryCategory::Accessors, bool (T&)>(function));
 
     return *this;
 }
@@ -170,6 +194,7 @@ ClassBuilder<T>& ClassBuilder<T>::writable(bool value)
     // Make sure we have a valid property
     assert(m_currentProperty != nullptr);
 
+    detail::MetaAllocationScope scope(m_target->m_allocations, MetadataKind::Property);
     m_currentProperty->m_writable = detail::Getter<bool>(value);
 
     return *this;
@@ -182,7 +207,9 @@ ClassBuilder<T>& ClassBuilder<T>::writable(F function)
     // Make sure we have a valid property
     assert(m_currentProperty != nullptr);
 
-    m_currentProperty->m_writable = detail::Getter<bool>(std::function<bool (T&)>(function));
+    detail::MetaAllocationScope scope(m_target->m_allocations, MetadataKind::Property);
+    m_currentProperty->m_writable = detail::Getter<bool>(
+        detail::MetaFunction<MemoryCategory::Accessors, bool (T&)>(function));
 
     return *this;
 }
@@ -191,6 +218,7 @@ template <typename T>
 template <typename... A>
 ClassBuilder<T>& ClassBuilder<T>::constructor()
 {
+    detail::MetaAllocationScope scope(m_target->m_allocations, MetadataKind::Constructor);
     Constructor* constructor = new detail::ConstructorImpl<T, A...>();
     m_target->m_constructors.push_back(Class::ConstructorPtr(constructor));
 
@@ -201,6 +229,8 @@ template <typename T>
 template <template <typename> class U>
 ClassBuilder<T>& ClassBuilder<T>::external()
 {
+    detail::MetaAllocationScope scope(m_target->m_allocations, MetadataKind::Property);
+
     // Create an instance of the mapper
     U<T> mapper;
 
@@ -217,6 +247,41 @@ ClassBuilder<T>& ClassBuilder<T>::external()
     return *this;
 }
 
+namespace detail
+{
+template <typename B>
+struct StaticPropertyDeclarer
+{
+    B& builder;
+
+    template <typename F>
+    void operator()(const F& field) const
+    {
+        builder.property(field.name, field.member);
+    }
+};
+} // namespace detail
+
+template <typename T>
+ClassBuilder<T>& ClassBuilder<T>::staticProperties()
+{
+    detail::StaticPropertyDeclarer<ClassBuilder<T>> declarer = {*this};
+    forEachField<T>(declarer);
+
+    return *this;
+}
+
+template <typename T>
+ClassBuilder<T>& ClassBuilder<T>::concurrency(Concurrency policy)
+{
+    if (policy == Concurrency::None)
+        m_target->m_seqLockClass = nullptr;
+    else if (!m_target->m_seqLockClass)
+        m_target->m_seqLockClass = m_target;
+
+    return *this;
+}
+
 template <typename T>
 ClassBuilder<T>& ClassBuilder<T>::addProperty(Property* property)
 {
@@ -231,6 +296,7 @@ ClassBuilder<T>& ClassBuilder<T>::addProperty(Property* property)
 
     m_currentTagHolder = m_currentProperty = property;
     m_currentFunction = nullptr;
+    m_currentEvent = nullptr;
 
     return *this;
 }
@@ -249,6 +315,26 @@ ClassBuilder<T>& ClassBuilder<T>::addFunction(Function* function)
 
     m_currentTagHolder = m_currentFunction = function;
     m_currentProperty = nullptr;
+    m_currentEvent = nullptr;
+
+    return *this;
+}
+
+template <typename T>
+ClassBuilder<T>& ClassBuilder<T>::addEvent(Event* event)
+{
+    // Retrieve the class' events indexed by name
+    Class::EventTable& events = m_target->m_events;
+
+    // First remove any event that already exists with the same name
+    events.erase(event->name());
+
+    // Insert the new event
+    events.insert(event->name(), Class::EventPtr(event));
+
+    m_currentTagHolder = m_currentEvent = event;
+    m_currentProperty = nullptr;
+    m_currentFunction = nullptr;
 
     return *this;
 }
@@ -52,6 +52,17 @@ class Class;
  */
 PONDER_API void* classCast(void* pointer, const Class& sourceClass, const Class& targetClass);
 
+/**
+ * \brief Convert a pointer from a source metaclass to a target metaclass, if they are related
+ *
+ * \param pointer Source pointer to convert, receives the converted pointer on success
+ * \param sourceClass Source metaclass to convert from
+ * \param targetClass Target metaclass to convert to
+ *
+ * \return True on success, false if sourceClass is not a base nor a derived of targetClass
+ */
+PONDER_API bool tryClassCast(void*& pointer, const Class& sourceClass, const Class& targetClass);
+
 } // namespace ponder
 
 #endif // PONDER_CLASSCAST_HPP
@@ -36,6 +36,7 @@
 #include <ponder/error.hpp>
 #include <ponder/detail/typeid.hpp>
 #include <ponder/detail/classmanager.hpp>
+#include <ponder/detail/classcache.hpp>
 #include <ponder/detail/util.hpp>
 #include <string>
 
@@ -51,6 +52,21 @@ namespace ponder
  */
 std::size_t classCount();
 
+/**
+ * \relates Class
+ *
+ * \brief Get the current generation of the metaclass and metaenum registry
+ *
+ * The generation changes every time a metaclass or a metaenum is declared or undeclared.
+ * A pointer to a metaclass obtained at a given generation is guaranteed to be valid as
+ * long as the generation hasn't changed.
+ *
+ * \return Registry generation
+ *
+ * \sa Module
+ */
+std::size_t registryGeneration();
+
 /**
  * \relates Class
  *
@@ -83,6 +99,17 @@ const Class& classByIndex(std::size_t index);
  */
 const Class& classByName(IdRef name);
 
+/**
+ * \relates Class
+ *
+ * \brief Get a metaclass from its name, without raising errors
+ *
+ * \param name Name of the metaclass to retrieve (case sensitive)
+ *
+ * \return Pointer to the requested metaclass, or null pointer if no metaclass has this name
+ */
+const Class* classByNameSafe(IdRef name);
+
 /**
  * \relates Class
  *
@@ -36,6 +36,11 @@ inline std::size_t classCount()
     return detail::ClassManager::instance().count();
 }
 
+inline std::size_t registryGeneration()
+{
+    return detail::ObserverNotifier::generation();
+}
+
 inline const Class& classByIndex(std::size_t index)
 {
     return detail::ClassManager::instance().getByIndex(index);
@@ -47,16 +52,59 @@ inline const Class& classByName(IdRef name)
     return detail::ClassManager::instance().getById(name);
 }
 
+inline const Class* classByNameSafe(IdRef name)
+{
+    return detail::ClassManager::instance().getByIdSafe(name);
+}
+
+namespace detail
+{
+template <typename T, typename E = void>
+struct ClassByObject
+{
+    static const Class& get(const T& object)
+    {
+        return ClassManager::instance().getById(typeId(object));
+    }
+};
+
+/*
+ * Specialization of ClassByObject for types using PONDER_POLYMORPHIC: the metaclass of
+ * the dynamic type is cached by the type itself, so no lookup by name is needed
+ */
+template <typename T>
+struct ClassByObject<T, typename std::enable_if<HasPonderClass<T>::value>::type>
+{
+    static const Class& get(const T& object)
+    {
+        typename ObjectTraits<const T&>::PointerType pointer =
+            ObjectTraits<const T&>::getPointer(object);
+        if (pointer)
+        {
+            if (const Class* cls = pointer->ponderClass())
+                return *cls;
+        }
+
+        return ClassManager::instance().getById(typeId(object));
+    }
+};
+} // namespace detail
+
 template <typename T>
 const Class& classByObject(const T& object)
 {
-    return detail::ClassManager::instance().getById(detail::typeId(object));
+    return detail::ClassByObject<T>::get(object);
 }
 
 template <typename T>
 const Class& classByType()
 {
-    return detail::ClassManager::instance().getById(detail::typeId<T>());
+    // The metaclass is cached per type until the registry changes
+    static detail::ClassCache cache;
+    const Class* cls = cache.valid() ? cache.get() : cache.resolve(detail::typeId<T>());
+
+    // Not registered: let the manager report the error
+    return cls ? *cls : detail::ClassManager::instance().getById(detail::typeId<T>());
 }
 
 template <typename T>
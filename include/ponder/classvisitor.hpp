@@ -39,9 +39,11 @@ namespace ponder
 class Property;
 class SimpleProperty;
 class ArrayProperty;
+class DictionaryProperty;
 class EnumProperty;
 class UserProperty;
 class Function;
+class Event;
 
 /**
  * \brief Base class for writing custom Class visitors
@@ -72,6 +74,11 @@ class Function;
  *                   << "dynamic:" << property.dynamic() << std::endl;
  *     }
  * 
+ *     void visit(const ponder::DictionaryProperty& property)
+ *     {
+ *         std::cout << "Dictionary property: " << property.name() << std::endl;
+ *     }
+ * 
  *     void visit(const ponder::EnumProperty& property)
  *     {
  *         std::cout << "Enum property: " << property.name() << " - "
@@ -130,6 +137,13 @@ public:
      */
     virtual void visit(const ArrayProperty& property);
 
+    /**
+     * \brief Visit a dictionary property
+     *
+     * \param property Property which is being visited
+     */
+    virtual void visit(const DictionaryProperty& property);
+
     /**
      * \brief Visit an enum property
      *
@@ -151,6 +165,13 @@ public:
      */
     virtual void visit(const Function& function);
 
+    /**
+     * \brief Visit an event
+     *
+     * \param event Event which is being visited
+     */
+    virtual void visit(const Event& event);
+
 protected:
 
     /**
@@ -62,6 +62,35 @@
 #ifndef PONDER_USING_LUA
 #   define PONDER_USING_LUA 0
 #endif
+
+// Define PONDER_SINGLE_THREADED to 1 (for Ponder and all its clients) if Ponder is only
+// used from one thread: shared handles then use non-atomic reference counts.
+#ifndef PONDER_SINGLE_THREADED
+#   define PONDER_SINGLE_THREADED 0
+#endif
+
+// Define PONDER_INSTRUMENT to 1 (for Ponder and all its clients) to count and time every
+// property access, function call and construction (see ponder/instrument.hpp).
+#ifndef PONDER_INSTRUMENT
+#   define PONDER_INSTRUMENT 0
+#endif
+
+// Define PONDER_TRACK_INSTANCES to 1 (for Ponder and all its clients) to count the live
+// instances of each metaclass created through Ponder (see ponder/instances.hpp).
+#ifndef PONDER_TRACK_INSTANCES
+#   define PONDER_TRACK_INSTANCES 0
+#endif
+
+// Define PONDER_NO_EXCEPTIONS to 1 (for Ponder and all its clients) to build without exceptions:
+// errors are then reported to the error handler (see ponder/error.hpp). It defaults to 1 when
+// the compiler has exceptions disabled.
+#ifndef PONDER_NO_EXCEPTIONS
+#   if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+#       define PONDER_NO_EXCEPTIONS 0
+#   else
+#       define PONDER_NO_EXCEPTIONS 1
+#   endif
+#endif
     
 // We disable some annoying warnings of VC++
 #if defined(_MSC_VER)
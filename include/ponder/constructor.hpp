@@ -32,6 +32,11 @@
 #define PONDER_CONSTRUCTOR_HPP
 
 
+#include <ponder/detail/refcount.hpp>
+#include <ponder/detail/metaallocator.hpp>
+#include <ponder/instrument.hpp>
+
+
 namespace ponder
 {
 class Args;
@@ -44,7 +49,9 @@ class UserObject;
  *
  * \sa Property, Function
  */
-class Constructor
+class Constructor : public detail::RefCounted,
+                    public detail::MetaAllocated<MemoryCategory::Objects>,
+                    public instrument::detail::Instrumented
 {
 public:
 
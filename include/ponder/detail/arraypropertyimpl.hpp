@@ -99,6 +99,21 @@ protected:
      */
     void removeElement(const UserObject& object, std::size_t index) const override;
 
+    /**
+     * \see Property::isInstance
+     */
+    bool isInstance(const UserObject& object) const override;
+
+    /**
+     * \see Property::canGetValue
+     */
+    bool canGetValue(const UserObject& object) const override;
+
+    /**
+     * \see Property::canSetValue
+     */
+    bool canSetValue(const UserObject& object, const Value& value) const override;
+
 private:
 
     typedef typename std::remove_reference<typename A::DataType>::type ArrayType;
@@ -92,6 +92,25 @@ typename ArrayPropertyImpl<A>::ArrayType& ArrayPropertyImpl<A>::array(const User
     return m_accessor.get(object.get<typename A::ClassType>());
 }
 
+template <typename A>
+bool ArrayPropertyImpl<A>::isInstance(const UserObject& object) const
+{
+    return CompatibleToUser<typename A::ClassType>::from(object);
+}
+
+template <typename A>
+bool ArrayPropertyImpl<A>::canGetValue(const UserObject& object) const
+{
+    // The value of an array is its first element
+    return getSize(object) > 0;
+}
+
+template <typename A>
+bool ArrayPropertyImpl<A>::canSetValue(const UserObject& object, const Value& value) const
+{
+    return getSize(object) > 0 && value.isCompatible<ElementType>();
+}
+
 } // namespace detail
 
 } // namespace ponder
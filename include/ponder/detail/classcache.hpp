@@ -0,0 +1,113 @@
+/****************************************************************************
+**
+** This file is part of the Ponder library, formerly CAMP.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+
+#ifndef PONDER_DETAIL_CLASSCACHE_HPP
+#define PONDER_DETAIL_CLASSCACHE_HPP
+
+
+#include <ponder/detail/observernotifier.hpp>
+#include <atomic>
+
+
+namespace ponder
+{
+class Class;
+class Enum;
+
+namespace detail
+{
+/**
+ * \brief Cached pointer to a metaclass or metaenum, valid for one registry generation
+ *
+ * This is used by PONDER_POLYMORPHIC to resolve the dynamic metaclass of an object with a
+ * virtual call and a generation check, instead of a lookup by name. It also caches the
+ * result of classByType() and enumByType() per C++ type, and the metaclasses referenced by
+ * properties. It can be shared by several threads: lookups don't lock, resolutions are
+ * serialized.
+ */
+template <typename T>
+class MetaCache
+{
+public:
+
+    /**
+     * \brief Construct an empty cache
+     */
+    MetaCache()
+        : m_meta(nullptr)
+        , m_generation(static_cast<std::size_t>(-1))
+    {
+    }
+
+    /**
+     * \brief Check if the cached pointer is valid for the current registry generation
+     */
+    bool valid() const
+    {
+        return m_generation.load(std::memory_order_acquire) == ObserverNotifier::generation();
+    }
+
+    /**
+     * \brief Get the cached pointer, only meaningful if valid() is true
+     *
+     * \return Cached metaclass or metaenum, or null if it wasn't declared when resolved
+     */
+    const T* get() const
+    {
+        return m_meta.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * \brief Resolve the metaclass or metaenum by name and cache it for the current generation
+     *
+     * \param id Name of the metaclass or metaenum
+     *
+     * \return Metaclass or metaenum, or null if it isn't declared
+     */
+    const T* resolve(const char* id);
+
+private:
+
+    std::atomic<const T*> m_meta; ///< Cached metaclass or metaenum
+    std::atomic<std::size_t> m_generation; ///< Registry generation m_meta is valid for
+};
+
+template <> PONDER_API const Class* MetaCache<Class>::resolve(const char* id);
+template <> PONDER_API const Enum* MetaCache<Enum>::resolve(const char* id);
+
+typedef MetaCache<Class> ClassCache;
+typedef MetaCache<Enum> EnumCache;
+
+} // namespace detail
+
+} // namespace ponder
+
+
+#endif // PONDER_DETAIL_CLASSCACHE_HPP
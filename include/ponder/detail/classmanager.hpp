@@ -32,6 +32,7 @@
 #define PONDER_DETAIL_CLASSMANAGER_HPP
 
 #include <ponder/detail/observernotifier.hpp>
+#include <ponder/detail/string_view.hpp>
 #include <map>
 
 namespace ponder {
@@ -152,7 +153,9 @@ public:
 
 private:
 
-    typedef std::map<Id, Class*> ClassTable; ///< No need for shared pointers in here, we're the one and only instance holder
+    /// No need for shared pointers in here, we're the one and only instance holder.
+    /// Keys view the name of their metaclass, so that lookups never copy the identifier.
+    typedef std::map<string_view, Class*> ClassTable;
     ClassTable m_classes; ///< Table storing classes indexed by their ID
 };
 
@@ -33,6 +33,7 @@
 
 
 #include <ponder/constructor.hpp>
+#include <ponder/instances.hpp>
 #include <ponder/valuemapper.hpp>
 #include <ponder/value.hpp>
 #include <ponder/valuevisitor.hpp>
@@ -46,27 +47,25 @@ namespace detail
 /**
  * \brief Helper function which converts an argument to a C++ type
  *
- * The main purpose of this function is to convert any BadType error to
- * a BadArgument one.
+ * The main purpose of this function is to report an incompatible argument
+ * as a BadArgument error.
  *
  * \param args List of arguments
  * \param index Index of the argument to convert
  *
  * \return Value of args[index] converted to T
  *
- * \thrown BadArgument conversion triggered a BadType error
+ * \thrown BadArgument args[index] is not compatible with T
  */
 template <typename T>
 inline typename std::remove_reference<T>::type convertArg(const Args& args, std::size_t index)
 {
-    try
-    {
-        return args[index].to<typename std::remove_reference<T>::type>();
-    }
-    catch (const BadType&)
-    {
-        PONDER_ERROR(BadArgument(args[index].kind(), mapType<T>(), index, "constructor"));
-    }
+    typedef typename std::remove_reference<T>::type ReturnType;
+
+    const Value& arg = args[index];
+    if (!arg.visit(ponder::detail::CompatibleVisitor<ReturnType, false>()))
+        PONDER_ERROR(BadArgument(arg.kind(), mapType<T>(), index, "constructor"));
+    return arg.to<ReturnType>();
 }
 
 /**
@@ -97,10 +96,10 @@ class ConstructorImpl : public Constructor
     template <typename... As, std::size_t... Is>
     static inline UserObject createWithArgs(void* ptr, const Args& args, _PONDER_SEQNS::index_sequence<Is...>)
     {
-        if (ptr)
-            return UserObject(*new(ptr) T(convertArg<As>(args, Is)...)); // placement new
-        else
-            return UserObject(*new T(convertArg<As>(args, Is)...));
+        UserObject object(ptr ? *new(ptr) T(convertArg<As>(args, Is)...)   // placement new
+                              : *new T(convertArg<As>(args, Is)...));
+        PONDER_INSTANCE_CREATED(object.getClass(), object.pointer());
+        return object;
     }
 
 public:
@@ -139,6 +139,8 @@ public:
     
     std::size_t size() const { return m_contents.size(); }
 
+    std::size_t capacity() const { return m_contents.capacity(); }
+
     void insert(KEY_REF key, const VALUE &value)
     {
         erase(key);
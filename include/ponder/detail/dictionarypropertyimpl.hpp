@@ -0,0 +1,159 @@
+/****************************************************************************
+**
+** This file is part of the Ponder library, formerly CAMP.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+
+
+#ifndef PONDER_DETAIL_DICTIONARYPROPERTYIMPL_HPP
+#define PONDER_DETAIL_DICTIONARYPROPERTYIMPL_HPP
+
+
+#include <ponder/dictionaryproperty.hpp>
+#include <ponder/mapmapper.hpp>
+#include <ponder/valuemapper.hpp>
+#include <type_traits>
+
+
+namespace ponder
+{
+namespace detail
+{
+/**
+ * \brief Typed implementation of DictionaryProperty
+ *
+ * DictionaryPropertyImpl is a template implementation of DictionaryProperty, which is
+ * strongly typed in order to keep track of the true underlying C++ types involved in the
+ * property.
+ *
+ * The template parameter A is an abstract helper to access the actual C++ property.
+ *
+ * This class uses the ponder_ext::MapMapper template to implement its operations according
+ * to the type of container.
+ *
+ * \sa DictionaryProperty, ponder_ext::MapMapper
+ */
+template <typename A>
+class DictionaryPropertyImpl : public DictionaryProperty
+{
+public:
+
+    /**
+     * \brief Construct the property
+     *
+     * \param name Name of the property
+     * \param accessor Object used to access the actual C++ property
+     */
+    DictionaryPropertyImpl(IdRef name, const A& accessor);
+
+protected:
+
+    /**
+     * \see DictionaryProperty::getSize
+     */
+    std::size_t getSize(const UserObject& object) const override;
+
+    /**
+     * \see DictionaryProperty::findElement
+     */
+    bool findElement(const UserObject& object, const Value& key, Value& value) const override;
+
+    /**
+     * \see DictionaryProperty::setElement
+     */
+    void setElement(const UserObject& object, const Value& key, const Value& value) const override;
+
+    /**
+     * \see DictionaryProperty::removeElement
+     */
+    bool removeElement(const UserObject& object, const Value& key) const override;
+
+    /**
+     * \see DictionaryProperty::insertElement
+     */
+    bool insertElement(const UserObject& object, const Value& key) const override;
+
+    /**
+     * \see DictionaryProperty::nextElement
+     */
+    bool nextElement(const UserObject& object, Value& key, Value& value) const override;
+
+    /**
+     * \see DictionaryProperty::visitElements
+     */
+    void visitElements(const UserObject& object, const ElementVisitor& visitor) const override;
+
+    /**
+     * \see Property::isInstance
+     */
+    bool isInstance(const UserObject& object) const override;
+
+private:
+
+    typedef typename std::remove_reference<typename A::DataType>::type MapType;
+    typedef ponder_ext::MapMapper<MapType> Mapper;
+    typedef typename Mapper::KeyType KeyType;
+    typedef typename Mapper::ElementType ElementType;
+
+    /**
+     * \brief Retrieve a reference to the container
+     *
+     * \param object Owner object
+     *
+     * \return Reference to the underlying container
+     */
+    MapType& map(const UserObject& object) const;
+
+    /**
+     * \brief Insert a default-constructed element (only if the element type allows it)
+     */
+    template <typename E = ElementType>
+    typename std::enable_if<std::is_default_constructible<E>::value, bool>::type
+    insertDefault(MapType& map, const KeyType& key) const
+    {
+        Mapper::set(map, key, E());
+        return true;
+    }
+
+    template <typename E = ElementType>
+    typename std::enable_if<!std::is_default_constructible<E>::value, bool>::type
+    insertDefault(MapType&, const KeyType&) const
+    {
+        return false;
+    }
+
+    A m_accessor; ///< Object used to access the actual C++ property
+};
+
+} // namespace detail
+
+} // namespace ponder
+
+#include <ponder/detail/dictionarypropertyimpl.inl>
+
+
+#endif // PONDER_DETAIL_DICTIONARYPROPERTYIMPL_HPP
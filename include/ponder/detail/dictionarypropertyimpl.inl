@@ -0,0 +1,130 @@
+/****************************************************************************
+**
+** This file is part of the Ponder library, formerly CAMP.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+
+
+namespace ponder
+{
+namespace detail
+{
+template <typename A>
+DictionaryPropertyImpl<A>::DictionaryPropertyImpl(IdRef name, const A& accessor)
+    : DictionaryProperty(name, mapType<KeyType>(), mapType<ElementType>())
+    , m_accessor(accessor)
+{
+}
+
+template <typename A>
+std::size_t DictionaryPropertyImpl<A>::getSize(const UserObject& object) const
+{
+    return Mapper::size(map(object));
+}
+
+template <typename A>
+bool DictionaryPropertyImpl<A>::findElement(const UserObject& object, const Value& key,
+                                            Value& value) const
+{
+    const ElementType* element = Mapper::find(map(object), key.to<KeyType>());
+    if (!element)
+        return false;
+
+    value = *element;
+    return true;
+}
+
+template <typename A>
+void DictionaryPropertyImpl<A>::setElement(const UserObject& object, const Value& key,
+                                           const Value& value) const
+{
+    Mapper::set(map(object), key.to<KeyType>(), value.to<ElementType>());
+}
+
+template <typename A>
+bool DictionaryPropertyImpl<A>::removeElement(const UserObject& object, const Value& key) const
+{
+    return Mapper::remove(map(object), key.to<KeyType>());
+}
+
+template <typename A>
+bool DictionaryPropertyImpl<A>::insertElement(const UserObject& object, const Value& key) const
+{
+    MapType& container = map(object);
+    const KeyType typedKey = key.to<KeyType>();
+    return Mapper::find(container, typedKey) || insertDefault(container, typedKey);
+}
+
+template <typename A>
+bool DictionaryPropertyImpl<A>::nextElement(const UserObject& object, Value& key,
+                                            Value& value) const
+{
+    const MapType& container = map(object);
+    typename Mapper::Cursor cursor = typename Mapper::Cursor();
+
+    // Continue after the current key (stop if it has been removed meanwhile)
+    if (key.kind() != ValueKind::None && !Mapper::seek(container, key.to<KeyType>(), cursor))
+        return false;
+
+    const KeyType* nextKey = nullptr;
+    const ElementType* element = nullptr;
+    if (!Mapper::next(container, cursor, nextKey, element))
+        return false;
+
+    key = *nextKey;
+    value = *element;
+    return true;
+}
+
+template <typename A>
+void DictionaryPropertyImpl<A>::visitElements(const UserObject& object,
+                                              const ElementVisitor& visitor) const
+{
+    const MapType& container = map(object);
+    typename Mapper::Cursor cursor = typename Mapper::Cursor();
+    const KeyType* key = nullptr;
+    const ElementType* element = nullptr;
+    while (Mapper::next(container, cursor, key, element))
+        visitor(Value(*key), Value(*element));
+}
+
+template <typename A>
+typename DictionaryPropertyImpl<A>::MapType&
+DictionaryPropertyImpl<A>::map(const UserObject& object) const
+{
+    return m_accessor.get(object.get<typename A::ClassType>());
+}
+
+template <typename A>
+bool DictionaryPropertyImpl<A>::isInstance(const UserObject& object) const
+{
+    return CompatibleToUser<typename A::ClassType>::from(object);
+}
+
+} // namespace detail
+
+} // namespace ponder
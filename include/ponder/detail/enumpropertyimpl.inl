@@ -64,6 +64,18 @@ bool EnumPropertyImpl<A>::isWritable() const
     return A::canWrite;
 }
 
+template <typename A>
+bool EnumPropertyImpl<A>::isInstance(const UserObject& object) const
+{
+    return CompatibleToUser<typename A::ClassType>::from(object);
+}
+
+template <typename A>
+bool EnumPropertyImpl<A>::canSetValue(const UserObject&, const Value& value) const
+{
+    return value.isCompatible<typename A::DataType>();
+}
+
 } // namespace detail
 
 } // namespace ponder
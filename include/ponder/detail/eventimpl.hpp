@@ -0,0 +1,166 @@
+/****************************************************************************
+**
+** This file is part of the Ponder library, formerly CAMP.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+
+
+#ifndef PONDER_DETAIL_EVENTIMPL_HPP
+#define PONDER_DETAIL_EVENTIMPL_HPP
+
+
+#include <ponder/event.hpp>
+#include <ponder/errors.hpp>
+#include <ponder/userobject.hpp>
+#include <ponder/valuemapper.hpp>
+#include <ponder/value.hpp>
+#include <ponder/valuevisitor.hpp>
+#include <array>
+
+
+namespace ponder
+{
+namespace detail
+{
+/**
+ * \brief Implementation of metaevents bound to an EventSource member
+ *
+ * \param C Class declaring the EventSource (the metaclass' type or one of its bases)
+ * \param A Types of the parameters of the event
+ */
+template <typename C, typename... A>
+class EventImpl : public Event
+{
+public:
+
+    typedef EventSource<A...> Source;
+
+    /**
+     * \brief Constructor
+     *
+     * \param name Name of the event
+     * \param source Member holding the subscribers of each object
+     */
+    EventImpl(IdRef name, Source C::*source)
+        : Event(name)
+        , m_source(source)
+    {
+    }
+
+    /**
+     * \see Event::paramCount
+     */
+    std::size_t paramCount() const override
+    {
+        return sizeof...(A);
+    }
+
+    /**
+     * \see Event::paramType
+     */
+    ValueKind paramType(std::size_t index) const override
+    {
+        static const std::array<ValueKind, sizeof...(A)> types =
+            {{mapType<typename std::decay<A>::type>()...}};
+
+        if (index >= types.size())
+            PONDER_ERROR(OutOfRange(index, types.size()));
+        return types[index];
+    }
+
+    /**
+     * \see Event::subscribe
+     */
+    EventHandle subscribe(const UserObject& object, EventHandler handler) const override
+    {
+        return source(object).subscribe([handler](const A&... args)
+        {
+            handler(Args(args...));
+        });
+    }
+
+    /**
+     * \see Event::unsubscribe
+     */
+    bool unsubscribe(const UserObject& object, EventHandle handle) const override
+    {
+        return source(object).unsubscribe(handle);
+    }
+
+    /**
+     * \see Event::fire
+     */
+    void fire(const UserObject& object, const Args& args) const override
+    {
+        if (args.count() < sizeof...(A))
+            PONDER_ERROR(NotEnoughArguments(name(), args.count(), sizeof...(A)));
+
+        fireWithArgs(source(object), args, _PONDER_SEQNS::make_index_sequence<sizeof...(A)>());
+    }
+
+    /**
+     * \see Event::subscriberCount
+     */
+    std::size_t subscriberCount(const UserObject& object) const override
+    {
+        return source(object).subscriberCount();
+    }
+
+private:
+
+    Source& source(const UserObject& object) const
+    {
+        return object.get<C>().*m_source;
+    }
+
+    template <std::size_t... Is>
+    void fireWithArgs(Source& source, const Args& args,
+                      _PONDER_SEQNS::index_sequence<Is...>) const
+    {
+        source.fire(convert<A>(args, Is)...);
+    }
+
+    template <typename T>
+    typename std::decay<T>::type convert(const Args& args, std::size_t index) const
+    {
+        typedef typename std::decay<T>::type ReturnType;
+
+        const Value& arg = args[index];
+        if (!arg.visit(ponder::detail::CompatibleVisitor<ReturnType, false>()))
+            PONDER_ERROR(BadArgument(arg.kind(), mapType<ReturnType>(), index, name()));
+        return arg.to<ReturnType>();
+    }
+
+    Source C::*m_source; ///< Member holding the subscribers of each object
+};
+
+} // namespace detail
+
+} // namespace ponder
+
+
+#endif // PONDER_DETAIL_EVENTIMPL_HPP
@@ -0,0 +1,245 @@
+/****************************************************************************
+**
+** This file is part of the Ponder library, formerly CAMP.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+
+#ifndef PONDER_DETAIL_FIELDPROPERTY_HPP
+#define PONDER_DETAIL_FIELDPROPERTY_HPP
+
+
+#include <ponder/simpleproperty.hpp>
+#include <ponder/detail/classcache.hpp>
+#include <ponder/detail/typeid.hpp>
+#include <cstddef>
+#include <type_traits>
+
+
+namespace ponder
+{
+namespace detail
+{
+/**
+ * \brief C++ types of the data members handled by FieldProperty
+ */
+enum class FieldType
+{
+    Bool,
+    Char,
+    UnsignedChar,
+    Short,
+    UnsignedShort,
+    Int,
+    UnsignedInt,
+    Long,
+    UnsignedLong,
+    LongLong,
+    UnsignedLongLong,
+    Float,
+    Double,
+    String
+};
+
+/**
+ * \brief Map a C++ type to its FieldType, if it is supported by FieldProperty
+ */
+template <typename T>
+struct FieldTypeOf
+{
+    enum {supported = false};
+};
+
+#define PONDER__FIELD_TYPE(T, E) \
+    template <> struct FieldTypeOf<T> \
+    { \
+        enum {supported = true}; \
+        static FieldType type() {return FieldType::E;} \
+    };
+
+PONDER__FIELD_TYPE(bool, Bool)
+PONDER__FIELD_TYPE(char, Char)
+PONDER__FIELD_TYPE(unsigned char, UnsignedChar)
+PONDER__FIELD_TYPE(short, Short)
+PONDER__FIELD_TYPE(unsigned short, UnsignedShort)
+PONDER__FIELD_TYPE(int, Int)
+PONDER__FIELD_TYPE(unsigned int, UnsignedInt)
+PONDER__FIELD_TYPE(long, Long)
+PONDER__FIELD_TYPE(unsigned long, UnsignedLong)
+PONDER__FIELD_TYPE(long long, LongLong)
+PONDER__FIELD_TYPE(unsigned long long, UnsignedLongLong)
+PONDER__FIELD_TYPE(float, Float)
+PONDER__FIELD_TYPE(double, Double)
+PONDER__FIELD_TYPE(ponder::String, String)
+
+#undef PONDER__FIELD_TYPE
+
+/**
+ * \brief Get a storage sized and aligned for an object of class C
+ *
+ * A single storage is shared by all the members of C whose offset is computed.
+ */
+template <typename C>
+const unsigned char* offsetStorage()
+{
+    static typename std::aligned_storage<sizeof(C), alignof(C)>::type storage;
+    return reinterpret_cast<const unsigned char*>(&storage);
+}
+
+/**
+ * \brief Get the offset of a data member within its class
+ *
+ * Like the usual implementations of offsetof, the address of the member is formed in a
+ * storage which holds no C object; the member is neither read nor written. The standard
+ * only guarantees this for standard-layout classes, which offsetof is limited to, but it is
+ * what the supported compilers do for any class. The member is declared in C itself, so it
+ * lies at a fixed offset whatever the type of the complete object.
+ */
+template <typename C, typename M>
+std::size_t fieldOffset(M C::*member)
+{
+    const unsigned char* storage = offsetStorage<C>();
+    const C* object = reinterpret_cast<const C*>(storage);
+    return static_cast<std::size_t>(reinterpret_cast<const unsigned char*>(&(object->*member))
+                                    - storage);
+}
+
+/**
+ * \brief Non-template implementation of SimpleProperty for plain data members
+ *
+ * Properties bound directly to a data member of a fundamental type or a string share this
+ * single implementation, which accesses the member through its offset in the owner class.
+ * This avoids instantiating an accessor and a property template, with their vtables, for
+ * every such member.
+ *
+ * \sa PropertyFactory1
+ */
+class PONDER_API FieldProperty : public SimpleProperty
+{
+public:
+
+    /**
+     * \brief Construct the property
+     *
+     * \param name Name of the property
+     * \param kind Kind of value of the property
+     * \param ownerId Type identifier of the class which declares the member
+     * \param offset Offset of the member in the owner class
+     * \param type C++ type of the member
+     * \param writable True if the member is not const
+     */
+    FieldProperty(IdRef name, ValueKind kind, const char* ownerId,
+                  std::size_t offset, FieldType type, bool writable);
+
+    /**
+     * \brief Get the C++ type of the member
+     *
+     * \return Type of the member
+     */
+    FieldType fieldType() const {return m_type;}
+
+    /**
+     * \brief Get the address of the member in an object
+     *
+     * \param object Pointer to the object
+     * \param objectClass Metaclass of the object, which may be derived from the owner class
+     *
+     * \return Pointer to the member
+     *
+     * \throw NullObject object is null
+     * \throw ClassNotFound the owner class is no longer declared
+     */
+    void* fieldPointer(void* object, const Class& objectClass) const;
+
+    /**
+     * \brief Get the address of the member in an object, without raising errors
+     *
+     * \param object Pointer to the object
+     * \param objectClass Metaclass of the object, which may be derived from the owner class
+     *
+     * \return Pointer to the member, or null if object is null, the owner class is no longer
+     *         declared or objectClass is not related to it
+     */
+    void* tryFieldPointer(void* object, const Class& objectClass) const;
+
+    /**
+     * \brief Get the offset of the member in the objects of a metaclass
+     *
+     * \param objectClass Metaclass of the objects, the owner class or derived from it
+     * \param offset Receives the offset of the member
+     *
+     * \return False if the owner class is no longer declared, or objectClass is not
+     *         derived from it
+     */
+    bool offset(const Class& objectClass, std::size_t& offset) const;
+
+protected:
+
+    /**
+     * \see Property::isReadable
+     */
+    bool isReadable() const override;
+
+    /**
+     * \see Property::isWritable
+     */
+    bool isWritable() const override;
+
+    /**
+     * \see Property::isInstance
+     */
+    bool isInstance(const UserObject& object) const override;
+
+    /**
+     * \see Property::canSetValue
+     */
+    bool canSetValue(const UserObject& object, const Value& value) const override;
+
+    /**
+     * \see Property::getValue
+     */
+    Value getValue(const UserObject& object) const override;
+
+    /**
+     * \see Property::setValue
+     */
+    void setValue(const UserObject& object, const Value& value) const override;
+
+private:
+
+    const char* m_ownerId; ///< Type identifier of the owner class
+    mutable ClassCache m_owner; ///< Owner class, cached per generation
+    std::size_t m_offset; ///< Offset of the member in the owner class
+    FieldType m_type; ///< C++ type of the member
+    bool m_writable; ///< Is the member non-const?
+};
+
+} // namespace detail
+
+} // namespace ponder
+
+
+#endif // PONDER_DETAIL_FIELDPROPERTY_HPP
@@ -33,6 +33,8 @@
 
 
 #include <ponder/userobject.hpp>
+#include <ponder/detail/refcount.hpp>
+#include <ponder/detail/metaallocator.hpp>
 #include <functional>
 
 namespace ponder
@@ -48,7 +50,7 @@ namespace detail
  * \sa Getter, GetterImpl
  */
 template <typename T>
-class GetterInterface
+class GetterInterface : public RefCounted, public MetaAllocated<MemoryCategory::Accessors>
 {
 public:
 
@@ -76,7 +78,7 @@ public:
     /**
      * \brief Construct the getter implementation from a function
      */
-    GetterImpl(std::function<T (C&)> function);
+    GetterImpl(MetaFunction<MemoryCategory::Accessors, T (C&)> function);
 
     /**
      * \see GetterInterface::get
@@ -85,7 +87,7 @@ public:
 
 private:
 
-    std::function<T (C&)> m_function; ///< Function object storing the actual getter
+    MetaFunction<MemoryCategory::Accessors, T (C&)> m_function; ///< Function object storing the actual getter
 };
 
 /**
@@ -120,7 +122,7 @@ public:
      * \param function Function object storing the actual getter
      */
     template <typename C>
-    Getter(std::function<T (C&)> function);
+    Getter(MetaFunction<MemoryCategory::Accessors, T (C&)> function);
 
     /**
      * \brief Get the default value of the getter
@@ -140,9 +142,16 @@ public:
      */
     T get(const UserObject& object) const;
 
+    /**
+     * \brief Check if the getter always returns its default value
+     *
+     * \return True if no function has been set
+     */
+    bool isConstant() const;
+
 private:
 
-    std::shared_ptr<GetterInterface<T> > m_getter; ///< Implementation of the getter
+    RefPtr<GetterInterface<T> > m_getter; ///< Implementation of the getter
     T m_defaultValue; ///< Default value to return if no function or no object is specified
 };
 
@@ -38,7 +38,7 @@ GetterInterface<T>::~GetterInterface()
 }
 
 template <typename T, typename C>
-GetterImpl<T, C>::GetterImpl(std::function<T (C&)> function)
+GetterImpl<T, C>::GetterImpl(MetaFunction<MemoryCategory::Accessors, T (C&)> function)
     : m_function(function)
 {
 }
@@ -58,7 +58,7 @@ Getter<T>::Getter(const T& defaultValue)
 
 template <typename T>
 template <typename C>
-Getter<T>::Getter(std::function<T (C&)> function)
+Getter<T>::Getter(MetaFunction<MemoryCategory::Accessors, T (C&)> function)
     : m_getter(new GetterImpl<T, C>(function))
 {
 }
@@ -75,6 +75,12 @@ T Getter<T>::get(const UserObject& object) const
     return m_getter ? m_getter->get(object) : m_defaultValue;
 }
 
+template <typename T>
+bool Getter<T>::isConstant() const
+{
+    return !m_getter;
+}
+
 } // namespace detail
 
 } // namespace ponder
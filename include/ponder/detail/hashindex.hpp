@@ -0,0 +1,141 @@
+/****************************************************************************
+**
+** This file is part of the Ponder library, formerly CAMP.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+
+#ifndef PONDER_DETAIL_HASHINDEX_HPP
+#define PONDER_DETAIL_HASHINDEX_HPP
+
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace ponder
+{
+namespace detail
+{
+/**
+ * \brief 32-bit FNV-1a hash of a name
+ */
+inline std::uint32_t hashName(const char* data, std::size_t size)
+{
+    std::uint32_t hash = 2166136261u;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * \brief Open addressing hash index over a table of entries stored elsewhere
+ *
+ * The index only stores entry indices, in a power-of-two table at most half full, so it
+ * can be built next to any flat container (e.g. a vector or a sorted Dictionary).
+ * The owner provides the hash of each entry when building, and an equality test
+ * when searching.
+ */
+class HashIndex
+{
+public:
+
+    enum : std::size_t {npos = static_cast<std::size_t>(-1)}; ///< Returned when not found
+
+    /**
+     * \brief Rebuild the index
+     *
+     * \param count Number of entries
+     * \param hashOf Function returning the hash of an entry from its index
+     */
+    template <typename H>
+    void build(std::size_t count, H hashOf)
+    {
+        std::size_t size = 4;
+        while (size < count * 2)
+            size *= 2;
+
+        m_slots.assign(count > 0 ? size : 0, 0);
+
+        const std::size_t mask = size - 1;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            std::size_t slot = hashOf(i) & mask;
+            while (m_slots[slot])
+                slot = (slot + 1) & mask;
+            m_slots[slot] = static_cast<std::uint32_t>(i + 1);
+        }
+    }
+
+    /**
+     * \brief Find an entry
+     *
+     * \param hash Hash of the entry to find
+     * \param equal Function returning true if the entry whose index is given matches
+     *
+     * \return Index of the entry, or npos if not found
+     */
+    template <typename E>
+    std::size_t find(std::size_t hash, E equal) const
+    {
+        if (m_slots.empty())
+            return npos;
+
+        const std::size_t mask = m_slots.size() - 1;
+        for (std::size_t slot = hash & mask; m_slots[slot]; slot = (slot + 1) & mask)
+        {
+            if (equal(m_slots[slot] - 1))
+                return m_slots[slot] - 1;
+        }
+
+        return npos;
+    }
+
+    /**
+     * \brief Remove all the entries
+     */
+    void clear() {m_slots.clear();}
+
+    /**
+     * \brief Get the number of bytes allocated by the index
+     */
+    std::size_t memoryUsage() const {return m_slots.capacity() * sizeof(std::uint32_t);}
+
+private:
+
+    std::vector<std::uint32_t> m_slots; ///< Entry index + 1, or 0 for empty slots
+};
+
+} // namespace detail
+
+} // namespace ponder
+
+
+#endif // PONDER_DETAIL_HASHINDEX_HPP
@@ -0,0 +1,385 @@
+/****************************************************************************
+**
+** This file is part of the Ponder library, formerly CAMP.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+
+
+#ifndef PONDER_DETAIL_MEMBERINDEX_HPP
+#define PONDER_DETAIL_MEMBERINDEX_HPP
+
+
+#include <ponder/detail/hashindex.hpp>
+#include <ponder/detail/refcount.hpp>
+#include <ponder/config.hpp>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+
+namespace ponder
+{
+namespace detail
+{
+/**
+ * \brief Get the kind of a member stored in its index entry
+ */
+template <typename T>
+inline std::uint8_t memberKind(const T& member)
+{
+    return static_cast<std::uint8_t>(member.kind());
+}
+
+/**
+ * \brief Release the unused capacity of a vector
+ *
+ * Unlike shrink_to_fit, which libstdc++ ignores when exceptions are disabled.
+ */
+template <typename V>
+inline void shrinkToFit(V& vector)
+{
+    V(vector).swap(vector);
+}
+
+/**
+ * \brief Packed index of the members (properties, functions or events) of a metaclass
+ *
+ * The tables of a metaclass only own the members it declares itself. The index is the
+ * view of all the members of the metaclass, in two layers: a layer of its own members,
+ * and an overlay of the members inherited from its base metaclasses. The overlay is the
+ * flattened view of the base metaclass, shared rather than copied when there is a single
+ * base, and it keeps the inherited members alive if a base metaclass is undeclared.
+ *
+ * Each layer stores the hot part of each member (hash, kind and address), 16 bytes per
+ * member, plus a hashed index of the names, so that finding a member by name reads a few
+ * contiguous cache lines and a single name per layer, instead of binary searching through
+ * strings scattered across the heap.
+ *
+ * Members are indexed in a stable order: the inherited members first, in the order of the
+ * base metaclass, then the members declared by the metaclass, in name order.
+ */
+template <typename T>
+class MemberIndex
+{
+public:
+
+    /**
+     * \brief Hot data of a member
+     */
+    struct Entry
+    {
+        std::uint32_t hash;     ///< Hash of the name
+        std::uint8_t kind;      ///< ValueKind, FunctionKind or parameter count (memberKind)
+        const T* member;        ///< The member
+
+        IdRef name() const {return member->name();}
+        const T* value() const {return member;}
+    };
+
+    /**
+     * \brief Iterator over the entries of an index, in index order
+     */
+    class const_iterator
+    {
+    public:
+        const_iterator(const MemberIndex* index, std::size_t position)
+            : m_index(index), m_position(position) {}
+        const Entry& operator * () const {return (*m_index)[m_position];}
+        const Entry* operator -> () const {return &(*m_index)[m_position];}
+        const_iterator& operator ++ () {++m_position; return *this;}
+        bool operator == (const const_iterator& other) const {return m_position == other.m_position;}
+        bool operator != (const const_iterator& other) const {return m_position != other.m_position;}
+    private:
+        const MemberIndex* m_index;
+        std::size_t m_position;
+    };
+
+    /**
+     * \brief Range over the entries, usable in range-based for loops
+     */
+    class Iterator
+    {
+        const_iterator m_begin, m_end;
+    public:
+        Iterator(const_iterator b, const_iterator e) : m_begin(b), m_end(e) {}
+        const_iterator begin() const    {return m_begin;}
+        const_iterator end() const      {return m_end;}
+    };
+
+    /**
+     * \brief Construct an empty index
+     */
+    MemberIndex()
+        : m_own(std::make_shared<Layer>())
+        , m_merged(false)
+        , m_overridden(false)
+        , m_inheritedCount(0)
+    {
+    }
+
+    /**
+     * \brief Rebuild the index from the members of a metaclass and of its bases
+     *
+     * Members declared by the metaclass override inherited members with the same name,
+     * and members of a base override those of the bases before it.
+     *
+     * \param table Dictionary of the members declared by the metaclass, sorted by name
+     * \param bases Indices of the base metaclasses, in declaration order
+     */
+    template <typename Table>
+    void build(const Table& table, const std::vector<const MemberIndex*>& bases)
+    {
+        // Inherited members: the view of a single base is shared, several bases are merged
+        m_inherited.reset();
+        m_flattened.reset();
+        m_merged = bases.size() > 1;
+        if (bases.size() == 1)
+        {
+            m_inherited = bases[0]->flattened();
+        }
+        else if (m_merged)
+        {
+            std::vector<std::shared_ptr<const Layer>> layers;
+            for (const MemberIndex* base : bases)
+                layers.push_back(base->flattened());
+
+            auto merged = std::make_shared<Layer>();
+            for (std::size_t i = 0; i < layers.size(); ++i)
+            {
+                for (std::size_t j = 0; j < layers[i]->entries.size(); ++j)
+                {
+                    const Entry& entry = layers[i]->entries[j];
+                    bool hidden = false;
+                    for (std::size_t k = i + 1; k < layers.size() && !hidden; ++k)
+                        hidden = layers[k]->find(entry.hash, entry.name()) != HashIndex::npos;
+                    if (!hidden)
+                        merged->add(entry, layers[i]->owners[j]);
+                }
+            }
+            merged->finish();
+            m_inherited = std::move(merged);
+        }
+        if (m_inherited && m_inherited->entries.empty())
+            m_inherited.reset();
+
+        // Own members, already sorted by name
+        auto own = std::make_shared<Layer>();
+        for (auto& pair : table)
+        {
+            const IdRef name = pair.first;
+            own->add(hashName(name.data(), name.size()), pair.second);
+        }
+        own->finish();
+        m_own = std::move(own);
+
+        // Inherited members overridden by own members are hidden
+        m_visible.clear();
+        m_overridden = false;
+        m_inheritedCount = 0;
+        if (m_inherited)
+        {
+            const std::vector<Entry>& entries = m_inherited->entries;
+            for (std::size_t i = 0; i < entries.size(); ++i)
+            {
+                if (m_own->find(entries[i].hash, entries[i].name()) == HashIndex::npos)
+                    m_visible.push_back(static_cast<std::uint32_t>(i));
+            }
+            m_inheritedCount = m_visible.size();
+            m_overridden = m_inheritedCount != entries.size();
+            if (!m_overridden)
+                m_visible.clear();
+            shrinkToFit(m_visible);
+        }
+    }
+
+    /**
+     * \brief Find a member by name
+     *
+     * \return Pointer to the member, or null if not found
+     */
+    const T* find(IdRef name) const
+    {
+        const std::uint32_t hash = hashName(name.data(), name.size());
+
+        std::size_t index = m_own->find(hash, name);
+        if (index != HashIndex::npos)
+            return m_own->entries[index].member;
+
+        // Overridden inherited members have the name of an own member, so they can't match
+        if (m_inherited)
+        {
+            index = m_inherited->find(hash, name);
+            if (index != HashIndex::npos)
+                return m_inherited->entries[index].member;
+        }
+
+        return nullptr;
+    }
+
+    /**
+     * \brief Get the hot data of a member, in index order
+     */
+    const Entry& operator[](std::size_t index) const
+    {
+        if (index >= m_inheritedCount)
+            return m_own->entries[index - m_inheritedCount];
+
+        return m_inherited->entries[m_overridden ? m_visible[index] : index];
+    }
+
+    /**
+     * \brief Get the number of indexed members
+     */
+    std::size_t size() const {return m_inheritedCount + m_own->entries.size();}
+
+    /**
+     * \brief Get the number of inherited members, which come first in index order
+     */
+    std::size_t inheritedCount() const {return m_inheritedCount;}
+
+    /**
+     * \brief Get a range over all the indexed members, in index order
+     */
+    Iterator getIterator() const
+    {
+        return Iterator(const_iterator(this, 0), const_iterator(this, size()));
+    }
+
+    /**
+     * \brief Get the number of bytes allocated by the layer of own members
+     */
+    std::size_t memoryUsage() const
+    {
+        return m_own->memoryUsage();
+    }
+
+    /**
+     * \brief Get the number of bytes allocated to reference inherited members
+     *
+     * This is the overlay when it merges several bases, the list of the inherited members
+     * which are not overridden, and the flattened view built for derived metaclasses.
+     * A shared overlay is counted by the metaclass it belongs to.
+     */
+    std::size_t inheritedMemoryUsage() const
+    {
+        return (m_merged && m_inherited ? m_inherited->memoryUsage() : 0)
+             + (m_flattened ? m_flattened->memoryUsage() : 0)
+             + m_visible.capacity() * sizeof(std::uint32_t);
+    }
+
+private:
+
+    /**
+     * \brief Members indexed by name, which can be shared between metaclasses
+     */
+    struct Layer
+    {
+        std::vector<Entry> entries;     ///< Hot data of the members
+        std::vector<RefPtr<T>> owners;  ///< Members of the entries, kept alive by the layer
+        HashIndex index;                ///< Hashed index of entries by name
+
+        void add(std::uint32_t hash, const RefPtr<T>& member)
+        {
+            Entry entry;
+            entry.hash = hash;
+            entry.kind = memberKind(*member);
+            entry.member = member.get();
+            entries.push_back(entry);
+            owners.push_back(member);
+        }
+
+        void add(const Entry& entry, const RefPtr<T>& member)
+        {
+            entries.push_back(entry);
+            owners.push_back(member);
+        }
+
+        void finish()
+        {
+            shrinkToFit(entries);
+            shrinkToFit(owners);
+            index.build(entries.size(), [this](std::size_t i) {return entries[i].hash;});
+        }
+
+        std::size_t find(std::uint32_t hash, IdRef name) const
+        {
+            return index.find(hash, [&](std::size_t i)
+            {
+                return entries[i].hash == hash && IdRef(entries[i].member->name()) == name;
+            });
+        }
+
+        std::size_t memoryUsage() const
+        {
+            return entries.capacity() * sizeof(Entry) + owners.capacity() * sizeof(RefPtr<T>)
+                 + index.memoryUsage();
+        }
+    };
+
+    /**
+     * \brief Get all the members in a single layer, in index order, to be shared by the
+     *        metaclasses deriving from this one
+     */
+    std::shared_ptr<const Layer> flattened() const
+    {
+        if (!m_inherited)
+            return m_own;
+        if (m_own->entries.empty())
+            return m_inherited;
+
+        // Only built for metaclasses which have both own and inherited members
+        if (!m_flattened)
+        {
+            auto layer = std::make_shared<Layer>();
+            for (std::size_t i = 0; i < m_inheritedCount; ++i)
+            {
+                const std::size_t position = m_overridden ? m_visible[i] : i;
+                layer->add(m_inherited->entries[position], m_inherited->owners[position]);
+            }
+            for (std::size_t i = 0; i < m_own->entries.size(); ++i)
+                layer->add(m_own->entries[i], m_own->owners[i]);
+            layer->finish();
+            m_flattened = std::move(layer);
+        }
+        return m_flattened;
+    }
+
+    std::shared_ptr<const Layer> m_own; ///< Members declared by the metaclass, in name order
+    std::shared_ptr<const Layer> m_inherited; ///< Members of the bases, or null if none
+    mutable std::shared_ptr<const Layer> m_flattened; ///< All the members, for derived classes
+    std::vector<std::uint32_t> m_visible; ///< Inherited members not overridden, if any is
+    bool m_merged; ///< Is m_inherited built by this index from several bases?
+    bool m_overridden; ///< Are some inherited members overridden by own members?
+    std::size_t m_inheritedCount; ///< Number of inherited members which are not overridden
+};
+
+} // namespace detail
+
+} // namespace ponder
+
+
+#endif // PONDER_DETAIL_MEMBERINDEX_HPP
@@ -0,0 +1,289 @@
+/****************************************************************************
+**
+** This file is part of the Ponder library, formerly CAMP.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+
+#ifndef PONDER_DETAIL_METAALLOCATOR_HPP
+#define PONDER_DETAIL_METAALLOCATOR_HPP
+
+
+#include <ponder/config.hpp>
+#include <ponder/allocator.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+namespace ponder
+{
+/**
+ * \brief Categories of the memory used by metadata
+ *
+ * \sa metadataMemoryReport
+ */
+enum class MemoryCategory
+{
+    Objects,    ///< Property, Function and Constructor objects
+    Accessors,  ///< Getters implementations (readable / writable states, tag values) and heap blocks of accessor functors
+    Callers,    ///< Per-module function callers (runtime, Lua), with the heap blocks of their functors
+    Names,      ///< Heap storage of the identifiers
+    Tags,       ///< Tables and indexes of tags
+    Tables,     ///< Tables of members and bases, metaclass and metaenum objects
+    Inherited   ///< Indices built to reference the members of base metaclasses
+};
+
+/**
+ * \brief Kinds of metadata the memory is used by
+ *
+ * \sa metadataMemoryReport
+ */
+enum class MetadataKind
+{
+    Class,
+    Property,
+    Function,
+    Constructor,
+    Event,
+    Enum
+};
+
+namespace detail
+{
+class MemoryCounter;
+
+enum : std::size_t
+{
+    memoryCategoryCount = 7,
+    metadataKindCount = 6,
+    allocatedCategoryCount = 3, ///< Categories counted by MetaAllocated (Objects to Callers)
+    memberKindCount = 5         ///< Metadata kinds a metaclass attributes its allocations to
+};
+
+/**
+ * \brief Bytes allocated by the members of a metaclass, per MetadataKind and MemoryCategory
+ */
+struct MetaAllocations
+{
+    std::uint32_t bytes[memberKindCount][allocatedCategoryCount] = {};
+};
+
+/**
+ * \brief Record an allocation or a deallocation of metadata
+ *
+ * \param category Category of the memory
+ * \param size Size of the block, in bytes
+ * \param allocated True for an allocation, false for a deallocation
+ */
+PONDER_API void countMetaAllocation(MemoryCategory category, std::size_t size, bool allocated);
+
+/**
+ * \brief Get the number of bytes currently allocated for a category of metadata
+ */
+PONDER_API std::size_t metaAllocatedBytes(MemoryCategory category);
+
+/**
+ * \brief Allocate a block of metadata from the metadata arena
+ *
+ * Blocks up to 512 bytes are carved in allocation order from 16 KiB chunks obtained from
+ * the current Allocator, so that the members of a metaclass, which are declared together,
+ * share a few cache lines instead of being scattered across the heap. Freed blocks are
+ * recycled per size class, chunks are kept until the program exits. Larger blocks are
+ * allocated directly.
+ *
+ * \param size Size of the block, in bytes
+ *
+ * \return Pointer to the block, aligned for any type
+ */
+PONDER_API void* arenaAllocate(std::size_t size);
+
+/**
+ * \brief Release a block returned by arenaAllocate
+ *
+ * \param ptr Pointer to the block
+ * \param size Size the block was allocated with
+ */
+PONDER_API void arenaDeallocate(void* ptr, std::size_t size);
+
+/**
+ * \brief Get the number of bytes of the chunks reserved by the metadata arena
+ */
+PONDER_API std::size_t arenaReservedBytes();
+
+/**
+ * \brief Base of the metadata objects whose allocations are counted
+ *
+ * The class-specific operators new and delete count the bytes used by every object
+ * derived from MetaAllocated, and allocate it from the metadata arena. The sized delete
+ * receives the size of the most derived type, so objects don't need to store their size.
+ */
+template <MemoryCategory C>
+class MetaAllocated
+{
+public:
+
+    static void* operator new(std::size_t size)
+    {
+        void* ptr = arenaAllocate(size);
+        countMetaAllocation(C, size, true);
+        return ptr;
+    }
+
+    static void operator delete(void* ptr, std::size_t size)
+    {
+        countMetaAllocation(C, size, false);
+        arenaDeallocate(ptr, size);
+    }
+};
+
+/**
+ * \brief Estimate the size of the heap block std::function allocates for a target
+ *
+ * The standard libraries store a target inline when it is trivially copyable and no
+ * larger than two pointers (e.g. function and member function pointers), and allocate
+ * the others, such as lambdas with captures and bound getters. The size of a target
+ * which is itself a std::function is unknown, and counted as 0.
+ */
+template <typename F>
+struct FunctionHeap
+{
+    static constexpr std::size_t size =
+        (sizeof(F) > 2 * sizeof(void*) || !std::is_trivially_copyable<F>::value) ? sizeof(F) : 0;
+};
+
+template <typename S>
+struct FunctionHeap<std::function<S>>
+{
+    static constexpr std::size_t size = 0;
+};
+
+template <MemoryCategory C, typename S>
+class MetaFunction;
+
+/**
+ * \brief std::function whose heap block is counted as metadata of category C
+ *
+ * The block std::function allocates for its target can't go through MetaAllocated, so
+ * its size is estimated from the type of the target (see FunctionHeap) and counted,
+ * like the objects it belongs to, while the MetaFunction is alive.
+ */
+template <MemoryCategory C, typename R, typename... A>
+class MetaFunction<C, R (A...)> : public std::function<R (A...)>
+{
+public:
+
+    template <typename F, typename = typename std::enable_if<
+        !std::is_same<typename std::decay<F>::type, MetaFunction>::value>::type>
+    MetaFunction(F function)
+        : std::function<R (A...)>(std::move(function))
+        , m_heap(FunctionHeap<F>::size)
+    {
+        count(true);
+    }
+
+    // Copy as a std::function, rather than wrapping the MetaFunction in a new target
+    MetaFunction(const MetaFunction& other)
+        : std::function<R (A...)>(static_cast<const std::function<R (A...)>&>(other))
+        , m_heap(other.m_heap)
+    {
+        count(true);
+    }
+
+    MetaFunction& operator=(const MetaFunction& other)
+    {
+        if (this != &other)
+        {
+            count(false);
+            std::function<R (A...)>::operator=(
+                static_cast<const std::function<R (A...)>&>(other));
+            m_heap = other.m_heap;
+            count(true);
+        }
+        return *this;
+    }
+
+    ~MetaFunction()
+    {
+        count(false);
+    }
+
+private:
+
+    void count(bool allocated) const
+    {
+        if (m_heap > 0)
+            countMetaAllocation(C, m_heap, allocated);
+    }
+
+    std::size_t m_heap; ///< Estimated size of the heap block of the target
+};
+
+/**
+ * \brief Attribute the metadata allocations of the calling thread to a metaclass
+ *
+ * While the scope is alive, the bytes allocated (and freed) through MetaAllocated by the
+ * calling thread are added to (and removed from) the counters of a member kind of a
+ * metaclass. ClassBuilder opens one around each declaration. Scopes may be nested, e.g.
+ * when declaring a member triggers the declaration of another metaclass.
+ */
+class PONDER_API MetaAllocationScope
+{
+public:
+
+    /**
+     * \brief Start attributing allocations
+     *
+     * \param allocations Counters of the metaclass
+     * \param kind Kind of the member being declared
+     */
+    MetaAllocationScope(MetaAllocations& allocations, MetadataKind kind);
+
+    /**
+     * \brief Stop attributing allocations, restoring the enclosing scope
+     */
+    ~MetaAllocationScope();
+
+    MetaAllocationScope(const MetaAllocationScope&) = delete;
+    MetaAllocationScope& operator=(const MetaAllocationScope&) = delete;
+
+private:
+
+    friend PONDER_API void countMetaAllocation(MemoryCategory, std::size_t, bool);
+
+    std::uint32_t* m_bytes; ///< Counters of the member kind, one per allocated category
+    MetaAllocationScope* m_previous; ///< Enclosing scope of the thread
+};
+
+} // namespace detail
+
+} // namespace ponder
+
+
+#endif // PONDER_DETAIL_METAALLOCATOR_HPP
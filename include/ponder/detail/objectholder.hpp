@@ -34,6 +34,9 @@
 
 #include <ponder/classget.hpp>
 #include <ponder/classcast.hpp>
+#include <ponder/allocator.hpp>
+#include <ponder/instances.hpp>
+#include <ponder/detail/refcount.hpp>
 
 
 namespace ponder {
@@ -42,10 +45,10 @@ namespace detail {
 /**
  * \brief Abstract base class for object holders
  *
- * This class is meant to be used by UserObject.
- * @todo Use an optimized memory pool if there are too many allocations of holders
+ * This class is meant to be used by UserObject, for the objects it stores by copy.
+ * Objects stored by reference don't need a holder.
  */
-class AbstractObjectHolder
+class AbstractObjectHolder : public RefCounted, public TemporaryAllocated
 {
 public:
 
@@ -71,6 +74,13 @@ public:
      */
     virtual AbstractObjectHolder* getWritable() = 0;
 
+    /**
+     * \brief Return a new holder storing a copy of the object
+     *
+     * \return Copy of the holder, allocated with the current allocator
+     */
+    virtual AbstractObjectHolder* clone() const = 0;
+
 protected:
 
     /**
@@ -80,59 +90,24 @@ protected:
 };
 
 /**
- * \brief Typed specialization of AbstractObjectHolder for storage by const reference
+ * \brief Typed specialization of AbstractObjectHolder for storage by copy
  */
 template <typename T>
-class ObjectHolderByConstRef : public AbstractObjectHolder
+class ObjectHolderByCopy : public AbstractObjectHolder
 {
 public:
 
     /**
-     * \brief Construct the holder from a const object
-     *
-     * \param object Pointer to the object to store
-     */
-    ObjectHolderByConstRef(const T* object);
-
-    /**
-     * \brief Return a typeless pointer to the stored object
-     *
-     * \return Pointer to the object
-     */
-    void* object() override;
-
-    /**
-     * \brief Return a holder which is able to modify its stored object
-     *
-     * The holder can return itself it it already meets the requirement,
-     * otherwise it may return a new holder storing a copy of its object.
+     * \brief Construct the holder from an object
      *
-     * \return Holder storing a writable object
+     * \param object Object to store
      */
-    AbstractObjectHolder* getWritable() override;
-
-private:
-
-    const T* m_object; ///< Pointer to the object
-    /// Pointer to the actual derived part of the object (may be different than
-    /// m_object in case of multiple inheritance with offset).
-    void* m_alignedPtr;
-};
-
-/**
- * \brief Typed specialization of AbstractObjectHolder for storage by reference
- */
-template <typename T>
-class ObjectHolderByRef : public AbstractObjectHolder
-{
-public:
+    ObjectHolderByCopy(const T* object);
 
     /**
-     * \brief Construct the holder from an object
-     *
-     * \param object Pointer to the object to store
+     * \brief Destructor
      */
-    ObjectHolderByRef(T* object);
+    ~ObjectHolderByCopy();
 
     /**
      * \brief Return a typeless pointer to the stored object
@@ -151,45 +126,12 @@ public:
      */
     AbstractObjectHolder* getWritable() override;
 
-private:
-
-    T* m_object; ///< Pointer to the object
-    /// Pointer to the actual derived part of the object (may be different than m_object
-    /// in case of multiple inheritance with offset)
-    void* m_alignedPtr;
-};
-
-/**
- * \brief Typed specialization of AbstractObjectHolder for storage by copy
- */
-template <typename T>
-class ObjectHolderByCopy : public AbstractObjectHolder
-{
-public:
-
     /**
-     * \brief Construct the holder from an object
+     * \brief Return a new holder storing a copy of the object
      *
-     * \param object Object to store
+     * \return Copy of the holder, allocated with the current allocator
      */
-    ObjectHolderByCopy(const T* object);
-
-    /**
-     * \brief Return a typeless pointer to the stored object
-     *
-     * \return Pointer to the object
-     */
-    void* object() override;
-
-    /**
-     * \brief Return a holder which is able to modify its stored object
-     *
-     * The holder can return itself it it already meets the requirement,
-     * otherwise it may return a new holder storing a copy of its object.
-     *
-     * \return Holder storing a writable object
-     */
-    AbstractObjectHolder* getWritable() override;
+    AbstractObjectHolder* clone() const override;
 
 private:
 
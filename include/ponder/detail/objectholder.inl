@@ -42,62 +42,39 @@ inline AbstractObjectHolder::AbstractObjectHolder()
 }
 
 template <typename T>
-ObjectHolderByConstRef<T>::ObjectHolderByConstRef(const T* object)
-    : m_object(object)
-    , m_alignedPtr(classCast(const_cast<T*>(object), classByType<T>(), classByObject(object)))
-{
-}
-
-template <typename T>
-void* ObjectHolderByConstRef<T>::object()
-{
-    return m_alignedPtr;
-}
-
-template <typename T>
-AbstractObjectHolder* ObjectHolderByConstRef<T>::getWritable()
+ObjectHolderByCopy<T>::ObjectHolderByCopy(const T* object)
+    : m_object(*object)
 {
-    // We hold a read-only object: return a holder which stores a copy of it
-    return nullptr; //new ObjectHolderByCopy<T>(m_object); XXXX const ref?!
+    PONDER_INSTANCE_CREATED(classByType<T>(), &m_object);
 }
 
 template <typename T>
-ObjectHolderByRef<T>::ObjectHolderByRef(T* object)
-    : m_object(object)
-    , m_alignedPtr(classCast(object, classByType<T>(), classByObject(object)))
+ObjectHolderByCopy<T>::~ObjectHolderByCopy()
 {
+#if PONDER_TRACK_INSTANCES
+    // The metaclass may have been undeclared before the last copy is released
+    if (const Class* metaclass = classByTypeSafe<T>())
+        PONDER_INSTANCE_DESTROYED(*metaclass, &m_object);
+#endif
 }
 
 template <typename T>
-void* ObjectHolderByRef<T>::object()
+void* ObjectHolderByCopy<T>::object()
 {
-    return m_alignedPtr;
+    return &m_object;
 }
 
 template <typename T>
-AbstractObjectHolder* ObjectHolderByRef<T>::getWritable()
+AbstractObjectHolder* ObjectHolderByCopy<T>::getWritable()
 {
     // We already store a modifiable object
     return this;
 }
 
 template <typename T>
-ObjectHolderByCopy<T>::ObjectHolderByCopy(const T* object)
-    : m_object(*object)
-{
-}
-
-template <typename T>
-void* ObjectHolderByCopy<T>::object()
-{
-    return &m_object;
-}
-
-template <typename T>
-AbstractObjectHolder* ObjectHolderByCopy<T>::getWritable()
+AbstractObjectHolder* ObjectHolderByCopy<T>::clone() const
 {
-    // We already store a modifiable object
-    return this;
+    return new ObjectHolderByCopy<T>(&m_object);
 }
 
 } // namespace detail
@@ -33,6 +33,7 @@
 
 
 #include <ponder/config.hpp>
+#include <atomic>
 #include <set>
 
 
@@ -47,10 +48,22 @@ namespace detail
 /**
  * \brief Base class for classes that can notify global observers
  */
-class ObserverNotifier
+class PONDER_API ObserverNotifier
 {
 public:
 
+    /**
+     * \brief Get the current registry generation
+     *
+     * The generation is incremented every time a metaclass or a metaenum is added or
+     * removed. Code caching pointers to metaclasses or metaenums can store the generation
+     * along with the pointer, and check that it is still valid with a single comparison.
+     * It can be read from any thread.
+     *
+     * \return Current generation of the registry
+     */
+    static std::size_t generation() {return s_generation.load(std::memory_order_acquire);}
+
     /**
      * \brief Register a new observer
      *
@@ -86,9 +99,20 @@ protected:
      */
     void notifyClassAdded(const Class& theClass);
 
+    /**
+     * \brief Invalidate the pointers cached for the current registry generation
+     *
+     * Removals call it once the metaclass or metaenum is deleted: a pointer cached by an
+     * observer while it is notified would otherwise stay valid and dangle.
+     */
+    static void nextGeneration();
+
     /**
      * \brief Notify all the registered observers of a class removal
      *
+     * The generation is not changed, nextGeneration() must be called after the class is
+     * deleted.
+     *
      * \param theClass Class that have been removed
      */
     void notifyClassRemoved(const Class& theClass);
@@ -103,6 +127,9 @@ protected:
     /**
      * \brief Notify all the registered observers of an enum removal
      *
+     * The generation is not changed, nextGeneration() must be called after the enum is
+     * deleted.
+     *
      * \param theEnum Enum that have been removed
      */
     void notifyEnumRemoved(const Enum& theEnum);
@@ -112,6 +139,8 @@ private:
     typedef std::set<Observer*> ObserverSet;
 
     ObserverSet m_observers; ///< Sequence of registered observers
+
+    static std::atomic<std::size_t> s_generation; ///< Incremented each time the registry changes
 };
 
 } // namespace detail
@@ -34,9 +34,12 @@
 
 #include <ponder/detail/simplepropertyimpl.hpp>
 #include <ponder/detail/arraypropertyimpl.hpp>
+#include <ponder/detail/dictionarypropertyimpl.hpp>
 #include <ponder/detail/enumpropertyimpl.hpp>
 #include <ponder/detail/userpropertyimpl.hpp>
+#include <ponder/detail/fieldproperty.hpp>
 #include <ponder/detail/functiontraits.hpp>
+#include <ponder/detail/metaallocator.hpp>
 
 
 namespace ponder
@@ -63,6 +66,15 @@ struct PropertyMapper<A, ponder::ValueKind::Array>
     typedef ArrayPropertyImpl<A> Type;
 };
 
+/*
+ * Instanciate dictionary properties
+ */
+template <typename A>
+struct PropertyMapper<A, ponder::ValueKind::Dictionary>
+{
+    typedef DictionaryPropertyImpl<A> Type;
+};
+
 /*
  * Instanciate enum properties
  */
@@ -182,7 +194,7 @@ public:
 
 private:
 
-    std::function<R (C&)> m_getter;
+    MetaFunction<MemoryCategory::Accessors, R (C&)> m_getter;
 };
 
 /*
@@ -221,7 +233,7 @@ public:
 
 private:
 
-    std::function<R (C&)> m_getter;
+    MetaFunction<MemoryCategory::Accessors, R (C&)> m_getter;
 };
 
 /*
@@ -263,8 +275,8 @@ public:
 
 private:
 
-    std::function<R (C&)> m_getter;
-    std::function<void (C&, ArgumentType)> m_setter;
+    MetaFunction<MemoryCategory::Accessors, R (C&)> m_getter;
+    MetaFunction<MemoryCategory::Accessors, void (C&, ArgumentType)> m_setter;
 };
 
 /*
@@ -305,8 +317,8 @@ public:
 
 private:
 
-    std::function<R (N&)> m_getter1;
-    std::function<N& (C&)> m_getter2;
+    MetaFunction<MemoryCategory::Accessors, R (N&)> m_getter1;
+    MetaFunction<MemoryCategory::Accessors, N& (C&)> m_getter2;
 };
 
 /*
@@ -346,15 +358,15 @@ public:
 
 private:
 
-    std::function<R (N&)> m_getter1;
-    std::function<N& (C&)> m_getter2;
+    MetaFunction<MemoryCategory::Accessors, R (N&)> m_getter1;
+    MetaFunction<MemoryCategory::Accessors, N& (C&)> m_getter2;
 };
 
 
 /*
  * Property factory which instanciates the proper type of property from 1 accessor
  */
-template <typename C, typename F>
+template <typename C, typename F, typename E = void>
 struct PropertyFactory1
 {
     typedef typename FunctionTraits<F>::ReturnType ReturnType;
@@ -370,6 +382,24 @@ struct PropertyFactory1
     }
 };
 
+/*
+ * Specialization of PropertyFactory1 for data members of fundamental and string types
+ * declared in C itself: they all share the non-template FieldProperty.
+ */
+template <typename C, typename M>
+struct PropertyFactory1<C, M C::*,
+    typename std::enable_if< FieldTypeOf<typename std::remove_const<M>::type>::supported >::type>
+{
+    typedef typename std::remove_const<M>::type DataType;
+
+    static Property* get(IdRef name, M C::* member)
+    {
+        return new FieldProperty(name, mapType<DataType>(), StaticTypeId<C>::get(),
+                                 fieldOffset(member), FieldTypeOf<DataType>::type(),
+                                 !std::is_const<M>::value);
+    }
+};
+
 /*
  * Property factory which instanciates the proper type of property from 2 accessors
  */
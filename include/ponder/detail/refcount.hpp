@@ -0,0 +1,152 @@
+/****************************************************************************
+**
+** This file is part of the Ponder library, formerly CAMP.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+
+#ifndef PONDER_DETAIL_REFCOUNT_HPP
+#define PONDER_DETAIL_REFCOUNT_HPP
+
+
+#include <ponder/config.hpp>
+#include <algorithm>
+#if !PONDER_SINGLE_THREADED
+#   include <atomic>
+#endif
+
+
+namespace ponder
+{
+namespace detail
+{
+template <typename T> class RefPtr;
+
+/**
+ * \brief Base class for objects shared through RefPtr
+ *
+ * The reference count is stored in the object itself, so sharing it costs no extra
+ * allocation. It is atomic unless Ponder is built with PONDER_SINGLE_THREADED, in which
+ * case it is a plain integer and Ponder objects must only be used from a single thread.
+ */
+class RefCounted
+{
+protected:
+
+    RefCounted() : m_refCount(0) {}
+    RefCounted(const RefCounted&) : m_refCount(0) {}
+    RefCounted& operator = (const RefCounted&) {return *this;}
+    ~RefCounted() {}
+
+private:
+
+    template <typename T> friend class RefPtr;
+
+#if PONDER_SINGLE_THREADED
+    void addRef() const {++m_refCount;}
+    bool release() const {return --m_refCount == 0;}
+
+    mutable long m_refCount; ///< Number of RefPtr pointing to this object
+#else
+    void addRef() const {m_refCount.fetch_add(1, std::memory_order_relaxed);}
+    bool release() const {return m_refCount.fetch_sub(1, std::memory_order_acq_rel) == 1;}
+
+    mutable std::atomic<long> m_refCount; ///< Number of RefPtr pointing to this object
+#endif
+};
+
+/**
+ * \brief Intrusive shared pointer to a RefCounted object
+ *
+ * RefPtr has the subset of the std::shared_ptr interface used by Ponder. The object is
+ * deleted when the last RefPtr pointing to it is destroyed, so T must have a virtual
+ * destructor if a RefPtr<T> may point to a derived object.
+ */
+template <typename T>
+class RefPtr
+{
+public:
+
+    RefPtr() : m_ptr(nullptr) {}
+
+    explicit RefPtr(T* ptr) : m_ptr(ptr) {acquire();}
+
+    RefPtr(const RefPtr& other) : m_ptr(other.m_ptr) {acquire();}
+
+    RefPtr(RefPtr&& other) : m_ptr(other.m_ptr) {other.m_ptr = nullptr;}
+
+    template <typename U>
+    RefPtr(const RefPtr<U>& other) : m_ptr(other.get()) {acquire();}
+
+    ~RefPtr() {dispose();}
+
+    RefPtr& operator = (RefPtr other)
+    {
+        swap(other);
+        return *this;
+    }
+
+    void reset(T* ptr = nullptr)
+    {
+        RefPtr(ptr).swap(*this);
+    }
+
+    void swap(RefPtr& other)
+    {
+        std::swap(m_ptr, other.m_ptr);
+    }
+
+    T* get() const {return m_ptr;}
+    T& operator * () const {return *m_ptr;}
+    T* operator -> () const {return m_ptr;}
+    explicit operator bool () const {return m_ptr != nullptr;}
+
+    bool operator == (const RefPtr& other) const {return m_ptr == other.m_ptr;}
+    bool operator != (const RefPtr& other) const {return m_ptr != other.m_ptr;}
+
+private:
+
+    void acquire()
+    {
+        if (m_ptr)
+            m_ptr->addRef();
+    }
+
+    void dispose()
+    {
+        if (m_ptr && m_ptr->release())
+            delete m_ptr;
+    }
+
+    T* m_ptr; ///< Pointed object, or null
+};
+
+} // namespace detail
+
+} // namespace ponder
+
+
+#endif // PONDER_DETAIL_REFCOUNT_HPP
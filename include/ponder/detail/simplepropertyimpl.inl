@@ -64,6 +64,18 @@ bool SimplePropertyImpl<A>::isWritable() const
     return A::canWrite;
 }
 
+template <typename A>
+bool SimplePropertyImpl<A>::isInstance(const UserObject& object) const
+{
+    return CompatibleToUser<typename A::ClassType>::from(object);
+}
+
+template <typename A>
+bool SimplePropertyImpl<A>::canSetValue(const UserObject&, const Value& value) const
+{
+    return value.isCompatible<typename A::DataType>();
+}
+
 } // namespace detail
 
 } // namespace ponder
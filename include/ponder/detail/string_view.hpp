@@ -35,9 +35,21 @@
 #include <iterator>
 #include <stdexcept>
 #include <algorithm>
+#include <cstdlib>
 
 namespace ponder {
 namespace detail {
+
+// Report an out of range position, exceptions may be disabled (see PONDER_NO_EXCEPTIONS)
+[[noreturn]] inline void string_view_out_of_range(const char* what)
+{
+#if PONDER_NO_EXCEPTIONS
+    (void)what;
+    std::abort();
+#else
+    throw std::out_of_range(what);
+#endif
+}
     
 #define CONSTEXPR_BACKUP CONSTEXPR
 #undef CONSTEXPR
@@ -149,7 +161,7 @@ public:
     }
     CONSTEXPR const_reference at(size_type pos) const
     {
-        return pos >= size()? throw std::out_of_range("basic_string_view at out of range")
+        return pos >= size()? (string_view_out_of_range("basic_string_view at out of range"), *start_)
                             : *(start_ + pos);
     }
     CONSTEXPR const_reference front() const { return *start_; }
@@ -202,7 +214,7 @@ public:
 #endif
     size_type copy(CharT* dest, size_type count, size_type pos = 0) const
     {
-        if (pos >= size()) { throw std::out_of_range("basic_string_view::copy out of range"); }
+        if (pos >= size()) { string_view_out_of_range("basic_string_view::copy out of range"); }
         for (int i = 0; i < size();++i)
         {
             dest[i] = operator[](i + pos);
@@ -211,7 +223,8 @@ public:
     CONSTEXPR basic_string_view
     substr(size_type pos = 0, size_type count = npos) const
     {
-        return pos >= size() ? throw std::out_of_range("basic_string_view::substr out of range"):
+        return pos >= size() ? (string_view_out_of_range("basic_string_view::substr out of range"),
+                                basic_string_view()) :
         (count > size() - pos) ? substr(pos,size() - pos) : basic_string_view(data() + pos, count);
     }
     CONSTEXPR_CPP14 int compare(basic_string_view v) const
@@ -34,6 +34,9 @@
 #include <ponder/detail/objecttraits.hpp>
 
 namespace ponder {
+
+class Class;
+
 namespace detail {
     
 /**
@@ -94,6 +97,21 @@ struct HasPonderRtti
         value = std::is_same<decltype(check<typename RawType<T>::Type>(0)), std::true_type>::value;
 };
 
+/**
+ * \brief Utility class used to check at compile-time if a type T caches its metaclass
+ *        (i.e. uses PONDER_POLYMORPHIC)
+ */
+template <typename T>
+struct HasPonderClass
+{
+    template <typename U, const Class* (U::*)() const> struct TestForMember {};
+    template <typename U> static std::true_type check(TestForMember<U, &U::ponderClass>*);
+    template <typename U> static std::false_type check(...);
+
+    static constexpr bool
+        value = std::is_same<decltype(check<typename RawType<T>::Type>(0)), std::true_type>::value;
+};
+
 /**
  * \brief Utility class to get the Ponder identifier associated to a C++ object
  *
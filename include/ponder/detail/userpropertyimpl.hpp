@@ -84,6 +84,16 @@ protected:
      */
     void setValue(const UserObject& object, const Value& value) const override;
 
+    /**
+     * \see Property::isInstance
+     */
+    bool isInstance(const UserObject& object) const override;
+
+    /**
+     * \see Property::canSetValue
+     */
+    bool canSetValue(const UserObject& object, const Value& value) const override;
+
 private:
 
     A m_accessor; ///< Object used to access the actual C++ property
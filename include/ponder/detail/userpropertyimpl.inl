@@ -103,6 +103,18 @@ bool UserPropertyImpl<A>::isWritable() const
     return A::canWrite;
 }
 
+template <typename A>
+bool UserPropertyImpl<A>::isInstance(const UserObject& object) const
+{
+    return CompatibleToUser<typename A::ClassType>::from(object);
+}
+
+template <typename A>
+bool UserPropertyImpl<A>::canSetValue(const UserObject&, const Value& value) const
+{
+    return value.isCompatible<typename A::DataType>();
+}
+
 } // namespace detail
 
 } // namespace ponder
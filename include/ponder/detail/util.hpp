@@ -65,6 +65,13 @@ struct if_c<false,T,F>
 
 class bad_conversion : std::exception {};
 
+/**
+ * \brief Raise a BadType error for a string which can't be converted to \a kind
+ *
+ * Without exceptions there is no bad_conversion to throw (see PONDER_NO_EXCEPTIONS).
+ */
+[[noreturn]] PONDER_API void badConversion(ValueKind kind);
+
 template <typename T, typename F, typename O = void>
 struct convert_impl
 {
@@ -124,7 +131,15 @@ struct convert_impl <T, Id,
     {
         T result;
         if (!conv(from, result))
+        {
+#if PONDER_NO_EXCEPTIONS
+            badConversion(std::is_same<T, bool>::value ? ValueKind::Boolean
+                          : std::is_floating_point<T>::value ? ValueKind::Real
+                          : ValueKind::Integer);
+#else
             throw detail::bad_conversion();
+#endif
+        }
         return result;
     }
 };
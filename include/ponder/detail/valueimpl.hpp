@@ -33,6 +33,7 @@
 
 #include <ponder/type.hpp>
 #include <ponder/valuemapper.hpp>
+#include <functional>
 
 
 namespace ponder {
@@ -66,6 +67,150 @@ struct ConvertVisitor
     }
 };
 
+/**
+ * \brief Conversions of the standard ValueMappers which succeed, per kind of the target type
+ *
+ * Custom mappers of a known kind are trusted to convert anything but empty values.
+ */
+template <typename T, ValueKind K = ponder_ext::ValueMapper<typename RawType<T>::Type>::kind>
+struct CompatibleTo
+{
+    // None, Array and Dictionary targets can't be converted to
+    template <typename U>
+    static bool from(const U&) {return false;}
+};
+
+template <typename T>
+struct CompatibleTo<T, ValueKind::Boolean>
+{
+    template <typename U>
+    static bool from(const U&) {return true;}
+    static bool from(const String& source) {bool result; return conv(source, result);}
+};
+
+template <typename T, bool Arithmetic = std::is_arithmetic<T>::value>
+struct CompatibleToNumber
+{
+    template <typename U>
+    static bool from(const U&) {return true;}
+};
+
+template <typename T>
+struct CompatibleToNumber<T, true>
+{
+    template <typename U>
+    static bool from(const U&) {return true;}
+    static bool from(const String& source) {T result; return conv(source, result);}
+    static bool from(const UserObject&) {return false;}
+};
+
+template <typename T>
+struct CompatibleTo<T, ValueKind::Integer> : CompatibleToNumber<typename RawType<T>::Type> {};
+
+template <typename T>
+struct CompatibleTo<T, ValueKind::Real> : CompatibleToNumber<typename RawType<T>::Type> {};
+
+template <typename T>
+struct CompatibleTo<T, ValueKind::String>
+{
+    template <typename U>
+    static bool from(const U&) {return true;}
+    static bool from(const UserObject&) {return false;}
+};
+
+template <typename T, typename E = void>
+struct CompatibleToEnum
+{
+    template <typename U>
+    static bool from(const U&) {return true;}
+};
+
+template <typename T>
+struct CompatibleToEnum<T, typename std::enable_if<std::is_enum<T>::value>::type>
+{
+    template <typename U>
+    static bool from(const U&) {return true;}
+    static bool from(const String& source) {Enum::EnumValue value; return parseEnum<T>(source, value);}
+    static bool from(const UserObject&) {return false;}
+};
+
+template <>
+struct CompatibleToEnum<EnumObject>
+{
+    template <typename U>
+    static bool from(const U&) {return false;}
+    static bool from(const EnumObject&) {return true;}
+};
+
+template <typename T>
+struct CompatibleTo<T, ValueKind::Enum> : CompatibleToEnum<typename RawType<T>::Type> {};
+
+template <typename T, typename E = void>
+struct CompatibleToUser
+{
+    template <typename U>
+    static bool from(const U&) {return false;}
+
+    static bool from(const UserObject& source)
+    {
+        // Same checks as UserObject::get()
+        void* pointer = source.pointer();
+        const Class* targetClass = classByTypeSafe<T>();
+        return pointer && targetClass && tryClassCast(pointer, source.getClass(), *targetClass);
+    }
+};
+
+template <typename T>
+struct CompatibleToUser<T,
+    typename std::enable_if<std::is_same<typename RawType<T>::Type, UserObject>::value>::type>
+{
+    template <typename U>
+    static bool from(const U&) {return false;}
+    static bool from(const UserObject&) {return true;}
+};
+
+// Values are "converted" to themselves
+template <typename T>
+struct CompatibleToUser<T,
+    typename std::enable_if<std::is_same<typename RawType<T>::Type, Value>::value>::type>
+{
+    template <typename U>
+    static bool from(const U&) {return true;}
+};
+
+template <typename T>
+struct CompatibleTo<T, ValueKind::User> : CompatibleToUser<T> {};
+
+/**
+ * \brief Value visitor which checks whether the stored value can be converted to a type T,
+ *        without raising errors
+ *
+ * With CheckObjects false, conversions of user objects to user types are assumed to succeed:
+ * the visitor then only checks that the conversion doesn't raise BadType, as those conversions
+ * raise their own errors (NullObject, ClassUnrelated...).
+ */
+template <typename T, bool CheckObjects = true>
+struct CompatibleVisitor
+{
+    typedef bool result_type;
+
+    template <typename U>
+    bool operator()(const U& value) const
+    {
+        return CompatibleTo<T>::from(value);
+    }
+
+    bool operator()(const UserObject& value) const
+    {
+        return (!CheckObjects && mapType<T>() == ValueKind::User) || CompatibleTo<T>::from(value);
+    }
+
+    bool operator()(NoType) const
+    {
+        return false;
+    }
+};
+
 /**
  * \brief Binary value visitor which compares two values using operator <
  */
@@ -122,6 +267,37 @@ struct EqualVisitor
     }
 };
 
+/**
+ * \brief Value visitor which computes a hash of the stored value, consistent with EqualVisitor
+ */
+struct HashVisitor
+{
+    typedef std::size_t result_type;
+
+    std::size_t operator()(NoType) const
+    {
+        return 0;
+    }
+
+    template <typename T>
+    std::size_t operator()(const T& value) const
+    {
+        // Mix in the type, as values of different types are never equal
+        return std::hash<T>()(value) ^ (static_cast<std::size_t>(mapType<T>()) * 0x9E3779B9u);
+    }
+
+    std::size_t operator()(const EnumObject& value) const
+    {
+        return std::hash<const void*>()(&value.getEnum()) ^ std::hash<long>()(value.value());
+    }
+
+    std::size_t operator()(const UserObject& value) const
+    {
+        // User objects are equal if they point to the same object
+        return std::hash<const void*>()(value.pointer());
+    }
+};
+
 } // namespace detail
 
 } // namespace ponder
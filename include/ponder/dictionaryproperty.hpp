@@ -0,0 +1,326 @@
+/****************************************************************************
+**
+** This file is part of the Ponder library, formerly CAMP.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+
+
+#ifndef PONDER_DICTIONARYPROPERTY_HPP
+#define PONDER_DICTIONARYPROPERTY_HPP
+
+
+#include <ponder/property.hpp>
+#include <functional>
+
+
+namespace ponder
+{
+/**
+ * \brief Specialized type of property for associative containers
+ *
+ * The elements are accessed by key, without copying the container. forEach() walks all
+ * the elements in a single pass; next() steps key by key, looking up the current key at
+ * each step:
+ *
+ * \code
+ * property.forEach(object, [](const ponder::Value& key, const ponder::Value& value)
+ * {
+ *     std::cout << key.to<std::string>() << " = " << value.to<std::string>() << std::endl;
+ * });
+ * \endcode
+ *
+ * \sa ponder_ext::MapMapper
+ */
+class PONDER_API DictionaryProperty : public Property
+{
+public:
+
+    /**
+     * \brief Function called for each element by forEach()
+     */
+    typedef std::function<void(const Value& key, const Value& value)> ElementVisitor;
+
+    /**
+     * \brief Construct the property from its description
+     *
+     * \param name Name of the property
+     * \param keyType Type of the keys
+     * \param elementType Type of the elements
+     */
+    DictionaryProperty(IdRef name, ValueKind keyType, ValueKind elementType);
+
+    /**
+     * \brief Destructor
+     */
+    virtual ~DictionaryProperty();
+
+    /**
+     * \brief Get the type of the keys
+     *
+     * \return Type of keys
+     */
+    ValueKind keyType() const;
+
+    /**
+     * \brief Get the type of the elements
+     *
+     * \return Type of elements
+     */
+    ValueKind elementType() const;
+
+    /**
+     * \brief Get the number of elements of the dictionary
+     *
+     * \param object Object
+     *
+     * \return Number of elements in the dictionary
+     *
+     * \throw NullObject object is invalid
+     * \throw ForbiddenRead property is not readable
+     */
+    std::size_t size(const UserObject& object) const;
+
+    /**
+     * \brief Check if an element is mapped to a key
+     *
+     * \param object Object
+     * \param key Key to look for
+     *
+     * \return True if the dictionary contains \a key
+     *
+     * \throw NullObject object is invalid
+     * \throw ForbiddenRead property is not readable
+     * \throw BadType \a key can't be converted to the key type
+     */
+    bool contains(const UserObject& object, const Value& key) const;
+
+    /**
+     * \brief Get the element mapped to a key
+     *
+     * \param object Object
+     * \param key Key of the element
+     *
+     * \return Value of the element
+     *
+     * \throw NullObject object is invalid
+     * \throw ForbiddenRead property is not readable
+     * \throw BadType \a key can't be converted to the key type
+     * \throw KeyNotFound no element is mapped to \a key
+     */
+    Value get(const UserObject& object, const Value& key) const;
+
+    /**
+     * \brief Insert an element, or assign the element already mapped to its key
+     *
+     * \param object Object
+     * \param key Key of the element
+     * \param value New value of the element
+     *
+     * \throw NullObject object is invalid
+     * \throw ForbiddenWrite property is not writable
+     * \throw BadType \a key or \a value can't be converted to the property's types
+     */
+    void set(const UserObject& object, const Value& key, const Value& value) const;
+
+    /**
+     * \brief Map a default-constructed element to a key, unless one is already mapped
+     *
+     * This is used to fill composed elements in place, e.g. when deserializing.
+     *
+     * \param object Object
+     * \param key Key of the element
+     *
+     * \return True if an element is mapped to \a key, false if the element type can't be
+     *         default-constructed
+     *
+     * \throw NullObject object is invalid
+     * \throw ForbiddenWrite property is not writable
+     * \throw BadType \a key can't be converted to the key type
+     */
+    bool insert(const UserObject& object, const Value& key) const;
+
+    /**
+     * \brief Remove the element mapped to a key
+     *
+     * \param object Object
+     * \param key Key of the element to remove
+     *
+     * \return True if an element was removed, false if the key wasn't found
+     *
+     * \throw NullObject object is invalid
+     * \throw ForbiddenWrite property is not writable
+     * \throw BadType \a key can't be converted to the key type
+     */
+    bool remove(const UserObject& object, const Value& key) const;
+
+    /**
+     * \brief Get the element following a key
+     *
+     * Iteration starts with an empty key, and follows the order of the underlying
+     * container. It stops if the current key is removed from the dictionary.
+     *
+     * \param object Object
+     * \param key Current key (empty to get the first element), replaced by the next key
+     * \param value Receives the value of the next element
+     *
+     * \return False if there are no more elements
+     *
+     * \throw NullObject object is invalid
+     * \throw ForbiddenRead property is not readable
+     */
+    bool next(const UserObject& object, Value& key, Value& value) const;
+
+    /**
+     * \brief Call a function for each element, in the order of the underlying container
+     *
+     * The container is walked in a single pass, so it must not be modified by \a visitor.
+     *
+     * \param object Object
+     * \param visitor Function called with the key and the value of each element
+     *
+     * \throw NullObject object is invalid
+     * \throw ForbiddenRead property is not readable
+     */
+    void forEach(const UserObject& object, const ElementVisitor& visitor) const;
+
+    /**
+     * \brief Accept the visitation of a ClassVisitor
+     *
+     * \param visitor Visitor to accept
+     */
+    void accept(ClassVisitor& visitor) const override;
+
+protected:
+
+    /**
+     * \see Property::getValue
+     *
+     * A dictionary can't be read as a single value, use get() with a key.
+     */
+    Value getValue(const UserObject& object) const override;
+
+    /**
+     * \see Property::setValue
+     *
+     * A dictionary can't be assigned as a single value, use set() with a key.
+     */
+    void setValue(const UserObject& object, const Value& value) const override;
+
+    /**
+     * \see Property::canGetValue
+     *
+     * A dictionary can't be read as a single value.
+     */
+    bool canGetValue(const UserObject& object) const override;
+
+    /**
+     * \see Property::canSetValue
+     *
+     * A dictionary can't be assigned as a single value.
+     */
+    bool canSetValue(const UserObject& object, const Value& value) const override;
+
+    /**
+     * \brief Do the actual retrieval of the size
+     *
+     * \param object Object
+     *
+     * \return Number of elements
+     */
+    virtual std::size_t getSize(const UserObject& object) const = 0;
+
+    /**
+     * \brief Do the actual lookup of an element
+     *
+     * \param object Object
+     * \param key Key of the element
+     * \param value Receives the value of the element, if found
+     *
+     * \return True if the element was found
+     */
+    virtual bool findElement(const UserObject& object, const Value& key, Value& value) const = 0;
+
+    /**
+     * \brief Do the actual insertion or assignment of an element
+     *
+     * \param object Object
+     * \param key Key of the element
+     * \param value New value of the element
+     */
+    virtual void setElement(const UserObject& object,
+                            const Value& key,
+                            const Value& value) const = 0;
+
+    /**
+     * \brief Do the actual removal of an element
+     *
+     * \param object Object
+     * \param key Key of the element
+     *
+     * \return True if an element was removed
+     */
+    virtual bool removeElement(const UserObject& object, const Value& key) const = 0;
+
+    /**
+     * \brief Do the actual insertion of a default-constructed element
+     *
+     * \param object Object
+     * \param key Key of the element
+     *
+     * \return True if an element is mapped to the key
+     */
+    virtual bool insertElement(const UserObject& object, const Value& key) const = 0;
+
+    /**
+     * \brief Do the actual iteration
+     *
+     * \param object Object
+     * \param key Current key (empty for the first element), replaced by the next key
+     * \param value Receives the value of the next element
+     *
+     * \return False if there are no more elements
+     */
+    virtual bool nextElement(const UserObject& object, Value& key, Value& value) const = 0;
+
+    /**
+     * \brief Do the actual single-pass iteration
+     *
+     * \param object Object
+     * \param visitor Function called for each element
+     */
+    virtual void visitElements(const UserObject& object, const ElementVisitor& visitor) const = 0;
+
+private:
+
+    ValueKind m_keyType; ///< Type of the keys
+    ValueKind m_elementType; ///< Type of the elements
+};
+
+} // namespace ponder
+
+
+#endif // PONDER_DICTIONARYPROPERTY_HPP
@@ -38,7 +38,11 @@
 #include <ponder/pondertype.hpp>
 #include <ponder/detail/typeid.hpp>
 #include <ponder/detail/dictionary.hpp>
+#include <ponder/detail/hashindex.hpp>
+#include <ponder/detail/metaallocator.hpp>
+#include <cstdint>
 #include <string>
+#include <vector>
 
 
 namespace ponder
@@ -72,6 +76,23 @@ namespace ponder
  * ponder::Enum::Pair p = metaenum.pair(0); // p == {"one", one}
  * \endcode
  *
+ * Enums of bit flags are declared with EnumBuilder::flags(); their combined values can
+ * then be formatted and parsed as "A|B|C".
+ *
+ * \code
+ * enum Access {read = 1, write = 2, exec = 4};
+ *
+ * ponder::Enum::declare<Access>("Access")
+ *     .flags()
+ *     .value("read", read)
+ *     .value("write", write)
+ *     .value("exec", exec);
+ *
+ * char text[32];
+ * metaenum.formatFlags(read | exec, text, sizeof(text)); // text == "read|exec"
+ * EnumValue v = metaenum.parseFlags("write|read");       // v == 3
+ * \endcode
+ *
  * \remark All values and names are unique within the metaenum.
  *
  * \sa Class, EnumBuilder
@@ -247,6 +268,83 @@ public:
     template <typename E>
     E value(IdRef name) const {return static_cast<E>(value(name));}
 
+    /**
+     * \brief Look up the value corresponding to a name, if it exists
+     *
+     * \param name Name to get
+     * \param valueRet Set to the value of the requested name, if found
+     *
+     * \return True if the metaenum contains a pair whose name is \a name
+     */
+    bool tryValue(IdRef name, EnumValue& valueRet) const;
+
+    /**
+     * \brief Check if the metaenum holds bit flags
+     *
+     * \return True if the metaenum was declared with EnumBuilder::flags()
+     *
+     * \sa formatFlags, parseFlags
+     */
+    bool isFlags() const;
+
+    /**
+     * \brief Get the combination of all the values of the metaenum
+     *
+     * \return Bitwise or of all the values
+     */
+    EnumValue flagMask() const;
+
+    /**
+     * \brief Format a combination of flags as names separated by '|'
+     *
+     * If the value itself is named, its name is used. Otherwise the name of each bit
+     * set in the value is written, from the lowest bit. Like snprintf, the text is
+     * truncated to fit the buffer and is always null-terminated if \a size isn't 0.
+     * No memory is allocated.
+     *
+     * \param value Value to format
+     * \param buffer Buffer receiving the text
+     * \param size Size of the buffer
+     *
+     * \return Length of the full text, excluding the terminator
+     *
+     * \throw EnumValueNotFound a bit set in the value has no name
+     */
+    std::size_t formatFlags(EnumValue value, char* buffer, std::size_t size) const;
+
+    /**
+     * \brief Format a combination of flags as names separated by '|', appended to a string
+     *
+     * \param value Value to format
+     * \param text String to append the names to
+     *
+     * \throw EnumValueNotFound a bit set in the value has no name
+     */
+    void formatFlags(EnumValue value, String& text) const;
+
+    /**
+     * \brief Parse a combination of flags from names separated by '|'
+     *
+     * Spaces around the names are ignored, and an empty text gives 0.
+     *
+     * \param text Text to parse
+     * \param valueRet Set to the combined value, if all the names are found
+     *
+     * \return True if all the names are found
+     */
+    bool tryParseFlags(IdRef text, EnumValue& valueRet) const;
+
+    /**
+     * \brief Parse a combination of flags from names separated by '|'
+     *
+     * \param text Text to parse
+     *
+     * \return Combined value
+     *
+     * \throw EnumNameNotFound one of the names doesn't exist in the metaenum
+     */
+    EnumValue parseFlags(IdRef text) const;
+
     /**
      * \brief Operator == to check equality between two metaenums
      *
@@ -271,6 +369,7 @@ private:
 
     friend class EnumBuilder;
     friend class detail::EnumManager;
+    friend class detail::MemoryCounter;
 
     /**
      * \brief Construct the metaenum from its name
@@ -278,11 +377,58 @@ private:
      * \param name Name of the metaenum
      */
     Enum(IdRef name);
+
+    /**
+     * \brief Add a pair, the lookup indices must then be rebuilt with buildIndex
+     */
+    void addValue(IdRef name, EnumValue value);
+
+    /**
+     * \brief Rebuild the name and value indices from the table of pairs
+     */
+    void buildIndex();
+
+    /**
+     * \brief Find the index of the pair with a given name
+     *
+     * \return Index of the pair, or size() if not found
+     */
+    std::size_t findName(IdRef name) const;
+
+    /**
+     * \brief Find the index of the pair with a given name, given as a sequence of characters
+     *
+     * \return Index of the pair, or size() if not found
+     */
+    std::size_t findName(const char* name, std::size_t length) const;
+
+    /**
+     * \brief Call f with the name of each flag making up a value
+     *
+     * \return False if a bit set in the value has no name
+     */
+    template <typename F>
+    bool forEachFlagName(EnumValue value, F f) const;
+
+    /**
+     * \brief Find the index of the pair with a given value
+     *
+     * \return Index of the pair, or size() if not found
+     */
+    std::size_t findValue(EnumValue value) const;
     
     typedef detail::Dictionary<Id, IdRef, EnumValue> EnumTable;
     
     Id m_name;     ///< Name of the metaenum
     EnumTable m_enums;      ///< Table of enums
+    detail::HashIndex m_nameIndex; ///< Hashed index of the names
+    detail::HashIndex m_valueHash; ///< Hashed index of the values, if they are sparse
+    std::vector<std::uint32_t> m_valueIndex; ///< Value - m_minValue -> pair index + 1, if dense
+    EnumValue m_minValue;   ///< Smallest value, origin of the direct-indexed value table
+    bool m_denseValues;     ///< Is m_valueIndex direct-indexed?
+    bool m_flags;           ///< Does the metaenum hold bit flags?
+    EnumValue m_flagMask;   ///< Bitwise or of all the values
+    std::vector<std::uint32_t> m_bitNames; ///< Bit -> index + 1 of the pair naming it (flags only)
 };
 
 } // namespace ponder
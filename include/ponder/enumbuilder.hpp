@@ -49,6 +49,9 @@ class Enum;
  *
  * This class should never be explicitely instanciated, unless you
  * need to split the metaenum creation in multiple parts.
+ *
+ * The lookup indices of the metaenum are built when the builder is destroyed, so the
+ * pairs are found by name or value once the declaration statement is complete.
  */
 class PONDER_API EnumBuilder
 {
@@ -61,6 +64,11 @@ public:
      */
     explicit EnumBuilder(Enum& target);
 
+    /**
+     * \brief Destructor, builds the lookup indices of the metaenum
+     */
+    ~EnumBuilder();
+
     /**
      * \brief Add a new pair to the metaenum
      *
@@ -68,6 +76,14 @@ public:
      * \param value Value of the pair
      */
     EnumBuilder& value(IdRef name, long value);
+
+    /**
+     * \brief Declare the metaenum as holding bit flags
+     *
+     * Combinations of the values can then be formatted and parsed as "A|B|C", see
+     * Enum::formatFlags and Enum::parseFlags.
+     */
+    EnumBuilder& flags();
     
     /**
      * \brief Add a new pair to the metaenum using enum class
@@ -35,6 +35,7 @@
 #include <ponder/error.hpp>
 #include <ponder/detail/typeid.hpp>
 #include <ponder/detail/enummanager.hpp>
+#include <ponder/detail/classcache.hpp>
 #include <string>
 
 
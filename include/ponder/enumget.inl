@@ -48,19 +48,24 @@ inline const Enum& enumByName(IdRef name)
 template <typename T>
 const Enum& enumByObject(T)
 {
-    return detail::EnumManager::instance().getById(detail::typeId<T>());
+    return enumByType<T>();
 }
 
 template <typename T>
 const Enum& enumByType()
 {
-    return detail::EnumManager::instance().getById(detail::typeId<T>());
+    const Enum* metaenum = enumByTypeSafe<T>();
+
+    // Not registered: let the manager report the error
+    return metaenum ? *metaenum : detail::EnumManager::instance().getById(detail::typeId<T>());
 }
 
 template <typename T>
 const Enum* enumByTypeSafe()
 {
-    return detail::EnumManager::instance().getByIdSafe(detail::safeTypeId<T>());
+    // The metaenum is cached per type until the registry changes
+    static detail::EnumCache cache;
+    return cache.valid() ? cache.get() : cache.resolve(detail::safeTypeId<T>());
 }
 
 } // namespace ponder
@@ -111,6 +111,59 @@ private:
     ponder::String m_location; ///< Location of the error (file, line and function)
 };
 
+/**
+ * \brief Function receiving the errors raised by Ponder
+ *
+ * With exceptions, the handler is called before the error is thrown: it may log it, or throw
+ * another exception instead. When Ponder is built with PONDER_NO_EXCEPTIONS, errors are fatal:
+ * the handler may log the error and terminate the program, and if it returns the error is
+ * printed and the program aborts. It must not longjmp out either, as the destructors of the
+ * frames in between would be skipped, leaving locks held and objects half-written. Code which
+ * has to recover uses the non-raising variants instead (Value::tryTo, Class::tryProperty,
+ * Property::tryGet, runtime::FunctionCaller::tryCall...).
+ */
+typedef void (*ErrorHandler)(const Error& error);
+
+/**
+ * \brief Get the error handler of the program, null by default
+ */
+PONDER_API ErrorHandler errorHandler();
+
+/**
+ * \brief Replace the error handler of the program
+ *
+ * It is not thread-safe: no other thread may raise errors meanwhile.
+ *
+ * \param handler New handler, or null to restore the default behaviour
+ *
+ * \return Previous handler
+ */
+PONDER_API ErrorHandler setErrorHandler(ErrorHandler handler);
+
+namespace detail
+{
+/**
+ * \brief Pass an error to the current error handler, if any
+ */
+PONDER_API void handleError(const Error& error);
+
+/**
+ * \brief Pass an error to the current error handler, and return it to be thrown
+ */
+template <typename T>
+const T& notifyError(const T& error)
+{
+    handleError(error);
+    return error;
+}
+
+/**
+ * \brief Pass an error to the current error handler, then abort if it returns
+ */
+[[noreturn]] PONDER_API void raiseError(const Error& error);
+
+} // namespace detail
+
 } // namespace ponder
 
 #include <ponder/error.inl>
@@ -118,7 +171,13 @@ private:
 /**
  * \brief Trigger a Ponder error
  */
-#define PONDER_ERROR(error) throw ponder::Error::prepare(error, __FILE__, __LINE__, __func__)
+#if PONDER_NO_EXCEPTIONS
+#   define PONDER_ERROR(error) \
+        ponder::detail::raiseError(ponder::Error::prepare(error, __FILE__, __LINE__, __func__))
+#else
+#   define PONDER_ERROR(error) \
+        throw ponder::detail::notifyError(ponder::Error::prepare(error, __FILE__, __LINE__, __func__))
+#endif
 
 
 #endif // PONDER_ERROR_HPP
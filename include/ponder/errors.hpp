@@ -204,6 +204,22 @@ public:
     EnumValueNotFound(long value, IdRef enumName);
 };
 
+/**
+ * \brief Error thrown when an event can't be found in a metaclass (by its name)
+ */
+class PONDER_API EventNotFound : public Error
+{
+public:
+
+    /**
+     * \brief Constructor
+     *
+     * \param name Name of the requested event
+     * \param className Name of the owner metaclass
+     */
+    EventNotFound(IdRef name, IdRef className);
+};
+
 /**
  * \brief Error thrown when calling a function that is not callable
  */
@@ -265,6 +281,22 @@ public:
     FunctionNotFound(IdRef name, IdRef className);
 };
 
+/**
+ * \brief Error thrown when a key can't be found in a dictionary property
+ */
+class PONDER_API KeyNotFound : public Error
+{
+public:
+
+    /**
+     * \brief Constructor
+     *
+     * \param key Requested key
+     * \param propertyName Name of the dictionary property
+     */
+    KeyNotFound(const String& key, IdRef propertyName);
+};
+
 /**
  * \brief Error thrown when a declaring a metaclass that already exists
  */
@@ -331,6 +363,21 @@ public:
     PropertyNotFound(IdRef name, IdRef className);
 };
 
+/**
+ * \brief Error thrown when generated code doesn't match the metaclass it was generated from
+ */
+class PONDER_API SchemaMismatch : public Error
+{
+public:
+
+    /**
+     * \brief Constructor
+     *
+     * \param className Name of the metaclass
+     */
+    SchemaMismatch(IdRef className);
+};
+
 } // namespace ponder
 
 
@@ -0,0 +1,366 @@
+/****************************************************************************
+**
+** This file is part of the Ponder library, formerly CAMP.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+
+
+#ifndef PONDER_EVENT_HPP
+#define PONDER_EVENT_HPP
+
+
+#include <ponder/config.hpp>
+#include <ponder/args.hpp>
+#include <ponder/tagholder.hpp>
+#include <ponder/type.hpp>
+#include <ponder/detail/memberindex.hpp>
+#include <ponder/detail/metaallocator.hpp>
+#include <ponder/detail/refcount.hpp>
+#include <ponder/detail/util.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+
+namespace ponder
+{
+class UserObject;
+class ClassVisitor;
+
+/**
+ * \brief Identifier of a subscription to an event, unique in the process
+ *
+ * Zero is never returned by a subscription, it can be used as "no subscription".
+ */
+typedef std::uint64_t EventHandle;
+
+/**
+ * \brief Handler of an event subscribed through its metaevent
+ */
+typedef std::function<void(const Args&)> EventHandler;
+
+namespace detail
+{
+/**
+ * \brief Get a new subscription handle
+ */
+PONDER_API EventHandle nextEventHandle();
+
+struct EventReader;
+
+/**
+ * \brief Mark the calling thread as reading subscriber lists for the lifetime of the guard
+ *
+ * The lists replaced by a subscription are retired with the current epoch, and deleted once
+ * no thread is still reading since that epoch. Each thread announces its epoch in a record
+ * of its own, so the readings don't write to memory shared by the firing threads. Nested
+ * readings keep the epoch of the outermost one.
+ */
+class PONDER_API EventReading : noncopyable
+{
+public:
+    EventReading();
+    ~EventReading();
+
+private:
+    EventReader& m_reader;
+};
+
+/**
+ * \brief Close the current epoch of the subscriber lists
+ *
+ * \return Epoch to retire the lists replaced before the call with
+ */
+PONDER_API std::uint64_t retireEventEpoch();
+
+/**
+ * \brief Get the oldest epoch still read by a thread
+ *
+ * \return Epoch before which the retired lists are no longer read
+ */
+PONDER_API std::uint64_t oldestEventEpoch();
+}
+
+/**
+ * \brief Subscribers of an event of an object
+ *
+ * An EventSource is a member of the class firing the event. It holds the subscribers in
+ * an immutable list which is replaced on each subscription, so firing the event loads the
+ * list and calls the handlers without taking any lock, nor writing to the event. Subscribing
+ * and unsubscribing can happen concurrently with firing, and from the handlers themselves;
+ * a handler removed while the event is being fired may still be called by that firing. The
+ * replaced lists are deleted by the next subscription or firing once no thread can still be
+ * reading them, even if the event is fired continuously.
+ *
+ * \code
+ * class Unit
+ * {
+ * public:
+ *     ponder::EventSource<int> damaged;
+ *
+ *     void hit(int amount) {m_health -= amount; damaged.fire(amount);}
+ * };
+ *
+ * ponder::EventHandle h = unit.damaged.subscribe([](int amount) {std::cout << amount;});
+ * unit.damaged.unsubscribe(h);
+ * \endcode
+ *
+ * Declare it with ClassBuilder::event() to subscribe and fire it through the metaclass.
+ *
+ * \sa Event, ClassBuilder::event
+ */
+template <typename... A>
+class EventSource : detail::noncopyable
+{
+public:
+
+    /**
+     * \brief Type of the handlers
+     */
+    typedef std::function<void(A...)> Handler;
+
+    /**
+     * \brief Construct an event without subscribers
+     */
+    EventSource();
+
+    /**
+     * \brief Destructor
+     *
+     * The event must not be fired nor subscribed to while it is destroyed.
+     */
+    ~EventSource();
+
+    /**
+     * \brief Add a subscriber
+     *
+     * \param handler Function to call each time the event is fired
+     *
+     * \return Handle of the subscription, to unsubscribe
+     */
+    EventHandle subscribe(Handler handler);
+
+    /**
+     * \brief Remove a subscriber
+     *
+     * \param handle Handle returned by subscribe()
+     *
+     * \return True if the subscriber was removed, false if \a handle is not subscribed
+     */
+    bool unsubscribe(EventHandle handle);
+
+    /**
+     * \brief Call the subscribers, in the order of their subscription
+     *
+     * \param args Arguments to pass to each subscriber
+     */
+    void fire(const A&... args) const;
+
+    /**
+     * \brief Get the number of subscribers
+     */
+    std::size_t subscriberCount() const;
+
+private:
+
+    struct Subscriber
+    {
+        EventHandle handle;
+        Handler handler;
+    };
+
+    struct List
+    {
+        std::vector<Subscriber> subscribers;
+        std::uint64_t epoch; ///< Epoch the list was replaced in
+        List* retired; ///< Next list replaced before this one, still possibly read
+    };
+
+    /**
+     * \brief Serialize the writers of the list for the lifetime of the guard
+     */
+    struct Writing
+    {
+        std::atomic_flag& flag;
+
+        explicit Writing(std::atomic_flag& f) : flag(f)
+        {
+            while (flag.test_and_set(std::memory_order_acquire)) {}
+        }
+        ~Writing() {flag.clear(std::memory_order_release);}
+    };
+
+    void publish(List* list);
+
+    /**
+     * \brief Delete the retired lists no thread can still read, with m_writing held
+     */
+    void reclaim() const;
+
+    std::atomic<List*> m_list; ///< Current subscribers, null if none
+    mutable std::atomic_flag m_writing = ATOMIC_FLAG_INIT; ///< Held while the lists change
+    mutable std::atomic<List*> m_retired; ///< Replaced lists, most recent first
+};
+
+/**
+ * \brief Abstract representation of an event
+ *
+ * Events are members of metaclasses, declared with ClassBuilder::event() from an
+ * EventSource member. They allow to subscribe to the event of an object, and to fire it,
+ * with arguments passed as Values.
+ *
+ * \code
+ * const ponder::Event& damaged = ponder::classByType<Unit>().event("damaged");
+ * ponder::EventHandle h = damaged.subscribe(unit, [](const ponder::Args& args)
+ * {
+ *     std::cout << args[0].to<int>();
+ * });
+ * damaged.fire(unit, ponder::Args(10));
+ * damaged.unsubscribe(unit, h);
+ * \endcode
+ *
+ * \sa EventSource, ClassBuilder::event
+ */
+class PONDER_API Event : public TagHolder, public detail::RefCounted,
+                        public detail::MetaAllocated<MemoryCategory::Objects>
+{
+public:
+
+    /**
+     * \brief Destructor
+     */
+    virtual ~Event();
+
+    /**
+     * \brief Get the name of the event
+     *
+     * \return Name of the event
+     */
+    IdReturn name() const;
+
+    /**
+     * \brief Get the number of parameters of the event
+     *
+     * \return Number of parameters passed to the subscribers
+     */
+    virtual std::size_t paramCount() const = 0;
+
+    /**
+     * \brief Get the type of a parameter of the event
+     *
+     * \param index Index of the parameter
+     *
+     * \return Type of the index-th parameter
+     *
+     * \throw OutOfRange index is out of range
+     */
+    virtual ValueKind paramType(std::size_t index) const = 0;
+
+    /**
+     * \brief Add a subscriber to the event of an object
+     *
+     * \param object Object firing the event
+     * \param handler Function to call with the arguments each time the event is fired
+     *
+     * \return Handle of the subscription, to unsubscribe
+     *
+     * \throw NullObject \a object is empty
+     */
+    virtual EventHandle subscribe(const UserObject& object, EventHandler handler) const = 0;
+
+    /**
+     * \brief Remove a subscriber from the event of an object
+     *
+     * \param object Object firing the event
+     * \param handle Handle returned by subscribe(), or by the subscription to the
+     *        EventSource of the object
+     *
+     * \return True if the subscriber was removed, false if \a handle is not subscribed
+     *
+     * \throw NullObject \a object is empty
+     */
+    virtual bool unsubscribe(const UserObject& object, EventHandle handle) const = 0;
+
+    /**
+     * \brief Fire the event of an object
+     *
+     * \param object Object firing the event
+     * \param args Arguments to pass to the subscribers
+     *
+     * \throw NullObject \a object is empty
+     * \throw NotEnoughArguments too few arguments are provided
+     * \throw BadArgument one of the arguments can't be converted to the parameter type
+     */
+    virtual void fire(const UserObject& object, const Args& args = Args::empty) const = 0;
+
+    /**
+     * \brief Get the number of subscribers to the event of an object
+     *
+     * \param object Object firing the event
+     *
+     * \throw NullObject \a object is empty
+     */
+    virtual std::size_t subscriberCount(const UserObject& object) const = 0;
+
+    /**
+     * \brief Accept the visitation of a ClassVisitor
+     *
+     * \param visitor Visitor to accept
+     */
+    void accept(ClassVisitor& visitor) const;
+
+protected:
+
+    /**
+     * \brief Construct the event from its description
+     *
+     * \param name Name of the event
+     */
+    Event(IdRef name);
+
+private:
+
+    Id m_name; ///< Name of the event
+};
+
+namespace detail
+{
+template <>
+inline std::uint8_t memberKind<Event>(const Event& event)
+{
+    return static_cast<std::uint8_t>(event.paramCount());
+}
+}
+
+} // namespace ponder
+
+#include <ponder/event.inl>
+
+
+#endif // PONDER_EVENT_HPP
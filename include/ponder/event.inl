@@ -0,0 +1,170 @@
+/****************************************************************************
+**
+** This file is part of the Ponder library, formerly CAMP.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+
+
+namespace ponder
+{
+
+template <typename... A>
+EventSource<A...>::EventSource()
+    : m_list(nullptr)
+    , m_retired(nullptr)
+{
+}
+
+template <typename... A>
+EventSource<A...>::~EventSource()
+{
+    delete m_list.load(std::memory_order_relaxed);
+    List* retired = m_retired.load(std::memory_order_relaxed);
+    while (retired)
+    {
+        List* next = retired->retired;
+        delete retired;
+        retired = next;
+    }
+}
+
+template <typename... A>
+EventHandle EventSource<A...>::subscribe(Handler handler)
+{
+    const EventHandle handle = detail::nextEventHandle();
+
+    Writing writing(m_writing);
+    const List* current = m_list.load();
+    List* list = new List{current ? current->subscribers : std::vector<Subscriber>(), 0, nullptr};
+    list->subscribers.push_back(Subscriber{handle, std::move(handler)});
+    publish(list);
+
+    return handle;
+}
+
+template <typename... A>
+bool EventSource<A...>::unsubscribe(EventHandle handle)
+{
+    Writing writing(m_writing);
+    const List* current = m_list.load();
+    if (!current)
+        return false;
+
+    auto it = std::find_if(current->subscribers.begin(), current->subscribers.end(),
+                           [handle](const Subscriber& s) {return s.handle == handle;});
+    if (it == current->subscribers.end())
+        return false;
+
+    List* list = nullptr;
+    if (current->subscribers.size() > 1)
+    {
+        list = new List{current->subscribers, 0, nullptr};
+        list->subscribers.erase(list->subscribers.begin() + (it - current->subscribers.begin()));
+    }
+    publish(list);
+
+    return true;
+}
+
+template <typename... A>
+void EventSource<A...>::fire(const A&... args) const
+{
+    // Without subscribers there is no list to keep alive
+    if (!m_list.load(std::memory_order_acquire))
+        return;
+
+    {
+        detail::EventReading reading;
+        if (const List* list = m_list.load())
+        {
+            for (const Subscriber& subscriber : list->subscribers)
+                subscriber.handler(args...);
+        }
+    }
+
+    // Delete the lists replaced meanwhile, unless a subscription is already at it
+    if (m_retired.load(std::memory_order_relaxed)
+        && !m_writing.test_and_set(std::memory_order_acquire))
+    {
+        reclaim();
+        m_writing.clear(std::memory_order_release);
+    }
+}
+
+template <typename... A>
+std::size_t EventSource<A...>::subscriberCount() const
+{
+    const List* list = m_list.load(std::memory_order_acquire);
+    return list ? list->subscribers.size() : 0;
+}
+
+template <typename... A>
+void EventSource<A...>::publish(List* list)
+{
+    // A firing may have loaded the replaced list before the exchange: it reads since the
+    // epoch closed here, or an older one
+    if (List* previous = m_list.exchange(list))
+    {
+        previous->epoch = detail::retireEventEpoch();
+        previous->retired = m_retired.load(std::memory_order_relaxed);
+        m_retired.store(previous, std::memory_order_relaxed);
+    }
+
+    reclaim();
+}
+
+template <typename... A>
+void EventSource<A...>::reclaim() const
+{
+    List* garbage = m_retired.load(std::memory_order_relaxed);
+    if (!garbage)
+        return;
+
+    const std::uint64_t oldest = detail::oldestEventEpoch();
+    if (garbage->epoch < oldest)
+    {
+        m_retired.store(nullptr, std::memory_order_relaxed);
+    }
+    else
+    {
+        // The lists are retired in increasing epochs: keep the most recent ones
+        List* last = garbage;
+        while (last->retired && last->retired->epoch >= oldest)
+            last = last->retired;
+        garbage = last->retired;
+        last->retired = nullptr;
+    }
+
+    while (garbage)
+    {
+        List* next = garbage->retired;
+        delete garbage;
+        garbage = next;
+    }
+}
+
+} // namespace ponder
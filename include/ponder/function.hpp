@@ -35,8 +35,11 @@
 #include <ponder/config.hpp>
 #include <ponder/detail/getter.hpp>
 #include <ponder/args.hpp>
+#include <ponder/instrument.hpp>
 #include <ponder/tagholder.hpp>
 #include <ponder/type.hpp>
+#include <ponder/detail/refcount.hpp>
+#include <ponder/detail/metaallocator.hpp>
 #include <ponder/value.hpp>
 #include <string>
 #include <vector>
@@ -54,7 +57,9 @@ class ClassVisitor;
  * Functions are members of metaclasses. Their purpose is to provide detailed information
  * about their prototype.
  */
-class PONDER_API Function : public TagHolder
+class PONDER_API Function : public TagHolder, public detail::RefCounted,
+                           public detail::MetaAllocated<MemoryCategory::Objects>,
+                           public instrument::detail::Instrumented
 {
 public:
 
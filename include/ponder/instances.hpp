@@ -0,0 +1,166 @@
+/****************************************************************************
+**
+** This file is part of the Ponder library, formerly CAMP.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+
+
+#ifndef PONDER_INSTANCES_HPP
+#define PONDER_INSTANCES_HPP
+
+
+#include <ponder/config.hpp>
+#include <atomic>
+#include <vector>
+
+
+namespace ponder
+{
+class Class;
+
+/**
+ * \brief Accounting of the live instances of each metaclass
+ *
+ * When Ponder is built with PONDER_TRACK_INSTANCES, the objects created and destroyed
+ * through Ponder are counted per metaclass: constructors (ObjectFactory, Lua, C interface),
+ * copies stored by UserObject::makeCopy, and Class::destruct. Optionally the call stack of
+ * each creation is recorded, to find where leaked instances come from.
+ *
+ * When PONDER_TRACK_INSTANCES is 0 (the default) the hooks compile to nothing and all the
+ * statistics are zero.
+ *
+ * \code
+ * const ponder::instances::Stats s = ponder::instances::stats(ponder::classByType<Session>());
+ * std::cout << s.live << " sessions, " << s.bytes << " bytes, peak " << s.peak;
+ * \endcode
+ *
+ * \note Objects created outside Ponder and destroyed through it aren't counted.
+ */
+namespace instances
+{
+/**
+ * \brief Instance counts of a metaclass
+ */
+struct PONDER_API Stats
+{
+    std::size_t live = 0;       ///< Number of instances alive
+    std::size_t peak = 0;       ///< Highest number of instances alive at once
+    std::size_t created = 0;    ///< Number of instances created
+    std::size_t bytes = 0;      ///< Size of the live instances: Class::sizeOf() * live
+};
+
+/**
+ * \brief Live instances created from the same call stack
+ */
+struct PONDER_API Site
+{
+    std::vector<const void*> frames;    ///< Return addresses, innermost first
+    std::size_t live = 0;               ///< Number of instances alive
+};
+
+/**
+ * \brief Check if Ponder was built with PONDER_TRACK_INSTANCES
+ */
+constexpr bool enabled() {return PONDER_TRACK_INSTANCES != 0;}
+
+/**
+ * \brief Get the instance counts of a metaclass
+ *
+ * \param metaclass Metaclass of the instances
+ */
+PONDER_API Stats stats(const Class& metaclass);
+
+/**
+ * \brief Start or stop recording the call stack of each created instance
+ *
+ * Recording takes a lock and captures a stack trace per creation, it is meant for
+ * debugging sessions. Call stacks are only available with glibc.
+ *
+ * \param record True to record the creation sites
+ */
+PONDER_API void recordSites(bool record);
+
+/**
+ * \brief Get the creation sites of the live instances of a metaclass
+ *
+ * Only the instances created while recordSites(true) was in effect are listed.
+ *
+ * \param metaclass Metaclass of the instances
+ *
+ * \return Sites sorted by decreasing number of live instances
+ */
+PONDER_API std::vector<Site> sites(const Class& metaclass);
+
+namespace detail
+{
+/**
+ * \brief Counters stored in each metaclass
+ */
+struct Counts
+{
+    std::atomic<std::size_t> live;
+    std::atomic<std::size_t> peak;
+    std::atomic<std::size_t> created;
+
+    Counts() : live(0), peak(0), created(0) {}
+};
+
+/**
+ * \brief Count an instance created through Ponder
+ */
+PONDER_API void created(const Class& metaclass, const void* object);
+
+/**
+ * \brief Count an instance destroyed through Ponder
+ */
+PONDER_API void destroyed(const Class& metaclass, const void* object);
+
+} // namespace detail
+
+} // namespace instances
+
+} // namespace ponder
+
+
+/**
+ * \brief Count an instance created or destroyed through Ponder
+ *
+ * \param metaclass Metaclass of the instance
+ * \param object Pointer to the instance
+ */
+#if PONDER_TRACK_INSTANCES
+#   define PONDER_INSTANCE_CREATED(metaclass, object) \
+        ::ponder::instances::detail::created(metaclass, object)
+#   define PONDER_INSTANCE_DESTROYED(metaclass, object) \
+        ::ponder::instances::detail::destroyed(metaclass, object)
+#else
+#   define PONDER_INSTANCE_CREATED(metaclass, object) ((void)0)
+#   define PONDER_INSTANCE_DESTROYED(metaclass, object) ((void)0)
+#endif
+
+
+#endif // PONDER_INSTANCES_HPP
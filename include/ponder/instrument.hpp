@@ -0,0 +1,285 @@
+/****************************************************************************
+**
+** This file is part of the Ponder library, formerly CAMP.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+
+#ifndef PONDER_INSTRUMENT_HPP
+#define PONDER_INSTRUMENT_HPP
+
+
+#include <ponder/config.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+
+
+namespace ponder
+{
+class Property;
+class Function;
+class Constructor;
+
+/**
+ * \brief Hot-path instrumentation of metaclass members
+ *
+ * When Ponder is built with PONDER_INSTRUMENT, every property read and write, function
+ * call and construction done through Ponder is counted and timed. Samples are recorded in
+ * per-thread shards, at a fixed slot of each member, so recording takes no lock and does
+ * no lookup; they are only aggregated when snapshot() is called. The statistics of a
+ * member are cleared when it is destroyed (i.e. when its class is undeclared).
+ *
+ * When PONDER_INSTRUMENT is 0 (the default) the hooks compile to nothing and snapshot()
+ * always returns empty statistics.
+ *
+ * \code
+ * ponder::instrument::Snapshot snap = ponder::instrument::snapshot();
+ * const ponder::instrument::Stats& s = snap.get(metaclass.property("name"),
+ *                                               ponder::instrument::Operation::Get);
+ * std::cout << s.calls << " reads, p99 <= " << s.percentile(0.99) << " ns";
+ * \endcode
+ */
+namespace instrument
+{
+/**
+ * \brief Kind of operation recorded for a member
+ */
+enum class Operation
+{
+    Get,        ///< Property read
+    Set,        ///< Property write
+    Call,       ///< Function call
+    Create      ///< Construction of an object
+};
+
+/**
+ * \brief Check if Ponder was built with instrumentation
+ */
+constexpr bool enabled() {return PONDER_INSTRUMENT != 0;}
+
+/**
+ * \brief Counters and latency histogram of one operation on one member
+ *
+ * Latencies are recorded in logarithmic buckets: bucket i counts the operations which
+ * took between 2^i and 2^(i+1) - 1 nanoseconds (bucket 0 also counts zero).
+ */
+struct PONDER_API Stats
+{
+    static constexpr std::size_t bucketCount = 40;
+
+    std::uint64_t calls = 0;                ///< Number of operations
+    std::uint64_t totalNs = 0;              ///< Total time spent, in nanoseconds
+    std::uint64_t maxNs = 0;                ///< Longest operation, in nanoseconds
+    std::uint64_t buckets[bucketCount] = {};///< Latency histogram
+
+    /**
+     * \brief Add a sample
+     *
+     * \param ns Duration of the operation, in nanoseconds
+     */
+    void record(std::uint64_t ns);
+
+    /**
+     * \brief Merge other statistics into these ones
+     */
+    void merge(const Stats& other);
+
+    /**
+     * \brief Get the mean latency
+     *
+     * \return Mean duration of an operation, in nanoseconds (0 if there was none)
+     */
+    std::uint64_t meanNs() const;
+
+    /**
+     * \brief Get an upper bound of a latency percentile
+     *
+     * \param p Percentile, in [0, 1]
+     *
+     * \return Upper bound of the histogram bucket containing the percentile, in nanoseconds
+     */
+    std::uint64_t percentile(double p) const;
+};
+
+namespace detail
+{
+/**
+ * \brief Base of the members which can be instrumented (Property, Function, Constructor)
+ *
+ * Each member gets a slot in the per-thread statistics on its first recorded operation.
+ * Destroying the member clears its statistics in all threads and frees its slot for reuse.
+ * Without PONDER_INSTRUMENT this class is empty.
+ */
+class PONDER_API Instrumented
+{
+#if PONDER_INSTRUMENT
+public:
+
+    /**
+     * \brief Get the statistics slot of the member, assigning it on first use
+     */
+    std::uint32_t slot() const
+    {
+        const std::uint32_t slot = m_slot.load(std::memory_order_acquire);
+        return slot != 0 ? slot : assignSlot();
+    }
+
+    /**
+     * \brief Get the statistics slot of the member, or 0 if it has never been recorded
+     */
+    std::uint32_t assignedSlot() const {return m_slot.load(std::memory_order_acquire);}
+
+protected:
+
+    Instrumented() = default;
+    ~Instrumented();
+
+private:
+
+    std::uint32_t assignSlot() const;
+
+    mutable std::atomic<std::uint32_t> m_slot {0};
+#endif
+};
+
+} // namespace detail
+
+/**
+ * \brief Statistics of all members, aggregated over all threads
+ *
+ * \sa snapshot
+ */
+class PONDER_API Snapshot
+{
+public:
+
+    /**
+     * \brief Get the statistics of a property
+     *
+     * \param property Property
+     * \param operation Operation::Get or Operation::Set
+     */
+    const Stats& get(const Property& property, Operation operation) const;
+
+    /**
+     * \brief Get the call statistics of a function
+     */
+    const Stats& get(const Function& function) const;
+
+    /**
+     * \brief Get the statistics of a constructor
+     */
+    const Stats& get(const Constructor& constructor) const;
+
+    /**
+     * \brief Get the number of distinct member operations recorded
+     */
+    std::size_t size() const {return m_stats.size();}
+
+private:
+
+    friend PONDER_API Snapshot snapshot();
+
+    const Stats& find(const detail::Instrumented& member, Operation operation) const;
+
+    std::unordered_map<std::uint32_t, Stats> m_stats; // indexed by statistics entry
+};
+
+/**
+ * \brief Aggregate the statistics of all threads
+ *
+ * Threads which have exited are included.
+ */
+PONDER_API Snapshot snapshot();
+
+/**
+ * \brief Clear the statistics of all threads
+ */
+PONDER_API void reset();
+
+namespace detail
+{
+/**
+ * \brief Record a sample in the statistics of the calling thread
+ */
+PONDER_API void record(const Instrumented& member, Operation operation, std::uint64_t ns);
+
+/**
+ * \brief Times the enclosing scope and records it for a member
+ */
+class Scope
+{
+public:
+
+    Scope(const Instrumented* member, Operation operation)
+        : m_member(*member)
+        , m_operation(operation)
+        , m_start(std::chrono::steady_clock::now())
+    {
+    }
+
+    ~Scope()
+    {
+        const auto elapsed = std::chrono::steady_clock::now() - m_start;
+        record(m_member, m_operation, static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+
+    const Instrumented& m_member;
+    Operation m_operation;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+} // namespace detail
+
+} // namespace instrument
+
+} // namespace ponder
+
+
+/**
+ * \brief Time the enclosing scope as an operation on a member (no-op without PONDER_INSTRUMENT)
+ *
+ * \param member Pointer to the Property, Function or Constructor
+ * \param operation Name of an instrument::Operation value
+ */
+#if PONDER_INSTRUMENT
+#   define PONDER_INSTRUMENT_SCOPE(member, operation) \
+        ::ponder::instrument::detail::Scope ponderInstrumentScope_( \
+            member, ::ponder::instrument::Operation::operation)
+#else
+#   define PONDER_INSTRUMENT_SCOPE(member, operation) ((void)0)
+#endif
+
+
+#endif // PONDER_INSTRUMENT_HPP
@@ -0,0 +1,219 @@
+/****************************************************************************
+**
+** This file is part of the Ponder library, formerly CAMP.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+
+
+#ifndef PONDER_MAPMAPPER_HPP
+#define PONDER_MAPMAPPER_HPP
+
+
+#include <ponder/config.hpp>
+#include <map>
+#include <unordered_map>
+
+
+namespace ponder_ext
+{
+/**
+ * \class MapMapper
+ *
+ * \brief Template providing a mapping between C++ associative containers and Ponder
+ *        DictionaryProperty
+ *
+ * MapMapper<T> must define the following members in order to make T fully compliant
+ * with the system:
+ *
+ * \li \c KeyType: type of the keys
+ * \li \c ElementType: type of the elements mapped to the keys
+ * \li \c size(): retrieve the number of elements
+ * \li \c find(): get a pointer to the element mapped to a key, or null
+ * \li \c Cursor: position of an iteration, a value-initialized cursor is before the first element
+ * \li \c seek(): move a cursor to the element mapped to a key
+ * \li \c next(): move a cursor to the next element, to iterate without copying the container
+ * \li \c set(): insert an element, or assign the element already mapped to its key
+ * \li \c remove(): remove the element mapped to a key
+ *
+ * MapMapper is specialized for std::map and std::unordered_map, and can be specialized
+ * for any of your own associative containers in order to extend the system.
+ *
+ * Here is an example of mapping for a custom container:
+ *
+ * \code
+ * namespace ponder_ext
+ * {
+ *     template <typename T>
+ *     struct MapMapper<MyMap<T> >
+ *     {
+ *         enum { isMap = true };
+ *         typedef std::string KeyType;
+ *         typedef T ElementType;
+ *
+ *         static std::size_t size(const MyMap<T>& map)
+ *         {
+ *             return map.count();
+ *         }
+ *
+ *         static const T* find(const MyMap<T>& map, const std::string& key)
+ *         {
+ *             return map.lookup(key);
+ *         }
+ *
+ *         typedef const typename MyMap<T>::Slot* Cursor;
+ *
+ *         static bool seek(const MyMap<T>& map, const std::string& key, Cursor& cursor)
+ *         {
+ *             cursor = map.slot(key);
+ *             return cursor != nullptr;
+ *         }
+ *
+ *         static bool next(const MyMap<T>& map, Cursor& cursor,
+ *                          const std::string*& key, const T*& element)
+ *         {
+ *             cursor = cursor ? map.slotAfter(cursor) : map.firstSlot();
+ *             if (!cursor)
+ *                 return false;
+ *             key = &cursor->key;
+ *             element = &cursor->value;
+ *             return true;
+ *         }
+ *
+ *         static void set(MyMap<T>& map, const std::string& key, const T& element)
+ *         {
+ *             map.store(key, element);
+ *         }
+ *
+ *         static bool remove(MyMap<T>& map, const std::string& key)
+ *         {
+ *             return map.erase(key);
+ *         }
+ *     };
+ * }
+ * \endcode
+ */
+
+/** \cond NoDocumentation */
+
+/*
+ * Generic version -- doesn't define anything
+ */
+template <typename T>
+struct MapMapper
+{
+    enum { isMap = false };
+};
+
+/*
+ * Implementation shared by the standard associative containers
+ */
+template <typename M>
+struct StandardMapMapper
+{
+    enum { isMap = true };
+    typedef typename M::key_type KeyType;
+    typedef typename M::mapped_type ElementType;
+
+    static std::size_t size(const M& map)
+    {
+        return map.size();
+    }
+
+    static const ElementType* find(const M& map, const KeyType& key)
+    {
+        typename M::const_iterator it = map.find(key);
+        return it != map.end() ? &it->second : nullptr;
+    }
+
+    struct Cursor
+    {
+        typename M::const_iterator position;
+        bool started = false;
+    };
+
+    static bool seek(const M& map, const KeyType& key, Cursor& cursor)
+    {
+        cursor.position = map.find(key);
+        cursor.started = true;
+        return cursor.position != map.end();
+    }
+
+    static bool next(const M& map, Cursor& cursor, const KeyType*& key, const ElementType*& element)
+    {
+        if (!cursor.started)
+        {
+            cursor.position = map.begin();
+            cursor.started = true;
+        }
+        else if (cursor.position != map.end())
+        {
+            ++cursor.position;
+        }
+        if (cursor.position == map.end())
+            return false;
+
+        key = &cursor.position->first;
+        element = &cursor.position->second;
+        return true;
+    }
+
+    static void set(M& map, const KeyType& key, const ElementType& element)
+    {
+        std::pair<typename M::iterator, bool> inserted = map.insert(std::make_pair(key, element));
+        if (!inserted.second)
+            inserted.first->second = element;
+    }
+
+    static bool remove(M& map, const KeyType& key)
+    {
+        return map.erase(key) != 0;
+    }
+};
+
+/*
+ * Specialization of MapMapper for std::map
+ */
+template <typename K, typename T, typename C, typename A>
+struct MapMapper<std::map<K, T, C, A> > : StandardMapMapper<std::map<K, T, C, A> >
+{
+};
+
+/*
+ * Specialization of MapMapper for std::unordered_map
+ */
+template <typename K, typename T, typename H, typename E, typename A>
+struct MapMapper<std::unordered_map<K, T, H, E, A> >
+    : StandardMapMapper<std::unordered_map<K, T, H, E, A> >
+{
+};
+
+/** \endcond NoDocumentation */
+
+} // namespace ponder_ext
+
+
+#endif // PONDER_MAPMAPPER_HPP
@@ -0,0 +1,141 @@
+/****************************************************************************
+**
+** This file is part of the Ponder library, formerly CAMP.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+
+#ifndef PONDER_MEMORYREPORT_HPP
+#define PONDER_MEMORYREPORT_HPP
+
+
+#include <ponder/config.hpp>
+#include <ponder/detail/metaallocator.hpp>
+#include <vector>
+
+
+namespace ponder
+{
+class Class;
+
+/**
+ * \brief Number of bytes used by metadata, per MemoryCategory
+ */
+struct PONDER_API MemoryUsage
+{
+    std::size_t bytes[detail::memoryCategoryCount] = {};
+
+    std::size_t& operator[](MemoryCategory category)
+    {
+        return bytes[static_cast<std::size_t>(category)];
+    }
+
+    std::size_t operator[](MemoryCategory category) const
+    {
+        return bytes[static_cast<std::size_t>(category)];
+    }
+
+    MemoryUsage& operator+=(const MemoryUsage& other);
+
+    /**
+     * \brief Get the number of bytes of all the categories
+     */
+    std::size_t total() const;
+};
+
+/**
+ * \brief Memory used by a metaclass, per kind of member
+ */
+struct PONDER_API ClassMemoryUsage
+{
+    const Class* metaclass = nullptr; ///< Metaclass
+    MemoryUsage kinds[detail::memberKindCount]; ///< Indexed by MetadataKind (Class to Event)
+
+    MemoryUsage& operator[](MetadataKind kind) {return kinds[static_cast<std::size_t>(kind)];}
+
+    const MemoryUsage& operator[](MetadataKind kind) const
+    {
+        return kinds[static_cast<std::size_t>(kind)];
+    }
+
+    /**
+     * \brief Get the number of bytes used by the metaclass and all its members
+     */
+    std::size_t total() const;
+};
+
+/**
+ * \brief Memory used by all the registered metadata
+ *
+ * \sa metadataMemoryReport
+ */
+struct PONDER_API MetadataMemoryReport
+{
+    std::vector<ClassMemoryUsage> classes; ///< Memory used by each metaclass
+    MemoryUsage kinds[detail::metadataKindCount]; ///< Memory used per MetadataKind
+    MemoryUsage total; ///< Memory used by all the metaclasses and metaenums
+
+    /**
+     * \brief Bytes currently allocated for members, counted by the allocator
+     *
+     * Only the Objects, Accessors and Callers categories are filled. Unlike \a total, this
+     * includes the members still referenced after their metaclass was undeclared.
+     */
+    MemoryUsage allocated;
+
+    /**
+     * \brief Bytes of the chunks reserved by the metadata arena, including its free blocks
+     */
+    std::size_t arenaReserved = 0;
+
+    const MemoryUsage& operator[](MetadataKind kind) const
+    {
+        return kinds[static_cast<std::size_t>(kind)];
+    }
+};
+
+/**
+ * \brief Measure the memory used by the registered metaclasses and metaenums
+ *
+ * Properties, functions, constructors, getters and function callers are allocated
+ * through a counting allocator, and each metaclass records the bytes allocated while
+ * its members were declared. Identifiers, tables, indexes and tags are measured from
+ * the capacity of their containers. The heap blocks of the std::function objects holding
+ * accessors, getters and callers (e.g. lambdas with captures) are counted with an
+ * estimate of their size, from the type of the target. Heap blocks owned by user mappers
+ * are not included.
+ *
+ * Use it to find which metaclasses and categories cost the most, and to catch memory
+ * regressions. It must not be called while metaclasses are being declared.
+ *
+ * \return Memory used per metaclass, per kind of metadata and per category
+ */
+PONDER_API MetadataMemoryReport metadataMemoryReport();
+
+} // namespace ponder
+
+
+#endif // PONDER_MEMORYREPORT_HPP
@@ -0,0 +1,174 @@
+/****************************************************************************
+**
+** This file is part of the Ponder library, formerly CAMP.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+
+#ifndef PONDER_MODULE_HPP
+#define PONDER_MODULE_HPP
+
+
+#include <ponder/config.hpp>
+#include <ponder/observer.hpp>
+#include <ponder/detail/util.hpp>
+#include <vector>
+
+
+namespace ponder
+{
+/**
+ * \brief Group of metaclasses and metaenums that are declared and unloaded together
+ *
+ * A module records every metaclass and metaenum declared while one of its scopes is
+ * active. The whole set can then be undeclared in a single call to unload(), which is
+ * typically done when a plugin that registered the types is unloaded.
+ *
+ * \code
+ * static ponder::Module s_module("MyPlugin");
+ *
+ * void pluginLoad()
+ * {
+ *     ponder::Module::Scope scope(s_module);
+ *     ponder::Class::declare<MyClass>();
+ *     ponder::Enum::declare<MyEnum>();
+ * }
+ *
+ * void pluginUnload()
+ * {
+ *     s_module.unload();
+ * }
+ * \endcode
+ *
+ * Every declaration or undeclaration increments the registry generation (see
+ * registryGeneration()), so code which caches pointers to metaclasses can detect that
+ * they may have become invalid.
+ *
+ * \sa Class::declare, Enum::declare, registryGeneration
+ */
+class PONDER_API Module : public Observer, detail::noncopyable
+{
+public:
+
+    /**
+     * \brief RAII helper making a module current for the lifetime of the scope
+     *
+     * Scopes can be nested; the previously current module is restored when the scope
+     * is destroyed.
+     */
+    class PONDER_API Scope : detail::noncopyable
+    {
+    public:
+
+        /**
+         * \brief Make \a module the current module
+         *
+         * \param module Module that will record the declarations
+         */
+        explicit Scope(Module& module);
+
+        /**
+         * \brief Restore the previous current module
+         */
+        ~Scope();
+
+    private:
+
+        Module* m_previous; ///< Module that was current when the scope was opened
+    };
+
+    /**
+     * \brief Construct an empty module
+     *
+     * \param name Name of the module, for information purposes
+     */
+    explicit Module(IdRef name);
+
+    /**
+     * \brief Destructor
+     *
+     * Unloads all the metaclasses and metaenums which still belong to the module.
+     */
+    ~Module();
+
+    /**
+     * \brief Get the name of the module
+     *
+     * \return Name of the module
+     */
+    IdReturn name() const;
+
+    /**
+     * \brief Get the number of metaclasses currently recorded in the module
+     *
+     * \return Number of metaclasses
+     */
+    std::size_t classCount() const;
+
+    /**
+     * \brief Get the number of metaenums currently recorded in the module
+     *
+     * \return Number of metaenums
+     */
+    std::size_t enumCount() const;
+
+    /**
+     * \brief Undeclare all the metaclasses and metaenums recorded in the module
+     *
+     * Metaclasses are removed in the reverse order of their declaration, then metaenums.
+     * Types that were already undeclared individually are skipped. The module is empty
+     * after this call and can be reused.
+     */
+    void unload();
+
+    /**
+     * \brief Get the module which currently records declarations
+     *
+     * \return Pointer to the current module, or nullptr if no scope is active
+     */
+    static Module* current();
+
+    void classAdded(const Class& added) override;
+    void classRemoved(const Class& removed) override;
+    void enumAdded(const Enum& added) override;
+    void enumRemoved(const Enum& removed) override;
+
+private:
+
+    static void forget(std::vector<Id>& ids, const Id& id);
+
+    Id m_name; ///< Name of the module
+    std::vector<Id> m_classes; ///< Metaclasses declared in the module, in declaration order
+    std::vector<Id> m_enums; ///< Metaenums declared in the module, in declaration order
+    bool m_unloading; ///< True while unload() is removing the module's types
+
+    static Module* s_current; ///< Module of the innermost active scope
+};
+
+} // namespace ponder
+
+
+#endif // PONDER_MODULE_HPP
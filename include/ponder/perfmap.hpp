@@ -0,0 +1,149 @@
+/****************************************************************************
+**
+** This file is part of the Ponder library, formerly CAMP.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+
+
+#ifndef PONDER_PERFMAP_HPP
+#define PONDER_PERFMAP_HPP
+
+
+#include <ponder/config.hpp>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+
+namespace ponder
+{
+/**
+ * \brief Symbolization of the code which implements reflected members
+ *
+ * Profiles of reflected code show template instances such as
+ * `SimplePropertyImpl<...>::getValue` or `FunctionCallerImpl<...>::execute`, which don't
+ * tell which member is hot. A SymbolTable maps the code of these implementations to the
+ * names of the members which use them, such as "Person::age (get)".
+ *
+ * The table is built on demand from the declared metaclasses, nothing is recorded while
+ * the program runs. It can be queried in-process, for example by a sampling profiler, or
+ * written in the `/tmp/perf-<pid>.map` format.
+ *
+ * perf itself only reads that file for samples in anonymous (JIT) mappings: addresses in
+ * libponder or in the executable are symbolized from their ELF files instead, so the file
+ * is meant for tools which consult it for any address, or to post-process profiles.
+ *
+ * \code
+ * ponder::perfmap::writePerfMap(); // writes /tmp/perf-<pid>.map
+ *
+ * ponder::perfmap::SymbolTable table;
+ * if (const ponder::perfmap::Symbol* symbol = table.find(samplePc))
+ *     std::cout << symbol->name;
+ * \endcode
+ *
+ * \note Code addresses are read from the virtual tables following the Itanium C++ ABI
+ *       (GCC and Clang). With other compilers the table is empty.
+ *
+ * \note Function sizes are read from the dynamic symbol table (glibc only). Functions
+ *       which aren't in it, such as the template instances of an executable not linked
+ *       with `-rdynamic` or of a stripped module, get a size of 0: find() ignores them and
+ *       they aren't written to the perf map.
+ */
+namespace perfmap
+{
+/**
+ * \brief Range of code labeled with the members it implements
+ */
+struct PONDER_API Symbol
+{
+    const void* address;    ///< Start of the code
+    std::size_t size;       ///< Size of the code, in bytes (0 if unknown)
+    std::string name;       ///< "Class::member (operation)", members sharing the code are listed
+};
+
+/**
+ * \brief Code symbols of all the declared metaclasses, sorted by address
+ */
+class PONDER_API SymbolTable
+{
+public:
+
+    /// Maximum number of members listed in the name of a shared symbol
+    static const std::size_t maxNames = 4;
+
+    /**
+     * \brief Build the table from the metaclasses currently declared
+     */
+    SymbolTable();
+
+    /**
+     * \brief Get the symbols, sorted by address
+     */
+    const std::vector<Symbol>& symbols() const {return m_symbols;}
+
+    /**
+     * \brief Find the symbol containing a code address
+     *
+     * \param address Code address, such as a sampled program counter
+     *
+     * \return Pointer to the symbol, or null if the address isn't in a reflected member
+     */
+    const Symbol* find(const void* address) const;
+
+    /**
+     * \brief Write the symbols of known size in the perf map format: "START SIZE name" per
+     *        line, in hexadecimal
+     *
+     * \param stream Stream to write to
+     */
+    void write(std::ostream& stream) const;
+
+private:
+
+    std::vector<Symbol> m_symbols;
+};
+
+/**
+ * \brief Get the path of the perf map of this process: /tmp/perf-<pid>.map
+ */
+PONDER_API std::string defaultPath();
+
+/**
+ * \brief Write the symbols of all the declared metaclasses to a perf map file
+ *
+ * \param path Path of the file, the file is replaced
+ *
+ * \return True if the file was written
+ */
+PONDER_API bool writePerfMap(const std::string& path = defaultPath());
+
+} // namespace perfmap
+
+} // namespace ponder
+
+
+#endif // PONDER_PERFMAP_HPP
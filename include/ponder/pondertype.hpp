@@ -32,6 +32,7 @@
 #define PONDER_PONDERTYPE_HPP
 
 #include <ponder/config.hpp>
+#include <ponder/detail/classcache.hpp>
 
 namespace ponder {
     
@@ -214,6 +215,10 @@ namespace detail
  * \note This macro does not need to be inserted into all Ponder classes being declared,
  *       only ones which would like to support features like downcasting via polymorphism.
  *
+ * Each class using the macro caches its metaclass until the registry changes, so that
+ * finding the metaclass of a polymorphic object (e.g. when wrapping it in a UserObject)
+ * costs a virtual call instead of a lookup by name.
+ *
  * Example:
  *
  * \code
@@ -235,6 +240,12 @@ namespace detail
 #define PONDER_POLYMORPHIC() \
     public: \
         virtual const char* ponderClassId() const {return ponder::detail::staticTypeId(this);} \
+        virtual const ponder::Class* ponderClass() const \
+        { \
+            static ponder::detail::ClassCache ponderClassCache; \
+            return ponderClassCache.valid() ? ponderClassCache.get() \
+                 : ponderClassCache.resolve(ponder::detail::staticTypeId(this)); \
+        } \
     private:
 
 } // namespace ponder
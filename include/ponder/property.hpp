@@ -32,8 +32,11 @@
 #define PONDER_PROPERTY_HPP
 
 
+#include <ponder/instrument.hpp>
 #include <ponder/tagholder.hpp>
 #include <ponder/type.hpp>
+#include <ponder/detail/refcount.hpp>
+#include <ponder/detail/metaallocator.hpp>
 
 namespace ponder
 {
@@ -47,7 +50,9 @@ class ClassVisitor;
  *
  * \sa SimpleProperty, ArrayProperty, EnumProperty, ObjectProperty
  */
-class PONDER_API Property : public TagHolder
+class PONDER_API Property : public TagHolder, public detail::RefCounted,
+                           public detail::MetaAllocated<MemoryCategory::Objects>,
+                           public instrument::detail::Instrumented
 {
 public:
 
@@ -92,6 +97,20 @@ public:
      */
     bool writable(const UserObject& object) const;
 
+    /**
+     * \brief Check if the property is readable for any object
+     *
+     * \return True if the property can be read and this doesn't depend on the object
+     */
+    bool alwaysReadable() const;
+
+    /**
+     * \brief Check if the property is writable for any object
+     *
+     * \return True if the property can be written and this doesn't depend on the object
+     */
+    bool alwaysWritable() const;
+
     /**
      * \brief Get the current value of the property for a given object
      *
@@ -116,6 +135,38 @@ public:
      */
     void set(const UserObject& object, const Value& value) const;
 
+    /**
+     * \brief Check if the property can be accessed on a given object
+     *
+     * \param object Object
+     *
+     * \return True if the object is valid and an instance of the class which declares the
+     *         property (or of a derived class)
+     */
+    bool appliesTo(const UserObject& object) const;
+
+    /**
+     * \brief Get the current value of the property for a given object, without raising errors
+     *
+     * \param object Object
+     * \param result Receives the value of the property
+     *
+     * \return False if the property doesn't apply to \a object, is not readable, or its value
+     *         can't be read (empty array, dictionary)
+     */
+    bool tryGet(const UserObject& object, Value& result) const;
+
+    /**
+     * \brief Set the current value of the property for a given object, without raising errors
+     *
+     * \param object Object
+     * \param value New value to assign to the property
+     *
+     * \return False if the property doesn't apply to \a object, is not writable, or \a value
+     *         can't be converted to the property's type
+     */
+    bool trySet(const UserObject& object, const Value& value) const;
+
     /**
      * \brief Accept the visitation of a ClassVisitor
      *
@@ -171,6 +222,38 @@ protected:
      */
     virtual bool isWritable() const;
 
+    /**
+     * \brief Check if a valid object is an instance of the class which declares the property
+     *
+     * The default implementation accepts any object.
+     *
+     * \param object Object, not null
+     *
+     * \return True if the property can be accessed on the object
+     */
+    virtual bool isInstance(const UserObject& object) const;
+
+    /**
+     * \brief Check if getValue can read the value of an object without raising an error
+     *
+     * \param object Object the property applies to
+     *
+     * \return True if the value can be read
+     */
+    virtual bool canGetValue(const UserObject& object) const;
+
+    /**
+     * \brief Check if setValue can assign a value without raising an error
+     *
+     * The default implementation accepts any value.
+     *
+     * \param object Object the property applies to
+     * \param value Value to assign
+     *
+     * \return True if the value can be converted to the property's type
+     */
+    virtual bool canSetValue(const UserObject& object, const Value& value) const;
+
 private:
 
     Id m_name; ///< Name of the property
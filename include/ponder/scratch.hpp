@@ -0,0 +1,154 @@
+/****************************************************************************
+**
+** This file is part of the Ponder library, formerly CAMP.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+
+#ifndef PONDER_SCRATCH_HPP
+#define PONDER_SCRATCH_HPP
+
+
+#include <ponder/config.hpp>
+#include <ponder/args.hpp>
+#include <cstddef>
+
+
+namespace ponder
+{
+class Value;
+class UserObject;
+
+/**
+ * \brief Redirect the temporary allocations of the current thread to a scratch arena
+ *
+ * While a scope is alive, the blocks Ponder allocates on its thread (holders of objects
+ * copied into UserObjects, storage of argument lists) are taken from a thread-local bump
+ * arena instead of the current allocator, and releasing them costs nothing. The arena is
+ * rewound when the scope is destroyed; its memory is kept for the next scope of the
+ * thread, so that a request which has been served once doesn't allocate any more.
+ *
+ * \code
+ * void serve(const Request& request)
+ * {
+ *     ponder::ScratchScope scope;
+ *     ponder::Value result = metaclass.function("handle").call(object, request.args());
+ *     store(ponder::ScratchScope::promote(result)); // result escapes the scope
+ * }
+ * \endcode
+ *
+ * Everything allocated within a scope must be destroyed before the scope, on the same
+ * thread, or be promoted to the current allocator with promote(). Scopes can be nested,
+ * they are rewound in the reverse order of their creation. Only the temporary blocks are
+ * redirected: metadata and trace buffers, which outlive the scope, still use the current
+ * allocator, and strings use the standard allocator.
+ *
+ * \sa Allocator
+ */
+class PONDER_API ScratchScope
+{
+public:
+
+    /**
+     * \brief Start redirecting the allocations of the current thread
+     */
+    ScratchScope();
+
+    /**
+     * \brief Rewind the arena to its state at the creation of the scope
+     */
+    ~ScratchScope();
+
+    ScratchScope(const ScratchScope&) = delete;
+    ScratchScope& operator=(const ScratchScope&) = delete;
+
+    /**
+     * \brief Get the number of bytes taken from the arena since the creation of the scope
+     */
+    std::size_t used() const;
+
+    /**
+     * \brief Check whether a scope is active on the current thread
+     */
+    static bool active();
+
+    /**
+     * \brief Copy a user object out of the scratch arena
+     *
+     * Objects stored by copy are copied again with the current allocator, objects stored
+     * by reference are returned unchanged.
+     *
+     * \param object Object to promote
+     *
+     * \return User object which can outlive the scope
+     */
+    static UserObject promote(const UserObject& object);
+
+    /**
+     * \brief Copy a value out of the scratch arena
+     *
+     * \param value Value to promote
+     *
+     * \return Value which can outlive the scope
+     */
+    static Value promote(const Value& value);
+
+    /**
+     * \brief Copy an argument list out of the scratch arena
+     *
+     * \param args Arguments to promote
+     *
+     * \return List owning values which can outlive the scope
+     */
+    static Args promote(const Args& args);
+
+private:
+
+    std::size_t m_chunk; ///< Index of the arena chunk in use at the creation of the scope
+    std::size_t m_offset; ///< Offset in this chunk at the creation of the scope
+    std::size_t m_used; ///< Bytes used by the arena at the creation of the scope
+};
+
+namespace detail
+{
+/**
+ * \brief Allocate a block from the scratch arena of the current thread
+ *
+ * \return Pointer to the block, or null if no scope is active on the thread
+ */
+PONDER_API void* scratchAllocate(std::size_t size);
+
+/**
+ * \brief Check whether a block was taken from the scratch arena of the current thread
+ */
+PONDER_API bool scratchOwns(const void* pointer);
+
+} // namespace detail
+
+} // namespace ponder
+
+
+#endif // PONDER_SCRATCH_HPP
@@ -0,0 +1,173 @@
+/****************************************************************************
+**
+** This file is part of the Ponder library, formerly CAMP.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+
+
+#ifndef PONDER_SEQLOCK_HPP
+#define PONDER_SEQLOCK_HPP
+
+
+#include <ponder/class.hpp>
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+
+namespace ponder
+{
+/**
+ * \brief Group writes to an object so that readConsistent() sees all of them or none
+ *
+ * Each write through UserObject::set is sequenced on its own. To update several
+ * properties together, or to write members directly in C++, keep a SequencedWrite alive
+ * around the writes. It does nothing if the metaclass of the object doesn't have the
+ * Concurrency::SeqLock policy.
+ *
+ * \code
+ * {
+ *     ponder::SequencedWrite write(body);
+ *     body.set("x", 1.0);
+ *     body.set("y", 2.0);
+ * }
+ * \endcode
+ *
+ * Writers never wait, so an object must be written by a single thread at a time, as with
+ * any seqlock; writers of different objects don't affect each other. Writes can be nested
+ * on the same thread, including writes of other objects.
+ *
+ * \sa readConsistent, ClassBuilder::concurrency
+ */
+class PONDER_API SequencedWrite : detail::noncopyable
+{
+public:
+
+    /**
+     * \brief Start writing an object
+     *
+     * \param object Object to write
+     */
+    explicit SequencedWrite(const UserObject& object);
+
+    /**
+     * \brief Publish the writes to the readers
+     */
+    ~SequencedWrite();
+
+private:
+
+    std::atomic<std::size_t>* m_counter; ///< Counter of the object, null if not sequenced
+};
+
+namespace detail
+{
+/**
+ * \brief Check that a property can be read by readConsistent
+ *
+ * \throw ForbiddenRead the property is not a boolean, a number or an enum
+ */
+PONDER_API void checkConsistentProperty(const Property& property);
+
+/**
+ * \brief Wait until no other thread is writing and return the sequence to check
+ */
+PONDER_API std::size_t seqLockReadBegin(const std::atomic<std::size_t>& counter);
+
+/**
+ * \brief Check if the object was written since seqLockReadBegin returned \a sequence
+ */
+PONDER_API bool seqLockReadRetry(const std::atomic<std::size_t>& counter, std::size_t sequence);
+
+inline const Property& consistentProperty(const UserObject&, const Property& property)
+{
+    return property;
+}
+
+inline const Property& consistentProperty(const UserObject& object, IdRef name)
+{
+    return object.getClass().property(name);
+}
+
+} // namespace detail
+
+/**
+ * \brief Read several properties of an object that another thread may be writing
+ *
+ * If the metaclass of the object has the Concurrency::SeqLock policy, the properties are
+ * read again until no write through UserObject::set or Property::set happened meanwhile,
+ * so that the values form a consistent snapshot. Readers never block writers. Otherwise
+ * the properties are simply read once.
+ *
+ * \code
+ * ponder::UserObject body(&simulation.body(0));
+ * std::array<ponder::Value, 3> pos = ponder::readConsistent(body, "x", "y", "z");
+ * \endcode
+ *
+ * A read may see a write in progress before it's discarded, so only booleans, numbers and
+ * enums can be read, by getters with no side effect: a string or a container being
+ * written could not even be copied safely.
+ * Writes which don't go through UserObject::set, such as the elements of array
+ * properties or direct C++ accesses, must be wrapped in a SequencedWrite.
+ *
+ * \param object Object to read
+ * \param properties Properties to read, as Property references or names
+ *
+ * \return Values of the properties, in the order of \a properties
+ *
+ * \throw PropertyNotFound a property name doesn't exist in the metaclass of the object
+ * \throw ForbiddenRead a property is not readable, or is not a boolean, a number or an enum
+ *
+ * \sa SequencedWrite, ClassBuilder::concurrency
+ */
+template <typename... P>
+std::array<Value, sizeof...(P)> readConsistent(const UserObject& object, const P&... properties)
+{
+    const std::array<const Property*, sizeof...(P)> resolved =
+        {{&detail::consistentProperty(object, properties)...}};
+    for (const Property* property : resolved)
+        detail::checkConsistentProperty(*property);
+    std::array<Value, sizeof...(P)> values;
+
+    const std::atomic<std::size_t>* counter = detail::seqLockCounter(object);
+    std::size_t sequence = counter ? detail::seqLockReadBegin(*counter) : 0;
+    for (;;)
+    {
+        for (std::size_t i = 0; i < resolved.size(); ++i)
+            values[i] = resolved[i]->get(object);
+
+        if (!counter || !detail::seqLockReadRetry(*counter, sequence))
+            return values;
+
+        sequence = detail::seqLockReadBegin(*counter);
+    }
+}
+
+} // namespace ponder
+
+
+#endif // PONDER_SEQLOCK_HPP
@@ -0,0 +1,204 @@
+/****************************************************************************
+**
+** This file is part of the Ponder library, formerly CAMP.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+
+#ifndef PONDER_STATICCLASS_HPP
+#define PONDER_STATICCLASS_HPP
+
+
+#include <ponder/config.hpp>
+#include <ponder/detail/util.hpp>
+#include <tuple>
+#include <type_traits>
+
+
+namespace ponder
+{
+/**
+ * \brief Compile-time description of a data member of a class
+ *
+ * Field descriptors are created with ponder::field() and listed in PONDER_STATIC_CLASS.
+ * They keep the full type of the member, so code which uses them is resolved at compile
+ * time and can be inlined, unlike the runtime Property interface.
+ *
+ * \sa PONDER_STATIC_CLASS, forEachProperty
+ */
+template <typename C, typename T>
+struct StaticField
+{
+    typedef C ClassType; ///< Type of the owner class
+    typedef T Type; ///< Type of the member
+
+    constexpr StaticField(const char* name_, T C::*member_) : name(name_), member(member_) {}
+
+    /**
+     * \brief Access the member in an object
+     *
+     * \param object Object to access
+     *
+     * \return Reference to the member
+     */
+    T& get(C& object) const {return object.*member;}
+    const T& get(const C& object) const {return object.*member;}
+
+    const char* name; ///< Name of the field, also used for the runtime property
+    T C::*member; ///< Pointer to the data member
+};
+
+/**
+ * \brief Create a field descriptor, to be used in PONDER_STATIC_CLASS
+ *
+ * \param name Name of the field
+ * \param member Pointer to the data member
+ *
+ * \return Field descriptor
+ */
+template <typename C, typename T>
+constexpr StaticField<C, T> field(const char* name, T C::*member)
+{
+    return StaticField<C, T>(name, member);
+}
+
+/**
+ * \brief Compile-time description of a class
+ *
+ * This template is only declared. It is specialized for each class with the
+ * PONDER_STATIC_CLASS macro, and the specializations provide:
+ * - Fields: std::tuple of the field descriptors
+ * - count: number of fields
+ * - fields(): function returning the field descriptors
+ */
+template <typename T>
+struct StaticClass;
+
+/**
+ * \brief Get the field descriptors of a class declared with PONDER_STATIC_CLASS
+ *
+ * \return std::tuple of StaticField
+ */
+template <typename T>
+inline typename StaticClass<T>::Fields staticClass()
+{
+    return StaticClass<T>::fields();
+}
+
+namespace detail
+{
+template <typename Fields, typename F, std::size_t... Is>
+inline void forEachFieldImpl(const Fields& fields, F& func, _PONDER_SEQNS::index_sequence<Is...>)
+{
+    const int expand[] = {0, ((void) func(std::get<Is>(fields)), 0)...};
+    (void) expand;
+}
+
+template <typename C, typename Fields, typename F, std::size_t... Is>
+inline void forEachPropertyImpl(C& object, const Fields& fields, F& func,
+                                _PONDER_SEQNS::index_sequence<Is...>)
+{
+    const int expand[] = {0, ((void) func(std::get<Is>(fields).name,
+                                          std::get<Is>(fields).get(object)), 0)...};
+    (void) expand;
+}
+} // namespace detail
+
+/**
+ * \brief Call a function for every field descriptor of a class
+ *
+ * The function is called as `func(field)` for each StaticField, in declaration order.
+ *
+ * \param func Function object to call, usually a generic functor
+ */
+template <typename T, typename F>
+inline void forEachField(F&& func)
+{
+    typedef StaticClass<T> Static;
+    detail::forEachFieldImpl(Static::fields(), func,
+                             _PONDER_SEQNS::make_index_sequence<Static::count>());
+}
+
+/**
+ * \brief Call a function for every field of an object
+ *
+ * The function is called as `func(name, value)` for each field of the class, in declaration
+ * order, where value is a reference to the member (const if \a object is const). The loop
+ * is unrolled at compile time so there is no dispatch through Property.
+ *
+ * \code
+ * struct Writer
+ * {
+ *     template <typename T>
+ *     void operator()(const char* name, const T& value) {out << name << "=" << value;}
+ * };
+ *
+ * ponder::forEachProperty(point, Writer());
+ * \endcode
+ *
+ * \param object Object to iterate
+ * \param func Function object to call
+ */
+template <typename C, typename F>
+inline void forEachProperty(C& object, F&& func)
+{
+    typedef StaticClass<typename std::remove_const<C>::type> Static;
+    detail::forEachPropertyImpl(object, Static::fields(), func,
+                                _PONDER_SEQNS::make_index_sequence<Static::count>());
+}
+
+} // namespace ponder
+
+/**
+ * \brief Declare the compile-time description of a class
+ *
+ * The macro must be used in the global namespace. The remaining arguments are field
+ * descriptors created with ponder::field(). If the fields are private, make
+ * `ponder::StaticClass<type>` a friend of the class.
+ *
+ * The same description can then be used to fill the runtime metaclass with
+ * ClassBuilder::staticProperties(), so that both share a single declaration.
+ *
+ * \code
+ * struct Point {float x, y;};
+ *
+ * PONDER_STATIC_CLASS(Point, ponder::field("x", &Point::x), ponder::field("y", &Point::y))
+ *
+ * ponder::Class::declare<Point>("Point")
+ *     .staticProperties();
+ * \endcode
+ */
+#define PONDER_STATIC_CLASS(type, ...) \
+    namespace ponder { \
+        template <> struct StaticClass<type> { \
+            typedef decltype(std::make_tuple(__VA_ARGS__)) Fields; \
+            enum {count = std::tuple_size<Fields>::value}; \
+            static Fields fields() {return Fields(__VA_ARGS__);} \
+        }; \
+    }
+
+
+#endif // PONDER_STATICCLASS_HPP
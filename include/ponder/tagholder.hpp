@@ -34,7 +34,9 @@
 
 #include <ponder/detail/getter.hpp>
 #include <ponder/value.hpp>
-#include <map>
+#include <ponder/detail/hashindex.hpp>
+#include <utility>
+#include <vector>
 
 
 namespace ponder
@@ -80,6 +82,8 @@ public:
     /**
      * \brief Get a tag by its index
      *
+     * Tags are indexed in declaration order.
+     *
      * \param index Index of the tag to retrieve
      *
      * \return index-th tag
@@ -127,10 +131,29 @@ protected:
 private:
 
     template <typename T> friend class ClassBuilder;
+    friend class detail::MemoryCounter;
+
+    /**
+     * \brief Add a tag, or replace the value of an existing one
+     *
+     * \param id Identifier of the tag
+     * \param value Value associated to the tag
+     */
+    void setTag(const Value& id, const detail::Getter<Value>& value);
+
+    /**
+     * \brief Find a tag
+     *
+     * \param id Identifier of the tag to find
+     *
+     * \return Index of the tag, or detail::HashIndex::npos if it doesn't exist
+     */
+    std::size_t findTag(const Value& id) const;
 
-    typedef std::map<Value, detail::Getter<Value> > TagsTable;
+    typedef std::vector<std::pair<Value, detail::Getter<Value> > > TagsTable;
 
-    TagsTable m_tags; ///< Table of tags / values
+    TagsTable m_tags; ///< Table of tags / values, in declaration order
+    detail::HashIndex m_index; ///< Hashed index of the tag identifiers
 };
 
 } // namespace ponder
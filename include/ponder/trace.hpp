@@ -0,0 +1,196 @@
+/****************************************************************************
+**
+** This file is part of the Ponder library, formerly CAMP.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+
+
+#ifndef PONDER_TRACE_HPP
+#define PONDER_TRACE_HPP
+
+
+#include <ponder/config.hpp>
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+
+
+namespace ponder
+{
+/**
+ * \brief Trace spans of reflected calls and serialization, in the Chrome trace-event format
+ *
+ * While tracing is started, runtime function calls, Lua-dispatched functions,
+ * ObjectFactory::construct and the serialization of each object and array by ponder-xml
+ * record a span, labeled with the class and member names. Each thread appends to its own
+ * buffer without locking. write() outputs the spans as JSON which can be loaded in
+ * chrome://tracing or Perfetto.
+ *
+ * When tracing is stopped, each traced operation costs a relaxed load and a branch on
+ * entry, a test of a null pointer on exit, and a Span (two pointers, the category and the
+ * start time) kept on the stack. Both branches always go the same way while tracing is
+ * stopped, so they are predicted.
+ *
+ * \code
+ * ponder::trace::start();
+ * runFrame();
+ * ponder::trace::stop();
+ * std::ofstream file("frame.json");
+ * ponder::trace::write(file);
+ * \endcode
+ *
+ * \note Labels point to the names stored in the metadata: write the trace before
+ *       undeclaring the traced metaclasses.
+ */
+namespace trace
+{
+/**
+ * \brief Kind of traced operation, written as the category of the events
+ */
+enum class Category
+{
+    Call,           ///< Function called through the runtime
+    Lua,            ///< Function called from Lua
+    Construct,      ///< Object constructed through an ObjectFactory
+    Serialize,      ///< Object or array serialized
+    Deserialize     ///< Object or array deserialized
+};
+
+namespace detail
+{
+PONDER_API extern std::atomic<bool> g_active;
+}
+
+/**
+ * \brief Check if spans are being recorded
+ */
+inline bool active() {return detail::g_active.load(std::memory_order_relaxed);}
+
+/**
+ * \brief Start recording spans
+ */
+PONDER_API void start();
+
+/**
+ * \brief Stop recording spans, the recorded ones are kept
+ */
+PONDER_API void stop();
+
+/**
+ * \brief Discard the recorded spans
+ *
+ * It must not be called while traced operations are running in other threads.
+ */
+PONDER_API void clear();
+
+/**
+ * \brief Get the number of spans recorded by all threads
+ */
+PONDER_API std::size_t eventCount();
+
+/**
+ * \brief Write the recorded spans as a Chrome trace-event JSON object
+ *
+ * Timestamps are in microseconds since the first start() following a clear().
+ *
+ * \param stream Stream to write to
+ */
+PONDER_API void write(std::ostream& stream);
+
+namespace detail
+{
+/**
+ * \brief Get the current time of the trace clock, in nanoseconds
+ */
+PONDER_API std::uint64_t now();
+
+/**
+ * \brief Append a span to the buffer of the calling thread
+ */
+PONDER_API void record(Category category, const char* className, const char* memberName,
+                       std::uint64_t startNs, std::uint64_t endNs);
+
+/**
+ * \brief Records the enclosing scope as a span, if begin() is called
+ */
+class Span
+{
+public:
+
+    Span() : m_className(nullptr) {}
+
+    ~Span()
+    {
+        if (m_className)
+            record(m_category, m_className, m_memberName, m_start, now());
+    }
+
+    void begin(Category category, const char* className, const char* memberName)
+    {
+        m_category = category;
+        m_className = className ? className : "";
+        m_memberName = memberName;
+        m_start = now();
+    }
+
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+private:
+
+    const char* m_className; ///< Null until the span begins
+    const char* m_memberName;
+    Category m_category;
+    std::uint64_t m_start;
+};
+
+} // namespace detail
+
+} // namespace trace
+
+} // namespace ponder
+
+
+/**
+ * \brief Record the enclosing scope as a span while tracing is started
+ *
+ * The labels are only evaluated when tracing is started. When it is stopped, the
+ * scope pays for the check of active() and for the check of the span in its destructor.
+ *
+ * \param category Name of a trace::Category value
+ * \param className Name of the class (const char*), or null
+ * \param memberName Name of the member (const char*), or null
+ */
+#define PONDER_TRACE_SCOPE(category, className, memberName) \
+    ::ponder::trace::detail::Span ponderTraceSpan_; \
+    if (::ponder::trace::active()) \
+        ponderTraceSpan_.begin(::ponder::trace::Category::category, className, memberName); \
+    else \
+        ((void)0)
+
+
+#endif // PONDER_TRACE_HPP
@@ -67,7 +67,8 @@ enum class ValueKind
     String,     ///< String types (char*, ponder::String)
     Enum,       ///< Enumerated types
     Array,      ///< Array types (std::vector, std::list, T[])
-    User        ///< User-defined classes
+    User,       ///< User-defined classes
+    Dictionary  ///< Associative containers (std::map, std::unordered_map)
 };
 
 /**
@@ -55,7 +55,7 @@ class ParentObject;
  *
  * \note UserObjects are stored interally as objects (a copy) or references (an existing 
  *       object). To be sure which you are constructing use UserObject::makeRef() or
- *       UserObject::makeCopy().
+ *       UserObject::makeCopy(). References don't allocate memory.
  *
  * \sa EnumObject
  */
@@ -300,6 +300,7 @@ public:
 private:
 
     friend class Property;
+    friend class ScratchScope;
 
     /**
      * \brief Assign a new value to a property of the object
@@ -309,13 +310,28 @@ private:
      */
     void set(const Property& property, const Value& value) const;
 
+    /**
+     * \brief Get the address of the part of an object described by its dynamic metaclass
+     *
+     * \param object Pointer to the object, with its static type
+     * \param dynamicClass Metaclass of the dynamic type of the object
+     *
+     * \return Pointer to the dynamic type part of the object
+     */
+    template <typename T>
+    static void* alignedPointer(T* object, const Class& dynamicClass);
+
 private:
 
     /// Metaclass of the stored object
     const Class* m_class;
     
-    /// Optional abstract holder storing the object
-    std::shared_ptr<detail::AbstractObjectHolder> m_holder;
+    /// Object referenced by the user object, or stored in m_holder. Referencing an object
+    /// doesn't allocate.
+    void* m_pointer;
+    
+    /// Optional abstract holder storing a copy of the object
+    detail::RefPtr<detail::AbstractObjectHolder> m_holder;
 };
 
 
@@ -33,12 +33,12 @@ namespace ponder {
 template <typename T>
 UserObject::UserObject(const T& object)
     : m_class(&classByObject(object))
+    , m_pointer()
     , m_holder()
 {
     typedef detail::ObjectTraits<T&> Traits;
-    typedef detail::ObjectHolderByRef<typename Traits::DataType> Holder;
 
-    m_holder.reset(new Holder(Traits::getPointer(const_cast<T&>(object))));
+    m_pointer = alignedPointer(Traits::getPointer(const_cast<T&>(object)), *m_class);
 }
 
 template <typename T>
@@ -64,11 +64,10 @@ template <typename T>
 UserObject UserObject::makeRef(T& object)
 {
     typedef detail::ObjectTraits<T&> Traits;
-    typedef detail::ObjectHolderByRef<typename Traits::DataType> Holder;
 
     UserObject userObject;
     userObject.m_class = &classByObject(object);
-    userObject.m_holder.reset(new Holder(Traits::getPointer(object)));
+    userObject.m_pointer = alignedPointer(Traits::getPointer(object), *userObject.m_class);
 
     return userObject;
 }
@@ -77,11 +76,10 @@ template <typename T>
 UserObject UserObject::makeRef(const T& object)
 {
     typedef detail::ObjectTraits<const T&> Traits;
-    typedef detail::ObjectHolderByConstRef<typename Traits::DataType> Holder;
 
     UserObject userObject;
     userObject.m_class = &classByObject(object);
-    userObject.m_holder.reset(new Holder(Traits::getPointer(object)));
+    userObject.m_pointer = alignedPointer(Traits::getPointer(object), *userObject.m_class);
 
     return userObject;
 }
@@ -95,6 +93,7 @@ UserObject UserObject::makeCopy(const T& object)
     UserObject userObject;
     userObject.m_class = &classByType<T>();
     userObject.m_holder.reset(new Holder(Traits::getPointer(object)));
+    userObject.m_pointer = userObject.m_holder->object();
 
     return userObject;
 }
@@ -102,13 +101,22 @@ UserObject UserObject::makeCopy(const T& object)
 template <typename T>
 T& UserObject::ref()
 {
-    return *reinterpret_cast<T*>(m_holder->object());
+    return *reinterpret_cast<T*>(m_pointer);
 }
 
 template <typename T>
 const T& UserObject::cref() const
 {
-    return *reinterpret_cast<T*>(m_holder->object());
+    return *reinterpret_cast<T*>(m_pointer);
+}
+
+template <typename T>
+void* UserObject::alignedPointer(T* object, const Class& dynamicClass)
+{
+    typedef typename std::remove_const<T>::type DataType;
+
+    // Apply the offset of the dynamic type (solves multiple inheritance issues)
+    return classCast(const_cast<DataType*>(object), classByType<DataType>(), dynamicClass);
 }
 
 } // namespace ponder
@@ -33,6 +33,7 @@
 
 
 #include <ponder/property.hpp>
+#include <ponder/detail/classcache.hpp>
 
 
 namespace ponder
@@ -76,7 +77,8 @@ public:
 
 private:
 
-    const Class* m_class; ///< Owner class of the property
+    Id m_classId; ///< Name of the owner class of the property
+    mutable detail::ClassCache m_class; ///< Owner class of the property, cached per generation
 };
 
 } // namespace ponder
@@ -0,0 +1,171 @@
+/****************************************************************************
+**
+** This file is part of the Ponder library, formerly CAMP.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+#ifndef PONDER_USES_CODEGEN_HPP
+#define PONDER_USES_CODEGEN_HPP
+
+#include <ponder/class.hpp>
+#include <ponder/classcast.hpp>
+#include <ponder/errors.hpp>
+#include <ponder/userobject.hpp>
+#include <array>
+#include <cstdint>
+#include <ostream>
+
+namespace ponder {
+namespace uses {
+
+/**
+ * \brief Compute a hash of the layout of a metaclass
+ *
+ * The hash covers the name of the class, and the names and kinds of its properties and
+ * functions (including parameter kinds), in index order. For properties bound to a plain
+ * data member it also covers the C++ type and offset of the member, which makes the hash
+ * specific to the compiler and platform. Generated code stores the hash of the metaclass
+ * it was generated from and compares it with the live one before use.
+ *
+ * \param cls Metaclass to hash
+ *
+ * \return 64-bit FNV-1a hash of the metaclass layout
+ */
+PONDER_API std::uint64_t schemaHash(const Class& cls);
+
+/**
+ * \brief Generate C++ code for a metaclass
+ *
+ * The generated code, placed in namespace `ponder_gen::<class name>`, contains:
+ * - the schema hash of the metaclass,
+ * - `property::<name>` and `function::<name>` index constants,
+ * - `handles()`, returning the properties and functions resolved once by index,
+ * - `encode()` / `decode()`, which copy all non-array properties to and from an Args
+ *   list in index order, as straight-line code. Properties bound to a plain data member
+ *   (and always readable, or writable) are accessed directly at their offset in the
+ *   object, the others through Property::get and Property::set,
+ * - when compiled with PONDER_USING_LUA, Lua getter thunks and `luaPushGetters()`.
+ *
+ * The namespace name is derived from the class name alone: `::` becomes `_` (e.g.
+ * `ponder_gen::geo_Point` for "geo::Point"), and names which are not only made of
+ * segments of letters and digits get a hash of the name appended, so that classes
+ * generated separately never collide.
+ *
+ * \param out Stream to write to
+ * \param cls Metaclass to generate code for
+ */
+PONDER_API void generateCode(std::ostream& out, const Class& cls);
+
+/**
+ * \brief Generate C++ code for all the registered metaclasses
+ *
+ * This writes the header preamble followed by generateCode() for each metaclass.
+ *
+ * \param out Stream to write to
+ */
+PONDER_API void generateCode(std::ostream& out);
+
+/**
+ * \brief Metaclass members resolved by index, used by generated code
+ *
+ * The members are resolved when constructed, after checking the schema hash, and again
+ * whenever the registry generation changes (e.g. when a module is reloaded).
+ *
+ * \throw ClassNotFound the metaclass is not declared
+ * \throw SchemaMismatch the metaclass was changed since the code was generated
+ */
+template <std::size_t NP, std::size_t NF>
+class SchemaHandles
+{
+public:
+
+    SchemaHandles(IdRef className, std::uint64_t hash)
+        : m_name(className)
+        , m_hash(hash)
+        , m_generation(0)
+        , m_class(nullptr)
+    {
+        resolve();
+    }
+
+    /**
+     * \brief Make sure the handles are still valid, resolve them again if not
+     *
+     * \return Reference to this
+     */
+    const SchemaHandles& check()
+    {
+        if (m_generation != registryGeneration())
+            resolve();
+        return *this;
+    }
+
+    const Class& metaclass() const {return *m_class;}
+    const Property& property(std::size_t index) const {return *m_properties[index];}
+    const Function& function(std::size_t index) const {return *m_functions[index];}
+
+    /**
+     * \brief Get the address of an object as an instance of the metaclass
+     *
+     * \throw NullObject the object is null
+     * \throw ClassUnrelated the object is not an instance of the metaclass nor of a derived one
+     */
+    void* pointer(const UserObject& object) const
+    {
+        if (!object.pointer())
+            PONDER_ERROR(NullObject(m_class));
+        return classCast(object.pointer(), object.getClass(), *m_class);
+    }
+
+private:
+
+    void resolve()
+    {
+        const Class& cls = classByName(m_name);
+        if (schemaHash(cls) != m_hash || cls.propertyCount() != NP || cls.functionCount() != NF)
+            PONDER_ERROR(SchemaMismatch(m_name));
+
+        for (std::size_t i = 0; i < NP; ++i)
+            m_properties[i] = &cls.property(i);
+        for (std::size_t i = 0; i < NF; ++i)
+            m_functions[i] = &cls.function(i);
+
+        m_class = &cls;
+        m_generation = registryGeneration();
+    }
+
+    Id m_name;
+    std::uint64_t m_hash;
+    std::size_t m_generation;
+    const Class* m_class;
+    std::array<const Property*, NP> m_properties;
+    std::array<const Function*, NF> m_functions;
+};
+
+} // namespace uses
+} // namespace ponder
+
+#endif // PONDER_USES_CODEGEN_HPP
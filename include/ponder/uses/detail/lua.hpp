@@ -38,6 +38,9 @@ extern "C" {
 #include <lauxlib.h>
 }
 
+#include <ponder/detail/metaallocator.hpp>
+#include <ponder/trace.hpp>
+
 // forward declare
 namespace ponder { namespace lua {
     int pushUserObject(lua_State *L, const ponder::UserObject& uobj);
@@ -406,7 +409,7 @@ template <typename R, typename P> struct FunctionWrapper;
 
 template <typename R, typename... P> struct FunctionWrapper<R, std::tuple<P...>>
 {
-    typedef typename std::function<R(P...)> Type;
+    typedef ponder::detail::MetaFunction<MemoryCategory::Callers, R(P...)> Type;
     
     template <typename F, typename FTraits, typename FPolicies>
     static int call(F func, lua_State* L)
@@ -420,7 +423,7 @@ template <typename R, typename... P> struct FunctionWrapper<R, std::tuple<P...>>
 //-----------------------------------------------------------------------------
 // Base for runtime function caller
 
-class FunctionCaller
+class FunctionCaller : public ponder::detail::MetaAllocated<MemoryCategory::Callers>
 {
 public:
     FunctionCaller(const IdRef name, int (*fn)(lua_State*) = nullptr)
@@ -433,10 +436,12 @@ public:
     
     const IdRef name() const { return m_name; }
 
-    void pushFunction(lua_State* L)
+    // The class is kept as a second upvalue to label trace spans
+    void pushFunction(lua_State* L, const Class& cls)
     {
         lua_pushlightuserdata(L, (void*) this);
-        lua_pushcclosure(L, m_luaFunc, 1);
+        lua_pushlightuserdata(L, (void*) &cls);
+        lua_pushcclosure(L, m_luaFunc, 2);
     }
     
 private:
@@ -471,8 +476,12 @@ private:
         ThisType *self = reinterpret_cast<ThisType*>(lua_touserdata(L, -1));
         lua_pop(L, 1);
 
+        PONDER_TRACE_SCOPE(Lua,
+            static_cast<const Class*>(lua_touserdata(L, lua_upvalueindex(2)))->name().data(),
+            self->name().data());
+
         return FunctionType::template
-            call<decltype(m_function), FTraits, FPolicies>(self->m_function, L);
+            call<const decltype(m_function)&, FTraits, FPolicies>(self->m_function, L);
     }
 };
     
@@ -31,6 +31,7 @@
 
 #include <ponder/detail/rawtype.hpp>
 #include <ponder/detail/util.hpp>
+#include <ponder/detail/metaallocator.hpp>
 
 namespace ponder {
 namespace runtime {
@@ -113,8 +114,8 @@ struct ChooseCallReturner<std::tuple<P, Ps...>, R> // recurse
 /*
  * Helper function which converts an argument to a C++ type
  *
- * The main purpose of this function is to convert any BadType error to
- * a BadArgument one.
+ * The main purpose of this function is to report an incompatible argument
+ * as a BadArgument error. accepts() checks beforehand that convert() won't raise any error.
  */
 template <int TFrom, typename TTo>
 struct ConvertArg
@@ -123,12 +124,16 @@ struct ConvertArg
     static ReturnType
     convert(const Args& args, size_t index)
     {
-        try {
-            return args[index].to<typename std::remove_reference<TTo>::type>();
-        }
-        catch (const BadType&) {
-            PONDER_ERROR(BadArgument(args[index].kind(), mapType<TTo>(), index, "?"));
-        }
+        const Value& arg = args[index];
+        if (!arg.visit(ponder::detail::CompatibleVisitor<ReturnType, false>()))
+            PONDER_ERROR(BadArgument(arg.kind(), mapType<TTo>(), index, "?"));
+        return arg.to<ReturnType>();
+    }
+
+    static bool accepts(const Args& args, std::size_t index)
+    {
+        return index < args.count()
+            && args[index].visit(ponder::detail::CompatibleVisitor<ReturnType>());
     }
 };
 
@@ -145,6 +150,13 @@ struct ConvertArg<(int)ValueKind::User, TTo&>
             PONDER_ERROR(NullObject(&uobj.getClass()));
         return uobj.ref<TTo>();
     }
+
+    static bool accepts(const Args& args, std::size_t index)
+    {
+        return index < args.count() && args[index].kind() == ValueKind::User
+            && args[index].visit(ponder::detail::CompatibleVisitor<TTo>())
+            && args[index].cref<UserObject>().pointer();
+    }
 };
 
 // Specialisation for returning const references.
@@ -160,6 +172,13 @@ struct ConvertArg<(int)ValueKind::User, const TTo&>
             PONDER_ERROR(NullObject(&uobj.getClass()));
         return uobj.cref<TTo>();
     }
+
+    static bool accepts(const Args& args, std::size_t index)
+    {
+        return index < args.count() && args[index].kind() == ValueKind::User
+            && args[index].visit(ponder::detail::CompatibleVisitor<TTo>())
+            && args[index].cref<UserObject>().pointer();
+    }
 };
 
 //-----------------------------------------------------------------------------
@@ -176,8 +195,24 @@ struct ConvertArgs
     {
         return Convertor::convert(args, index);
     }
+
+    static bool accepts(const Args& args, std::size_t index)
+    {
+        return Convertor::accepts(args, index);
+    }
 };
 
+// Check that all the arguments can be converted
+template<typename... A, size_t... Is>
+bool acceptArgs(const Args& args, _PONDER_SEQNS::index_sequence<Is...>)
+{
+    const bool accepted[] = {true, ConvertArgs<A>::accepts(args, Is)...};
+    for (bool a : accepted)
+        if (!a)
+            return false;
+    return true;
+}
+
 template <typename R, typename FTraits, typename FPolicies>
 class CallHelper
 {
@@ -212,7 +247,7 @@ template <typename R, typename A> struct FunctionWrapper;
 
 template <typename R, typename... A> struct FunctionWrapper<R, std::tuple<A...>>
 {
-    typedef typename std::function<R(A...)> Type;
+    typedef ponder::detail::MetaFunction<MemoryCategory::Callers, R(A...)> Type;
     
     template <typename F, typename FTraits, typename FPolicies>
     static Value call(F func, const Args& args)
@@ -221,12 +256,18 @@ template <typename R, typename... A> struct FunctionWrapper<R, std::tuple<A...>>
         return CallHelper<R, FTraits, FPolicies>::template
             call<F, A...>(func, args, ArgEnumerator());
     }
+
+    static bool accepts(const Args& args)
+    {
+        typedef _PONDER_SEQNS::make_index_sequence<sizeof...(A)> ArgEnumerator;
+        return acceptArgs<A...>(args, ArgEnumerator());
+    }
 };
     
 //-----------------------------------------------------------------------------
 // Base for runtime function caller
 
-class FunctionCaller
+class FunctionCaller : public ponder::detail::MetaAllocated<MemoryCategory::Callers>
 {
 public:
     FunctionCaller(const IdRef name) : m_name(name) {}
@@ -237,6 +278,9 @@ public:
     const IdRef name() const { return m_name; }
     
     virtual Value execute(const Args& args) const = 0;
+
+    // Check that execute() can convert all the arguments, without raising errors
+    virtual bool accepts(const Args& args) const = 0;
     
 private:
     const IdRef m_name;
@@ -264,7 +308,12 @@ private:
     Value execute(const Args& args) const
     {
         return FunctionType::template
-            call<decltype(m_function), FTraits, FPolicies>(m_function, args);
+            call<const decltype(m_function)&, FTraits, FPolicies>(m_function, args);
+    }
+
+    bool accepts(const Args& args) const
+    {
+        return FunctionType::accepts(args);
     }
 };
 
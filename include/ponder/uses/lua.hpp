@@ -144,9 +144,13 @@ bool runString(lua_State *L, const char *luaCode);
 
 #include <ponder/uses/runtime.hpp>
 #include <ponder/uses/detail/lua.hpp>
+#include <ponder/dictionaryproperty.hpp>
+#include <memory>
 
 #define _PONDER_LUA_METATBLS "_ponder_meta"
 #define _PONDER_LUA_INSTTBLS "_instmt"
+#define _PONDER_LUA_DICTMT "_ponder_dictmt"
+#define _PONDER_LUA_EVENTMT "_ponder_eventmt"
 
 namespace ponder {
 namespace lua {
@@ -262,12 +266,254 @@ static Value getValue(lua_State *L, int index,
     
     return Value(); // no value
 }
+
+//
+// Dictionary properties are pushed as a proxy referencing the object and the property, so
+// that elements are looked up, assigned and iterated without copying the container.
+//
+struct DictionaryRef
+{
+    UserObject object;
+    const DictionaryProperty* property;
+};
+
+// dict[key]
+static int l_dict_index(lua_State *L)
+{
+    DictionaryRef *ref = (DictionaryRef*) lua_touserdata(L, 1);
+    const Value key = getValue(L, 2, ref->property->keyType());
+    
+    if (!ref->property->contains(ref->object, key))
+        return 0;
+    return pushValue(L, ref->property->get(ref->object, key));
+}
+
+// dict[key] = value, or remove the element if value is nil
+static int l_dict_newindex(lua_State *L)
+{
+    DictionaryRef *ref = (DictionaryRef*) lua_touserdata(L, 1);
+    const Value key = getValue(L, 2, ref->property->keyType());
+    
+    if (lua_isnil(L, 3))
+        ref->property->remove(ref->object, key);
+    else
+        ref->property->set(ref->object, key, getValue(L, 3, ref->property->elementType()));
+    return 0;
+}
+
+// #dict
+static int l_dict_len(lua_State *L)
+{
+    DictionaryRef *ref = (DictionaryRef*) lua_touserdata(L, 1);
+    lua_pushinteger(L, static_cast<lua_Integer>(ref->property->size(ref->object)));
+    return 1;
+}
+
+// next(dict, key) -> next key, value
+static int l_dict_next(lua_State *L)
+{
+    DictionaryRef *ref = (DictionaryRef*) lua_touserdata(L, 1);
+    Value key = lua_isnil(L, 2) ? Value() : getValue(L, 2, ref->property->keyType());
+    Value value;
+    
+    if (!ref->property->next(ref->object, key, value))
+    {
+        lua_pushnil(L);
+        return 1;
+    }
+    pushValue(L, key);
+    pushValue(L, value);
+    return 2;
+}
+
+// pairs(dict)
+static int l_dict_pairs(lua_State *L)
+{
+    lua_pushcfunction(L, l_dict_next);          // +1 iterator
+    lua_pushvalue(L, 1);                        // +1 state
+    lua_pushnil(L);                             // +1 first key
+    return 3;
+}
+
+static int l_dict_gc(lua_State *L)
+{
+    DictionaryRef *ref = (DictionaryRef*) lua_touserdata(L, 1);
+    ref->~DictionaryRef();
+    return 0;
+}
+
+static int pushDictionary(lua_State *L, const UserObject& object,
+                          const DictionaryProperty& property)
+{
+    void *ud = lua_newuserdata(L, sizeof(DictionaryRef)); // +1
+    new(ud) DictionaryRef{object, &property};
+    
+    // the metatable is shared by all the dictionaries
+    if (luaL_newmetatable(L, _PONDER_LUA_DICTMT)) // +1
+    {
+        const luaL_Reg methods[] = {
+            {"__index", l_dict_index},
+            {"__newindex", l_dict_newindex},
+            {"__len", l_dict_len},
+            {"__pairs", l_dict_pairs},
+            {"__gc", l_dict_gc},
+            {nullptr, nullptr}
+        };
+        luaL_setfuncs(L, methods, 0);
+    }
+    lua_setmetatable(L, -2);                    // -1
+    return 1;
+}
+
+//
+// Events are pushed as a proxy referencing the object and the event, with the methods
+// subscribe(function) returning a handle, unsubscribe(handle) and fire(...). The subscribed
+// functions are kept in the registry until they are unsubscribed, which must happen before
+// the state is closed. The events must be fired on the thread running the state.
+//
+struct EventRef
+{
+    UserObject object;
+    const Event* event;
+};
+
+// Lua function subscribed to an event, released with the subscription
+struct LuaSubscriber
+{
+    lua_State *L;
+    int function;
+    
+    ~LuaSubscriber() {luaL_unref(L, LUA_REGISTRYINDEX, function);}
+};
+
+// event:subscribe(function) -> handle
+static int l_event_subscribe(lua_State *L)
+{
+    EventRef *ref = (EventRef*) luaL_checkudata(L, 1, _PONDER_LUA_EVENTMT);
+    luaL_checktype(L, 2, LUA_TFUNCTION);
+    
+    lua_pushvalue(L, 2);                        // +1
+    std::shared_ptr<LuaSubscriber> subscriber(
+        new LuaSubscriber{L, luaL_ref(L, LUA_REGISTRYINDEX)}); // -1
+    
+    const EventHandle handle = ref->event->subscribe(ref->object,
+        [subscriber](const Args& args)
+        {
+            lua_State *L = subscriber->L;
+            lua_rawgeti(L, LUA_REGISTRYINDEX, subscriber->function);
+            for (std::size_t i = 0; i < args.count(); ++i)
+                pushValue(L, args[i]);
+            
+            // Errors can't be propagated through the C++ code firing the event
+            if (lua_pcall(L, static_cast<int>(args.count()), 0, 0) != LUA_OK)
+                lua_pop(L, 1);
+        });
+    
+    lua_pushinteger(L, static_cast<lua_Integer>(handle));
+    return 1;
+}
+
+// event:unsubscribe(handle) -> boolean
+static int l_event_unsubscribe(lua_State *L)
+{
+    EventRef *ref = (EventRef*) luaL_checkudata(L, 1, _PONDER_LUA_EVENTMT);
+    const EventHandle handle = static_cast<EventHandle>(luaL_checkinteger(L, 2));
+    
+    lua_pushboolean(L, ref->event->unsubscribe(ref->object, handle));
+    return 1;
+}
+
+// event:fire(...)
+static int l_event_fire(lua_State *L)
+{
+    EventRef *ref = (EventRef*) luaL_checkudata(L, 1, _PONDER_LUA_EVENTMT);
+    
+    Args args;
+    const std::size_t nparams = ref->event->paramCount();
+    for (int i = 2, nargs = lua_gettop(L); i <= nargs; ++i)
+    {
+        const std::size_t index = static_cast<std::size_t>(i - 2);
+        args += getValue(L, i, index < nparams ? ref->event->paramType(index) : ValueKind::None);
+    }
+    
+    ref->event->fire(ref->object, args);
+    return 0;
+}
+
+static int l_event_gc(lua_State *L)
+{
+    EventRef *ref = (EventRef*) lua_touserdata(L, 1);
+    ref->~EventRef();
+    return 0;
+}
+
+static int pushEvent(lua_State *L, const UserObject& object, const Event& event)
+{
+    void *ud = lua_newuserdata(L, sizeof(EventRef)); // +1
+    new(ud) EventRef{object, &event};
+    
+    // the metatable is shared by all the events, and holds their methods
+    if (luaL_newmetatable(L, _PONDER_LUA_EVENTMT)) // +1
+    {
+        const luaL_Reg methods[] = {
+            {"subscribe", l_event_subscribe},
+            {"unsubscribe", l_event_unsubscribe},
+            {"fire", l_event_fire},
+            {"__gc", l_event_gc},
+            {nullptr, nullptr}
+        };
+        luaL_setfuncs(L, methods, 0);
+        lua_pushvalue(L, -1);                   // +1
+        lua_setfield(L, -2, "__index");         // -1 mt.__index = mt
+    }
+    lua_setmetatable(L, -2);                    // -1
+    return 1;
+}
+
+// Instance userdata: the UserObject, followed by a flag set when the object was created by
+// Lua and is destroyed with the userdata. Other instances reference (or hold a copy of) an
+// object owned elsewhere.
+static const std::size_t c_instanceSize = sizeof(UserObject) + sizeof(bool);
+
+static UserObject* newInstance(lua_State *L, const UserObject& object, bool owned)
+{
+    void *ud = lua_newuserdata(L, c_instanceSize);  // +1
+    *reinterpret_cast<bool*>(static_cast<char*>(ud) + sizeof(UserObject)) = owned;
+    return new(ud) UserObject(object);
+}
+
+static bool instanceOwned(void *ud)
+{
+    return *reinterpret_cast<const bool*>(static_cast<const char*>(ud) + sizeof(UserObject));
+}
+
+// Get the instance class from the closure upvalues: (Class*, generation, class name).
+// The cached pointer is re-resolved by name if the registry changed since it was stored.
+static const Class* instanceClass(lua_State *L)
+{
+    const Class *cls = (const Class *) lua_touserdata(L, lua_upvalueindex(1));
+    const std::size_t generation = ponder::detail::ObserverNotifier::generation();
+    
+    if (static_cast<std::size_t>(lua_tointeger(L, lua_upvalueindex(2))) != generation)
+    {
+        const char *name = lua_tostring(L, lua_upvalueindex(3));
+        cls = ponder::detail::ClassManager::instance().getByIdSafe(name);
+        if (!cls)
+            luaL_error(L, "Class %s has been undeclared", name);
+        
+        lua_pushlightuserdata(L, (void*) cls);
+        lua_replace(L, lua_upvalueindex(1));
+        lua_pushinteger(L, static_cast<lua_Integer>(generation));
+        lua_replace(L, lua_upvalueindex(2));
+    }
+    
+    return cls;
+}
     
 // obj[key]
 static int l_inst_index(lua_State *L)
 {
-    lua_pushvalue(L, lua_upvalueindex(1));
-    const Class *cls = (const Class *) lua_touserdata(L, -1);
+    const Class *cls = instanceClass(L);
     
     void *ud = lua_touserdata(L, 1);                // userobj - (obj, key) -> obj[key]
     const IdRef key(lua_tostring(L, 2));
@@ -277,6 +523,8 @@ static int l_inst_index(lua_State *L)
     if (cls->tryProperty(key, pp))
     {
         ponder::UserObject *uobj = (ponder::UserObject*) ud;
+        if (pp->kind() == ValueKind::Dictionary)
+            return pushDictionary(L, *uobj, static_cast<const DictionaryProperty&>(*pp));
         return pushValue(L, pp->get(*uobj));
     }
     
@@ -288,18 +536,22 @@ static int l_inst_index(lua_State *L)
             std::get<uses::Uses::eLuaModule>(
                 *reinterpret_cast<const uses::Uses::PerFunctionUserData*>(fp->getUsesData()));
         
-        caller->pushFunction(L);
+        caller->pushFunction(L, *cls);
         return 1;
     }
     
+    // check if getting an event to subscribe to
+    const Event *ep = nullptr;
+    if (cls->tryEvent(key, ep))
+        return pushEvent(L, *(ponder::UserObject*) ud, *ep);
+    
     return 0;
 }
 
 // obj[key] = value
 static int l_inst_newindex(lua_State *L)   // (obj, key, value) obj[key] = value
 {
-    lua_pushvalue(L, lua_upvalueindex(1));
-    const Class *cls = (const Class *) lua_touserdata(L, -1);
+    const Class *cls = instanceClass(L);
     
     void *ud = lua_touserdata(L, 1);                // userobj
     const std::string key(lua_tostring(L, 2));
@@ -337,8 +589,7 @@ static int l_instance_create(lua_State *L)
         luaL_error(L, "Matching constructor not found");
     }
     
-    void *ud = lua_newuserdata(L, sizeof(UserObject));   // +1
-    new(ud) UserObject(obj);
+    newInstance(L, obj, true);          // +1 owned, destroyed by __gc
     
     // set instance metatable
     lua_getmetatable(L, 1);             // +1
@@ -365,7 +616,7 @@ static int l_get_class_static(lua_State *L)
             std::get<uses::Uses::eLuaModule>(
                 *reinterpret_cast<const uses::Uses::PerFunctionUserData*>(func->getUsesData()));
         
-        caller->pushFunction(L);
+        caller->pushFunction(L, *cls);
         return 1;
     }
     
@@ -375,18 +626,38 @@ static int l_get_class_static(lua_State *L)
 //
 // Create instance metatable. This is shared between all instances of the class type
 //
+// Release the UserObject stored in an instance userdata, and the copy it may hold.
+// Objects constructed by Lua are destroyed as well.
+static int l_inst_gc(lua_State *L)
+{
+    void *ud = lua_touserdata(L, 1);
+    UserObject *uobj = (UserObject*) ud;
+    if (instanceOwned(ud))
+        ponder::runtime::ObjectFactory(uobj->getClass()).destroy(*uobj);
+    uobj->~UserObject();
+    return 0;
+}
+
 static void createInstanceMetatable(lua_State *L, const Class& cls)
 {
-    lua_createtable(L, 0, 3);                   // +1 mt
+    lua_createtable(L, 0, 4);                   // +1 mt
     
     lua_pushliteral(L, "__index");              // +1
     lua_pushlightuserdata(L, (void*) &cls);     // +1
-    lua_pushcclosure(L, l_inst_index, 1);       // 0 +-
+    lua_pushinteger(L, static_cast<lua_Integer>(ponder::detail::ObserverNotifier::generation())); // +1
+    lua_pushstring(L, cls.name().c_str());      // +1
+    lua_pushcclosure(L, l_inst_index, 3);       // -2 +-
     lua_rawset(L, -3);                          // -2
 
     lua_pushliteral(L, "__newindex");           // +1
     lua_pushlightuserdata(L, (void*) &cls);     // +1
-    lua_pushcclosure(L, l_inst_newindex, 1);    // 0 +-
+    lua_pushinteger(L, static_cast<lua_Integer>(ponder::detail::ObserverNotifier::generation())); // +1
+    lua_pushstring(L, cls.name().c_str());      // +1
+    lua_pushcclosure(L, l_inst_newindex, 3);    // -2 +-
+    lua_rawset(L, -3);                          // -2
+
+    lua_pushliteral(L, "__gc");                 // +1
+    lua_pushcfunction(L, l_inst_gc);            // +1
     lua_rawset(L, -3);                          // -2
 
     lua_pushglobaltable(L);                     // +1
@@ -466,8 +737,7 @@ void expose(lua_State *L, const Enum& enm, const IdRef name)
 int pushUserObject(lua_State *L, const UserObject& uobj)
 {
     Class const& cls = uobj.getClass();
-    void *ud = lua_newuserdata(L, sizeof(UserObject));  // +1
-    new(ud) UserObject(uobj);
+    impl::newInstance(L, uobj, false);          // +1
     
     // set instance metatable
     lua_pushglobaltable(L);                     // +1   _G
@@ -0,0 +1,226 @@
+/****************************************************************************
+**
+** This file is part of the Ponder library, formerly CAMP.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+/**
+ * \file
+ * \brief C interface to Ponder registered data, for foreign runtimes.
+ *
+ * Classes, properties and functions are accessed through opaque handles, which stay
+ * valid as long as the metaclass they come from is declared. Values cross the boundary
+ * as tagged scalars (ponder_value) and no C++ exception escapes: each entry point
+ * returns a ponder_status and ponder_last_error() describes the last failure.
+ *
+ * Strings and objects returned by value are kept in thread-local storage and are valid
+ * until the next call to this interface from the same thread.
+ */
+
+#ifndef PONDER_USES_PONDER_C_H
+#define PONDER_USES_PONDER_C_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32) || defined(__WIN32__)
+#   ifndef PONDER_STATIC
+#       ifdef PONDER_EXPORTS
+#           define PONDER_C_API __declspec(dllexport)
+#       else
+#           define PONDER_C_API __declspec(dllimport)
+#       endif
+#   else
+#       define PONDER_C_API
+#   endif
+#else
+#   define PONDER_C_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** \brief Opaque handle to a metaclass */
+typedef struct ponder_class ponder_class;
+
+/** \brief Opaque handle to a property */
+typedef struct ponder_property ponder_property;
+
+/** \brief Opaque handle to a function */
+typedef struct ponder_function ponder_function;
+
+/**
+ * \brief Result of the C interface calls
+ */
+typedef enum ponder_status
+{
+    PONDER_OK = 0,          /**< Success */
+    PONDER_NOT_FOUND,       /**< Class, property or function not found */
+    PONDER_BAD_TYPE,        /**< Value can't be converted to the requested type */
+    PONDER_BAD_ARGUMENT,    /**< Bad function argument, or too few of them */
+    PONDER_FORBIDDEN,       /**< Property not readable/writable, or function not callable */
+    PONDER_NULL_OBJECT,     /**< Null object or class handle */
+    PONDER_OUT_OF_RANGE,    /**< Index out of range */
+    PONDER_ERROR,           /**< Other Ponder error */
+    PONDER_UNKNOWN_ERROR    /**< Exception not raised by Ponder */
+} ponder_status;
+
+/**
+ * \brief Type tag of a ponder_value
+ */
+typedef enum ponder_type
+{
+    PONDER_TYPE_NONE = 0,   /**< No value */
+    PONDER_TYPE_BOOL,       /**< u.b */
+    PONDER_TYPE_INT,        /**< u.i (integers and enums) */
+    PONDER_TYPE_REAL,       /**< u.r */
+    PONDER_TYPE_STRING,     /**< u.s, not necessarily null-terminated */
+    PONDER_TYPE_OBJECT      /**< u.o, pointer to an instance and its metaclass */
+} ponder_type;
+
+/**
+ * \brief Tagged scalar passed to and returned from the C interface
+ */
+typedef struct ponder_value
+{
+    ponder_type type;
+    union
+    {
+        int32_t b;
+        int64_t i;
+        double r;
+        struct { const char* data; size_t size; } s;
+        struct { void* ptr; const ponder_class* cls; } o;
+    } u;
+} ponder_value;
+
+/**
+ * \brief Get the message of the last error raised in the calling thread
+ *
+ * \return Error message, empty if the last call succeeded
+ */
+PONDER_C_API const char* ponder_last_error(void);
+
+/**
+ * \brief Find a metaclass by name
+ *
+ * \param name Name of the metaclass
+ * \param cls Receives the metaclass handle
+ */
+PONDER_C_API ponder_status ponder_class_find(const char* name, const ponder_class** cls);
+
+/** \brief Get the name of a metaclass */
+PONDER_C_API const char* ponder_class_name(const ponder_class* cls);
+
+/** \brief Get the number of properties of a metaclass */
+PONDER_C_API size_t ponder_class_property_count(const ponder_class* cls);
+
+/** \brief Get the number of functions of a metaclass */
+PONDER_C_API size_t ponder_class_function_count(const ponder_class* cls);
+
+/**
+ * \brief Find a property of a metaclass by name, including inherited ones
+ *
+ * \param cls Metaclass
+ * \param name Name of the property
+ * \param property Receives the property handle
+ */
+PONDER_C_API ponder_status ponder_class_property(const ponder_class* cls, const char* name,
+                                                 const ponder_property** property);
+
+/**
+ * \brief Find a function of a metaclass by name, including inherited ones
+ *
+ * \param cls Metaclass
+ * \param name Name of the function
+ * \param function Receives the function handle
+ */
+PONDER_C_API ponder_status ponder_class_function(const ponder_class* cls, const char* name,
+                                                 const ponder_function** function);
+
+/** \brief Get the name of a property */
+PONDER_C_API const char* ponder_property_name(const ponder_property* property);
+
+/** \brief Get the type of the values of a property (PONDER_TYPE_NONE for arrays) */
+PONDER_C_API ponder_type ponder_property_type(const ponder_property* property);
+
+/**
+ * \brief Get the value of a property
+ *
+ * Data members of fundamental and string types are read directly from the object,
+ * without going through ponder::Value; strings then point into the object.
+ *
+ * \param property Property to read
+ * \param cls Metaclass of the object
+ * \param object Pointer to the object
+ * \param value Receives the value
+ */
+PONDER_C_API ponder_status ponder_property_get(const ponder_property* property,
+                                               const ponder_class* cls, void* object,
+                                               ponder_value* value);
+
+/**
+ * \brief Set the value of a property
+ *
+ * Data members of fundamental and string types are written directly to the object,
+ * without going through ponder::Value.
+ *
+ * \param property Property to write
+ * \param cls Metaclass of the object
+ * \param object Pointer to the object
+ * \param value New value
+ */
+PONDER_C_API ponder_status ponder_property_set(const ponder_property* property,
+                                               const ponder_class* cls, void* object,
+                                               const ponder_value* value);
+
+/** \brief Get the name of a function */
+PONDER_C_API const char* ponder_function_name(const ponder_function* function);
+
+/** \brief Get the number of parameters of a function, excluding the object */
+PONDER_C_API size_t ponder_function_param_count(const ponder_function* function);
+
+/**
+ * \brief Call a function
+ *
+ * \param function Function to call
+ * \param cls Metaclass of the object, ignored if object is null
+ * \param object Pointer to the object, or null to call a non-member function
+ * \param args Packed array of arguments
+ * \param argc Number of arguments
+ * \param result Receives the returned value, may be null
+ */
+PONDER_C_API ponder_status ponder_function_call(const ponder_function* function,
+                                                const ponder_class* cls, void* object,
+                                                const ponder_value* args, size_t argc,
+                                                ponder_value* result);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* PONDER_USES_PONDER_C_H */
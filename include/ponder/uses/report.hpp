@@ -35,7 +35,12 @@ namespace ponder {
 namespace uses {
 
 /**
- * \brief Expose a single Ponder metaclass to a Lua state
+ * \brief Print a report of all the registered metaclasses
+ *
+ * The memory used by each metaclass and a summary per kind of metadata are included (see
+ * metadataMemoryReport()). When Ponder is built with PONDER_INSTRUMENT, the counters and
+ * latencies of each member are included too (see ponder/instrument.hpp), and with
+ * PONDER_TRACK_INSTANCES the live instances of each metaclass (see ponder/instances.hpp).
  */
 void reportAll();
 
@@ -37,6 +37,8 @@
 
 #include <ponder/class.hpp>
 #include <ponder/constructor.hpp>
+#include <ponder/instrument.hpp>
+#include <ponder/trace.hpp>
 
 /**
  * \namespace ponder::runtime
@@ -50,16 +52,6 @@ static inline void destroy(const UserObject &uo);
 
 namespace detail {
 
-template <typename... A>
-struct ArgsBuilder { static Args makeArgs(A... args) { return {args...}; } };
-    
-template <>
-struct ArgsBuilder<Args> { static Args makeArgs(const Args& args) { return args; } };
-
-template <>
-struct ArgsBuilder<void> { static Args makeArgs(const Args& args) { return Args::empty; } };
-
-    
 struct UserObjectDeleter {
     void operator () (UserObject *uo) { destroy(*uo); }
 };
@@ -207,6 +199,30 @@ public:
     template <typename... A>
     Value call(const UserObject &obj, A... args);
     
+    /**
+     * \brief Call the function with a list of arguments
+     *
+     * Unlike the variadic version, this copies the list to insert the object.
+     *
+     * \param obj Object
+     * \param args Arguments to pass to the function
+     *
+     * \return Value returned by the function call
+     */
+    Value call(const UserObject &obj, const Args& args);
+
+    /**
+     * \brief Call the function with a list of arguments, without raising errors
+     *
+     * \param obj Object
+     * \param args Arguments to pass to the function
+     * \param result Receives the value returned by the function call
+     *
+     * \return False if the object is null, too few arguments are provided or one of them
+     *         can't be converted to the requested type; the function is not called then
+     */
+    bool tryCall(const UserObject &obj, const Args& args, Value& result);
+    
 private:
     
     const Function &m_func;
@@ -257,6 +273,26 @@ public:
     template <typename... A>
     Value call(A... args);
     
+    /**
+     * \brief Call the static function with a list of arguments
+     *
+     * \param args Arguments to pass to the function
+     *
+     * \return Value returned by the function call
+     */
+    Value call(const Args& args);
+
+    /**
+     * \brief Call the static function with a list of arguments, without raising errors
+     *
+     * \param args Arguments to pass to the function
+     * \param result Receives the value returned by the function call
+     *
+     * \return False if too few arguments are provided or one of them can't be converted to
+     *         the requested type; the function is not called then
+     */
+    bool tryCall(const Args& args, Value& result);
+    
 private:
     
     const Function &m_func;
@@ -295,13 +331,13 @@ static inline UniquePtr createUnique(const Class &cls, A... args)
 template <typename... A>
 static inline Value call(const Function &fn, const UserObject &obj, A... args)
 {
-    return ObjectCaller(fn).call(obj, detail::ArgsBuilder<A...>::makeArgs(args...));
+    return ObjectCaller(fn).call(obj, args...);
 }
 
 template <typename... A>
 static inline Value callStatic(const Function &fn, A... args)
 {
-    return FunctionCaller(fn).call(detail::ArgsBuilder<A...>::makeArgs(args...));
+    return FunctionCaller(fn).call(args...);
 }
 
 } // namespace runtime
@@ -323,25 +359,80 @@ inline UserObject ObjectFactory::create(A... args) const
 template <typename... A>
 inline Value ObjectCaller::call(const UserObject &obj, A... vargs)
 {
+    PONDER_INSTRUMENT_SCOPE(&m_func, Call);
+
     if (obj.pointer() == nullptr)
         PONDER_ERROR(NullObject(&obj.getClass()));
 
-    Args args(detail::ArgsBuilder<A...>::makeArgs(vargs...));
-    
+    PONDER_TRACE_SCOPE(Call, obj.getClass().name().data(), m_func.name().data());
+
     // Check the number of arguments
-    if (args.count() < m_func.paramCount())
-        PONDER_ERROR(NotEnoughArguments(m_func.name(), args.count(), m_func.paramCount()));
+    if (sizeof...(A) < m_func.paramCount())
+        PONDER_ERROR(NotEnoughArguments(m_func.name(), sizeof...(A), m_func.paramCount()));
+
+    // The object and the arguments stay on the stack, the call doesn't allocate
+    const Value values[] = {Value(obj), Value(vargs)...};
+
+    return m_caller->execute(Args::reference(values, 1 + sizeof...(A)));
+}
+
+inline Value ObjectCaller::call(const UserObject &obj, const Args& vargs)
+{
+    PONDER_INSTRUMENT_SCOPE(&m_func, Call);
+
+    if (obj.pointer() == nullptr)
+        PONDER_ERROR(NullObject(&obj.getClass()));
 
+    PONDER_TRACE_SCOPE(Call, obj.getClass().name().data(), m_func.name().data());
+
+    // Check the number of arguments
+    if (vargs.count() < m_func.paramCount())
+        PONDER_ERROR(NotEnoughArguments(m_func.name(), vargs.count(), m_func.paramCount()));
+
+    Args args(vargs);
     args.insert(0, obj);
 
     return m_caller->execute(args);
 }
+
+inline bool ObjectCaller::tryCall(const UserObject &obj, const Args& vargs, Value& result)
+{
+    if (obj.pointer() == nullptr || vargs.count() < m_func.paramCount())
+        return false;
+
+    Args args(vargs);
+    args.insert(0, obj);
+    if (!m_caller->accepts(args))
+        return false;
+
+    PONDER_INSTRUMENT_SCOPE(&m_func, Call);
+    PONDER_TRACE_SCOPE(Call, obj.getClass().name().data(), m_func.name().data());
+
+    result = m_caller->execute(args);
+    return true;
+}
     
 template <typename... A>
 inline Value FunctionCaller::call(A... vargs)
 {
-    Args args(detail::ArgsBuilder<A...>::makeArgs(vargs...));
-    
+    PONDER_INSTRUMENT_SCOPE(&m_func, Call);
+    PONDER_TRACE_SCOPE(Call, nullptr, m_func.name().data());
+
+    // Check the number of arguments
+    if (sizeof...(A) < m_func.paramCount())
+        PONDER_ERROR(NotEnoughArguments(m_func.name(), sizeof...(A), m_func.paramCount()));
+
+    // One more element, so that the array isn't empty when there are no arguments
+    const Value values[sizeof...(A) + 1] = {Value(vargs)...};
+
+    return m_caller->execute(Args::reference(values, sizeof...(A)));
+}
+
+inline Value FunctionCaller::call(const Args& args)
+{
+    PONDER_INSTRUMENT_SCOPE(&m_func, Call);
+    PONDER_TRACE_SCOPE(Call, nullptr, m_func.name().data());
+
     // Check the number of arguments
     if (args.count() < m_func.paramCount())
         PONDER_ERROR(NotEnoughArguments(m_func.name(), args.count(), m_func.paramCount()));
@@ -349,6 +440,18 @@ inline Value FunctionCaller::call(A... vargs)
     return m_caller->execute(args);
 }
 
+inline bool FunctionCaller::tryCall(const Args& args, Value& result)
+{
+    if (args.count() < m_func.paramCount() || !m_caller->accepts(args))
+        return false;
+
+    PONDER_INSTRUMENT_SCOPE(&m_func, Call);
+    PONDER_TRACE_SCOPE(Call, nullptr, m_func.name().data());
+
+    result = m_caller->execute(args);
+    return true;
+}
+
 } // namespace runtime
 } // namespace ponder
 
@@ -370,6 +473,8 @@ UserObject ObjectFactory::construct(const Args& args, void* ptr) const
         if (constructor.matches(args))
         {
             // Match found: use the constructor to create the new instance
+            PONDER_INSTRUMENT_SCOPE(&constructor, Create);
+            PONDER_TRACE_SCOPE(Construct, m_class.name().data(), nullptr);
             return constructor.create(ptr, args);
         }
     }
@@ -0,0 +1,197 @@
+/****************************************************************************
+**
+** This file is part of the Ponder library, formerly CAMP.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+
+
+#ifndef PONDER_VALIDATION_HPP
+#define PONDER_VALIDATION_HPP
+
+
+#include <ponder/config.hpp>
+#include <ponder/classget.hpp>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+
+namespace ponder
+{
+class Class;
+class Property;
+class UserObject;
+
+namespace detail
+{
+class ValidationProgram;
+}
+
+/**
+ * \brief Constraints which can be declared on properties, as tags
+ *
+ * | Constraint | Tag        | Tag value     | Properties                          |
+ * |------------|------------|---------------|-------------------------------------|
+ * | Min        | "min"      | number        | numbers: value >= min               |
+ * | Max        | "max"      | number        | numbers: value <= max               |
+ * | NonEmpty   | "nonEmpty" | none          | strings, arrays and dictionaries    |
+ * | Regex      | "regex"    | ECMAScript    | strings: the whole string matches   |
+ *
+ * No string matches a malformed pattern. Regex constraints are ignored when Ponder is
+ * built with PONDER_NO_EXCEPTIONS, as std::regex can't report a malformed pattern then.
+ *
+ * \sa Validator
+ */
+enum class Constraint
+{
+    Min,
+    Max,
+    NonEmpty,
+    Regex
+};
+
+/**
+ * \brief Get the tag declaring a constraint
+ *
+ * \param constraint Constraint
+ *
+ * \return Name of the tag ("min", "max", "nonEmpty" or "regex")
+ */
+PONDER_API const char* constraintTag(Constraint constraint);
+
+/**
+ * \brief Constraint broken by a property of an object
+ */
+struct Violation
+{
+    std::size_t index;          ///< Index of the object in the validated range, 0 for one object
+    const Property* property;   ///< Property breaking the constraint
+    Constraint constraint;      ///< Constraint broken
+};
+
+/**
+ * \brief Checks the constraints declared on the properties of a metaclass
+ *
+ * The constraints are declared as tags of the properties (see Constraint), and compiled
+ * once by the constructor into one rule per constrained property. Properties bound to a
+ * data member are read at their offset in the object, without going through a Value:
+ * numeric ranges are checked over a range of objects as a column, branch-free, and
+ * strings are checked in place. Other properties are read through Property::get.
+ *
+ * \code
+ * ponder::Class::declare<Record>("Record")
+ *     .property("age", &Record::age).tag("min", 0).tag("max", 150)
+ *     .property("name", &Record::name).tag("nonEmpty")
+ *     .property("code", &Record::code).tag("regex", "[A-Z]{3}[0-9]+");
+ *
+ * static const ponder::Validator validator(ponder::classByType<Record>());
+ *
+ * std::vector<ponder::Violation> violations;
+ * if (!validator.validate(records.data(), records.size(), violations))
+ *     for (const ponder::Violation& v : violations)
+ *         log(v.index, v.property->name(), ponder::constraintTag(v.constraint));
+ * \endcode
+ *
+ * Violations are reported in the order of the objects, they are not errors: validating
+ * only raises one when given objects of an unrelated class. Constraints which don't apply
+ * to the kind of a property, and tags whose value is computed from the object, are
+ * ignored. A Validator can be used from several threads at once, the metaclass must
+ * outlive it.
+ */
+class PONDER_API Validator
+{
+public:
+
+    /**
+     * \brief Compile the constraints declared on the properties of a metaclass
+     *
+     * \param metaclass Metaclass of the objects to validate
+     */
+    explicit Validator(const Class& metaclass);
+
+    /**
+     * \brief Get the metaclass of the validated objects
+     */
+    const Class& getClass() const;
+
+    /**
+     * \brief Get the number of constrained properties
+     */
+    std::size_t ruleCount() const;
+
+    /**
+     * \brief Check an object
+     *
+     * \param object Object to check, of the metaclass of the validator or derived from it
+     * \param violations Vector to append the violations to
+     *
+     * \return True if the object satisfies all the constraints
+     */
+    bool validate(const UserObject& object, std::vector<Violation>& violations) const;
+
+    /**
+     * \brief Check a contiguous range of objects
+     *
+     * \param objects Pointer to the first object
+     * \param count Number of objects
+     * \param violations Vector to append the violations to
+     *
+     * \return True if all the objects satisfy all the constraints
+     */
+    template <typename T>
+    bool validate(const T* objects, std::size_t count, std::vector<Violation>& violations) const
+    {
+        return validate(objects, count, sizeof(T), classByType<T>(), violations);
+    }
+
+    /**
+     * \brief Check a range of objects laid out at regular intervals
+     *
+     * \param objects Pointer to the first object
+     * \param count Number of objects
+     * \param stride Number of bytes from an object to the next
+     * \param objectClass Metaclass of the objects, the metaclass of the validator or
+     *        derived from it
+     * \param violations Vector to append the violations to
+     *
+     * \return True if all the objects satisfy all the constraints
+     *
+     * \throw ClassUnrelated \a objectClass is not derived from the validated metaclass
+     */
+    bool validate(const void* objects, std::size_t count, std::size_t stride,
+                  const Class& objectClass, std::vector<Violation>& violations) const;
+
+private:
+
+    const Class* m_class; ///< Metaclass of the validated objects
+    std::shared_ptr<const detail::ValidationProgram> m_program; ///< Compiled rules
+};
+
+} // namespace ponder
+
+
+#endif // PONDER_VALIDATION_HPP
@@ -165,6 +165,16 @@ public:
     template <typename T>
     bool isCompatible() const;
 
+    /**
+     * \brief Convert the value to the type T, without raising errors
+     *
+     * \param result Receives the converted value, left untouched on failure
+     *
+     * \return True if the conversion succeeded, false if the value is not convertible to T
+     */
+    template <typename T>
+    bool tryTo(T& result) const;
+
     /**
      * \brief Visit the value with a unary visitor
      *
@@ -261,5 +271,20 @@ PONDER_API std::ostream& operator<<(std::ostream& stream, const Value& value);
 
 #include <ponder/value.inl>
 
+namespace std
+{
+/**
+ * \brief Specialization of std::hash for ponder::Value, consistent with Value::operator ==
+ */
+template <>
+struct hash<ponder::Value>
+{
+    std::size_t operator()(const ponder::Value& value) const
+    {
+        return value.visit(ponder::detail::HashVisitor());
+    }
+};
+}
+
 
 #endif // PONDER_VALUE_HPP
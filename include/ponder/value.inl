@@ -74,40 +74,23 @@ Value::Value(const T& val)
 template <typename T>
 T Value::to() const
 {
-    try
-    {
-        return detail::ValueTo<T>::convert(*this);
-    }
-    catch (detail::bad_conversion&)
-    {
-        PONDER_ERROR(BadType(kind(), mapType<T>()));
-    }
+    return detail::ValueTo<T>::convert(*this);
 }
 
 template <typename T>
 T& Value::ref()
 {
-    try
-    {
-        return m_value.get<T>();
-    }
-    catch (detail::bad_conversion&)
-    {
+    if (!m_value.is<T>())
         PONDER_ERROR(BadType(kind(), mapType<T>()));
-    }
+    return m_value.get_unchecked<T>();
 }
 
 template <typename T>
 const T& Value::cref() const
 {
-    try
-    {
-        return m_value.get<T>();
-    }
-    catch (detail::bad_conversion&)
-    {
+    if (!m_value.is<T>())
         PONDER_ERROR(BadType(kind(), mapType<T>()));
-    }
+    return m_value.get_unchecked<T>();
 }
 
 
@@ -120,15 +103,17 @@ Value::operator T() const
 template <typename T>
 bool Value::isCompatible() const
 {
-    try
-    {
-        to<T>();
-        return true;
-    }
-    catch (std::exception&)
-    {
+    return visit(detail::CompatibleVisitor<T>());
+}
+
+template <typename T>
+bool Value::tryTo(T& result) const
+{
+    if (!isCompatible<T>())
         return false;
-    }
+
+    result = to<T>();
+    return true;
 }
 
 template <typename T>
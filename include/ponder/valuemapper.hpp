@@ -36,6 +36,7 @@
 #include <ponder/enumobject.hpp>
 #include <ponder/userobject.hpp>
 #include <ponder/arraymapper.hpp>
+#include <ponder/mapmapper.hpp>
 #include <ponder/errors.hpp>
 #include <ponder/detail/util.hpp>
 
@@ -71,6 +72,48 @@ ValueKind mapType()
     return ponder_ext::ValueMapper<typename detail::RawType<T>::Type>::kind;
 }
 
+namespace detail
+{
+/**
+ * \brief Convert a string to a number, or raise BadType if it isn't one
+ */
+template <typename T>
+T convertString(const String& source)
+{
+    T result;
+    if (!conv(source, result))
+        PONDER_ERROR(BadType(ValueKind::String, mapType<T>()));
+    return result;
+}
+
+/**
+ * \brief Convert a string to the value of the enum T, as a name (or names of flags "A|B")
+ *        or as a number
+ *
+ * \return True if the string is a valid value of T
+ */
+template <typename T>
+bool parseEnum(const String& source, Enum::EnumValue& value)
+{
+    // Get the metaenum of T, if any
+    const Enum* metaenum = enumByTypeSafe<T>();
+
+    // First try as a name, or names of flags "A|B"
+    if (metaenum && (metaenum->isFlags() ? metaenum->tryParseFlags(source, value)
+                                         : metaenum->tryValue(source, value)))
+        return true;
+
+    // Then try as a number
+    long number;
+    if (!conv(source, number))
+        return false;
+    value = number;
+    return !metaenum || metaenum->hasValue(value)
+        || (metaenum->isFlags() && (value & ~metaenum->flagMask()) == 0);
+}
+
+} // namespace detail
+
 } // namespace ponder
 
 
@@ -176,7 +219,8 @@ struct ValueMapper<bool>
     static bool from(bool source)                  {return source;}
     static bool from(long source)                  {return source != 0;}
     static bool from(double source)                {return source != 0.;}
-    static bool from(const ponder::String& source) {return ponder::detail::convert<bool>(source);}
+    static bool from(const ponder::String& source)
+        {return ponder::detail::convertString<bool>(source);}
     static bool from(const ponder::EnumObject& source) {return source.value() != 0;}
     static bool from(const ponder::UserObject& source) {return source.pointer() != nullptr;}
 };
@@ -198,7 +242,7 @@ struct ValueMapper<T,
     static T from(bool source)                    {return static_cast<T>(source);}
     static T from(long source)                    {return static_cast<T>(source);}
     static T from(double source)                  {return static_cast<T>(source);}
-    static T from(const ponder::String& source)   {return ponder::detail::convert<T>(source);}
+    static T from(const ponder::String& source)   {return ponder::detail::convertString<T>(source);}
     static T from(const ponder::EnumObject& source)
         {return static_cast<T>(source.value());}
     static T from(const ponder::UserObject&)
@@ -222,7 +266,7 @@ struct ValueMapper<T,
     static T from(bool source)                    {return static_cast<T>(source);}
     static T from(long source)                    {return static_cast<T>(source);}
     static T from(double source)                  {return static_cast<T>(source);}
-    static T from(const ponder::String& source)   {return ponder::detail::convert<T>(source);}
+    static T from(const ponder::String& source)   {return ponder::detail::convertString<T>(source);}
     static T from(const ponder::EnumObject& source) {return static_cast<T>(source.value());}
     static T from(const ponder::UserObject&)
         {PONDER_ERROR(ponder::BadType(ponder::ValueKind::User, ponder::ValueKind::Real));}
@@ -246,7 +290,15 @@ struct ValueMapper<ponder::String>
     static ponder::String from(const ponder::String& source)
         {return source;}
     static ponder::String from(const ponder::EnumObject& source)
-        {return ponder::String(source.name());}
+    {
+        const ponder::Enum& metaenum = source.getEnum();
+        if (!metaenum.isFlags())
+            return ponder::String(source.name());
+
+        ponder::String text;
+        metaenum.formatFlags(source.value(), text);
+        return text;
+    }
     static ponder::String from(const ponder::UserObject&)
         {PONDER_ERROR(ponder::BadType(ponder::ValueKind::User, ponder::ValueKind::String));}
 };
@@ -268,6 +320,16 @@ struct ValueMapper<T,
     static const ponder::ValueKind kind = ponder::ValueKind::Array;
 };
 
+/**
+ * Specialization of ValueMapper for associative containers.
+ * No conversion allowed, only type mapping is provided.
+ */
+template <typename T>
+struct ValueMapper<T, typename std::enable_if<ponder_ext::MapMapper<T>::isMap>::type>
+{
+    static const ponder::ValueKind kind = ponder::ValueKind::Dictionary;
+};
+
 /**
  * Specializations of ValueMapper for char arrays.
  * Conversion to char[N] is disabled (can't return an array).
@@ -311,20 +373,10 @@ struct ValueMapper<T,
     // we try two different conversions (as a name and as a value)
     static T from(const ponder::String& source)
     {
-        // Get the metaenum of T, if any
-        const ponder::Enum* metaenum = ponder::enumByTypeSafe<T>();
-
-        // First try as a name
-        if (metaenum && metaenum->hasName(source))
-            return static_cast<T>(metaenum->value(source));
-
-        // Then try as a number
-        long value = ponder::detail::convert<long>(source);
-        if (!metaenum || metaenum->hasValue(value))
-            return static_cast<T>(value);
-
-        // Not a valid enum name or number: throw an error
-        PONDER_ERROR(ponder::BadType(ponder::ValueKind::String, ponder::ValueKind::Enum));
+        ponder::Enum::EnumValue value;
+        if (!ponder::detail::parseEnum<T>(source, value))
+            PONDER_ERROR(ponder::BadType(ponder::ValueKind::String, ponder::ValueKind::Enum));
+        return static_cast<T>(value);
     }
 };
 
@@ -0,0 +1,147 @@
+/****************************************************************************
+**
+** This file is part of the Ponder library, formerly CAMP.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+
+
+#include <ponder/allocator.hpp>
+#include <ponder/scratch.hpp>
+#include <cstdlib>
+#include <new>
+
+
+namespace ponder
+{
+namespace
+{
+void* defaultAllocate(std::size_t size, void*)
+{
+    return ::operator new(size, std::nothrow);
+}
+
+void defaultDeallocate(void* pointer, std::size_t, void*)
+{
+    ::operator delete(pointer);
+}
+
+// Constant-initialized, so that it can be used during static initialization
+Allocator g_allocator = {&defaultAllocate, &defaultDeallocate, nullptr};
+
+} // anonymous namespace
+
+Allocator defaultAllocator()
+{
+    return Allocator{&defaultAllocate, &defaultDeallocate, nullptr};
+}
+
+const Allocator& allocator()
+{
+    return g_allocator;
+}
+
+void setAllocator(const Allocator& allocator)
+{
+    g_allocator = allocator;
+}
+
+AllocationCounter::AllocationCounter()
+    : m_previous(g_allocator)
+    , m_allocations(0)
+    , m_deallocations(0)
+    , m_bytes(0)
+{
+    g_allocator = Allocator{&AllocationCounter::allocate, &AllocationCounter::deallocate, this};
+}
+
+AllocationCounter::~AllocationCounter()
+{
+    g_allocator = m_previous;
+}
+
+void AllocationCounter::reset()
+{
+    m_allocations = 0;
+    m_deallocations = 0;
+    m_bytes = 0;
+}
+
+void* AllocationCounter::allocate(std::size_t size, void* context)
+{
+    AllocationCounter& counter = *static_cast<AllocationCounter*>(context);
+    counter.m_allocations.fetch_add(1, std::memory_order_relaxed);
+    counter.m_bytes.fetch_add(size, std::memory_order_relaxed);
+    return counter.m_previous.allocate(size, counter.m_previous.context);
+}
+
+void AllocationCounter::deallocate(void* pointer, std::size_t size, void* context)
+{
+    AllocationCounter& counter = *static_cast<AllocationCounter*>(context);
+    counter.m_deallocations.fetch_add(1, std::memory_order_relaxed);
+    counter.m_previous.deallocate(pointer, size, counter.m_previous.context);
+}
+
+namespace detail
+{
+void* allocate(std::size_t size)
+{
+    void* pointer = g_allocator.allocate(size, g_allocator.context);
+    if (!pointer)
+    {
+#if PONDER_NO_EXCEPTIONS
+        std::abort();
+#else
+        throw std::bad_alloc();
+#endif
+    }
+    return pointer;
+}
+
+void deallocate(void* pointer, std::size_t size)
+{
+    if (pointer)
+        g_allocator.deallocate(pointer, size, g_allocator.context);
+}
+
+void* allocateTemporary(std::size_t size)
+{
+    if (void* scratch = scratchAllocate(size))
+        return scratch;
+
+    return allocate(size);
+}
+
+void deallocateTemporary(void* pointer, std::size_t size)
+{
+    // Blocks of the scratch arena are released when their scope is rewound
+    if (pointer && !scratchOwns(pointer))
+        g_allocator.deallocate(pointer, size, g_allocator.context);
+}
+
+} // namespace detail
+
+} // namespace ponder
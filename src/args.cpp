@@ -37,18 +37,52 @@ namespace ponder
     
 const Args Args::empty;
 
+Args::Args(const Args& other)
+    : m_values(other.m_referenced
+               ? decltype(m_values)(other.m_referenced, other.m_referenced + other.m_referencedCount)
+               : other.m_values)
+{
+}
+
+Args::Args(Args&& other)
+    : m_values(std::move(other.m_values))
+    , m_referenced(other.m_referenced)
+    , m_referencedCount(other.m_referencedCount)
+{
+    other.m_referenced = nullptr;
+}
+
+Args& Args::operator=(const Args& other)
+{
+    if (this != &other)
+    {
+        Args copy(other);
+        m_values.swap(copy.m_values);
+        m_referenced = nullptr;
+    }
+    return *this;
+}
+
+Args Args::reference(const Value* values, std::size_t count)
+{
+    Args args;
+    args.m_referenced = values;
+    args.m_referencedCount = count;
+    return args;
+}
+
 std::size_t Args::count() const
 {
-    return m_values.size();
+    return m_referenced ? m_referencedCount : m_values.size();
 }
 
 const Value& Args::operator[](std::size_t index) const
 {
     // Make sure that the index is not out of range
-    if (index >= m_values.size())
-        PONDER_ERROR(OutOfRange(index, m_values.size()));
+    if (index >= count())
+        PONDER_ERROR(OutOfRange(index, count()));
 
-    return m_values[index];
+    return m_referenced ? m_referenced[index] : m_values[index];
 }
 
 Args Args::operator+(const Value& arg) const
@@ -61,6 +95,7 @@ Args Args::operator+(const Value& arg) const
 
 Args& Args::operator+=(const Value& arg)
 {
+    own();
     m_values.push_back(arg);
 
     return *this;
@@ -68,8 +103,18 @@ Args& Args::operator+=(const Value& arg)
 
 Args& Args::insert(std::size_t index, const Value& v)
 {
+    own();
     m_values.insert(m_values.begin() + index, v);
     return *this;
 }
 
+void Args::own()
+{
+    if (m_referenced)
+    {
+        m_values.assign(m_referenced, m_referenced + m_referencedCount);
+        m_referenced = nullptr;
+    }
+}
+
 } // namespace ponder
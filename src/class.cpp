@@ -38,6 +38,7 @@ namespace ponder
 Class::Class(IdRef name)
 : m_sizeof(0)
 , m_id(name)
+, m_seqLockClass(nullptr)
 {
 }    
     
@@ -51,6 +52,11 @@ std::size_t Class::sizeOf() const
     return m_sizeof;
 }
 
+Concurrency Class::concurrency() const
+{
+    return m_seqLockClass ? Concurrency::SeqLock : Concurrency::None;
+}
+
 std::size_t Class::constructorCount() const
 {
     return m_constructors.size();
@@ -72,83 +78,119 @@ const Class& Class::base(std::size_t index) const
 
 std::size_t Class::functionCount() const
 {
-    return m_functions.size();
+    return m_functionIndex.size();
 }
 
 bool Class::hasFunction(IdRef id) const
 {
-    return m_functions.containsKey(id);
+    return m_functionIndex.find(id) != nullptr;
 }
 
 const Function& Class::function(std::size_t index) const
 {
     // Make sure that the index is not out of range
-    if (index >= m_functions.size())
-        PONDER_ERROR(OutOfRange(index, m_functions.size()));
+    if (index >= m_functionIndex.size())
+        PONDER_ERROR(OutOfRange(index, m_functionIndex.size()));
 
-    FunctionTable::const_iterator it = m_functions.begin();
-    std::advance(it, index);
-
-    return *it->second;
+    return *m_functionIndex[index].member;
 }
 
 const Function& Class::function(IdRef id) const
 {
-    FunctionTable::const_iterator it;
-    if (!m_functions.tryFind(id, it))
+    const Function* function = m_functionIndex.find(id);
+    if (!function)
     {
         PONDER_ERROR(FunctionNotFound(id, name()));
     }
 
-    return *it->second;
+    return *function;
+}
+
+std::size_t Class::eventCount() const
+{
+    return m_eventIndex.size();
+}
+
+bool Class::hasEvent(IdRef id) const
+{
+    return m_eventIndex.find(id) != nullptr;
+}
+
+const Event& Class::event(std::size_t index) const
+{
+    // Make sure that the index is not out of range
+    if (index >= m_eventIndex.size())
+        PONDER_ERROR(OutOfRange(index, m_eventIndex.size()));
+
+    return *m_eventIndex[index].member;
+}
+
+const Event& Class::event(IdRef id) const
+{
+    const Event* event = m_eventIndex.find(id);
+    if (!event)
+    {
+        PONDER_ERROR(EventNotFound(id, name()));
+    }
+
+    return *event;
 }
 
 std::size_t Class::propertyCount() const
 {
-    return m_properties.size();
+    return m_propertyIndex.size();
 }
 
 bool Class::hasProperty(IdRef id) const
 {
-    return m_properties.containsKey(id);
+    return m_propertyIndex.find(id) != nullptr;
 }
 
 const Property& Class::property(std::size_t index) const
 {
     // Make sure that the index is not out of range
-    if (index >= m_properties.size())
-        PONDER_ERROR(OutOfRange(index, m_properties.size()));
+    if (index >= m_propertyIndex.size())
+        PONDER_ERROR(OutOfRange(index, m_propertyIndex.size()));
 
-    PropertyTable::const_iterator it = m_properties.begin();
-    std::advance(it, index);
-
-    return *it->second;
+    return *m_propertyIndex[index].member;
 }
 
 const Property& Class::property(IdRef id) const
 {
-    PropertyTable::const_iterator it;
-    if (!m_properties.tryFind(id, it))
+    const Property* property = m_propertyIndex.find(id);
+    if (!property)
     {
         PONDER_ERROR(PropertyNotFound(id, name()));
     }
 
-    return *it->second;
+    return *property;
+}
+
+std::shared_ptr<const std::vector<bool>> Class::propertiesWithTag(const Value& id) const
+{
+    TagIndex::const_iterator it = m_tagIndex.find(id);
+    return it != m_tagIndex.end() ? it->second : m_untagged;
 }
 
 void Class::visit(ClassVisitor& visitor) const
 {
     // First visit properties
-    for (PropertyTable::pair_t const& prop : m_properties)
+    for (auto const& prop : m_propertyIndex.getIterator())
     {
         prop.value()->accept(visitor);
     }
 
     // Then visit functions
-    for (FunctionTable::pair_t const& func : m_functions)
+    for (auto const& func : m_functionIndex.getIterator())
     {
         func.value()->accept(visitor);
     }
+
+    // And finally events
+    for (auto const& event : m_eventIndex.getIterator())
+    {
+        event.value()->accept(visitor);
+    }
 }
 
 void* Class::applyOffset(void* pointer, const Class& target) const
@@ -157,18 +199,36 @@ void* Class::applyOffset(void* pointer, const Class& target) const
     if (!pointer)
         return pointer;
 
+    if (!tryApplyOffset(pointer, target))
+    {
+        // No match found, target is not a base class nor a derived class of this
+        PONDER_ERROR(ClassUnrelated(name(), target.name()));
+    }
+    return pointer;
+}
+
+bool Class::tryApplyOffset(void*& pointer, const Class& target) const
+{
     // Check target as a base class of this
     int offset = baseOffset(target);
     if (offset != -1)
-        return static_cast<void*>(static_cast<char*>(pointer) + offset);
+    {
+        // Leave null pointers null
+        if (pointer)
+            pointer = static_cast<char*>(pointer) + offset;
+        return true;
+    }
 
     // Check target as a derived class of this
     offset = target.baseOffset(*this);
     if (offset != -1)
-        return static_cast<void*>(static_cast<char*>(pointer) - offset);
+    {
+        if (pointer)
+            pointer = static_cast<char*>(pointer) - offset;
+        return true;
+    }
 
-    // No match found, target is not a base class nor a derived class of this
-    PONDER_ERROR(ClassUnrelated(name(), target.name()));
+    return false;
 }
 
 bool Class::operator == (const Class& other) const
@@ -198,4 +258,43 @@ int Class::baseOffset(const Class& base) const
     return -1;
 }
 
+void Class::membersChanged()
+{
+    // Inherited members are not copied, the index shares the flattened indices of the bases
+    std::vector<const detail::MemberIndex<Property>*> propertyBases;
+    std::vector<const detail::MemberIndex<Function>*> functionBases;
+    std::vector<const detail::MemberIndex<Event>*> eventBases;
+    for (auto const& b : m_bases)
+    {
+        propertyBases.push_back(&b.base->m_propertyIndex);
+        functionBases.push_back(&b.base->m_functionIndex);
+        eventBases.push_back(&b.base->m_eventIndex);
+    }
+
+    m_propertyIndex.build(m_properties, propertyBases);
+    m_functionIndex.build(m_functions, functionBases);
+    m_eventIndex.build(m_events, eventBases);
+
+    // Index the tags of the properties of this class only: the bitsets are replaced, not
+    // modified, so the ones already returned by propertiesWithTag stay valid
+    const std::size_t count = m_propertyIndex.size();
+    std::unordered_map<Value, std::vector<bool>> tags;
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        const Property& property = *m_propertyIndex[index].member;
+        for (std::size_t i = 0; i < property.tagCount(); ++i)
+        {
+            std::vector<bool>& properties = tags[property.tagId(i)];
+            properties.resize(count);
+            properties[index] = true;
+        }
+    }
+
+    m_tagIndex.clear();
+    for (auto& entry : tags)
+        m_tagIndex.emplace(entry.first, std::make_shared<const std::vector<bool>>(
+                                            std::move(entry.second)));
+    m_untagged = std::make_shared<const std::vector<bool>>(count);
+}
+
 } // namespace ponder
@@ -0,0 +1,83 @@
+/****************************************************************************
+**
+** This file is part of the Ponder library, formerly CAMP.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+
+#include <ponder/detail/classcache.hpp>
+#include <ponder/detail/classmanager.hpp>
+#include <ponder/detail/enummanager.hpp>
+#include <mutex>
+
+
+namespace ponder
+{
+namespace detail
+{
+namespace
+{
+// Caches are resolved one at a time: a pointer and its generation are always stored by the
+// same writer, so a reader never pairs the pointer of a generation with a later generation
+std::mutex& resolveMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+}
+
+template <>
+const Class* MetaCache<Class>::resolve(const char* id)
+{
+    std::lock_guard<std::mutex> lock(resolveMutex());
+
+    // The caller computed the id first, which may have declared the class (auto types)
+    const std::size_t generation = ObserverNotifier::generation();
+    const Class* cls = ClassManager::instance().getByIdSafe(id);
+
+    m_meta.store(cls, std::memory_order_relaxed);
+    m_generation.store(generation, std::memory_order_release);
+
+    return cls;
+}
+
+template <>
+const Enum* MetaCache<Enum>::resolve(const char* id)
+{
+    std::lock_guard<std::mutex> lock(resolveMutex());
+
+    const std::size_t generation = ObserverNotifier::generation();
+    const Enum* metaenum = EnumManager::instance().getByIdSafe(id);
+
+    m_meta.store(metaenum, std::memory_order_relaxed);
+    m_generation.store(generation, std::memory_order_release);
+
+    return metaenum;
+}
+
+} // namespace detail
+
+} // namespace ponder
@@ -40,4 +40,9 @@ void* classCast(void* pointer, const Class& sourceClass, const Class& targetClas
     return sourceClass.applyOffset(pointer, targetClass);
 }
 
+bool tryClassCast(void*& pointer, const Class& sourceClass, const Class& targetClass)
+{
+    return sourceClass.tryApplyOffset(pointer, targetClass);
+}
+
 } // namespace ponder
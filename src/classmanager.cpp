@@ -53,7 +53,7 @@ Class& ClassManager::addClass(IdRef id)
     Class *newClass = new Class(id);
 
     // Insert it into the table
-    m_classes.insert(std::make_pair(Id(id), newClass));
+    m_classes.insert(std::make_pair(string_view(newClass->name()), newClass));
 
     // Notify observers
     notifyClassAdded(*newClass);
@@ -75,8 +75,12 @@ void ClassManager::removeClass(IdRef id)
     // Notify observers
     notifyClassRemoved(*classPtr);
         
-    delete classPtr;
+    // The key views the name of the metaclass: erase it first
     m_classes.erase(it);
+    delete classPtr;
+
+    // Only now, so that nothing resolved by the observers keeps the deleted pointer
+    nextGeneration();
 }
     
 std::size_t ClassManager::count() const
@@ -113,7 +117,7 @@ const Class* ClassManager::getByIdSafe(IdRef id) const
 
 bool ClassManager::classExists(IdRef id) const
 {
-    return m_classes.find(Id(id)) != m_classes.end();
+    return m_classes.find(id) != m_classes.end();
 }
 
 ClassManager::ClassManager()
@@ -129,6 +133,7 @@ ClassManager::~ClassManager()
         notifyClassRemoved(*classPtr);
         delete classPtr;
     }
+    nextGeneration();
 }
 
 } // namespace ponder
@@ -54,6 +54,11 @@ void ClassVisitor::visit(const ArrayProperty&)
     // The default implementation does nothing
 }
 
+void ClassVisitor::visit(const DictionaryProperty&)
+{
+    // The default implementation does nothing
+}
+
 void ClassVisitor::visit(const EnumProperty&)
 {
     // The default implementation does nothing
@@ -69,6 +74,11 @@ void ClassVisitor::visit(const Function&)
     // The default implementation does nothing
 }
 
+void ClassVisitor::visit(const Event&)
+{
+    // The default implementation does nothing
+}
+
 ClassVisitor::ClassVisitor()
 {
     // Nothing to do
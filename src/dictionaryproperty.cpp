@@ -0,0 +1,166 @@
+/****************************************************************************
+**
+** This file is part of the Ponder library, formerly CAMP.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+
+
+#include <ponder/dictionaryproperty.hpp>
+#include <ponder/classvisitor.hpp>
+
+
+namespace ponder
+{
+
+DictionaryProperty::DictionaryProperty(IdRef name, ValueKind keyType, ValueKind elementType)
+    : Property(name, ValueKind::Dictionary)
+    , m_keyType(keyType)
+    , m_elementType(elementType)
+{
+}
+
+DictionaryProperty::~DictionaryProperty()
+{
+}
+
+ValueKind DictionaryProperty::keyType() const
+{
+    return m_keyType;
+}
+
+ValueKind DictionaryProperty::elementType() const
+{
+    return m_elementType;
+}
+
+std::size_t DictionaryProperty::size(const UserObject& object) const
+{
+    // Check if the property is readable
+    if (!readable(object))
+        PONDER_ERROR(ForbiddenRead(name()));
+
+    return getSize(object);
+}
+
+bool DictionaryProperty::contains(const UserObject& object, const Value& key) const
+{
+    // Check if the property is readable
+    if (!readable(object))
+        PONDER_ERROR(ForbiddenRead(name()));
+
+    Value value;
+    return findElement(object, key, value);
+}
+
+Value DictionaryProperty::get(const UserObject& object, const Value& key) const
+{
+    // Check if the property is readable
+    if (!readable(object))
+        PONDER_ERROR(ForbiddenRead(name()));
+
+    // Make sure that the key exists
+    Value value;
+    if (!findElement(object, key, value))
+    {
+        PONDER_ERROR(KeyNotFound(key.isCompatible<String>() ? key.to<String>() : String("?"),
+                                 name()));
+    }
+
+    return value;
+}
+
+void DictionaryProperty::set(const UserObject& object, const Value& key, const Value& value) const
+{
+    // Check if the property is writable
+    if (!writable(object))
+        PONDER_ERROR(ForbiddenWrite(name()));
+
+    setElement(object, key, value);
+}
+
+bool DictionaryProperty::insert(const UserObject& object, const Value& key) const
+{
+    // Check if the property is writable
+    if (!writable(object))
+        PONDER_ERROR(ForbiddenWrite(name()));
+
+    return insertElement(object, key);
+}
+
+bool DictionaryProperty::remove(const UserObject& object, const Value& key) const
+{
+    // Check if the property is writable
+    if (!writable(object))
+        PONDER_ERROR(ForbiddenWrite(name()));
+
+    return removeElement(object, key);
+}
+
+bool DictionaryProperty::next(const UserObject& object, Value& key, Value& value) const
+{
+    // Check if the property is readable
+    if (!readable(object))
+        PONDER_ERROR(ForbiddenRead(name()));
+
+    return nextElement(object, key, value);
+}
+
+void DictionaryProperty::forEach(const UserObject& object, const ElementVisitor& visitor) const
+{
+    // Check if the property is readable
+    if (!readable(object))
+        PONDER_ERROR(ForbiddenRead(name()));
+
+    visitElements(object, visitor);
+}
+
+void DictionaryProperty::accept(ClassVisitor& visitor) const
+{
+    visitor.visit(*this);
+}
+
+Value DictionaryProperty::getValue(const UserObject&) const
+{
+    PONDER_ERROR(ForbiddenRead(name()));
+}
+
+void DictionaryProperty::setValue(const UserObject&, const Value&) const
+{
+    PONDER_ERROR(ForbiddenWrite(name()));
+}
+
+bool DictionaryProperty::canGetValue(const UserObject&) const
+{
+    return false;
+}
+
+bool DictionaryProperty::canSetValue(const UserObject&, const Value&) const
+{
+    return false;
+}
+
+} // namespace ponder
@@ -30,14 +30,174 @@
 
 #include <ponder/enum.hpp>
 #include <ponder/errors.hpp>
+#include <algorithm>
+#include <cstring>
 
 
+namespace
+{
+    using ponder::detail::hashName;
+
+    // Fibonacci hash of a value
+    std::size_t hashValue(ponder::Enum::EnumValue value)
+    {
+        return static_cast<std::size_t>(
+            (static_cast<std::uint64_t>(value) * 0x9E3779B97F4A7C15ULL) >> 32);
+    }
+
+}
+
 namespace ponder
 {
 
 Enum::Enum(IdRef name)
     :   m_name(name)
+    ,   m_minValue(0)
+    ,   m_denseValues(true)
+    ,   m_flags(false)
+    ,   m_flagMask(0)
+{
+}
+
+void Enum::addValue(IdRef name, EnumValue value)
+{
+    // The indices are rebuilt once, when the EnumBuilder is destroyed
+    m_enums.insert(name, value);
+}
+
+void Enum::buildIndex()
+{
+    const std::size_t count = m_enums.size();
+
+    m_nameIndex.build(count, [this](std::size_t i)
+    {
+        const Id& name = m_enums.at(i)->first;
+        return hashName(name.data(), name.size());
+    });
+
+    m_valueIndex.clear();
+    m_valueHash.clear();
+    m_minValue = 0;
+    m_denseValues = true;
+    m_flagMask = 0;
+    m_bitNames.clear();
+    if (count == 0)
+        return;
+
+    for (auto&& pair : m_enums)
+        m_flagMask |= pair.second;
+
+    // For flags, find the pairs naming single bits
+    if (m_flags)
+    {
+        m_bitNames.assign(sizeof(EnumValue) * 8, 0);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const unsigned long bits = static_cast<unsigned long>(m_enums.at(i)->second);
+            if (bits != 0 && (bits & (bits - 1)) == 0)
+            {
+                std::size_t bit = 0;
+                while (!(bits & (1UL << bit)))
+                    ++bit;
+                m_bitNames[bit] = static_cast<std::uint32_t>(i + 1);
+            }
+        }
+    }
+
+    EnumValue maxValue = m_enums.begin()->second;
+    m_minValue = maxValue;
+    for (auto&& pair : m_enums)
+    {
+        m_minValue = std::min(m_minValue, pair.second);
+        maxValue = std::max(maxValue, pair.second);
+    }
+
+    // Use a direct-indexed table if the values are dense enough, a hash table otherwise
+    const unsigned long range =
+        static_cast<unsigned long>(maxValue) - static_cast<unsigned long>(m_minValue);
+    m_denseValues = range < count * 2 + 16;
+    if (m_denseValues)
+    {
+        m_valueIndex.assign(range + 1, 0);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const EnumValue value = m_enums.at(i)->second;
+            m_valueIndex[static_cast<unsigned long>(value) - static_cast<unsigned long>(m_minValue)]
+                = static_cast<std::uint32_t>(i + 1);
+        }
+    }
+    else
+    {
+        m_valueHash.build(count, [this](std::size_t i)
+        {
+            return hashValue(m_enums.at(i)->second);
+        });
+    }
+}
+
+std::size_t Enum::findName(IdRef name) const
+{
+    return findName(name.data(), name.size());
+}
+
+std::size_t Enum::findName(const char* name, std::size_t length) const
+{
+    const std::size_t index = m_nameIndex.find(hashName(name, length), [&](std::size_t i)
+    {
+        const Id& key = m_enums.at(i)->first;
+        return key.size() == length && key.compare(0, length, name, length) == 0;
+    });
+
+    return index == detail::HashIndex::npos ? m_enums.size() : index;
+}
+
+template <typename F>
+bool Enum::forEachFlagName(EnumValue value, F f) const
 {
+    // A named value (including combinations and 0) is written as is
+    const std::size_t index = findValue(value);
+    if (index != m_enums.size())
+    {
+        f(m_enums.at(index)->first);
+        return true;
+    }
+
+    if (!m_flags)
+        return false;
+
+    // Visit the bits set, from the lowest
+    for (unsigned long bits = static_cast<unsigned long>(value); bits; bits &= bits - 1)
+    {
+        const unsigned long lowest = bits & (~bits + 1);
+        std::size_t bit = 0;
+        while ((1UL << bit) != lowest)
+            ++bit;
+
+        if (!m_bitNames[bit])
+            return false;
+        f(m_enums.at(m_bitNames[bit] - 1)->first);
+    }
+
+    return true;
+}
+
+std::size_t Enum::findValue(EnumValue value) const
+{
+    if (m_denseValues)
+    {
+        const unsigned long offset =
+            static_cast<unsigned long>(value) - static_cast<unsigned long>(m_minValue);
+        if (offset < m_valueIndex.size() && m_valueIndex[offset])
+            return m_valueIndex[offset] - 1;
+        return m_enums.size();
+    }
+
+    const std::size_t index = m_valueHash.find(hashValue(value), [&](std::size_t i)
+    {
+        return m_enums.at(i)->second == value;
+    });
+
+    return index == detail::HashIndex::npos ? m_enums.size() : index;
 }
 
 IdReturn Enum::name() const
@@ -62,32 +222,143 @@ Enum::Pair Enum::pair(std::size_t index) const
 
 bool Enum::hasName(IdRef name) const
 {
-    return m_enums.containsKey(name);
+    return findName(name) != m_enums.size();
 }
 
 bool Enum::hasValue(EnumValue value) const
 {
-    return m_enums.containsValue(value);
+    return findValue(value) != m_enums.size();
 }
 
 IdReturn Enum::name(EnumValue value) const
 {
-    auto it = m_enums.findValue(value);
+    const std::size_t index = findValue(value);
     
-    if (it == m_enums.end())
+    if (index == m_enums.size())
         PONDER_ERROR(EnumValueNotFound(value, name()));
 
-    return it->first;
+    return m_enums.at(index)->first;
 }
 
 Enum::EnumValue Enum::value(IdRef name) const
 {
-    auto it = m_enums.findKey(name);
+    const std::size_t index = findName(name);
 
-    if (it == m_enums.end())
+    if (index == m_enums.size())
         PONDER_ERROR(EnumNameNotFound(name, m_name));
 
-    return it->second;
+    return m_enums.at(index)->second;
+}
+
+bool Enum::tryValue(IdRef name, EnumValue& valueRet) const
+{
+    const std::size_t index = findName(name);
+    if (index == m_enums.size())
+        return false;
+
+    valueRet = m_enums.at(index)->second;
+    return true;
+}
+
+bool Enum::isFlags() const
+{
+    return m_flags;
+}
+
+Enum::EnumValue Enum::flagMask() const
+{
+    return m_flagMask;
+}
+
+std::size_t Enum::formatFlags(EnumValue value, char* buffer, std::size_t size) const
+{
+    // Copy as much as fits, keeping room for the terminator
+    std::size_t length = 0;
+    const std::size_t capacity = size > 0 ? size - 1 : 0;
+    auto append = [&](const char* data, std::size_t count)
+    {
+        if (length < capacity)
+            std::memcpy(buffer + length, data, std::min(count, capacity - length));
+        length += count;
+    };
+
+    const bool found = forEachFlagName(value, [&](const Id& flag)
+    {
+        if (length > 0)
+            append("|", 1);
+        append(flag.data(), flag.size());
+    });
+
+    if (!found)
+        PONDER_ERROR(EnumValueNotFound(value, name()));
+
+    if (size > 0)
+        buffer[std::min(length, capacity)] = '\0';
+
+    return length;
+}
+
+void Enum::formatFlags(EnumValue value, String& text) const
+{
+    bool first = true;
+    const bool found = forEachFlagName(value, [&](const Id& flag)
+    {
+        if (!first)
+            text += '|';
+        text += flag;
+        first = false;
+    });
+
+    if (!found)
+        PONDER_ERROR(EnumValueNotFound(value, name()));
+}
+
+bool Enum::tryParseFlags(IdRef text, EnumValue& valueRet) const
+{
+    const char* pos = text.data();
+    const char* const end = pos + text.size();
+
+    if (pos == end)
+    {
+        valueRet = 0;
+        return true;
+    }
+
+    // Every separator is followed by a name, which may be empty ("A|" is invalid)
+    EnumValue value = 0;
+    for (;;)
+    {
+        const char* separator = std::find(pos, end, '|');
+
+        // Trim the spaces around the name
+        const char* first = pos;
+        const char* last = separator;
+        while (first < last && *first == ' ')
+            ++first;
+        while (last > first && last[-1] == ' ')
+            --last;
+
+        const std::size_t index = findName(first, static_cast<std::size_t>(last - first));
+        if (index == m_enums.size())
+            return false;
+        value |= m_enums.at(index)->second;
+
+        if (separator == end)
+            break;
+        pos = separator + 1;
+    }
+
+    valueRet = value;
+    return true;
+}
+
+Enum::EnumValue Enum::parseFlags(IdRef text) const
+{
+    EnumValue value;
+    if (!tryParseFlags(text, value))
+        PONDER_ERROR(EnumNameNotFound(text, m_name));
+
+    return value;
 }
 
 bool Enum::operator == (const Enum& other) const
@@ -40,12 +40,25 @@ EnumBuilder::EnumBuilder(Enum& target)
 {
 }
 
+EnumBuilder::~EnumBuilder()
+{
+    // Pairs are sorted by name: build the indices once, when all the pairs are declared
+    m_target->buildIndex();
+}
+
 EnumBuilder& EnumBuilder::value(IdRef name, Enum::EnumValue value)
 {
-    assert(!m_target->hasName(name));
-    assert(!m_target->hasValue(value));
+    assert(!m_target->m_enums.containsKey(name));
+    assert(!m_target->m_enums.containsValue(value));
+
+    m_target->addValue(name, value);
 
-    m_target->m_enums.insert(name, value);
+    return *this;
+}
+
+EnumBuilder& EnumBuilder::flags()
+{
+    m_target->m_flags = true;
 
     return *this;
 }
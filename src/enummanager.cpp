@@ -78,6 +78,9 @@ void EnumManager::removeClass(IdRef id)
 
     delete en;
     m_enums.erase(id);
+
+    // Only now, so that nothing resolved by the observers keeps the deleted pointer
+    nextGeneration();
 }
 
 std::size_t EnumManager::count() const
@@ -130,6 +133,7 @@ EnumManager::~EnumManager()
         notifyEnumRemoved(*enumPtr);
         delete enumPtr;
     }
+    nextGeneration();
 }
 
 } // namespace detail
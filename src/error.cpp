@@ -29,11 +29,18 @@
 
 
 #include <ponder/error.hpp>
+#include <cstdio>
+#include <cstdlib>
 
 
 namespace ponder
 {
-    
+namespace
+{
+ErrorHandler g_handler = nullptr;
+
+} // anonymous namespace
+
 Error::~Error() throw()
 {
 }
@@ -54,4 +61,35 @@ Error::Error(IdRef message)
 {
 }
 
+ErrorHandler errorHandler()
+{
+    return g_handler;
+}
+
+ErrorHandler setErrorHandler(ErrorHandler handler)
+{
+    const ErrorHandler previous = g_handler;
+    g_handler = handler;
+    return previous;
+}
+
+namespace detail
+{
+void handleError(const Error& error)
+{
+    if (const ErrorHandler handler = g_handler)
+        handler(error);
+}
+
+void raiseError(const Error& error)
+{
+    handleError(error);
+
+    // The handler returned: there's no way to recover
+    std::fprintf(stderr, "ponder: %s [%s]\n", error.what(), error.where());
+    std::abort();
+}
+
+} // namespace detail
+
 } // namespace ponder
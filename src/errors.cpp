@@ -99,6 +99,11 @@ EnumValueNotFound::EnumValueNotFound(long value, IdRef enumName)
 {
 }
 
+EventNotFound::EventNotFound(IdRef name, IdRef className)
+    : Error("the event " + String(name) + " couldn't be found in metaclass " + String(className))
+{
+}
+
 ForbiddenCall::ForbiddenCall(IdRef functionName)
     : Error("the function " + String(functionName) + " is not callable")
 {
@@ -119,6 +124,12 @@ FunctionNotFound::FunctionNotFound(IdRef name, IdRef className)
 {
 }
 
+KeyNotFound::KeyNotFound(const String& key, IdRef propertyName)
+    : Error("the key " + key + " couldn't be found in the dictionary property "
+            + String(propertyName))
+{
+}
+
 NotEnoughArguments::NotEnoughArguments(IdRef functionName,
                                        std::size_t provided,
                                        std::size_t expected)
@@ -144,4 +155,10 @@ PropertyNotFound::PropertyNotFound(IdRef name, IdRef className)
 {
 }
 
+SchemaMismatch::SchemaMismatch(IdRef className)
+    : Error("the generated code for metaclass " + String(className) +
+            " doesn't match its current declaration")
+{
+}
+
 } // namespace ponder
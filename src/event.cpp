@@ -0,0 +1,150 @@
+/****************************************************************************
+**
+** This file is part of the Ponder library, formerly CAMP.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+
+
+#include <ponder/event.hpp>
+#include <ponder/classvisitor.hpp>
+
+
+namespace ponder
+{
+namespace detail
+{
+/**
+ * \brief Record of a thread reading subscriber lists
+ *
+ * The records are never deleted: the record of a finished thread is reused by a new one.
+ */
+struct EventReader
+{
+    std::atomic<std::uint64_t> epoch{0}; ///< Epoch of the outermost reading, 0 if none
+    std::atomic<bool> owned{true}; ///< Is the record used by a thread?
+    std::size_t depth = 0; ///< Number of nested readings, only used by the owner
+    EventReader* next = nullptr; ///< Next record
+};
+}
+
+namespace
+{
+std::atomic<EventHandle> g_nextHandle(1);
+std::atomic<std::uint64_t> g_epoch(1);
+std::atomic<detail::EventReader*> g_readers(nullptr);
+
+detail::EventReader* acquireReader()
+{
+    for (detail::EventReader* reader = g_readers.load(); reader; reader = reader->next)
+    {
+        bool owned = false;
+        if (!reader->owned.load(std::memory_order_relaxed)
+            && reader->owned.compare_exchange_strong(owned, true))
+            return reader;
+    }
+
+    detail::EventReader* reader = new detail::EventReader;
+    reader->next = g_readers.load();
+    while (!g_readers.compare_exchange_weak(reader->next, reader)) {}
+    return reader;
+}
+
+// Release the record of the thread when it ends
+struct ThreadReader
+{
+    detail::EventReader* reader = acquireReader();
+    ~ThreadReader() {reader->owned.store(false, std::memory_order_release);}
+};
+
+detail::EventReader& threadReader()
+{
+    static thread_local ThreadReader thread;
+    return *thread.reader;
+}
+}
+
+namespace detail
+{
+EventHandle nextEventHandle()
+{
+    return g_nextHandle.fetch_add(1, std::memory_order_relaxed);
+}
+
+EventReading::EventReading()
+    : m_reader(threadReader())
+{
+    // The epoch is visible to the reclaimers before the reader loads any list
+    if (m_reader.depth++ == 0)
+        m_reader.epoch.store(g_epoch.load());
+}
+
+EventReading::~EventReading()
+{
+    if (--m_reader.depth == 0)
+        m_reader.epoch.store(0, std::memory_order_release);
+}
+
+std::uint64_t retireEventEpoch()
+{
+    return g_epoch.fetch_add(1);
+}
+
+std::uint64_t oldestEventEpoch()
+{
+    // A list retired in epoch E was replaced before the epoch moved past E: the readings
+    // which announced a later epoch loaded its replacement
+    std::uint64_t oldest = g_epoch.load();
+    for (const EventReader* reader = g_readers.load(); reader; reader = reader->next)
+    {
+        const std::uint64_t epoch = reader->epoch.load();
+        if (epoch != 0 && epoch < oldest)
+            oldest = epoch;
+    }
+    return oldest;
+}
+}
+
+Event::Event(IdRef name)
+    : m_name(name)
+{
+}
+
+Event::~Event()
+{
+}
+
+IdReturn Event::name() const
+{
+    return m_name;
+}
+
+void Event::accept(ClassVisitor& visitor) const
+{
+    visitor.visit(*this);
+}
+
+} // namespace ponder
@@ -0,0 +1,191 @@
+/****************************************************************************
+**
+** This file is part of the Ponder library, formerly CAMP.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+
+#include <ponder/detail/fieldproperty.hpp>
+#include <ponder/class.hpp>
+#include <ponder/classcast.hpp>
+
+
+namespace ponder
+{
+namespace detail
+{
+
+FieldProperty::FieldProperty(IdRef name, ValueKind kind, const char* ownerId,
+                             std::size_t offset, FieldType type, bool writable)
+    : SimpleProperty(name, kind)
+    , m_ownerId(ownerId)
+    , m_offset(offset)
+    , m_type(type)
+    , m_writable(writable)
+{
+}
+
+bool FieldProperty::isReadable() const
+{
+    return true;
+}
+
+bool FieldProperty::isWritable() const
+{
+    return m_writable;
+}
+
+void* FieldProperty::fieldPointer(void* pointer, const Class& objectClass) const
+{
+    if (!pointer)
+        PONDER_ERROR(NullObject(&objectClass));
+
+    const Class* owner = m_owner.valid() ? m_owner.get() : m_owner.resolve(m_ownerId);
+    if (!owner)
+        PONDER_ERROR(ClassNotFound(m_ownerId));
+
+    // Apply the proper offset to the pointer (solves multiple inheritance issues)
+    pointer = classCast(pointer, objectClass, *owner);
+
+    return static_cast<char*>(pointer) + m_offset;
+}
+
+void* FieldProperty::tryFieldPointer(void* pointer, const Class& objectClass) const
+{
+    const Class* owner = m_owner.valid() ? m_owner.get() : m_owner.resolve(m_ownerId);
+    if (!pointer || !owner || !tryClassCast(pointer, objectClass, *owner))
+        return nullptr;
+
+    return static_cast<char*>(pointer) + m_offset;
+}
+
+bool FieldProperty::offset(const Class& objectClass, std::size_t& offset) const
+{
+    const Class* owner = m_owner.valid() ? m_owner.get() : m_owner.resolve(m_ownerId);
+    const int base = owner ? objectClass.baseOffset(*owner) : -1;
+    if (base == -1)
+        return false;
+
+    offset = static_cast<std::size_t>(base) + m_offset;
+    return true;
+}
+
+bool FieldProperty::isInstance(const UserObject& object) const
+{
+    return tryFieldPointer(object.pointer(), object.getClass()) != nullptr;
+}
+
+bool FieldProperty::canSetValue(const UserObject&, const Value& value) const
+{
+    switch (m_type)
+    {
+        case FieldType::Bool:             return value.isCompatible<bool>();
+        case FieldType::Char:             return value.isCompatible<char>();
+        case FieldType::UnsignedChar:     return value.isCompatible<unsigned char>();
+        case FieldType::Short:            return value.isCompatible<short>();
+        case FieldType::UnsignedShort:    return value.isCompatible<unsigned short>();
+        case FieldType::Int:              return value.isCompatible<int>();
+        case FieldType::UnsignedInt:      return value.isCompatible<unsigned int>();
+        case FieldType::Long:             return value.isCompatible<long>();
+        case FieldType::UnsignedLong:     return value.isCompatible<unsigned long>();
+        case FieldType::LongLong:         return value.isCompatible<long long>();
+        case FieldType::UnsignedLongLong: return value.isCompatible<unsigned long long>();
+        case FieldType::Float:            return value.isCompatible<float>();
+        case FieldType::Double:           return value.isCompatible<double>();
+        case FieldType::String:           return value.isCompatible<String>();
+    }
+
+    return false;
+}
+
+Value FieldProperty::getValue(const UserObject& object) const
+{
+    const void* field = fieldPointer(object.pointer(), object.getClass());
+
+    switch (m_type)
+    {
+        case FieldType::Bool:             return *static_cast<const bool*>(field);
+        case FieldType::Char:             return *static_cast<const char*>(field);
+        case FieldType::UnsignedChar:     return *static_cast<const unsigned char*>(field);
+        case FieldType::Short:            return *static_cast<const short*>(field);
+        case FieldType::UnsignedShort:    return *static_cast<const unsigned short*>(field);
+        case FieldType::Int:              return *static_cast<const int*>(field);
+        case FieldType::UnsignedInt:      return *static_cast<const unsigned int*>(field);
+        case FieldType::Long:             return *static_cast<const long*>(field);
+        case FieldType::UnsignedLong:     return *static_cast<const unsigned long*>(field);
+        case FieldType::LongLong:         return *static_cast<const long long*>(field);
+        case FieldType::UnsignedLongLong: return *static_cast<const unsigned long long*>(field);
+        case FieldType::Float:            return *static_cast<const float*>(field);
+        case FieldType::Double:           return *static_cast<const double*>(field);
+        case FieldType::String:           return *static_cast<const String*>(field);
+    }
+
+    return Value::nothing;
+}
+
+void FieldProperty::setValue(const UserObject& object, const Value& value) const
+{
+    if (!m_writable)
+        PONDER_ERROR(ForbiddenWrite(name()));
+
+    void* field = fieldPointer(object.pointer(), object.getClass());
+
+    switch (m_type)
+    {
+        case FieldType::Bool:
+            *static_cast<bool*>(field) = value.to<bool>(); break;
+        case FieldType::Char:
+            *static_cast<char*>(field) = value.to<char>(); break;
+        case FieldType::UnsignedChar:
+            *static_cast<unsigned char*>(field) = value.to<unsigned char>(); break;
+        case FieldType::Short:
+            *static_cast<short*>(field) = value.to<short>(); break;
+        case FieldType::UnsignedShort:
+            *static_cast<unsigned short*>(field) = value.to<unsigned short>(); break;
+        case FieldType::Int:
+            *static_cast<int*>(field) = value.to<int>(); break;
+        case FieldType::UnsignedInt:
+            *static_cast<unsigned int*>(field) = value.to<unsigned int>(); break;
+        case FieldType::Long:
+            *static_cast<long*>(field) = value.to<long>(); break;
+        case FieldType::UnsignedLong:
+            *static_cast<unsigned long*>(field) = value.to<unsigned long>(); break;
+        case FieldType::LongLong:
+            *static_cast<long long*>(field) = value.to<long long>(); break;
+        case FieldType::UnsignedLongLong:
+            *static_cast<unsigned long long*>(field) = value.to<unsigned long long>(); break;
+        case FieldType::Float:
+            *static_cast<float*>(field) = value.to<float>(); break;
+        case FieldType::Double:
+            *static_cast<double*>(field) = value.to<double>(); break;
+        case FieldType::String:
+            *static_cast<String*>(field) = value.to<String>(); break;
+    }
+}
+
+} // namespace detail
+
+} // namespace ponder
@@ -0,0 +1,182 @@
+/****************************************************************************
+**
+** This file is part of the Ponder library, formerly CAMP.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+
+#include <ponder/instances.hpp>
+#include <ponder/class.hpp>
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#if defined(__GLIBC__)
+#   include <execinfo.h>
+#endif
+
+
+namespace ponder
+{
+namespace instances
+{
+namespace
+{
+#if PONDER_TRACK_INSTANCES
+
+const int maxFrames = 16;
+
+struct Creation
+{
+    const Class* metaclass;
+    std::vector<const void*> frames;
+};
+
+// Intentionally leaked, so that instances destroyed during static destruction can still be removed
+struct SiteRegistry
+{
+    std::atomic<bool> recording{false};
+    std::atomic<bool> used{false}; // set once a site has been recorded
+    std::mutex mutex;
+    std::unordered_map<const void*, Creation> creations; // indexed by object
+};
+
+SiteRegistry& siteRegistry()
+{
+    static SiteRegistry* instance = new SiteRegistry;
+    return *instance;
+}
+
+#endif // PONDER_TRACK_INSTANCES
+
+} // anonymous namespace
+
+Stats stats(const Class& metaclass)
+{
+    Stats stats;
+    stats.live = metaclass.m_instanceCounts.live.load(std::memory_order_relaxed);
+    stats.peak = metaclass.m_instanceCounts.peak.load(std::memory_order_relaxed);
+    stats.created = metaclass.m_instanceCounts.created.load(std::memory_order_relaxed);
+    stats.bytes = stats.live * metaclass.sizeOf();
+    return stats;
+}
+
+void recordSites(bool record)
+{
+#if PONDER_TRACK_INSTANCES
+    siteRegistry().recording.store(record);
+#else
+    (void)record;
+#endif
+}
+
+std::vector<Site> sites(const Class& metaclass)
+{
+    std::vector<Site> result;
+#if PONDER_TRACK_INSTANCES
+    SiteRegistry& registry = siteRegistry();
+    std::map<std::vector<const void*>, std::size_t> counts;
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for (auto& creation : registry.creations)
+        {
+            if (creation.second.metaclass == &metaclass)
+                ++counts[creation.second.frames];
+        }
+    }
+
+    result.reserve(counts.size());
+    for (auto& count : counts)
+    {
+        Site site;
+        site.frames = count.first;
+        site.live = count.second;
+        result.push_back(std::move(site));
+    }
+    std::stable_sort(result.begin(), result.end(),
+                     [](const Site& a, const Site& b) {return a.live > b.live;});
+#else
+    (void)metaclass;
+#endif
+    return result;
+}
+
+namespace detail
+{
+void created(const Class& metaclass, const void* object)
+{
+    Counts& counts = metaclass.m_instanceCounts;
+    counts.created.fetch_add(1, std::memory_order_relaxed);
+
+    const std::size_t live = counts.live.fetch_add(1, std::memory_order_relaxed) + 1;
+    std::size_t peak = counts.peak.load(std::memory_order_relaxed);
+    while (live > peak && !counts.peak.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+        ;
+
+#if PONDER_TRACK_INSTANCES
+    SiteRegistry& registry = siteRegistry();
+    if (registry.recording.load(std::memory_order_relaxed))
+    {
+        Creation creation = {&metaclass, {}};
+#if defined(__GLIBC__)
+        void* frames[maxFrames + 1];
+        const int count = backtrace(frames, maxFrames + 1);
+        creation.frames.assign(frames + std::min(count, 1), frames + count); // skip created()
+#endif
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.creations[object] = std::move(creation);
+        registry.used.store(true, std::memory_order_relaxed);
+    }
+#else
+    (void)object;
+#endif
+}
+
+void destroyed(const Class& metaclass, const void* object)
+{
+    // Objects created outside Ponder aren't counted, don't let them wrap the counter around
+    Counts& counts = metaclass.m_instanceCounts;
+    std::size_t live = counts.live.load(std::memory_order_relaxed);
+    while (live > 0 && !counts.live.compare_exchange_weak(live, live - 1, std::memory_order_relaxed))
+        ;
+
+#if PONDER_TRACK_INSTANCES
+    SiteRegistry& registry = siteRegistry();
+    if (registry.used.load(std::memory_order_relaxed))
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.creations.erase(object);
+    }
+#else
+    (void)object;
+#endif
+}
+
+} // namespace detail
+
+} // namespace instances
+
+} // namespace ponder
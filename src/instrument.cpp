@@ -0,0 +1,432 @@
+/****************************************************************************
+**
+** This file is part of the Ponder library, formerly CAMP.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+
+#include <ponder/instrument.hpp>
+#include <ponder/constructor.hpp>
+#include <ponder/function.hpp>
+#include <ponder/property.hpp>
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <vector>
+
+
+namespace ponder
+{
+namespace instrument
+{
+namespace
+{
+std::size_t bucketOf(std::uint64_t ns)
+{
+    std::size_t bucket = 0;
+    for (std::uint64_t v = ns >> 1; v != 0 && bucket < Stats::bucketCount - 1; v >>= 1)
+        ++bucket;
+    return bucket;
+}
+
+const Stats& emptyStats()
+{
+    static const Stats empty;
+    return empty;
+}
+
+#if PONDER_INSTRUMENT
+
+// Each slot has two statistics entries: the read, call or construction, and the write
+std::uint32_t entryOf(std::uint32_t slot, Operation operation)
+{
+    return slot * 2 + (operation == Operation::Set ? 1 : 0);
+}
+
+constexpr std::uint32_t entriesPerPage = 64;
+constexpr std::uint32_t maxPages = 2048;
+constexpr std::uint32_t maxSlots = entriesPerPage * maxPages / 2; // members beyond are not recorded
+
+// Counters of one entry: only the owner thread writes them (without read-modify-write),
+// snapshots read them concurrently
+struct Counters
+{
+    std::atomic<std::uint64_t> calls;
+    std::atomic<std::uint64_t> totalNs;
+    std::atomic<std::uint64_t> maxNs;
+    std::atomic<std::uint64_t> buckets[Stats::bucketCount];
+
+    static void add(std::atomic<std::uint64_t>& counter, std::uint64_t value)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    void record(std::uint64_t ns)
+    {
+        add(calls, 1);
+        add(totalNs, ns);
+        if (ns > maxNs.load(std::memory_order_relaxed))
+            maxNs.store(ns, std::memory_order_relaxed);
+        add(buckets[bucketOf(ns)], 1);
+    }
+
+    void load(Stats& stats) const
+    {
+        stats.calls = calls.load(std::memory_order_relaxed);
+        stats.totalNs = totalNs.load(std::memory_order_relaxed);
+        stats.maxNs = maxNs.load(std::memory_order_relaxed);
+        for (std::size_t i = 0; i < Stats::bucketCount; ++i)
+            stats.buckets[i] = buckets[i].load(std::memory_order_relaxed);
+    }
+
+    void clear()
+    {
+        calls.store(0, std::memory_order_relaxed);
+        totalNs.store(0, std::memory_order_relaxed);
+        maxNs.store(0, std::memory_order_relaxed);
+        for (auto& bucket : buckets)
+            bucket.store(0, std::memory_order_relaxed);
+    }
+};
+
+struct Page
+{
+    Counters entries[entriesPerPage];
+};
+
+// Bumped by reset(): each shard clears itself on its next sample
+std::atomic<std::uint64_t> s_generation {0};
+
+struct Shard;
+
+// Intentionally leaked, so that threads exiting after static destruction can still retire their shard
+struct Registry
+{
+    std::mutex mutex;
+    std::vector<Shard*> shards;
+    std::vector<Stats> retired;             // statistics of the threads which have exited, by entry
+    std::vector<std::uint32_t> freeSlots;   // slots of destroyed members
+    std::uint32_t nextSlot = 1;             // 0 means "not assigned"
+
+    Stats& retiredEntry(std::uint32_t entry)
+    {
+        if (entry >= retired.size())
+            retired.resize(entry + 1);
+        return retired[entry];
+    }
+};
+
+Registry& registry()
+{
+    static Registry* instance = new Registry;
+    return *instance;
+}
+
+// Statistics of one thread, in pages of entries allocated on demand: only its owner
+// writes them, and the registry lock is only taken to create, retire or read shards
+struct Shard
+{
+    std::atomic<Page*> pages[maxPages];
+    std::atomic<std::uint64_t> generation; // last reset() seen by the owner
+
+    Shard()
+        : generation(s_generation.load(std::memory_order_acquire))
+    {
+        for (auto& page : pages)
+            page.store(nullptr, std::memory_order_relaxed);
+
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        reg.shards.push_back(this);
+    }
+
+    ~Shard()
+    {
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        if (current())
+            forEach([&reg](std::uint32_t entry, const Stats& stats)
+                    {reg.retiredEntry(entry).merge(stats);});
+        for (auto& page : pages)
+            delete page.load(std::memory_order_relaxed);
+        reg.shards.erase(std::remove(reg.shards.begin(), reg.shards.end(), this), reg.shards.end());
+    }
+
+    // False if a reset() happened since the owner last cleared its statistics
+    bool current() const
+    {
+        return generation.load(std::memory_order_acquire) ==
+               s_generation.load(std::memory_order_acquire);
+    }
+
+    Counters* counters(std::uint32_t entry)
+    {
+        const std::uint32_t index = entry / entriesPerPage;
+        if (index >= maxPages)
+            return nullptr;
+
+        Page* page = pages[index].load(std::memory_order_relaxed);
+        if (!page)
+        {
+            page = new Page();
+            pages[index].store(page, std::memory_order_release);
+        }
+        return &page->entries[entry % entriesPerPage];
+    }
+
+    Counters* existing(std::uint32_t entry) const
+    {
+        const std::uint32_t index = entry / entriesPerPage;
+        Page* page = index < maxPages ? pages[index].load(std::memory_order_acquire) : nullptr;
+        return page ? &page->entries[entry % entriesPerPage] : nullptr;
+    }
+
+    // Called by the owner only
+    void clear(std::uint64_t newGeneration)
+    {
+        for (auto& page : pages)
+        {
+            if (Page* p = page.load(std::memory_order_relaxed))
+                for (auto& counters : p->entries)
+                    counters.clear();
+        }
+        generation.store(newGeneration, std::memory_order_release);
+    }
+
+    template <typename F>
+    void forEach(F visit) const
+    {
+        for (std::uint32_t index = 0; index < maxPages; ++index)
+        {
+            Page* page = pages[index].load(std::memory_order_acquire);
+            if (!page)
+                continue;
+
+            for (std::uint32_t i = 0; i < entriesPerPage; ++i)
+            {
+                Stats stats;
+                page->entries[i].load(stats);
+                if (stats.calls > 0)
+                    visit(index * entriesPerPage + i, stats);
+            }
+        }
+    }
+};
+
+Shard& localShard()
+{
+    static thread_local Shard shard;
+    return shard;
+}
+
+#endif // PONDER_INSTRUMENT
+
+} // anonymous namespace
+
+void Stats::record(std::uint64_t ns)
+{
+    ++calls;
+    totalNs += ns;
+    maxNs = std::max(maxNs, ns);
+    ++buckets[bucketOf(ns)];
+}
+
+void Stats::merge(const Stats& other)
+{
+    calls += other.calls;
+    totalNs += other.totalNs;
+    maxNs = std::max(maxNs, other.maxNs);
+    for (std::size_t i = 0; i < bucketCount; ++i)
+        buckets[i] += other.buckets[i];
+}
+
+std::uint64_t Stats::meanNs() const
+{
+    return calls > 0 ? totalNs / calls : 0;
+}
+
+std::uint64_t Stats::percentile(double p) const
+{
+    if (calls == 0)
+        return 0;
+
+    const double clamped = std::min(std::max(p, 0.0), 1.0);
+    const std::uint64_t rank = std::max<std::uint64_t>(
+        1, static_cast<std::uint64_t>(std::ceil(clamped * static_cast<double>(calls))));
+
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < bucketCount; ++i)
+    {
+        seen += buckets[i];
+        if (seen >= rank)
+            return std::min(maxNs, (std::uint64_t(2) << i) - 1);
+    }
+
+    return maxNs;
+}
+
+const Stats& Snapshot::get(const Property& property, Operation operation) const
+{
+    return find(property, operation);
+}
+
+const Stats& Snapshot::get(const Function& function) const
+{
+    return find(function, Operation::Call);
+}
+
+const Stats& Snapshot::get(const Constructor& constructor) const
+{
+    return find(constructor, Operation::Create);
+}
+
+const Stats& Snapshot::find(const detail::Instrumented& member, Operation operation) const
+{
+#if PONDER_INSTRUMENT
+    const std::uint32_t slot = member.assignedSlot();
+    if (slot != 0)
+    {
+        auto it = m_stats.find(entryOf(slot, operation));
+        if (it != m_stats.end())
+            return it->second;
+    }
+#else
+    (void)member;
+    (void)operation;
+#endif
+
+    return emptyStats();
+}
+
+Snapshot snapshot()
+{
+    Snapshot snap;
+
+#if PONDER_INSTRUMENT
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (std::uint32_t entry = 0; entry < reg.retired.size(); ++entry)
+    {
+        if (reg.retired[entry].calls > 0)
+            snap.m_stats[entry].merge(reg.retired[entry]);
+    }
+    for (Shard* shard : reg.shards)
+    {
+        if (shard->current())
+            shard->forEach([&snap](std::uint32_t entry, const Stats& stats)
+                           {snap.m_stats[entry].merge(stats);});
+    }
+#endif
+
+    return snap;
+}
+
+void reset()
+{
+#if PONDER_INSTRUMENT
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.retired.clear();
+    s_generation.fetch_add(1, std::memory_order_acq_rel);
+#endif
+}
+
+namespace detail
+{
+#if PONDER_INSTRUMENT
+
+std::uint32_t Instrumented::assignSlot() const
+{
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+
+    std::uint32_t slot = m_slot.load(std::memory_order_relaxed);
+    if (slot == 0)
+    {
+        if (!reg.freeSlots.empty())
+        {
+            slot = reg.freeSlots.back();
+            reg.freeSlots.pop_back();
+        }
+        else
+        {
+            slot = reg.nextSlot++;
+        }
+        m_slot.store(slot, std::memory_order_release);
+    }
+    return slot;
+}
+
+Instrumented::~Instrumented()
+{
+    const std::uint32_t slot = m_slot.load(std::memory_order_acquire);
+    if (slot == 0)
+        return;
+
+    // Clear the statistics of the member so that the next one using the slot starts afresh
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (std::uint32_t entry = entryOf(slot, Operation::Get); entry <= entryOf(slot, Operation::Set); ++entry)
+    {
+        for (Shard* shard : reg.shards)
+        {
+            if (Counters* counters = shard->existing(entry))
+                counters->clear();
+        }
+        if (entry < reg.retired.size())
+            reg.retired[entry] = Stats();
+    }
+    reg.freeSlots.push_back(slot);
+}
+
+#endif // PONDER_INSTRUMENT
+
+void record(const Instrumented& member, Operation operation, std::uint64_t ns)
+{
+#if PONDER_INSTRUMENT
+    Shard& shard = localShard();
+    const std::uint64_t generation = s_generation.load(std::memory_order_acquire);
+    if (shard.generation.load(std::memory_order_relaxed) != generation)
+        shard.clear(generation);
+
+    const std::uint32_t slot = member.slot();
+    if (slot >= maxSlots)
+        return;
+
+    if (Counters* counters = shard.counters(entryOf(slot, operation)))
+        counters->record(ns);
+#else
+    (void)member;
+    (void)operation;
+    (void)ns;
+#endif
+}
+
+} // namespace detail
+
+} // namespace instrument
+
+} // namespace ponder
@@ -0,0 +1,249 @@
+/****************************************************************************
+**
+** This file is part of the Ponder library, formerly CAMP.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+
+#include <ponder/memoryreport.hpp>
+#include <ponder/class.hpp>
+#include <ponder/enum.hpp>
+#include <ponder/classget.hpp>
+#include <ponder/enumget.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <string>
+#include <unordered_map>
+
+
+namespace ponder
+{
+namespace detail
+{
+namespace
+{
+// Not destroyed, so that metadata freed during static destruction is still counted
+std::atomic<std::size_t> g_allocatedBytes[allocatedCategoryCount];
+
+thread_local MetaAllocationScope* t_scope = nullptr;
+
+// Heap block of a string, if it isn't stored inline (small string optimization)
+std::size_t stringHeap(const std::string& str)
+{
+    const char* data = str.data();
+    const char* self = reinterpret_cast<const char*>(&str);
+    const bool inlined = data >= self && data < self + sizeof(str);
+    return inlined ? 0 : str.capacity() + 1;
+}
+
+std::size_t valueHeap(const Value& value)
+{
+    return value.kind() == ValueKind::String ? stringHeap(value.to<String>()) : 0;
+}
+
+// Estimate for node-based hash tables: the bucket array plus one node per element
+template <typename M>
+std::size_t hashTableHeap(const M& table)
+{
+    return table.bucket_count() * sizeof(void*)
+         + table.size() * (sizeof(typename M::value_type) + 2 * sizeof(void*));
+}
+
+} // anonymous namespace
+
+void countMetaAllocation(MemoryCategory category, std::size_t size, bool allocated)
+{
+    const std::size_t index = static_cast<std::size_t>(category);
+    assert(index < allocatedCategoryCount);
+
+    if (allocated)
+        g_allocatedBytes[index].fetch_add(size, std::memory_order_relaxed);
+    else
+        g_allocatedBytes[index].fetch_sub(size, std::memory_order_relaxed);
+
+    if (t_scope)
+    {
+        std::uint32_t& bytes = t_scope->m_bytes[index];
+        if (allocated)
+            bytes += static_cast<std::uint32_t>(size);
+        else
+            bytes -= std::min(bytes, static_cast<std::uint32_t>(size));
+    }
+}
+
+std::size_t metaAllocatedBytes(MemoryCategory category)
+{
+    return g_allocatedBytes[static_cast<std::size_t>(category)].load(std::memory_order_relaxed);
+}
+
+MetaAllocationScope::MetaAllocationScope(MetaAllocations& allocations, MetadataKind kind)
+    : m_bytes(allocations.bytes[static_cast<std::size_t>(kind)])
+    , m_previous(t_scope)
+{
+    assert(static_cast<std::size_t>(kind) < memberKindCount);
+    t_scope = this;
+}
+
+MetaAllocationScope::~MetaAllocationScope()
+{
+    t_scope = m_previous;
+}
+
+/**
+ * \brief Measures the containers of metaclasses and metaenums
+ */
+class MemoryCounter
+{
+public:
+
+    static void count(const Class& metaclass, ClassMemoryUsage& usage)
+    {
+        MemoryUsage& self = usage[MetadataKind::Class];
+        self[MemoryCategory::Tables] += sizeof(Class)
+            + metaclass.m_bases.capacity() * sizeof(Class::BaseInfo);
+        self[MemoryCategory::Names] += stringHeap(metaclass.m_id);
+        self[MemoryCategory::Tags] += tags(metaclass) + hashTableHeap(metaclass.m_tagIndex);
+        for (auto& entry : metaclass.m_tagIndex)
+            self[MemoryCategory::Tags] += valueHeap(entry.first) + sizeof(std::vector<bool>)
+                                        + entry.second->capacity() / 8;
+
+        // Bytes of the members, counted by the allocator when they were declared
+        for (std::size_t kind = 0; kind < memberKindCount; ++kind)
+        {
+            for (std::size_t category = 0; category < allocatedCategoryCount; ++category)
+                usage.kinds[kind].bytes[category] += metaclass.m_allocations.bytes[kind][category];
+        }
+
+        members(metaclass.m_properties, metaclass.m_propertyIndex, usage[MetadataKind::Property]);
+        members(metaclass.m_functions, metaclass.m_functionIndex, usage[MetadataKind::Function]);
+        members(metaclass.m_events, metaclass.m_eventIndex, usage[MetadataKind::Event]);
+
+        usage[MetadataKind::Constructor][MemoryCategory::Tables] +=
+            metaclass.m_constructors.capacity() * sizeof(Class::ConstructorPtr);
+    }
+
+    static void count(const Enum& metaenum, MemoryUsage& usage)
+    {
+        usage[MemoryCategory::Tables] += sizeof(Enum)
+            + metaenum.m_enums.capacity() * sizeof(Enum::EnumTable::value_type)
+            + metaenum.m_nameIndex.memoryUsage() + metaenum.m_valueHash.memoryUsage()
+            + (metaenum.m_valueIndex.capacity() + metaenum.m_bitNames.capacity())
+                * sizeof(std::uint32_t);
+
+        usage[MemoryCategory::Names] += stringHeap(metaenum.m_name);
+        for (auto& entry : metaenum.m_enums)
+            usage[MemoryCategory::Names] += stringHeap(entry.first);
+    }
+
+private:
+
+    static std::size_t tags(const TagHolder& holder)
+    {
+        std::size_t bytes = holder.m_tags.capacity() * sizeof(TagHolder::TagsTable::value_type)
+                          + holder.m_index.memoryUsage();
+        for (auto& tag : holder.m_tags)
+            bytes += valueHeap(tag.first);
+        return bytes;
+    }
+
+    // Members inherited from a base metaclass are not copied, the derived metaclass shares
+    // the index of its base, and only pays for what it builds to reference it
+    template <typename Table, typename Index>
+    static void members(const Table& table, const Index& index, MemoryUsage& usage)
+    {
+        usage[MemoryCategory::Tables] += table.capacity() * sizeof(typename Table::value_type)
+                                       + index.memoryUsage();
+        usage[MemoryCategory::Inherited] += index.inheritedMemoryUsage();
+
+        for (auto& entry : table)
+        {
+            usage[MemoryCategory::Names] += stringHeap(entry.first)
+                                          + stringHeap(entry.second->name());
+            usage[MemoryCategory::Tags] += tags(*entry.second);
+        }
+    }
+};
+
+} // namespace detail
+
+MemoryUsage& MemoryUsage::operator+=(const MemoryUsage& other)
+{
+    for (std::size_t i = 0; i < detail::memoryCategoryCount; ++i)
+        bytes[i] += other.bytes[i];
+    return *this;
+}
+
+std::size_t MemoryUsage::total() const
+{
+    std::size_t sum = 0;
+    for (std::size_t i = 0; i < detail::memoryCategoryCount; ++i)
+        sum += bytes[i];
+    return sum;
+}
+
+std::size_t ClassMemoryUsage::total() const
+{
+    std::size_t sum = 0;
+    for (std::size_t i = 0; i < detail::memberKindCount; ++i)
+        sum += kinds[i].total();
+    return sum;
+}
+
+MetadataMemoryReport metadataMemoryReport()
+{
+    MetadataMemoryReport report;
+
+    const std::size_t nbClasses = classCount();
+    report.classes.resize(nbClasses);
+    for (std::size_t i = 0; i < nbClasses; ++i)
+    {
+        ClassMemoryUsage& usage = report.classes[i];
+        usage.metaclass = &classByIndex(i);
+        detail::MemoryCounter::count(*usage.metaclass, usage);
+
+        for (std::size_t kind = 0; kind < detail::memberKindCount; ++kind)
+            report.kinds[kind] += usage.kinds[kind];
+    }
+
+    MemoryUsage& enums = report.kinds[static_cast<std::size_t>(MetadataKind::Enum)];
+    for (std::size_t i = 0, nbEnums = enumCount(); i < nbEnums; ++i)
+        detail::MemoryCounter::count(enumByIndex(i), enums);
+
+    for (const MemoryUsage& kind : report.kinds)
+        report.total += kind;
+
+    for (std::size_t category = 0; category < detail::allocatedCategoryCount; ++category)
+    {
+        report.allocated.bytes[category] =
+            detail::metaAllocatedBytes(static_cast<MemoryCategory>(category));
+    }
+    report.arenaReserved = detail::arenaReservedBytes();
+
+    return report;
+}
+
+} // namespace ponder
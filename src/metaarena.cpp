@@ -0,0 +1,140 @@
+/****************************************************************************
+**
+** This file is part of the Ponder library, formerly CAMP.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+
+#include <ponder/detail/metaallocator.hpp>
+#include <mutex>
+
+
+namespace ponder
+{
+namespace detail
+{
+namespace
+{
+const std::size_t granularity = 16;     // multiple of the alignment of any type
+const std::size_t maxBlockSize = 512;
+const std::size_t chunkSize = 16384;
+const std::size_t sizeClassCount = maxBlockSize / granularity;
+
+struct FreeBlock
+{
+    FreeBlock* next;
+};
+
+// Intentionally leaked, so that metadata released during static destruction can still be freed
+struct Arena
+{
+    std::mutex mutex;
+    FreeBlock* freeLists[sizeClassCount] = {}; // indexed by size class
+    char* current = nullptr;    // next free byte of the current chunk
+    std::size_t remaining = 0;  // bytes left in the current chunk
+    std::size_t reserved = 0;   // bytes of all the chunks
+};
+
+Arena& arena()
+{
+    static Arena* instance = new Arena;
+    return *instance;
+}
+
+std::size_t sizeClass(std::size_t size)
+{
+    return (size + granularity - 1) / granularity - 1;
+}
+
+void pushFree(Arena& arena, void* ptr, std::size_t index)
+{
+    FreeBlock* block = static_cast<FreeBlock*>(ptr);
+    block->next = arena.freeLists[index];
+    arena.freeLists[index] = block;
+}
+
+} // anonymous namespace
+
+void* arenaAllocate(std::size_t size)
+{
+    if (size > maxBlockSize)
+        return allocate(size);
+
+    const std::size_t index = sizeClass(size > 0 ? size : 1);
+    const std::size_t rounded = (index + 1) * granularity;
+
+    Arena& a = arena();
+    std::lock_guard<std::mutex> lock(a.mutex);
+
+    if (FreeBlock* block = a.freeLists[index])
+    {
+        a.freeLists[index] = block->next;
+        return block;
+    }
+
+    if (a.remaining < rounded)
+    {
+        // Keep the tail of the current chunk for smaller blocks
+        if (a.remaining >= granularity)
+            pushFree(a, a.current, sizeClass(a.remaining));
+
+        a.current = static_cast<char*>(allocate(chunkSize));
+        a.remaining = chunkSize;
+        a.reserved += chunkSize;
+    }
+
+    void* ptr = a.current;
+    a.current += rounded;
+    a.remaining -= rounded;
+    return ptr;
+}
+
+void arenaDeallocate(void* ptr, std::size_t size)
+{
+    if (!ptr)
+        return;
+
+    if (size > maxBlockSize)
+    {
+        deallocate(ptr, size);
+        return;
+    }
+
+    Arena& a = arena();
+    std::lock_guard<std::mutex> lock(a.mutex);
+    pushFree(a, ptr, sizeClass(size > 0 ? size : 1));
+}
+
+std::size_t arenaReservedBytes()
+{
+    Arena& a = arena();
+    std::lock_guard<std::mutex> lock(a.mutex);
+    return a.reserved;
+}
+
+} // namespace detail
+
+} // namespace ponder
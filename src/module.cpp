@@ -0,0 +1,149 @@
+/****************************************************************************
+**
+** This file is part of the Ponder library, formerly CAMP.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+
+#include <ponder/module.hpp>
+#include <ponder/class.hpp>
+#include <ponder/enum.hpp>
+#include <ponder/detail/classmanager.hpp>
+#include <ponder/detail/enummanager.hpp>
+#include <algorithm>
+
+
+namespace ponder
+{
+
+Module* Module::s_current = nullptr;
+
+Module::Scope::Scope(Module& module)
+    : m_previous(s_current)
+{
+    s_current = &module;
+}
+
+Module::Scope::~Scope()
+{
+    s_current = m_previous;
+}
+
+Module::Module(IdRef name)
+    : m_name(name)
+    , m_unloading(false)
+{
+    // Registering ourselves also constructs the managers first, which guarantees that
+    // they outlive the module and are still there when the destructor unloads it
+    addObserver(this);
+}
+
+Module::~Module()
+{
+    unload();
+    removeObserver(this);
+
+    if (s_current == this)
+        s_current = nullptr;
+}
+
+IdReturn Module::name() const
+{
+    return m_name;
+}
+
+std::size_t Module::classCount() const
+{
+    return m_classes.size();
+}
+
+std::size_t Module::enumCount() const
+{
+    return m_enums.size();
+}
+
+void Module::unload()
+{
+    std::vector<Id> classes, enums;
+    classes.swap(m_classes);
+    enums.swap(m_enums);
+
+    m_unloading = true;
+
+    detail::ClassManager& classManager = detail::ClassManager::instance();
+    for (std::vector<Id>::reverse_iterator it = classes.rbegin(); it != classes.rend(); ++it)
+    {
+        if (classManager.classExists(*it))
+            classManager.removeClass(*it);
+    }
+
+    detail::EnumManager& enumManager = detail::EnumManager::instance();
+    for (std::vector<Id>::reverse_iterator it = enums.rbegin(); it != enums.rend(); ++it)
+    {
+        if (enumManager.enumExists(*it))
+            enumManager.removeClass(*it);
+    }
+
+    m_unloading = false;
+}
+
+Module* Module::current()
+{
+    return s_current;
+}
+
+void Module::classAdded(const Class& added)
+{
+    if (s_current == this)
+        m_classes.push_back(added.name());
+}
+
+void Module::classRemoved(const Class& removed)
+{
+    if (!m_unloading)
+        forget(m_classes, removed.name());
+}
+
+void Module::enumAdded(const Enum& added)
+{
+    if (s_current == this)
+        m_enums.push_back(added.name());
+}
+
+void Module::enumRemoved(const Enum& removed)
+{
+    if (!m_unloading)
+        forget(m_enums, removed.name());
+}
+
+void Module::forget(std::vector<Id>& ids, const Id& id)
+{
+    std::vector<Id>::iterator it = std::find(ids.begin(), ids.end(), id);
+    if (it != ids.end())
+        ids.erase(it);
+}
+
+} // namespace ponder
@@ -37,7 +37,9 @@ namespace ponder
 {
 namespace detail
 {
-    
+
+std::atomic<std::size_t> ObserverNotifier::s_generation(0);
+
 void ObserverNotifier::addObserver(Observer* observer)
 {
     assert(observer != nullptr);
@@ -54,8 +56,15 @@ ObserverNotifier::ObserverNotifier()
 {
 }
 
+void ObserverNotifier::nextGeneration()
+{
+    s_generation.fetch_add(1, std::memory_order_acq_rel);
+}
+
 void ObserverNotifier::notifyClassAdded(const Class& theClass)
 {
+    s_generation.fetch_add(1, std::memory_order_acq_rel);
+
     for (ObserverSet::iterator it = m_observers.begin(); it != m_observers.end(); ++it)
     {
         (*it)->classAdded(theClass);
@@ -72,6 +81,8 @@ void ObserverNotifier::notifyClassRemoved(const Class& theClass)
 
 void ObserverNotifier::notifyEnumAdded(const Enum& theEnum)
 {
+    s_generation.fetch_add(1, std::memory_order_acq_rel);
+
     for (ObserverSet::iterator it = m_observers.begin(); it != m_observers.end(); ++it)
     {
         (*it)->enumAdded(theEnum);
@@ -0,0 +1,340 @@
+/****************************************************************************
+**
+** This file is part of the Ponder library, formerly CAMP.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+
+#include <ponder/perfmap.hpp>
+#include <ponder/class.hpp>
+#include <ponder/classget.hpp>
+#include <ponder/arrayproperty.hpp>
+#include <ponder/constructor.hpp>
+#include <ponder/dictionaryproperty.hpp>
+#include <ponder/function.hpp>
+#include <ponder/uses/uses.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <set>
+#ifdef _WIN32
+#   include <process.h>
+#else
+#   include <unistd.h>
+#endif
+#if defined(__linux__) && defined(__GLIBC__)
+#   include <dlfcn.h>
+#   include <link.h>
+#   define PONDER_PERFMAP_ELF_SIZES 1
+#endif
+
+
+namespace ponder
+{
+namespace perfmap
+{
+namespace
+{
+// Address of the final overrider of a virtual function called on an object
+template <typename T, typename F>
+const void* codeAddress(const T& object, F T::*function)
+{
+#if defined(__GNUC__) && !defined(_WIN32)
+    // Itanium C++ ABI: a member function pointer is {ptr, adj}; a virtual function is
+    // flagged by the low bit, and its pointer is then an offset in the virtual table
+    struct MemberFunction {std::uintptr_t ptr; std::ptrdiff_t adj;};
+    static_assert(sizeof(function) == sizeof(MemberFunction), "unexpected member pointer layout");
+
+    MemberFunction member;
+    std::memcpy(&member, &function, sizeof(member));
+
+#   if defined(__arm__) || defined(__aarch64__)
+    // ARM variant: the flag is the low bit of the adjustment
+    const bool isVirtual = (member.adj & 1) != 0;
+    const std::uintptr_t offset = member.ptr;
+    member.adj >>= 1;
+#   else
+    const bool isVirtual = (member.ptr & 1) != 0;
+    const std::uintptr_t offset = member.ptr - 1;
+#   endif
+
+    if (!isVirtual)
+        return reinterpret_cast<const void*>(member.ptr);
+
+    const char* self = reinterpret_cast<const char*>(&object) + member.adj;
+    const char* vtable = *reinterpret_cast<const char* const*>(self);
+    return *reinterpret_cast<const void* const*>(vtable + offset);
+#else
+    (void)object;
+    (void)function;
+    return nullptr;
+#endif
+}
+
+// Size of the code from an address to the end of the function containing it, read from
+// the dynamic symbol table of the module (0 if the function isn't in it)
+std::size_t codeSize(const void* address)
+{
+#ifdef PONDER_PERFMAP_ELF_SIZES
+    Dl_info info;
+    void* entry = nullptr;
+    if (!dladdr1(address, &info, &entry, RTLD_DL_SYMENT)
+        || !entry || !info.dli_saddr)
+        return 0;
+    const ElfW(Sym)* symbol = static_cast<const ElfW(Sym)*>(entry);
+
+    // dladdr1 returns the closest symbol below the address, which may end before it
+    const std::size_t offset = static_cast<std::size_t>(
+        static_cast<const char*>(address) - static_cast<const char*>(info.dli_saddr));
+    return offset < symbol->st_size ? static_cast<std::size_t>(symbol->st_size) - offset : 0;
+#else
+    (void)address;
+    return 0;
+#endif
+}
+
+// Getters and setters are protected: derived classes can name them
+struct PropertyCode : Property
+{
+    static const void* get(const Property& p) {return codeAddress(p, &PropertyCode::getValue);}
+    static const void* set(const Property& p) {return codeAddress(p, &PropertyCode::setValue);}
+};
+
+struct ArrayPropertyCode : ArrayProperty
+{
+    static const void* size(const ArrayProperty& p)
+    {
+        return codeAddress(p, &ArrayPropertyCode::getSize);
+    }
+    static const void* get(const ArrayProperty& p)
+    {
+        return codeAddress(p, &ArrayPropertyCode::getElement);
+    }
+    static const void* set(const ArrayProperty& p)
+    {
+        return codeAddress(p, &ArrayPropertyCode::setElement);
+    }
+};
+
+struct DictionaryPropertyCode : DictionaryProperty
+{
+    static const void* find(const DictionaryProperty& p)
+    {
+        return codeAddress(p, &DictionaryPropertyCode::findElement);
+    }
+    static const void* set(const DictionaryProperty& p)
+    {
+        return codeAddress(p, &DictionaryPropertyCode::setElement);
+    }
+    static const void* next(const DictionaryProperty& p)
+    {
+        return codeAddress(p, &DictionaryPropertyCode::nextElement);
+    }
+};
+
+// Names of the members implemented by each piece of code
+class Collector
+{
+public:
+
+    void add(const void* code, const std::string& name)
+    {
+        if (!code)
+            return;
+
+        Names& names = m_code[code];
+        if (names.list.size() < SymbolTable::maxNames)
+            names.list.push_back(name);
+        else
+            ++names.more;
+    }
+
+    // Each member is labeled once, with the first class listing it
+    bool visit(const void* member)
+    {
+        return m_visited.insert(member).second;
+    }
+
+    std::vector<Symbol> symbols() const
+    {
+        std::vector<Symbol> result;
+        result.reserve(m_code.size());
+        for (auto it = m_code.begin(); it != m_code.end(); ++it)
+        {
+            Symbol symbol;
+            symbol.address = it->first;
+            symbol.size = codeSize(it->first);
+
+            // Symbols never overlap, even if a function was folded into another one
+            auto next = std::next(it);
+            if (next != m_code.end())
+            {
+                const std::size_t gap = static_cast<std::size_t>(
+                    static_cast<const char*>(next->first) - static_cast<const char*>(it->first));
+                symbol.size = std::min(symbol.size, gap);
+            }
+
+            for (auto& name : it->second.list)
+                symbol.name += (symbol.name.empty() ? "" : ", ") + name;
+            if (it->second.more > 0)
+                symbol.name += " +" + std::to_string(it->second.more) + " more";
+
+            result.push_back(std::move(symbol));
+        }
+        return result;
+    }
+
+private:
+
+    struct Names
+    {
+        std::vector<std::string> list;
+        std::size_t more = 0;
+    };
+
+    std::map<const void*, Names, std::less<const void*>> m_code; // sorted by address
+    std::set<const void*> m_visited;
+};
+
+void collect(Collector& collector, const Class& metaclass)
+{
+    const std::string className = metaclass.name();
+
+    for (std::size_t i = 0, count = metaclass.propertyCount(); i < count; ++i)
+    {
+        const Property& property = metaclass.property(i);
+        if (!collector.visit(&property))
+            continue;
+
+        const std::string name = className + "::" + std::string(property.name());
+        collector.add(PropertyCode::get(property), name + " (get)");
+        collector.add(PropertyCode::set(property), name + " (set)");
+
+        if (property.kind() == ValueKind::Array)
+        {
+            const ArrayProperty& array = static_cast<const ArrayProperty&>(property);
+            collector.add(ArrayPropertyCode::size(array), name + " (size)");
+            collector.add(ArrayPropertyCode::get(array), name + " (get element)");
+            collector.add(ArrayPropertyCode::set(array), name + " (set element)");
+        }
+        else if (property.kind() == ValueKind::Dictionary)
+        {
+            const DictionaryProperty& dictionary = static_cast<const DictionaryProperty&>(property);
+            collector.add(DictionaryPropertyCode::find(dictionary), name + " (find element)");
+            collector.add(DictionaryPropertyCode::set(dictionary), name + " (set element)");
+            collector.add(DictionaryPropertyCode::next(dictionary), name + " (next element)");
+        }
+    }
+
+    for (std::size_t i = 0, count = metaclass.functionCount(); i < count; ++i)
+    {
+        const Function& function = metaclass.function(i);
+        if (!collector.visit(&function) || !function.getUsesData())
+            continue;
+
+        const runtime::impl::FunctionCaller* caller = std::get<uses::Uses::eRuntimeModule>(
+            *reinterpret_cast<const uses::Uses::PerFunctionUserData*>(function.getUsesData()));
+        collector.add(codeAddress(*caller, &runtime::impl::FunctionCaller::execute),
+                      className + "::" + std::string(function.name()) + " (call)");
+    }
+
+    for (std::size_t i = 0, count = metaclass.constructorCount(); i < count; ++i)
+    {
+        const Constructor& constructor = *metaclass.constructor(i);
+        if (collector.visit(&constructor))
+            collector.add(codeAddress(constructor, &Constructor::create), className + " (construct)");
+    }
+}
+
+} // anonymous namespace
+
+const std::size_t SymbolTable::maxNames;
+
+SymbolTable::SymbolTable()
+{
+    Collector collector;
+    for (std::size_t i = 0, count = classCount(); i < count; ++i)
+        collect(collector, classByIndex(i));
+
+    m_symbols = collector.symbols();
+}
+
+const Symbol* SymbolTable::find(const void* address) const
+{
+    // Last symbol starting at or before the address
+    auto it = std::upper_bound(m_symbols.begin(), m_symbols.end(), address,
+        [](const void* addr, const Symbol& symbol)
+        {
+            return std::less<const void*>()(addr, symbol.address);
+        });
+    if (it == m_symbols.begin())
+        return nullptr;
+
+    const Symbol& symbol = *--it;
+    const char* start = static_cast<const char*>(symbol.address);
+    const char* pc = static_cast<const char*>(address);
+    return static_cast<std::size_t>(pc - start) < symbol.size ? &symbol : nullptr;
+}
+
+void SymbolTable::write(std::ostream& stream) const
+{
+    const std::ios::fmtflags flags = stream.flags();
+    for (auto& symbol : m_symbols)
+    {
+        if (symbol.size == 0)
+            continue;
+
+        stream << std::hex << reinterpret_cast<std::uintptr_t>(symbol.address) << ' '
+               << symbol.size << std::dec << ' ' << symbol.name << '\n';
+    }
+    stream.flags(flags);
+}
+
+std::string defaultPath()
+{
+#ifdef _WIN32
+    const long pid = static_cast<long>(_getpid());
+#else
+    const long pid = static_cast<long>(getpid());
+#endif
+    return "/tmp/perf-" + std::to_string(pid) + ".map";
+}
+
+bool writePerfMap(const std::string& path)
+{
+    std::ofstream file(path.c_str(), std::ios::out | std::ios::trunc);
+    if (!file)
+        return false;
+
+    SymbolTable().write(file);
+    return static_cast<bool>(file);
+}
+
+} // namespace perfmap
+
+} // namespace ponder
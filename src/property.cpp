@@ -30,6 +30,7 @@
 
 #include <ponder/property.hpp>
 #include <ponder/classvisitor.hpp>
+#include <ponder/instrument.hpp>
 
 
 namespace ponder
@@ -59,8 +60,20 @@ bool Property::writable(const UserObject& object) const
     return isWritable() && m_writable.get(object);
 }
 
+bool Property::alwaysReadable() const
+{
+    return isReadable() && m_readable.isConstant() && m_readable.get();
+}
+
+bool Property::alwaysWritable() const
+{
+    return isWritable() && m_writable.isConstant() && m_writable.get();
+}
+
 Value Property::get(const UserObject& object) const
 {
+    PONDER_INSTRUMENT_SCOPE(this, Get);
+
     // Check if the property is readable
     if (!readable(object))
         PONDER_ERROR(ForbiddenRead(name()));
@@ -70,6 +83,8 @@ Value Property::get(const UserObject& object) const
 
 void Property::set(const UserObject& object, const Value& value) const
 {
+    PONDER_INSTRUMENT_SCOPE(this, Set);
+
     // Check if the property is writable
     if (!writable(object))
         PONDER_ERROR(ForbiddenWrite(name()));
@@ -79,6 +94,29 @@ void Property::set(const UserObject& object, const Value& value) const
     object.set(*this, value);
 }
 
+bool Property::appliesTo(const UserObject& object) const
+{
+    return object.pointer() && isInstance(object);
+}
+
+bool Property::tryGet(const UserObject& object, Value& result) const
+{
+    if (!appliesTo(object) || !readable(object) || !canGetValue(object))
+        return false;
+
+    result = get(object);
+    return true;
+}
+
+bool Property::trySet(const UserObject& object, const Value& value) const
+{
+    if (!appliesTo(object) || !writable(object) || !canSetValue(object, value))
+        return false;
+
+    set(object, value);
+    return true;
+}
+
 void Property::accept(ClassVisitor& visitor) const
 {
     visitor.visit(*this);
@@ -94,6 +132,21 @@ bool Property::isWritable() const
     return true;
 }
 
+bool Property::isInstance(const UserObject&) const
+{
+    return true;
+}
+
+bool Property::canGetValue(const UserObject&) const
+{
+    return true;
+}
+
+bool Property::canSetValue(const UserObject&, const Value&) const
+{
+    return true;
+}
+
 Property::Property(IdRef name, ValueKind type)
     : m_name(name)
     , m_type(type)
@@ -0,0 +1,201 @@
+/****************************************************************************
+**
+** This file is part of the Ponder library, formerly CAMP.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+
+#include <ponder/scratch.hpp>
+#include <ponder/userobject.hpp>
+#include <ponder/value.hpp>
+#include <algorithm>
+#include <new>
+#include <vector>
+
+
+namespace ponder
+{
+namespace
+{
+const std::size_t firstChunkSize = 4096;
+const std::size_t blockAlignment = alignof(std::max_align_t);
+
+struct Chunk
+{
+    char* data;
+    std::size_t size;
+};
+
+// Scratch arena of a thread. The chunks are kept until the thread exits.
+struct Arena
+{
+    std::vector<Chunk> chunks;
+    std::size_t chunk = 0; ///< Index of the chunk in use
+    std::size_t offset = 0; ///< Offset of the next block in this chunk
+    std::size_t used = 0; ///< Bytes taken since the first chunk
+    int scopes = 0; ///< Number of active scopes
+    bool suspended = false; ///< Set while promoting, to allocate with the current allocator
+
+    ~Arena()
+    {
+        for (const Chunk& c : chunks)
+            ::operator delete(c.data);
+    }
+
+    void* allocate(std::size_t size)
+    {
+        size = (size + blockAlignment - 1) & ~(blockAlignment - 1);
+
+        // Use the first chunk with enough room, the arena is rewound chunk by chunk
+        while (chunk < chunks.size() && offset + size > chunks[chunk].size)
+        {
+            used += chunks[chunk].size - offset;
+            ++chunk;
+            offset = 0;
+        }
+
+        if (chunk == chunks.size())
+        {
+            const std::size_t last = chunks.empty() ? firstChunkSize / 2 : chunks.back().size;
+            const std::size_t chunkSize = std::max(2 * last, size);
+            chunks.push_back(Chunk{static_cast<char*>(::operator new(chunkSize)), chunkSize});
+        }
+
+        void* pointer = chunks[chunk].data + offset;
+        offset += size;
+        used += size;
+        return pointer;
+    }
+
+    bool owns(const void* pointer) const
+    {
+        const char* p = static_cast<const char*>(pointer);
+        for (const Chunk& c : chunks)
+        {
+            if (p >= c.data && p < c.data + c.size)
+                return true;
+        }
+        return false;
+    }
+};
+
+thread_local Arena t_arena;
+
+// Allocate with the current allocator while alive
+class Suspend
+{
+public:
+
+    Suspend() : m_previous(t_arena.suspended) {t_arena.suspended = true;}
+    ~Suspend() {t_arena.suspended = m_previous;}
+
+private:
+
+    bool m_previous;
+};
+
+} // anonymous namespace
+
+ScratchScope::ScratchScope()
+    : m_chunk(t_arena.chunk)
+    , m_offset(t_arena.offset)
+    , m_used(t_arena.used)
+{
+    ++t_arena.scopes;
+}
+
+ScratchScope::~ScratchScope()
+{
+    t_arena.chunk = m_chunk;
+    t_arena.offset = m_offset;
+    t_arena.used = m_used;
+    --t_arena.scopes;
+}
+
+std::size_t ScratchScope::used() const
+{
+    return t_arena.used - m_used;
+}
+
+bool ScratchScope::active()
+{
+    return t_arena.scopes > 0;
+}
+
+UserObject ScratchScope::promote(const UserObject& object)
+{
+    if (!object.m_holder)
+        return object;
+
+    Suspend suspend;
+    UserObject copy;
+    copy.m_class = object.m_class;
+    copy.m_holder.reset(object.m_holder->clone());
+
+    // Keep the offset of the dynamic type part of the object
+    const std::ptrdiff_t offset = static_cast<char*>(object.m_pointer)
+                                - static_cast<char*>(object.m_holder->object());
+    copy.m_pointer = static_cast<char*>(copy.m_holder->object()) + offset;
+    return copy;
+}
+
+Value ScratchScope::promote(const Value& value)
+{
+    if (value.kind() == ValueKind::User)
+        return promote(value.cref<UserObject>());
+
+    return value;
+}
+
+Args ScratchScope::promote(const Args& args)
+{
+    Suspend suspend;
+    Args copy;
+    for (std::size_t i = 0; i < args.count(); ++i)
+        copy += promote(args[i]);
+    return copy;
+}
+
+namespace detail
+{
+void* scratchAllocate(std::size_t size)
+{
+    Arena& arena = t_arena;
+    if (arena.scopes == 0 || arena.suspended)
+        return nullptr;
+
+    return arena.allocate(size);
+}
+
+bool scratchOwns(const void* pointer)
+{
+    const Arena& arena = t_arena;
+    return !arena.chunks.empty() && arena.owns(pointer);
+}
+
+} // namespace detail
+
+} // namespace ponder
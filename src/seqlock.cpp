@@ -0,0 +1,153 @@
+/****************************************************************************
+**
+** This file is part of the Ponder library, formerly CAMP.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+
+
+#include <ponder/seqlock.hpp>
+#include <cstdint>
+#include <thread>
+
+
+namespace ponder
+{
+namespace
+{
+// Objects are mapped to a fixed set of counters by address, so that sequencing them
+// doesn't need any storage in the objects nor any registration.
+const std::size_t stripeCount = 256;
+
+// A counter holds the number of writes in progress in its low bits and the number of
+// completed writes above them. Starting or ending a write changes it, so a reader which
+// sees no write in progress and the same value before and after reading has seen no write.
+// Writers never wait, objects sharing a counter can't block each other.
+const unsigned int writerBits = 16;
+const std::size_t writerMask = (std::size_t(1) << writerBits) - 1;
+const std::size_t completedWrite = std::size_t(1) << writerBits;
+
+struct alignas(64) Stripe
+{
+    std::atomic<std::size_t> sequence{0};
+};
+
+Stripe g_stripes[stripeCount];
+
+// Writes in progress on each stripe by the current thread, to allow nested writes
+// (a setter writing another property) and reads from a setter.
+thread_local unsigned int t_writing[stripeCount];
+
+std::size_t stripeIndex(const std::atomic<std::size_t>* counter)
+{
+    return static_cast<std::size_t>(reinterpret_cast<const Stripe*>(counter) - g_stripes);
+}
+
+} // namespace
+
+namespace detail
+{
+std::atomic<std::size_t>* seqLockCounter(const UserObject& object)
+{
+    const Class* root = object.getClass().m_seqLockClass;
+    void* pointer = object.pointer();
+    if (!root || !pointer)
+        return nullptr;
+
+    // Use the address seen by the class declaring the policy, so that an object is
+    // sequenced the same way through all its metaclasses
+    object.getClass().tryApplyOffset(pointer, *root);
+
+    const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(pointer) >> 3;
+    const std::size_t index =
+        static_cast<std::size_t>((address * 0x9E3779B97F4A7C15ull) >> 32) % stripeCount;
+    return &g_stripes[index].sequence;
+}
+
+void checkConsistentProperty(const Property& property)
+{
+    switch (property.kind())
+    {
+        case ValueKind::Boolean:
+        case ValueKind::Integer:
+        case ValueKind::Real:
+        case ValueKind::Enum:
+            return;
+
+        default:
+            PONDER_ERROR(ForbiddenRead(property.name()));
+    }
+}
+
+} // namespace detail
+
+SequencedWrite::SequencedWrite(const UserObject& object)
+    : m_counter(detail::seqLockCounter(object))
+{
+    if (m_counter && t_writing[stripeIndex(m_counter)]++ == 0)
+    {
+        m_counter->fetch_add(1, std::memory_order_acquire);
+
+        // Keep the writes to the object after the write is counted as in progress
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+}
+
+SequencedWrite::~SequencedWrite()
+{
+    if (m_counter && --t_writing[stripeIndex(m_counter)] == 0)
+        m_counter->fetch_add(completedWrite - 1, std::memory_order_release);
+}
+
+namespace detail
+{
+std::size_t seqLockReadBegin(const std::atomic<std::size_t>& counter)
+{
+    // A thread reading from a setter counts as one of the writes in progress
+    const std::size_t ownWrites = t_writing[stripeIndex(&counter)] > 0 ? 1 : 0;
+
+    unsigned int spins = 0;
+    std::size_t sequence = counter.load(std::memory_order_acquire);
+    while ((sequence & writerMask) != ownWrites)
+    {
+        if (++spins % 64 == 0)
+            std::this_thread::yield();
+        sequence = counter.load(std::memory_order_acquire);
+    }
+
+    return sequence;
+}
+
+bool seqLockReadRetry(const std::atomic<std::size_t>& counter, std::size_t sequence)
+{
+    // Keep the reads of the object before the counter is checked again
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return counter.load(std::memory_order_relaxed) != sequence;
+}
+
+} // namespace detail
+
+} // namespace ponder
@@ -49,31 +49,28 @@ const Value& TagHolder::tagId(std::size_t index) const
     if (index >= m_tags.size())
         PONDER_ERROR(OutOfRange(index, m_tags.size()));
 
-    TagsTable::const_iterator it = m_tags.begin();
-    std::advance(it, index);
-
-    return it->first;
+    return m_tags[index].first;
 }
 
 bool TagHolder::hasTag(const Value& id) const
 {
-    return m_tags.find(id) != m_tags.end();
+    return findTag(id) != detail::HashIndex::npos;
 }
 
 const Value& TagHolder::tag(const Value& id) const
 {
-    TagsTable::const_iterator it = m_tags.find(id);
-    if (it != m_tags.end())
-        return it->second.get();
+    const std::size_t index = findTag(id);
+    if (index != detail::HashIndex::npos)
+        return m_tags[index].second.get();
 
     return Value::nothing;
 }
 
 Value TagHolder::tag(const Value& id, const UserObject& object) const
 {
-    TagsTable::const_iterator it = m_tags.find(id);
-    if (it != m_tags.end())
-        return it->second.get(object);
+    const std::size_t index = findTag(id);
+    if (index != detail::HashIndex::npos)
+        return m_tags[index].second.get(object);
 
     return Value::nothing;
 }
@@ -82,4 +79,28 @@ TagHolder::TagHolder()
 {
 }
 
+void TagHolder::setTag(const Value& id, const detail::Getter<Value>& value)
+{
+    const std::size_t index = findTag(id);
+    if (index != detail::HashIndex::npos)
+    {
+        m_tags[index].second = value;
+        return;
+    }
+
+    m_tags.push_back(std::make_pair(id, value));
+    m_index.build(m_tags.size(), [this](std::size_t i)
+    {
+        return std::hash<Value>()(m_tags[i].first);
+    });
+}
+
+std::size_t TagHolder::findTag(const Value& id) const
+{
+    return m_index.find(std::hash<Value>()(id), [&](std::size_t i)
+    {
+        return m_tags[i].first == id;
+    });
+}
+
 } // namespace ponder
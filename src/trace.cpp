@@ -0,0 +1,279 @@
+/****************************************************************************
+**
+** This file is part of the Ponder library, formerly CAMP.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+
+#include <ponder/trace.hpp>
+#include <ponder/allocator.hpp>
+#include <chrono>
+#include <ostream>
+
+
+namespace ponder
+{
+namespace trace
+{
+namespace detail
+{
+std::atomic<bool> g_active(false);
+}
+
+namespace
+{
+struct Event
+{
+    const char* className;
+    const char* memberName;
+    std::uint64_t start;
+    std::uint64_t end;
+    Category category;
+};
+
+// Events are appended to chunks which are never moved, so that readers can walk them while
+// the owner thread keeps recording
+struct Chunk : public ponder::detail::Allocated
+{
+    static const std::size_t capacity = 4096;
+
+    Event events[capacity];
+    std::atomic<std::size_t> count; // published with release once the event is written
+    std::atomic<Chunk*> next;
+
+    Chunk() : count(0), next(nullptr) {}
+};
+
+// Events of one thread: only its owner appends to it, without locking. Buffers are never
+// freed, so that the events of exited threads can still be written; the buffer of an exited
+// thread is reused by the next thread which starts recording.
+struct Buffer : public ponder::detail::Allocated
+{
+    Chunk* head;
+    Chunk* tail;
+    unsigned int threadId;
+    std::atomic<bool> owned;
+    Buffer* next;
+
+    Buffer(unsigned int id) : head(new Chunk), tail(head), threadId(id), owned(true), next(nullptr) {}
+};
+
+// Lock-free list of all buffers, new buffers are pushed to the front
+std::atomic<Buffer*> g_buffers(nullptr);
+std::atomic<unsigned int> g_threadCount(0);
+std::atomic<std::uint64_t> g_epoch(0);
+
+Buffer* acquireBuffer()
+{
+    for (Buffer* buffer = g_buffers.load(std::memory_order_acquire); buffer; buffer = buffer->next)
+    {
+        bool owned = false;
+        if (buffer->owned.compare_exchange_strong(owned, true, std::memory_order_acquire))
+            return buffer;
+    }
+
+    Buffer* buffer = new Buffer(++g_threadCount);
+    buffer->next = g_buffers.load(std::memory_order_relaxed);
+    while (!g_buffers.compare_exchange_weak(buffer->next, buffer,
+                                            std::memory_order_release, std::memory_order_relaxed))
+        ;
+    return buffer;
+}
+
+// Buffer of the calling thread, acquired on its first event and released when it exits
+struct LocalBuffer
+{
+    Buffer* buffer = nullptr;
+
+    ~LocalBuffer()
+    {
+        if (buffer)
+            buffer->owned.store(false, std::memory_order_release);
+    }
+};
+
+Buffer& localBuffer()
+{
+    static thread_local LocalBuffer local;
+    if (!local.buffer)
+        local.buffer = acquireBuffer();
+    return *local.buffer;
+}
+
+template <typename F>
+void forEachEvent(F func)
+{
+    for (Buffer* buffer = g_buffers.load(std::memory_order_acquire); buffer; buffer = buffer->next)
+    {
+        for (Chunk* chunk = buffer->head; chunk; chunk = chunk->next.load(std::memory_order_acquire))
+        {
+            const std::size_t count = chunk->count.load(std::memory_order_acquire);
+            for (std::size_t i = 0; i < count; ++i)
+                func(*buffer, chunk->events[i]);
+        }
+    }
+}
+
+const char* categoryName(Category category)
+{
+    switch (category)
+    {
+        case Category::Call: return "call";
+        case Category::Lua: return "lua";
+        case Category::Construct: return "construct";
+        case Category::Serialize: return "serialize";
+        case Category::Deserialize: return "deserialize";
+    }
+    return "";
+}
+
+void writeEscaped(std::ostream& stream, const char* text)
+{
+    static const char hex[] = "0123456789abcdef";
+
+    for (; *text; ++text)
+    {
+        const unsigned char c = static_cast<unsigned char>(*text);
+        if (c == '"' || c == '\\')
+            stream << '\\' << c;
+        else if (c < 0x20)
+            stream << "\\u00" << hex[c >> 4] << hex[c & 0xf];
+        else
+            stream << c;
+    }
+}
+
+// Write a duration in nanoseconds as microseconds, the unit of the trace-event format
+void writeMicroseconds(std::ostream& stream, std::uint64_t ns)
+{
+    const std::uint64_t fraction = ns % 1000;
+    stream << ns / 1000 << '.' << fraction / 100 << (fraction / 10) % 10 << fraction % 10;
+}
+
+} // anonymous namespace
+
+void start()
+{
+    std::uint64_t epoch = 0;
+    g_epoch.compare_exchange_strong(epoch, detail::now());
+    detail::g_active.store(true, std::memory_order_relaxed);
+}
+
+void stop()
+{
+    detail::g_active.store(false, std::memory_order_relaxed);
+}
+
+void clear()
+{
+    for (Buffer* buffer = g_buffers.load(std::memory_order_acquire); buffer; buffer = buffer->next)
+    {
+        Chunk* chunk = buffer->head->next.exchange(nullptr);
+        while (chunk)
+        {
+            Chunk* next = chunk->next.load(std::memory_order_relaxed);
+            delete chunk;
+            chunk = next;
+        }
+        buffer->tail = buffer->head;
+        buffer->head->count.store(0, std::memory_order_release);
+    }
+
+    g_epoch.store(active() ? detail::now() : 0);
+}
+
+std::size_t eventCount()
+{
+    std::size_t count = 0;
+    forEachEvent([&count](const Buffer&, const Event&) {++count;});
+    return count;
+}
+
+void write(std::ostream& stream)
+{
+    const std::uint64_t epoch = g_epoch.load();
+    bool first = true;
+
+    stream << "{\"traceEvents\":[";
+    forEachEvent([&](const Buffer& buffer, const Event& event)
+    {
+        stream << (first ? "\n" : ",\n") << "{\"name\":\"";
+        first = false;
+
+        writeEscaped(stream, event.className);
+        if (event.memberName)
+        {
+            if (*event.className)
+                stream << "::";
+            writeEscaped(stream, event.memberName);
+        }
+
+        stream << "\",\"cat\":\"" << categoryName(event.category) << "\",\"ph\":\"X\",\"ts\":";
+        writeMicroseconds(stream, event.start >= epoch ? event.start - epoch : 0);
+        stream << ",\"dur\":";
+        writeMicroseconds(stream, event.end - event.start);
+        stream << ",\"pid\":1,\"tid\":" << buffer.threadId << '}';
+    });
+    stream << "\n],\"displayTimeUnit\":\"ns\"}\n";
+}
+
+namespace detail
+{
+std::uint64_t now()
+{
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void record(Category category, const char* className, const char* memberName,
+            std::uint64_t startNs, std::uint64_t endNs)
+{
+    Buffer& buffer = localBuffer();
+
+    Chunk* chunk = buffer.tail;
+    std::size_t index = chunk->count.load(std::memory_order_relaxed);
+    if (index == Chunk::capacity)
+    {
+        Chunk* next = new Chunk;
+        chunk->next.store(next, std::memory_order_release);
+        buffer.tail = chunk = next;
+        index = 0;
+    }
+
+    Event& event = chunk->events[index];
+    event.className = className;
+    event.memberName = memberName;
+    event.start = startNs;
+    event.end = endNs;
+    event.category = category;
+    chunk->count.store(index + 1, std::memory_order_release);
+}
+
+} // namespace detail
+
+} // namespace trace
+
+} // namespace ponder
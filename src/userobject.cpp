@@ -31,6 +31,7 @@
 #include <ponder/userobject.hpp>
 #include <ponder/userproperty.hpp>
 #include <ponder/class.hpp>
+#include <ponder/seqlock.hpp>
 
 
 namespace ponder
@@ -40,25 +41,32 @@ const UserObject UserObject::nothing;
 
 UserObject::UserObject()
     : m_class(nullptr)
+    , m_pointer(nullptr)
     , m_holder()
 {
 }
 
 UserObject::UserObject(const UserObject& other)
     : m_class(other.m_class)
+    , m_pointer(other.m_pointer)
     , m_holder(other.m_holder)
 {
 }
 
 UserObject::UserObject(UserObject&& other) noexcept
+    : m_class(nullptr)
+    , m_pointer(nullptr)
+    , m_holder()
 {
     std::swap(m_class, other.m_class);
+    std::swap(m_pointer, other.m_pointer);
     std::swap(m_holder, other.m_holder);
 }
 
 UserObject& UserObject::operator = (const UserObject& other)
 {
     m_class = other.m_class;
+    m_pointer = other.m_pointer;
     m_holder = other.m_holder;
     return *this;
 }
@@ -66,13 +74,14 @@ UserObject& UserObject::operator = (const UserObject& other)
 UserObject& UserObject::operator = (UserObject&& other) noexcept
 {
     std::swap(m_class, other.m_class);
+    std::swap(m_pointer, other.m_pointer);
     std::swap(m_holder, other.m_holder);
     return *this;
 }
 
 void* UserObject::pointer() const
 {
-    return m_holder ? m_holder->object() : nullptr;
+    return m_pointer;
 }
 
 const Class& UserObject::getClass() const
@@ -109,9 +118,9 @@ void UserObject::set(std::size_t index, const Value& value) const
 
 bool UserObject::operator == (const UserObject& other) const
 {
-    if (m_holder && other.m_holder)
+    if (m_pointer && other.m_pointer)
     {
-        return m_holder->object() == other.m_holder->object();
+        return m_pointer == other.m_pointer;
     }
     else if (!m_class && !other.m_class)
     {
@@ -123,11 +132,11 @@ bool UserObject::operator == (const UserObject& other) const
 
 bool UserObject::operator < (const UserObject& other) const
 {
-    if (m_holder)
+    if (m_pointer)
     {
-        if (other.m_holder)
+        if (other.m_pointer)
         {
-            return m_holder->object() < other.m_holder->object();
+            return m_pointer < other.m_pointer;
         }
     }
     assert(0);
@@ -136,9 +145,10 @@ bool UserObject::operator < (const UserObject& other) const
 
 void UserObject::set(const Property& property, const Value& value) const
 {
-    if (m_holder)
+    if (m_pointer)
     {
-        // Just forward to the property, no extra processing required
+        // Forward to the property, sequenced if the class asks for it
+        SequencedWrite write(*this);
         property.setValue(*this, value);
     }
     else
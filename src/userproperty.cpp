@@ -30,6 +30,8 @@
 
 #include <ponder/userproperty.hpp>
 #include <ponder/classvisitor.hpp>
+#include <ponder/class.hpp>
+#include <ponder/detail/classmanager.hpp>
 
 
 namespace ponder
@@ -37,8 +39,9 @@ namespace ponder
     
 UserProperty::UserProperty(IdRef name, const Class& propClass)
     : Property(name, ValueKind::User)
-    , m_class(&propClass)
+    , m_classId(propClass.name())
 {
+    m_class.resolve(m_classId.c_str());
 }
 
 UserProperty::~UserProperty()
@@ -47,7 +50,12 @@ UserProperty::~UserProperty()
 
 const Class& UserProperty::getClass() const
 {
-    return *m_class;
+    // The class may have been undeclared (and maybe redeclared) since we cached it
+    const Class* cls = m_class.valid() ? m_class.get() : m_class.resolve(m_classId.c_str());
+    if (!cls)
+        PONDER_ERROR(ClassNotFound(m_classId));
+
+    return *cls;
 }
 
 void UserProperty::accept(ClassVisitor& visitor) const
@@ -0,0 +1,442 @@
+/****************************************************************************
+**
+** This file is part of the Ponder library, formerly CAMP.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+#include <ponder/uses/codegen.hpp>
+#include <ponder/arrayproperty.hpp>
+#include <ponder/dictionaryproperty.hpp>
+#include <ponder/userproperty.hpp>
+#include <ponder/detail/fieldproperty.hpp>
+#include <ponder/detail/util.hpp>
+#include <cstdio>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace ponder;
+
+namespace {
+
+    // 64-bit FNV-1a
+    class Hasher
+    {
+        std::uint64_t m_hash;
+
+    public:
+
+        Hasher() : m_hash(14695981039346656037ULL) {}
+
+        void add(const char* data, std::size_t size)
+        {
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                m_hash ^= static_cast<unsigned char>(data[i]);
+                m_hash *= 1099511628211ULL;
+            }
+        }
+
+        void add(const std::string& text)
+        {
+            add(text.data(), text.size() + 1); // include terminator to separate fields
+        }
+
+        void add(std::uint64_t value)
+        {
+            char bytes[8];
+            for (int i = 0; i < 8; ++i)
+                bytes[i] = static_cast<char>(value >> (i * 8));
+            add(bytes, sizeof(bytes));
+        }
+
+        std::uint64_t value() const {return m_hash;}
+    };
+
+    bool isKeyword(const std::string& word)
+    {
+        static const char* const keywords[] = {
+            "alignas", "alignof", "and", "and_eq", "asm", "auto", "bitand", "bitor", "bool",
+            "break", "case", "catch", "char", "char16_t", "char32_t", "class", "compl",
+            "const", "constexpr", "const_cast", "continue", "decltype", "default", "delete",
+            "do", "double", "dynamic_cast", "else", "enum", "explicit", "export", "extern",
+            "false", "float", "for", "friend", "goto", "if", "inline", "int", "long",
+            "mutable", "namespace", "new", "noexcept", "not", "not_eq", "nullptr", "operator",
+            "or", "or_eq", "private", "protected", "public", "register", "reinterpret_cast",
+            "return", "short", "signed", "sizeof", "static", "static_assert", "static_cast",
+            "struct", "switch", "template", "this", "thread_local", "throw", "true", "try",
+            "typedef", "typeid", "typename", "union", "unsigned", "using", "virtual", "void",
+            "volatile", "wchar_t", "while", "xor", "xor_eq"
+        };
+        for (const char* keyword : keywords)
+        {
+            if (word == keyword)
+                return true;
+        }
+        return false;
+    }
+
+    // Turn a Ponder name into a C++ identifier, unique within "used"
+    std::string identifier(const std::string& name, std::set<std::string>& used)
+    {
+        std::string id;
+        for (std::size_t i = 0; i < name.size(); ++i)
+        {
+            const char c = name[i];
+            if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9'))
+                id += c;
+            else if (c == ':' && i + 1 < name.size() && name[i + 1] == ':')
+                id += '_', ++i;
+            else
+                id += '_';
+        }
+
+        if (id.empty() || (id[0] >= '0' && id[0] <= '9'))
+            id.insert(0, "_");
+        if (isKeyword(id))
+            id += '_';
+
+        std::string unique = id;
+        for (int n = 2; used.count(unique); ++n)
+            unique = id + "_" + std::to_string(n);
+        used.insert(unique);
+
+        return unique;
+    }
+
+    // Turn a class name into a namespace name derived from the name alone, so that classes
+    // generated separately never collide. Names made of "::"-separated segments starting
+    // with a letter keep a readable identifier, which can't contain "_0"; any other name
+    // gets a hash of the full name appended after "_0x".
+    std::string classIdentifier(const std::string& name)
+    {
+        bool readable = !name.empty() && !isKeyword(name);
+        bool segmentStart = true;
+        for (std::size_t i = 0; i < name.size() && readable; ++i)
+        {
+            const char c = name[i];
+            if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'))
+                segmentStart = false;
+            else if (c >= '0' && c <= '9')
+                readable = !segmentStart;
+            else if (c == ':' && !segmentStart && i + 2 < name.size() && name[i + 1] == ':')
+                segmentStart = true, ++i;
+            else
+                readable = false;
+        }
+
+        std::set<std::string> used;
+        std::string id = identifier(name, used);
+        if (!readable)
+        {
+            Hasher hasher;
+            hasher.add(name);
+            char hash[24];
+            std::snprintf(hash, sizeof(hash), "_0x%016llx",
+                          static_cast<unsigned long long>(hasher.value()));
+            id += hash;
+        }
+
+        return id;
+    }
+
+    // C++ type of the data member of a FieldProperty
+    const char* fieldTypeName(detail::FieldType type)
+    {
+        switch (type)
+        {
+            case detail::FieldType::Bool:             return "bool";
+            case detail::FieldType::Char:             return "char";
+            case detail::FieldType::UnsignedChar:     return "unsigned char";
+            case detail::FieldType::Short:            return "short";
+            case detail::FieldType::UnsignedShort:    return "unsigned short";
+            case detail::FieldType::Int:              return "int";
+            case detail::FieldType::UnsignedInt:      return "unsigned int";
+            case detail::FieldType::Long:             return "long";
+            case detail::FieldType::UnsignedLong:     return "unsigned long";
+            case detail::FieldType::LongLong:         return "long long";
+            case detail::FieldType::UnsignedLongLong: return "unsigned long long";
+            case detail::FieldType::Float:            return "float";
+            case detail::FieldType::Double:           return "double";
+            case detail::FieldType::String:           return "ponder::String";
+        }
+        return "";
+    }
+
+    std::string quoted(const std::string& text)
+    {
+        std::string ret = "\"";
+        for (char c : text)
+        {
+            if (c == '"' || c == '\\')
+                ret += '\\';
+            ret += c;
+        }
+        return ret + "\"";
+    }
+
+    // Lua call pushing a ponder::Value named "value" of the given kind, or empty
+    const char* luaPush(ValueKind kind)
+    {
+        switch (kind)
+        {
+            case ValueKind::Boolean:
+                return "lua_pushboolean(L, value.to<bool>());";
+            case ValueKind::Integer:
+            case ValueKind::Enum:
+                return "lua_pushinteger(L, value.to<lua_Integer>());";
+            case ValueKind::Real:
+                return "lua_pushnumber(L, value.to<lua_Number>());";
+            case ValueKind::String:
+                return "lua_pushstring(L, value.to<std::string>().c_str());";
+            case ValueKind::User:
+                return "ponder::lua::pushUserObject(L, value.to<ponder::UserObject>());";
+            default:
+                return "";
+        }
+    }
+
+} // anonymous namespace
+
+namespace ponder {
+namespace uses {
+
+std::uint64_t schemaHash(const Class& cls)
+{
+    Hasher hasher;
+    hasher.add(cls.name());
+
+    hasher.add(static_cast<std::uint64_t>(cls.propertyCount()));
+    for (std::size_t i = 0, nb = cls.propertyCount(); i < nb; ++i)
+    {
+        const Property& property = cls.property(i);
+        hasher.add(property.name());
+        hasher.add(static_cast<std::uint64_t>(property.kind()));
+
+        if (property.kind() == ValueKind::User)
+        {
+            hasher.add(static_cast<const UserProperty&>(property).getClass().name());
+        }
+        else if (const ArrayProperty* array = dynamic_cast<const ArrayProperty*>(&property))
+        {
+            hasher.add(static_cast<std::uint64_t>(array->elementType()));
+            hasher.add(static_cast<std::uint64_t>(array->dynamic()));
+        }
+        else if (const DictionaryProperty* dictionary =
+                     dynamic_cast<const DictionaryProperty*>(&property))
+        {
+            hasher.add(static_cast<std::uint64_t>(dictionary->keyType()));
+            hasher.add(static_cast<std::uint64_t>(dictionary->elementType()));
+        }
+        else if (const detail::FieldProperty* field =
+                     dynamic_cast<const detail::FieldProperty*>(&property))
+        {
+            // Generated code accesses these members directly
+            std::size_t offset = 0;
+            const bool direct = field->offset(cls, offset);
+            hasher.add(static_cast<std::uint64_t>(field->fieldType()));
+            hasher.add(static_cast<std::uint64_t>(direct ? offset : ~std::size_t(0)));
+            hasher.add(static_cast<std::uint64_t>(field->alwaysReadable()));
+            hasher.add(static_cast<std::uint64_t>(field->alwaysWritable()));
+        }
+    }
+
+    hasher.add(static_cast<std::uint64_t>(cls.functionCount()));
+    for (std::size_t i = 0, nb = cls.functionCount(); i < nb; ++i)
+    {
+        const Function& function = cls.function(i);
+        hasher.add(function.name());
+        hasher.add(static_cast<std::uint64_t>(function.kind()));
+        hasher.add(static_cast<std::uint64_t>(function.returnType()));
+        hasher.add(static_cast<std::uint64_t>(function.paramCount()));
+        for (std::size_t p = 0; p < function.paramCount(); ++p)
+            hasher.add(static_cast<std::uint64_t>(function.paramType(p)));
+    }
+
+    return hasher.value();
+}
+
+void generateCode(std::ostream& out, const Class& cls)
+{
+    const std::string classId = classIdentifier(cls.name());
+
+    const std::size_t nbProperties = cls.propertyCount();
+    const std::size_t nbFunctions = cls.functionCount();
+
+    std::set<std::string> usedIds;
+    std::vector<std::string> propertyIds, functionIds;
+    for (std::size_t i = 0; i < nbProperties; ++i)
+        propertyIds.push_back(identifier(cls.property(i).name(), usedIds));
+    usedIds.clear();
+    for (std::size_t i = 0; i < nbFunctions; ++i)
+        functionIds.push_back(identifier(cls.function(i).name(), usedIds));
+
+    // Properties bound to a plain data member are accessed directly at their offset
+    std::vector<const detail::FieldProperty*> fields(nbProperties, nullptr);
+    std::vector<std::size_t> offsets(nbProperties, 0);
+    bool directReads = false, directWrites = false;
+    for (std::size_t i = 0; i < nbProperties; ++i)
+    {
+        const detail::FieldProperty* field =
+            dynamic_cast<const detail::FieldProperty*>(&cls.property(i));
+        if (field && field->offset(cls, offsets[i]))
+        {
+            fields[i] = field;
+            directReads = directReads || field->alwaysReadable();
+            directWrites = directWrites || field->alwaysWritable();
+        }
+    }
+
+    char hash[32];
+    std::snprintf(hash, sizeof(hash), "0x%016llxULL",
+                  static_cast<unsigned long long>(schemaHash(cls)));
+
+    out << "namespace ponder_gen {\n"
+        << "namespace " << classId << " {\n\n"
+        << "const char* const name = " << quoted(cls.name()) << ";\n"
+        << "const std::uint64_t schemaHash = " << hash << ";\n\n";
+
+    out << "namespace property {\n";
+    for (std::size_t i = 0; i < nbProperties; ++i)
+        out << "const std::size_t " << propertyIds[i] << " = " << i << ";\n";
+    out << "} // namespace property\n\n";
+
+    out << "namespace function {\n";
+    for (std::size_t i = 0; i < nbFunctions; ++i)
+        out << "const std::size_t " << functionIds[i] << " = " << i << ";\n";
+    out << "} // namespace function\n\n";
+
+    out << "typedef ponder::uses::SchemaHandles<" << nbProperties << ", " << nbFunctions
+        << "> Handles;\n\n"
+        << "inline const Handles& handles()\n"
+        << "{\n"
+        << "    static Handles h(name, schemaHash);\n"
+        << "    return h.check();\n"
+        << "}\n\n";
+
+    // Arrays and dictionaries have no single Value representation, they are left to the caller
+    std::size_t slot = 0;
+    out << "inline void encode(const ponder::UserObject& object, ponder::Args& out)\n"
+        << "{\n"
+        << "    const Handles& h = handles();\n";
+    if (directReads)
+        out << "    const char* base = static_cast<const char*>(h.pointer(object));\n";
+    for (std::size_t i = 0; i < nbProperties; ++i)
+    {
+        if (cls.property(i).kind() == ValueKind::Array
+            || cls.property(i).kind() == ValueKind::Dictionary)
+            continue;
+        if (fields[i] && fields[i]->alwaysReadable())
+            out << "    out += *reinterpret_cast<const " << fieldTypeName(fields[i]->fieldType())
+                << "*>(base + " << offsets[i] << ");\n";
+        else
+            out << "    out += h.property(property::" << propertyIds[i] << ").get(object);\n";
+    }
+    out << "}\n\n";
+
+    out << "inline void decode(const ponder::UserObject& object, const ponder::Args& in)\n"
+        << "{\n"
+        << "    const Handles& h = handles();\n";
+    if (directWrites)
+        out << "    char* base = static_cast<char*>(h.pointer(object));\n"
+            << "    ponder::SequencedWrite write(object);\n";
+    for (std::size_t i = 0; i < nbProperties; ++i)
+    {
+        if (cls.property(i).kind() == ValueKind::Array
+            || cls.property(i).kind() == ValueKind::Dictionary)
+            continue;
+        if (fields[i] && fields[i]->alwaysWritable())
+        {
+            const char* type = fieldTypeName(fields[i]->fieldType());
+            out << "    *reinterpret_cast<" << type << "*>(base + " << offsets[i] << ") = in["
+                << slot++ << "].to<" << type << ">();\n";
+        }
+        else
+        {
+            out << "    if (h.property(property::" << propertyIds[i] << ").writable(object))\n"
+                << "        h.property(property::" << propertyIds[i] << ").set(object, in["
+                << slot << "]);\n";
+            ++slot;
+        }
+    }
+    out << "}\n\n";
+
+    out << "#if PONDER_USING_LUA\n";
+    std::size_t nbThunks = 0;
+    for (std::size_t i = 0; i < nbProperties; ++i)
+    {
+        const char* push = luaPush(cls.property(i).kind());
+        if (!*push)
+            continue;
+        out << "inline int luaGet_" << propertyIds[i] << "(lua_State* L)\n"
+            << "{\n"
+            << "    const ponder::UserObject& object =\n"
+            << "        *static_cast<const ponder::UserObject*>(lua_touserdata(L, 1));\n";
+        if (fields[i] && fields[i]->alwaysReadable())
+            out << "    const char* base = static_cast<const char*>(handles().pointer(object));\n"
+                << "    const ponder::Value value = *reinterpret_cast<const "
+                << fieldTypeName(fields[i]->fieldType()) << "*>(base + " << offsets[i] << ");\n";
+        else
+            out << "    const ponder::Value value = handles().property(property::"
+                << propertyIds[i] << ").get(object);\n";
+        out << "    " << push << "\n"
+            << "    return 1;\n"
+            << "}\n\n";
+        ++nbThunks;
+    }
+    out << "inline void luaPushGetters(lua_State* L)\n"
+        << "{\n"
+        << "    lua_createtable(L, 0, " << nbThunks << ");\n";
+    for (std::size_t i = 0; i < nbProperties; ++i)
+    {
+        if (!*luaPush(cls.property(i).kind()))
+            continue;
+        out << "    lua_pushcfunction(L, luaGet_" << propertyIds[i] << ");\n"
+            << "    lua_setfield(L, -2, " << quoted(cls.property(i).name()) << ");\n";
+    }
+    out << "}\n"
+        << "#endif // PONDER_USING_LUA\n\n";
+
+    out << "} // namespace " << classId << "\n"
+        << "} // namespace ponder_gen\n\n";
+}
+
+void generateCode(std::ostream& out)
+{
+    out << "// Generated by ponder-codegen from the declared metaclasses. Do not edit.\n\n"
+        << "#include <ponder/uses/codegen.hpp>\n"
+        << "#include <ponder/args.hpp>\n"
+        << "#include <ponder/seqlock.hpp>\n"
+        << "#if PONDER_USING_LUA\n"
+        << "#include <ponder/uses/lua.hpp>\n"
+        << "#endif\n\n";
+
+    for (std::size_t i = 0, nb = classCount(); i < nb; ++i)
+        generateCode(out, classByIndex(i));
+}
+
+} // namespace uses
+} // namespace ponder
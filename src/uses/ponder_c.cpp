@@ -0,0 +1,517 @@
+/****************************************************************************
+**
+** This file is part of the Ponder library, formerly CAMP.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+#include <ponder/uses/ponder_c.h>
+#include <ponder/classbuilder.hpp>
+#include <ponder/errors.hpp>
+#include <ponder/instrument.hpp>
+#include <ponder/arrayproperty.hpp>
+#include <ponder/dictionaryproperty.hpp>
+#include <ponder/detail/fieldproperty.hpp>
+#include <exception>
+#include <limits>
+#include <string>
+
+using namespace ponder;
+using ponder::detail::FieldProperty;
+using ponder::detail::FieldType;
+
+namespace {
+
+    // Per-thread state: error message and values returned by value
+    thread_local std::string t_lastError;
+    thread_local std::string t_string;
+    thread_local UserObject t_object;
+
+    const Class* toClass(const ponder_class* cls)
+    {
+        return reinterpret_cast<const Class*>(cls);
+    }
+
+    const Property* toProperty(const ponder_property* property)
+    {
+        return reinterpret_cast<const Property*>(property);
+    }
+
+    const Function* toFunction(const ponder_function* function)
+    {
+        return reinterpret_cast<const Function*>(function);
+    }
+
+    ponder_status fail(ponder_status status, const char* message)
+    {
+        t_lastError = message;
+        return status;
+    }
+
+    // Report an error without raising it
+    ponder_status fail(ponder_status status, const Error& error)
+    {
+        return fail(status, error.what());
+    }
+
+    ponder_status succeed()
+    {
+        t_lastError.clear();
+        return PONDER_OK;
+    }
+
+    ponder_status unrelated(const Property& property, const Class& objectClass)
+    {
+        const String message = "the property " + String(property.name())
+                             + " doesn't apply to the objects of class " + String(objectClass.name());
+        return fail(PONDER_ERROR, message.c_str());
+    }
+
+#if PONDER_NO_EXCEPTIONS
+
+    // Without exceptions, the errors can't be recovered from: the entry points check
+    // beforehand every condition that would raise one, and report it as a status
+    template <typename F>
+    ponder_status guard(F f)
+    {
+        return f();
+    }
+
+#else
+
+    // Status code of a Ponder error
+    template <typename T>
+    bool is(const Error& e)
+    {
+        return dynamic_cast<const T*>(&e) != nullptr;
+    }
+
+    ponder_status statusOf(const Error& e)
+    {
+        if (is<BadArgument>(e) || is<NotEnoughArguments>(e))
+            return PONDER_BAD_ARGUMENT;
+        if (is<BadType>(e))
+            return PONDER_BAD_TYPE;
+        if (is<ClassNotFound>(e) || is<PropertyNotFound>(e) || is<FunctionNotFound>(e))
+            return PONDER_NOT_FOUND;
+        if (is<ForbiddenRead>(e) || is<ForbiddenWrite>(e) || is<ForbiddenCall>(e))
+            return PONDER_FORBIDDEN;
+        if (is<NullObject>(e))
+            return PONDER_NULL_OBJECT;
+        if (is<OutOfRange>(e))
+            return PONDER_OUT_OF_RANGE;
+        return PONDER_ERROR;
+    }
+
+    // Run f, translating the exceptions thrown by the bound C++ code into status codes
+    template <typename F>
+    ponder_status guard(F f)
+    {
+        try
+        {
+            return f();
+        }
+        catch (const Error& e)              {return fail(statusOf(e), e);}
+        catch (const std::exception& e)     {return fail(PONDER_UNKNOWN_ERROR, e.what());}
+        catch (...)                         {return fail(PONDER_UNKNOWN_ERROR, "unknown exception");}
+    }
+
+#endif
+
+    ponder_type typeOf(ValueKind kind)
+    {
+        switch (kind)
+        {
+            case ValueKind::Boolean: return PONDER_TYPE_BOOL;
+            case ValueKind::Integer: return PONDER_TYPE_INT;
+            case ValueKind::Enum:    return PONDER_TYPE_INT;
+            case ValueKind::Real:    return PONDER_TYPE_REAL;
+            case ValueKind::String:  return PONDER_TYPE_STRING;
+            case ValueKind::User:    return PONDER_TYPE_OBJECT;
+            default:                 return PONDER_TYPE_NONE;
+        }
+    }
+
+    ponder_status toValue(const ponder_value& value, Value& result)
+    {
+        switch (value.type)
+        {
+            case PONDER_TYPE_BOOL:   result = value.u.b != 0; break;
+            case PONDER_TYPE_INT:
+                // Value holds integers as long, which has only 32 bits on LLP64 platforms
+                if (value.u.i < std::numeric_limits<long>::min()
+                    || value.u.i > std::numeric_limits<long>::max())
+                    return fail(PONDER_BAD_TYPE, BadType(ValueKind::Integer, ValueKind::Integer));
+                result = static_cast<long>(value.u.i);
+                break;
+            case PONDER_TYPE_REAL:   result = value.u.r; break;
+            case PONDER_TYPE_STRING: result = String(value.u.s.data, value.u.s.size); break;
+            case PONDER_TYPE_OBJECT:
+                if (!value.u.o.ptr || !value.u.o.cls)
+                    return fail(PONDER_NULL_OBJECT, NullObject(nullptr));
+                result = toClass(value.u.o.cls)->getUserObjectFromPointer(value.u.o.ptr);
+                break;
+            default:                 result = Value::nothing; break;
+        }
+        return PONDER_OK;
+    }
+
+    void fromValue(const Value& value, ponder_value& out)
+    {
+        out.type = typeOf(value.kind());
+        switch (out.type)
+        {
+            case PONDER_TYPE_BOOL:
+                out.u.b = value.to<bool>();
+                break;
+            case PONDER_TYPE_INT:
+                out.u.i = value.to<long long>();
+                break;
+            case PONDER_TYPE_REAL:
+                out.u.r = value.to<double>();
+                break;
+            case PONDER_TYPE_STRING:
+                t_string = value.to<String>();
+                out.u.s.data = t_string.c_str();
+                out.u.s.size = t_string.size();
+                break;
+            case PONDER_TYPE_OBJECT:
+                t_object = value.to<UserObject>();
+                out.u.o.ptr = t_object.pointer();
+                out.u.o.cls = reinterpret_cast<const ponder_class*>(&t_object.getClass());
+                break;
+            default:
+                break;
+        }
+    }
+
+    // Direct access to data members, without going through Value
+
+    template <typename T>
+    void readNumber(const void* field, ponder_value& out)
+    {
+        out.type = PONDER_TYPE_INT;
+        out.u.i = static_cast<int64_t>(*static_cast<const T*>(field));
+    }
+
+    void readField(const FieldProperty& property, const void* field, ponder_value& out)
+    {
+        switch (property.fieldType())
+        {
+            case FieldType::Bool:
+                out.type = PONDER_TYPE_BOOL;
+                out.u.b = *static_cast<const bool*>(field);
+                break;
+            case FieldType::Char:             readNumber<char>(field, out); break;
+            case FieldType::UnsignedChar:     readNumber<unsigned char>(field, out); break;
+            case FieldType::Short:            readNumber<short>(field, out); break;
+            case FieldType::UnsignedShort:    readNumber<unsigned short>(field, out); break;
+            case FieldType::Int:              readNumber<int>(field, out); break;
+            case FieldType::UnsignedInt:      readNumber<unsigned int>(field, out); break;
+            case FieldType::Long:             readNumber<long>(field, out); break;
+            case FieldType::UnsignedLong:     readNumber<unsigned long>(field, out); break;
+            case FieldType::LongLong:         readNumber<long long>(field, out); break;
+            case FieldType::UnsignedLongLong: readNumber<unsigned long long>(field, out); break;
+            case FieldType::Float:
+                out.type = PONDER_TYPE_REAL;
+                out.u.r = *static_cast<const float*>(field);
+                break;
+            case FieldType::Double:
+                out.type = PONDER_TYPE_REAL;
+                out.u.r = *static_cast<const double*>(field);
+                break;
+            case FieldType::String:
+            {
+                const String& str = *static_cast<const String*>(field);
+                out.type = PONDER_TYPE_STRING;
+                out.u.s.data = str.c_str();
+                out.u.s.size = str.size();
+                break;
+            }
+        }
+    }
+
+    template <typename T>
+    bool writeNumber(void* field, const ponder_value& value)
+    {
+        switch (value.type)
+        {
+            case PONDER_TYPE_BOOL: *static_cast<T*>(field) = static_cast<T>(value.u.b != 0); return true;
+            case PONDER_TYPE_INT:  *static_cast<T*>(field) = static_cast<T>(value.u.i); return true;
+            case PONDER_TYPE_REAL: *static_cast<T*>(field) = static_cast<T>(value.u.r); return true;
+            default:               return false;
+        }
+    }
+
+    // Return false if the conversion is not trivial, to let Value handle it
+    bool writeField(const FieldProperty& property, void* field, const ponder_value& value)
+    {
+        switch (property.fieldType())
+        {
+            case FieldType::Bool:             return writeNumber<bool>(field, value);
+            case FieldType::Char:             return writeNumber<char>(field, value);
+            case FieldType::UnsignedChar:     return writeNumber<unsigned char>(field, value);
+            case FieldType::Short:            return writeNumber<short>(field, value);
+            case FieldType::UnsignedShort:    return writeNumber<unsigned short>(field, value);
+            case FieldType::Int:              return writeNumber<int>(field, value);
+            case FieldType::UnsignedInt:      return writeNumber<unsigned int>(field, value);
+            case FieldType::Long:             return writeNumber<long>(field, value);
+            case FieldType::UnsignedLong:     return writeNumber<unsigned long>(field, value);
+            case FieldType::LongLong:         return writeNumber<long long>(field, value);
+            case FieldType::UnsignedLongLong: return writeNumber<unsigned long long>(field, value);
+            case FieldType::Float:            return writeNumber<float>(field, value);
+            case FieldType::Double:           return writeNumber<double>(field, value);
+            case FieldType::String:
+                if (value.type != PONDER_TYPE_STRING)
+                    return false;
+                static_cast<String*>(field)->assign(value.u.s.data, value.u.s.size);
+                return true;
+        }
+        return false;
+    }
+
+} // anonymous namespace
+
+extern "C" {
+
+const char* ponder_last_error(void)
+{
+    return t_lastError.c_str();
+}
+
+ponder_status ponder_class_find(const char* name, const ponder_class** cls)
+{
+    if (!name || !cls)
+        return fail(PONDER_NULL_OBJECT, "null argument");
+
+    const Class* found = classByNameSafe(name);
+    if (!found)
+        return fail(PONDER_NOT_FOUND, ClassNotFound(name));
+
+    *cls = reinterpret_cast<const ponder_class*>(found);
+    return succeed();
+}
+
+const char* ponder_class_name(const ponder_class* cls)
+{
+    return cls ? toClass(cls)->name().c_str() : "";
+}
+
+size_t ponder_class_property_count(const ponder_class* cls)
+{
+    return cls ? toClass(cls)->propertyCount() : 0;
+}
+
+size_t ponder_class_function_count(const ponder_class* cls)
+{
+    return cls ? toClass(cls)->functionCount() : 0;
+}
+
+ponder_status ponder_class_property(const ponder_class* cls, const char* name,
+                                    const ponder_property** property)
+{
+    if (!cls || !name || !property)
+        return fail(PONDER_NULL_OBJECT, "null argument");
+
+    const Property* found = nullptr;
+    if (!toClass(cls)->tryProperty(name, found))
+        return fail(PONDER_NOT_FOUND, PropertyNotFound(name, toClass(cls)->name()));
+
+    *property = reinterpret_cast<const ponder_property*>(found);
+    return succeed();
+}
+
+ponder_status ponder_class_function(const ponder_class* cls, const char* name,
+                                    const ponder_function** function)
+{
+    if (!cls || !name || !function)
+        return fail(PONDER_NULL_OBJECT, "null argument");
+
+    const Function* found = nullptr;
+    if (!toClass(cls)->tryFunction(name, found))
+        return fail(PONDER_NOT_FOUND, FunctionNotFound(name, toClass(cls)->name()));
+
+    *function = reinterpret_cast<const ponder_function*>(found);
+    return succeed();
+}
+
+const char* ponder_property_name(const ponder_property* property)
+{
+    return property ? toProperty(property)->name().c_str() : "";
+}
+
+ponder_type ponder_property_type(const ponder_property* property)
+{
+    return property ? typeOf(toProperty(property)->kind()) : PONDER_TYPE_NONE;
+}
+
+ponder_status ponder_property_get(const ponder_property* property,
+                                  const ponder_class* cls, void* object,
+                                  ponder_value* value)
+{
+    if (!property || !cls || !object || !value)
+        return fail(PONDER_NULL_OBJECT, "null argument");
+
+    return guard([&]() -> ponder_status
+    {
+        const Property& prop = *toProperty(property);
+        const Class& objectClass = *toClass(cls);
+        const FieldProperty* field = dynamic_cast<const FieldProperty*>(&prop);
+        if (field && prop.alwaysReadable())
+        {
+            const void* pointer = field->tryFieldPointer(object, objectClass);
+            if (!pointer)
+                return unrelated(prop, objectClass);
+
+            // The fast path bypasses Property::get, so it is instrumented here
+            PONDER_INSTRUMENT_SCOPE(&prop, Get);
+            readField(*field, pointer, *value);
+            return succeed();
+        }
+
+        const UserObject instance = objectClass.getUserObjectFromPointer(object);
+        if (!prop.appliesTo(instance))
+            return unrelated(prop, objectClass);
+        if (!prop.readable(instance))
+            return fail(PONDER_FORBIDDEN, ForbiddenRead(prop.name()));
+
+        Value result;
+        if (!prop.tryGet(instance, result))
+        {
+            // The value of an array is its first element, there is none
+            if (dynamic_cast<const ArrayProperty*>(&prop))
+                return fail(PONDER_OUT_OF_RANGE, OutOfRange(0, 0));
+            return fail(PONDER_FORBIDDEN, ForbiddenRead(prop.name()));
+        }
+
+        fromValue(result, *value);
+        return succeed();
+    });
+}
+
+ponder_status ponder_property_set(const ponder_property* property,
+                                  const ponder_class* cls, void* object,
+                                  const ponder_value* value)
+{
+    if (!property || !cls || !object || !value)
+        return fail(PONDER_NULL_OBJECT, "null argument");
+
+    return guard([&]() -> ponder_status
+    {
+        const Property& prop = *toProperty(property);
+        const Class& objectClass = *toClass(cls);
+        const FieldProperty* field = dynamic_cast<const FieldProperty*>(&prop);
+        if (field && prop.alwaysWritable() &&
+            objectClass.concurrency() == ponder::Concurrency::None)
+        {
+            void* pointer = field->tryFieldPointer(object, objectClass);
+            if (!pointer)
+                return unrelated(prop, objectClass);
+
+            PONDER_INSTRUMENT_SCOPE(&prop, Set);
+            if (writeField(*field, pointer, *value))
+                return succeed();
+        }
+
+        Value converted;
+        const ponder_status status = toValue(*value, converted);
+        if (status != PONDER_OK)
+            return status;
+
+        const UserObject instance = objectClass.getUserObjectFromPointer(object);
+        if (!prop.appliesTo(instance))
+            return unrelated(prop, objectClass);
+        if (!prop.writable(instance) || dynamic_cast<const DictionaryProperty*>(&prop))
+            return fail(PONDER_FORBIDDEN, ForbiddenWrite(prop.name()));
+
+        if (!prop.trySet(instance, converted))
+        {
+            // The value of an array is its first element, there may be none
+            const ArrayProperty* array = dynamic_cast<const ArrayProperty*>(&prop);
+            if (array && array->readable(instance) && array->size(instance) == 0)
+                return fail(PONDER_OUT_OF_RANGE, OutOfRange(0, 0));
+            return fail(PONDER_BAD_TYPE, BadType(converted.kind(), prop.kind()));
+        }
+
+        return succeed();
+    });
+}
+
+const char* ponder_function_name(const ponder_function* function)
+{
+    return function ? toFunction(function)->name().c_str() : "";
+}
+
+size_t ponder_function_param_count(const ponder_function* function)
+{
+    return function ? toFunction(function)->paramCount() : 0;
+}
+
+ponder_status ponder_function_call(const ponder_function* function,
+                                   const ponder_class* cls, void* object,
+                                   const ponder_value* args, size_t argc,
+                                   ponder_value* result)
+{
+    if (!function || (object && !cls) || (argc && !args))
+        return fail(PONDER_NULL_OBJECT, "null argument");
+
+    return guard([&]() -> ponder_status
+    {
+        const Function& func = *toFunction(function);
+        if (argc < func.paramCount())
+            return fail(PONDER_BAD_ARGUMENT,
+                        NotEnoughArguments(func.name(), argc, func.paramCount()));
+
+        Args callArgs;
+        if (object)
+            callArgs += toClass(cls)->getUserObjectFromPointer(object);
+        for (size_t i = 0; i < argc; ++i)
+        {
+            Value arg;
+            const ponder_status status = toValue(args[i], arg);
+            if (status != PONDER_OK)
+                return status;
+            callArgs += arg;
+        }
+
+        const runtime::impl::FunctionCaller* caller = std::get<uses::Uses::eRuntimeModule>(
+            *reinterpret_cast<const uses::Uses::PerFunctionUserData*>(func.getUsesData()));
+        if (!caller->accepts(callArgs))
+        {
+            const String message = "the arguments of function " + String(func.name())
+                                 + " couldn't be converted to its parameter types";
+            return fail(PONDER_BAD_ARGUMENT, message.c_str());
+        }
+
+        PONDER_INSTRUMENT_SCOPE(&func, Call);
+        const Value ret = caller->execute(callArgs);
+
+        if (result)
+            fromValue(ret, *result);
+        return succeed();
+    });
+}
+
+} // extern "C"
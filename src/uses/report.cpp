@@ -38,6 +38,10 @@
 #include <ponder/userproperty.hpp>
 
 #include <ponder/type.hpp>
+#include <ponder/instances.hpp>
+#include <ponder/instrument.hpp>
+#include <ponder/constructor.hpp>
+#include <ponder/memoryreport.hpp>
 
 // #include "picojson.h"
 
@@ -128,13 +132,61 @@ namespace {
 //        }
 //    };
 
+    // Counters and latencies of a member, only when Ponder is built with PONDER_INSTRUMENT
+    void reportStats(Reporter &rp, string_view what, const instrument::Stats& stats)
+    {
+        if (stats.calls == 0)
+            return;
+        
+        rp.open(what);
+        rp.info("calls", std::to_string(stats.calls));
+        rp.info("mean_ns", std::to_string(stats.meanNs()));
+        rp.info("p50_ns", std::to_string(stats.percentile(0.5)));
+        rp.info("p99_ns", std::to_string(stats.percentile(0.99)));
+        rp.info("max_ns", std::to_string(stats.maxNs));
+        rp.close();
+    }
+
+    const char* const c_memoryCategories[] =
+    {
+        "objects", "accessors", "callers", "names", "tags", "tables", "inherited"
+    };
+
+    const char* const c_metadataKinds[] =
+    {
+        "classes", "properties", "functions", "constructors", "events", "enums"
+    };
+
+    // Bytes used per category, skipping the empty ones
+    void reportMemory(Reporter &rp, string_view what, const MemoryUsage& usage)
+    {
+        rp.open(what);
+        for (std::size_t i = 0; i < detail::memoryCategoryCount; ++i)
+        {
+            if (usage.bytes[i] > 0)
+                rp.info(c_memoryCategories[i], std::to_string(usage.bytes[i]));
+        }
+        rp.info("total", std::to_string(usage.total()));
+        rp.close();
+    }
+
     class ReportVisitor : public ponder::ClassVisitor
     {
         Reporter &m_rp;
+        const instrument::Snapshot &m_stats;
+        
+        void instrumentation(const Property& property)
+        {
+            reportStats(m_rp, "get", m_stats.get(property, instrument::Operation::Get));
+            reportStats(m_rp, "set", m_stats.get(property, instrument::Operation::Set));
+        }
         
     public:
         
-        ReportVisitor(Reporter &rp) : m_rp(rp) {}
+        ReportVisitor(Reporter &rp, const instrument::Snapshot &stats)
+            :   m_rp(rp)
+            ,   m_stats(stats)
+        {}
     
         virtual ~ReportVisitor() {}
 
@@ -143,6 +195,7 @@ namespace {
             m_rp.open("Property");
             m_rp.info("name", property.name());
             m_rp.info("kind", enumByType<ValueKind>().name(property.kind()));            
+            instrumentation(property);
             m_rp.close();
         }
 
@@ -151,6 +204,7 @@ namespace {
             m_rp.open("SimpleProperty");
             m_rp.info("name", property.name());
             m_rp.info("kind", enumByType<ValueKind>().name(property.kind()));
+            instrumentation(property);
             m_rp.close();
         }
 
@@ -159,6 +213,7 @@ namespace {
             m_rp.open("ArrayProperty");
             m_rp.info("name", property.name());
             m_rp.info("kind", enumByType<ValueKind>().name(property.kind()));
+            instrumentation(property);
             m_rp.close();
         }
 
@@ -167,6 +222,7 @@ namespace {
             m_rp.open("EnumProperty");
             m_rp.info("name", property.name());
             m_rp.info("kind", enumByType<ValueKind>().name(property.kind()));
+            instrumentation(property);
             m_rp.close();
         }
 
@@ -175,6 +231,7 @@ namespace {
             m_rp.open("UserProperty");
             m_rp.info("name", property.name());
             m_rp.info("kind", enumByType<ValueKind>().name(property.kind()));
+            instrumentation(property);
             m_rp.close();
         }
 
@@ -183,6 +240,7 @@ namespace {
             m_rp.open("Function");
             m_rp.info("name", function.name());
             m_rp.info("kind", enumByType<FunctionKind>().name(function.kind()));
+            reportStats(m_rp, "call", m_stats.get(function));
             m_rp.close();
         }
     };
@@ -199,6 +257,8 @@ static void declarePonder()
         .value("String",            ValueKind::String) 
         .value("Enum",              ValueKind::Enum)   
         .value("Array",             ValueKind::Array)  
+        .value("User",              ValueKind::User)
+        .value("Dictionary",        ValueKind::Dictionary)
         ;
 
     Enum::declare<ponder::FunctionKind>()
@@ -220,15 +280,34 @@ static void reportTo(Reporter &rep)
     auto const& clmgr = detail::ClassManager::instance();
     auto nbClasses = clmgr.count();
     
-    ReportVisitor repVis(rep);
+    const instrument::Snapshot stats = instrument::snapshot();
+    const MetadataMemoryReport memory = metadataMemoryReport();
+    ReportVisitor repVis(rep, stats);
     for (auto ci = 0; ci < nbClasses; ++ci)
     {
         auto const& cls = clmgr.getByIndex(ci);
         rep.open("Class");
         rep.info("name", cls.name());
+        rep.info("memory", std::to_string(memory.classes[ci].total()));
+        if (instances::enabled())
+        {
+            const instances::Stats count = instances::stats(cls);
+            rep.info("instances", std::to_string(count.live) + " live, "
+                                + std::to_string(count.peak) + " peak, "
+                                + std::to_string(count.bytes) + " bytes");
+        }
         cls.visit(repVis);
+        for (std::size_t i = 0, nb = cls.constructorCount(); i < nb; ++i)
+            reportStats(rep, "constructor", stats.get(*cls.constructor(i)));
         rep.close();
     }
+
+    rep.open("Memory");
+    for (std::size_t kind = 0; kind < detail::metadataKindCount; ++kind)
+        reportMemory(rep, c_metadataKinds[kind], memory.kinds[kind]);
+    reportMemory(rep, "all", memory.total);
+    reportMemory(rep, "allocated", memory.allocated);
+    rep.close();
 }
 
 void ponder::uses::reportAll()
@@ -29,6 +29,9 @@
 
 
 #include <ponder/detail/util.hpp>
+#include <ponder/errors.hpp>
+#include <cerrno>
+#include <cstdlib>
 
 #ifdef _MSC_VER
 #   include <string.h>
@@ -60,15 +63,27 @@ static inline int stricmp(const char* a, const char* b)
 
 // parse string
     
+// Call a strtol-like function, checking that it parsed a number in range, as std::stol does
+template <typename T, typename F>
+static bool parse(const String& from, T& to, F function)
+{
+    const char* begin = from.c_str();
+    char* end = nullptr;
+    errno = 0;
+    const T result = function(begin, &end);
+    if (end == begin || errno == ERANGE)
+        return false;
+    to = result;
+    return true;
+}
+
 template <typename T>
 static bool parse_integer(const String& from, T& to)
 {
-    try {
-        const long p = std::stol(from.c_str(), nullptr, 0);
-        to = static_cast<T>(p);
-    } catch (std::logic_error&) {
+    long p;
+    if (!parse(from, p, [](const char* s, char** end) {return std::strtol(s, end, 0);}))
         return false;
-    }
+    to = static_cast<T>(p);
     return true;
 }
 
@@ -123,22 +138,12 @@ bool conv(const String& from, unsigned long& to)
 
 bool conv(const String& from, long long& to)
 {
-    try {
-        to = std::stoll(from.c_str(), nullptr, 0);
-    } catch (std::logic_error&) {
-        return false;
-    }
-    return true;
+    return parse(from, to, [](const char* s, char** end) {return std::strtoll(s, end, 0);});
 }
 
 bool conv(const String& from, unsigned long long& to)
 {
-    try {
-        to = std::stoull(from.c_str(), nullptr, 0);
-    } catch (std::logic_error&) {
-        return false;
-    }
-    return true;
+    return parse(from, to, [](const char* s, char** end) {return std::strtoull(s, end, 0);});
 }
     
 bool conv(const String& from, bool& to)
@@ -159,22 +164,12 @@ bool conv(const String& from, bool& to)
 
 bool conv(const String& from, float& to)
 {
-    try {
-        to = std::stof(from.c_str());
-    } catch (std::logic_error&) {
-        return false;
-    }
-    return true;
+    return parse(from, to, [](const char* s, char** end) {return std::strtof(s, end);});
 }
 
 bool conv(const String& from, double& to)
 {
-    try {
-        to = std::stod(from.c_str());
-    } catch (std::logic_error&) {
-        return false;
-    }
-    return true;
+    return parse(from, to, [](const char* s, char** end) {return std::strtod(s, end);});
 }
 
 
@@ -188,12 +183,18 @@ static const char* c_typeNames[] =
     "enum",     // ValueKind::Enum,
     "array",    // ValueKind::Array,
     "user",     // ValueKind::User
+    "dictionary", // ValueKind::Dictionary
 };
 
+void badConversion(ValueKind kind)
+{
+    PONDER_ERROR(BadType(ValueKind::String, kind));
+}
+
 const char* valueTypeAsString(ValueKind t)
 {
     const unsigned int i = static_cast<unsigned int>(t);
-    return i <= static_cast<unsigned int>(ValueKind::User) ? c_typeNames[i] : "unknown";
+    return i <= static_cast<unsigned int>(ValueKind::Dictionary) ? c_typeNames[i] : "unknown";
 }
 
 } // namespace detail
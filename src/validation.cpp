@@ -0,0 +1,396 @@
+/****************************************************************************
+**
+** This file is part of the Ponder library, formerly CAMP.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+
+
+#include <ponder/validation.hpp>
+#include <ponder/arrayproperty.hpp>
+#include <ponder/class.hpp>
+#include <ponder/dictionaryproperty.hpp>
+#include <ponder/detail/fieldproperty.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <regex>
+
+
+namespace ponder
+{
+namespace detail
+{
+/**
+ * \brief Constraints of a property, compiled by Validator
+ */
+struct ValidationRule
+{
+    const Property* property;
+    bool hasMin = false;
+    bool hasMax = false;
+    double min = 0;
+    double max = 0;
+    bool nonEmpty = false;
+    std::shared_ptr<const std::regex> regex;
+    bool badRegex = false; ///< Set if the pattern is malformed: no string matches it
+
+    const FieldProperty* field = nullptr; ///< Set if the property is read in place
+    std::size_t offset = 0; ///< Offset of the field in the objects of the validated class
+};
+
+class ValidationProgram
+{
+public:
+
+    std::vector<ValidationRule> rules;
+};
+
+} // namespace detail
+
+namespace
+{
+using detail::FieldType;
+using detail::ValidationRule;
+
+// Objects are checked in blocks: a first pass computes a mask of the failing objects
+// without branching, violations are only looked for in the blocks which have some
+const std::size_t blockSize = 64;
+
+bool isNumber(ValueKind kind)
+{
+    return kind == ValueKind::Integer || kind == ValueKind::Real;
+}
+
+bool isNumber(FieldType type)
+{
+    return type != FieldType::String;
+}
+
+// Bounds of a range converted to the type of a field
+template <typename V>
+struct Range
+{
+    V min;
+    V max;
+    bool empty;
+};
+
+template <typename V>
+Range<V> makeRange(const ValidationRule& rule, std::true_type /* integral */)
+{
+    // max() + 1 is a power of two, exact in a double unlike max() itself
+    const double lowest = static_cast<double>(std::numeric_limits<V>::lowest());
+    const double beyond = std::ldexp(1.0, std::numeric_limits<V>::digits);
+
+    Range<V> range = {std::numeric_limits<V>::lowest(), std::numeric_limits<V>::max(), false};
+    if (rule.hasMin)
+    {
+        const double min = std::ceil(rule.min);
+        if (min >= beyond)
+            range.empty = true;
+        else if (min > lowest)
+            range.min = static_cast<V>(min);
+    }
+    if (rule.hasMax)
+    {
+        const double max = std::floor(rule.max);
+        if (max < lowest)
+            range.empty = true;
+        else if (max < beyond)
+            range.max = static_cast<V>(max);
+    }
+    return range;
+}
+
+template <typename V>
+Range<V> makeRange(const ValidationRule& rule, std::false_type /* floating point */)
+{
+    const V infinity = std::numeric_limits<V>::infinity();
+    return {rule.hasMin ? static_cast<V>(rule.min) : -infinity,
+            rule.hasMax ? static_cast<V>(rule.max) : infinity, false};
+}
+
+template <typename V>
+void checkRange(const ValidationRule& rule, const char* first, std::size_t count,
+                std::size_t stride, std::vector<Violation>& violations)
+{
+    const Range<V> range = makeRange<V>(rule, std::is_integral<V>());
+
+    for (std::size_t block = 0; block < count; block += blockSize)
+    {
+        const std::size_t size = std::min(blockSize, count - block);
+        const char* data = first + block * stride;
+
+        // NaNs are outside of any range
+        std::uint64_t failed = 0;
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            V value;
+            std::memcpy(&value, data + i * stride, sizeof(V));
+            const bool inside = (value >= range.min) & (value <= range.max);
+            failed |= static_cast<std::uint64_t>(!inside | range.empty) << i;
+        }
+
+        for (std::size_t i = 0; failed != 0; ++i, failed >>= 1)
+        {
+            if (!(failed & 1))
+                continue;
+
+            V value;
+            std::memcpy(&value, data + i * stride, sizeof(V));
+            const bool low = rule.hasMin && !(value >= range.min && !range.empty);
+            violations.push_back({block + i, rule.property,
+                                  low ? Constraint::Min : Constraint::Max});
+        }
+    }
+}
+
+void checkFieldRange(const ValidationRule& rule, const char* first, std::size_t count,
+                     std::size_t stride, std::vector<Violation>& violations)
+{
+    first += rule.offset;
+
+    switch (rule.field->fieldType())
+    {
+        case FieldType::Bool:             checkRange<bool>(rule, first, count, stride, violations); break;
+        case FieldType::Char:             checkRange<char>(rule, first, count, stride, violations); break;
+        case FieldType::UnsignedChar:     checkRange<unsigned char>(rule, first, count, stride, violations); break;
+        case FieldType::Short:            checkRange<short>(rule, first, count, stride, violations); break;
+        case FieldType::UnsignedShort:    checkRange<unsigned short>(rule, first, count, stride, violations); break;
+        case FieldType::Int:              checkRange<int>(rule, first, count, stride, violations); break;
+        case FieldType::UnsignedInt:      checkRange<unsigned int>(rule, first, count, stride, violations); break;
+        case FieldType::Long:             checkRange<long>(rule, first, count, stride, violations); break;
+        case FieldType::UnsignedLong:     checkRange<unsigned long>(rule, first, count, stride, violations); break;
+        case FieldType::LongLong:         checkRange<long long>(rule, first, count, stride, violations); break;
+        case FieldType::UnsignedLongLong: checkRange<unsigned long long>(rule, first, count, stride, violations); break;
+        case FieldType::Float:            checkRange<float>(rule, first, count, stride, violations); break;
+        case FieldType::Double:           checkRange<double>(rule, first, count, stride, violations); break;
+        case FieldType::String:           break;
+    }
+}
+
+void checkString(const ValidationRule& rule, const String& value, std::size_t index,
+                 std::vector<Violation>& violations)
+{
+    if (rule.nonEmpty && value.empty())
+        violations.push_back({index, rule.property, Constraint::NonEmpty});
+    if (rule.badRegex || (rule.regex && !std::regex_match(value, *rule.regex)))
+        violations.push_back({index, rule.property, Constraint::Regex});
+}
+
+void checkValue(const ValidationRule& rule, const UserObject& object, std::size_t index,
+                std::vector<Violation>& violations)
+{
+    const Property& property = *rule.property;
+    if (!property.readable(object))
+        return;
+
+    switch (property.kind())
+    {
+        case ValueKind::Integer:
+        case ValueKind::Real:
+        {
+            const double value = property.get(object).to<double>();
+            if (rule.hasMin && !(value >= rule.min))
+                violations.push_back({index, rule.property, Constraint::Min});
+            else if (rule.hasMax && !(value <= rule.max))
+                violations.push_back({index, rule.property, Constraint::Max});
+            break;
+        }
+
+        case ValueKind::String:
+            checkString(rule, property.get(object).to<String>(), index, violations);
+            break;
+
+        case ValueKind::Array:
+            if (static_cast<const ArrayProperty&>(property).size(object) == 0)
+                violations.push_back({index, rule.property, Constraint::NonEmpty});
+            break;
+
+        case ValueKind::Dictionary:
+            if (static_cast<const DictionaryProperty&>(property).size(object) == 0)
+                violations.push_back({index, rule.property, Constraint::NonEmpty});
+            break;
+
+        default:
+            break;
+    }
+}
+
+// Compile the constraints of a property, return false if it has none which applies
+bool compile(const Property& property, const Class& metaclass, ValidationRule& rule)
+{
+    rule.property = &property;
+    const ValueKind kind = property.kind();
+
+    if (isNumber(kind))
+    {
+        const Value& min = property.tag(constraintTag(Constraint::Min));
+        const Value& max = property.tag(constraintTag(Constraint::Max));
+        rule.hasMin = isNumber(min.kind());
+        rule.hasMax = isNumber(max.kind());
+        rule.min = rule.hasMin ? min.to<double>() : 0;
+        rule.max = rule.hasMax ? max.to<double>() : 0;
+    }
+
+    if (kind == ValueKind::String || kind == ValueKind::Array || kind == ValueKind::Dictionary)
+        rule.nonEmpty = property.hasTag(constraintTag(Constraint::NonEmpty));
+
+    if (kind == ValueKind::String)
+    {
+        const Value& pattern = property.tag(constraintTag(Constraint::Regex));
+#if PONDER_NO_EXCEPTIONS
+        // std::regex can only report a malformed pattern with an exception
+        (void)pattern;
+#else
+        if (pattern.kind() == ValueKind::String)
+        {
+            try
+            {
+                rule.regex = std::make_shared<std::regex>(pattern.to<String>());
+            }
+            catch (const std::regex_error&)
+            {
+                rule.badRegex = true;
+            }
+        }
+#endif
+    }
+
+    if (!rule.hasMin && !rule.hasMax && !rule.nonEmpty && !rule.regex && !rule.badRegex)
+        return false;
+
+    // Data members are read in place, at their offset in the validated class
+    rule.field = dynamic_cast<const detail::FieldProperty*>(&property);
+    if (rule.field && !rule.field->offset(metaclass, rule.offset))
+        rule.field = nullptr;
+
+    return true;
+}
+
+} // namespace
+
+const char* constraintTag(Constraint constraint)
+{
+    switch (constraint)
+    {
+        case Constraint::Min:       return "min";
+        case Constraint::Max:       return "max";
+        case Constraint::NonEmpty:  return "nonEmpty";
+        case Constraint::Regex:     return "regex";
+    }
+
+    return "";
+}
+
+Validator::Validator(const Class& metaclass)
+    : m_class(&metaclass)
+{
+    auto program = std::make_shared<detail::ValidationProgram>();
+    for (auto const& entry : metaclass.propertyIterator())
+    {
+        ValidationRule rule;
+        if (compile(*entry.value(), metaclass, rule))
+            program->rules.push_back(std::move(rule));
+    }
+    m_program = std::move(program);
+}
+
+const Class& Validator::getClass() const
+{
+    return *m_class;
+}
+
+std::size_t Validator::ruleCount() const
+{
+    return m_program->rules.size();
+}
+
+bool Validator::validate(const UserObject& object, std::vector<Violation>& violations) const
+{
+    if (object.pointer() == nullptr)
+        return true;
+
+    return validate(object.pointer(), 1, 0, object.getClass(), violations);
+}
+
+bool Validator::validate(const void* objects, std::size_t count, std::size_t stride,
+                         const Class& objectClass, std::vector<Violation>& violations) const
+{
+    if (count == 0 || m_program->rules.empty())
+        return true;
+
+    // Adjust the objects to the validated class, they keep the same stride
+    void* pointer = const_cast<void*>(objects);
+    if (!objectClass.tryApplyOffset(pointer, *m_class))
+        PONDER_ERROR(ClassUnrelated(objectClass.name(), m_class->name()));
+    const char* first = static_cast<const char*>(pointer);
+
+    const std::size_t before = violations.size();
+    bool unordered = false;
+    for (const ValidationRule& rule : m_program->rules)
+    {
+        const std::size_t found = violations.size();
+
+        if (rule.field && isNumber(rule.field->fieldType()))
+        {
+            checkFieldRange(rule, first, count, stride, violations);
+        }
+        else if (rule.field)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const String& value =
+                    *reinterpret_cast<const String*>(first + i * stride + rule.offset);
+                checkString(rule, value, i, violations);
+            }
+        }
+        else
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                void* object = const_cast<char*>(first + i * stride);
+                checkValue(rule, m_class->getUserObjectFromPointer(object), i, violations);
+            }
+        }
+
+        unordered = unordered || (found != before && violations.size() != found);
+    }
+
+    // Rules are checked one after the other, report the violations in the object order
+    if (unordered)
+    {
+        std::stable_sort(violations.begin() + before, violations.end(),
+                         [](const Violation& a, const Violation& b) {return a.index < b.index;});
+    }
+
+    return violations.size() == before;
+}
+
+} // namespace ponder
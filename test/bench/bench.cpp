@@ -0,0 +1,155 @@
+/****************************************************************************
+**
+** This file is part of the CAMP library.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+#include "bench.hpp"
+#include <ponder/config.hpp>
+#include <ponder/version.hpp>
+#include <cstdarg>
+#include <string>
+#include <vector>
+
+namespace bench
+{
+    namespace
+    {
+        struct Result
+        {
+            std::string suite;
+            std::string name;
+            long iterations;
+            double ns;
+        };
+        
+        std::string currentSuite;
+        std::vector<Result> results;
+        
+        std::string escapeJson(const std::string& text)
+        {
+            std::string escaped;
+            for (char c : text)
+            {
+                if (c == '"' || c == '\\')
+                    escaped += '\\';
+                escaped += c;
+            }
+            return escaped;
+        }
+        
+        std::string escapeCsv(const std::string& text)
+        {
+            std::string escaped = "\"";
+            for (char c : text)
+            {
+                if (c == '"')
+                    escaped += '"';
+                escaped += c;
+            }
+            return escaped + '"';
+        }
+    }
+    
+    Options& options()
+    {
+        static Options options;
+        return options;
+    }
+    
+    void suite(const char* format, ...)
+    {
+        char title[256];
+        va_list args;
+        va_start(args, format);
+        std::vsnprintf(title, sizeof(title), format, args);
+        va_end(args);
+        
+        currentSuite = title;
+        std::printf("\n%s:\n", title);
+    }
+    
+    long iterations(long count)
+    {
+        const long scaled = static_cast<long>(count * options().scale);
+        return scaled > 0 ? scaled : 1;
+    }
+    
+    void record(const char* name, long iterations, double ns)
+    {
+        results.push_back(Result{currentSuite, name, iterations, ns});
+        std::printf("%-48s %10.1f ns\n", name, ns);
+        std::fflush(stdout);
+    }
+    
+    bool writeJson(const char* path)
+    {
+        std::FILE* file = std::fopen(path, "w");
+        if (!file)
+            return false;
+        
+        std::fprintf(file, "{\n");
+        std::fprintf(file, "  \"version\": \"%s\",\n", PONDER_VERSION_STR);
+        std::fprintf(file, "  \"threads\": \"%s\",\n",
+                     PONDER_SINGLE_THREADED ? "single" : "atomic");
+        std::fprintf(file, "  \"instrument\": %s,\n", PONDER_INSTRUMENT ? "true" : "false");
+#ifdef NDEBUG
+        std::fprintf(file, "  \"assertions\": false,\n");
+#else
+        std::fprintf(file, "  \"assertions\": true,\n");
+#endif
+        std::fprintf(file, "  \"scale\": %g,\n", options().scale);
+        std::fprintf(file, "  \"results\": [\n");
+        for (std::size_t i = 0; i < results.size(); ++i)
+        {
+            const Result& result = results[i];
+            std::fprintf(file,
+                         "    {\"suite\": \"%s\", \"name\": \"%s\", \"iterations\": %ld, \"ns\": %.3f}%s\n",
+                         escapeJson(result.suite).c_str(), escapeJson(result.name).c_str(),
+                         result.iterations, result.ns, i + 1 < results.size() ? "," : "");
+        }
+        std::fprintf(file, "  ]\n}\n");
+        
+        return std::fclose(file) == 0;
+    }
+    
+    bool writeCsv(const char* path)
+    {
+        std::FILE* file = std::fopen(path, "w");
+        if (!file)
+            return false;
+        
+        std::fprintf(file, "suite,name,iterations,ns\n");
+        for (const Result& result : results)
+        {
+            std::fprintf(file, "%s,%s,%ld,%.3f\n",
+                         escapeCsv(result.suite).c_str(), escapeCsv(result.name).c_str(),
+                         result.iterations, result.ns);
+        }
+        
+        return std::fclose(file) == 0;
+    }
+}
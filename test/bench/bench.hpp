@@ -0,0 +1,112 @@
+/****************************************************************************
+**
+** This file is part of the CAMP library.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+#ifndef PONDERBENCH_BENCH_HPP
+#define PONDERBENCH_BENCH_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+
+namespace bench
+{
+    // Prevent the optimizer from removing a computation
+    template <typename T>
+    inline void keep(const T& value)
+    {
+#if defined(_MSC_VER)
+        static const void* volatile sink;
+        sink = &value;
+#else
+        asm volatile("" : : "g"(&value) : "memory");
+#endif
+    }
+    
+    // Command line options shared by all the suites
+    struct Options
+    {
+        double scale = 1.;              // factor applied to every number of iterations
+        std::size_t maxClasses = 10000; // size of the largest synthetic schema
+    };
+    
+    Options& options();
+    
+    // Start a new group of measures, printed as a header and reported with each result
+    void suite(const char* format, ...);
+    
+    // Scale a number of iterations by the factor given on the command line
+    long iterations(long count);
+    
+    // Record a result in the current suite and print it
+    void record(const char* name, long iterations, double ns);
+    
+    // Write all the recorded results, returns false if the file can't be written
+    bool writeJson(const char* path);
+    bool writeCsv(const char* path);
+    
+    // Run func iterations times and record the time per iteration
+    template <typename F>
+    double measure(const char* name, long iterations, F func)
+    {
+        typedef std::chrono::steady_clock Clock;
+        
+        iterations = bench::iterations(iterations);
+        
+        func(); // warm up
+        
+        const Clock::time_point start = Clock::now();
+        for (long i = 0; i < iterations; ++i)
+            func();
+        const Clock::time_point end = Clock::now();
+        
+        const double ns = std::chrono::duration<double, std::nano>(end - start).count()
+                            / iterations;
+        record(name, iterations, ns);
+        return ns;
+    }
+    
+    // Run func once and record the time per item, for operations which can't be repeated
+    // (e.g. declaring count classes)
+    template <typename F>
+    double measureOnce(const char* name, long count, F func)
+    {
+        typedef std::chrono::steady_clock Clock;
+        
+        const Clock::time_point start = Clock::now();
+        func();
+        const Clock::time_point end = Clock::now();
+        
+        const double ns = std::chrono::duration<double, std::nano>(end - start).count()
+                            / count;
+        record(name, count, ns);
+        return ns;
+    }
+}
+
+#endif // PONDERBENCH_BENCH_HPP
@@ -0,0 +1,184 @@
+/****************************************************************************
+**
+** This file is part of the CAMP library.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+#include "bench.hpp"
+#include <ponder/classbuilder.hpp>
+#include <ponder/trace.hpp>
+#include <ponder/uses/runtime.hpp>
+#include <string>
+
+// Function calls with increasing numbers of arguments and object construction, through
+// the runtime.
+
+namespace CallBench
+{
+    struct Calculator
+    {
+        Calculator() : base(0) {}
+        Calculator(int a) : base(a) {}
+        Calculator(int a, int b) : base(a + b) {}
+        Calculator(int a, int b, int c) : base(a + b + c) {}
+        
+        int base;
+        
+        int f0() {return base;}
+        int f1(int a) {return base + a;}
+        int f2(int a, int b) {return base + a + b;}
+        int f3(int a, int b, int c) {return base + a + b + c;}
+        int f4(int a, int b, int c, int d) {return base + a + b + c + d;}
+        int f5(int a, int b, int c, int d, int e) {return base + a + b + c + d + e;}
+        int f6(int a, int b, int c, int d, int e, int f) {return base + a + b + c + d + e + f;}
+        
+        std::string concat(const std::string& a, const std::string& b) {return a + b;}
+        
+        static int twice(int a) {return a * 2;}
+    };
+}
+
+PONDER_TYPE(CallBench::Calculator)
+
+void benchCall()
+{
+    using namespace CallBench;
+    
+    ponder::Class::declare<Calculator>("CallBench::Calculator")
+        .constructor()
+        .constructor<int>()
+        .constructor<int, int>()
+        .constructor<int, int, int>()
+        .function("f0", &Calculator::f0)
+        .function("f1", &Calculator::f1)
+        .function("f2", &Calculator::f2)
+        .function("f3", &Calculator::f3)
+        .function("f4", &Calculator::f4)
+        .function("f5", &Calculator::f5)
+        .function("f6", &Calculator::f6)
+        .function("concat", &Calculator::concat)
+        .function("twice", &Calculator::twice);
+    
+    const ponder::Class& metaclass = ponder::classByType<Calculator>();
+    Calculator calculator;
+    const ponder::UserObject object(calculator);
+    
+    bench::suite("runtime::call");
+    
+    const ponder::Function* f[7];
+    for (int i = 0; i < 7; ++i)
+        f[i] = &metaclass.function("f" + std::to_string(i));
+    
+    bench::measure("0 arguments", 1000000, [&]()
+    {
+        bench::keep(ponder::runtime::call(*f[0], object));
+    });
+    
+    bench::measure("1 argument", 1000000, [&]()
+    {
+        bench::keep(ponder::runtime::call(*f[1], object, 1));
+    });
+    
+    bench::measure("2 arguments", 1000000, [&]()
+    {
+        bench::keep(ponder::runtime::call(*f[2], object, 1, 2));
+    });
+    
+    // Each traced call appends an event, keep the buffers small
+    ponder::trace::start();
+    bench::measure("2 arguments, traced", 100000, [&]()
+    {
+        bench::keep(ponder::runtime::call(*f[2], object, 1, 2));
+    });
+    ponder::trace::stop();
+    ponder::trace::clear();
+    
+    bench::measure("3 arguments", 1000000, [&]()
+    {
+        bench::keep(ponder::runtime::call(*f[3], object, 1, 2, 3));
+    });
+    
+    bench::measure("4 arguments", 1000000, [&]()
+    {
+        bench::keep(ponder::runtime::call(*f[4], object, 1, 2, 3, 4));
+    });
+    
+    bench::measure("5 arguments", 1000000, [&]()
+    {
+        bench::keep(ponder::runtime::call(*f[5], object, 1, 2, 3, 4, 5));
+    });
+    
+    bench::measure("6 arguments", 1000000, [&]()
+    {
+        bench::keep(ponder::runtime::call(*f[6], object, 1, 2, 3, 4, 5, 6));
+    });
+    
+    const ponder::Function& concat = metaclass.function("concat");
+    const std::string left = "left", right = "right";
+    bench::measure("2 String arguments", 1000000, [&]()
+    {
+        bench::keep(ponder::runtime::call(concat, object, left, right));
+    });
+    
+    const ponder::Function& twice = metaclass.function("twice");
+    bench::measure("callStatic, 1 argument", 1000000, [&]()
+    {
+        bench::keep(ponder::runtime::callStatic(twice, 1));
+    });
+    
+    ponder::runtime::ObjectCaller caller(*f[2]);
+    bench::measure("ObjectCaller::call, 2 arguments", 1000000, [&]()
+    {
+        bench::keep(caller.call(object, ponder::Args(1, 2)));
+    });
+    
+    bench::suite("ObjectFactory");
+    
+    const ponder::runtime::ObjectFactory factory(metaclass);
+    
+    bench::measure("create and destroy, 0 arguments", 1000000, [&]()
+    {
+        factory.destroy(factory.create());
+    });
+    
+    bench::measure("create and destroy, 1 argument", 1000000, [&]()
+    {
+        factory.destroy(factory.create(1));
+    });
+    
+    bench::measure("create and destroy, 3 arguments", 1000000, [&]()
+    {
+        factory.destroy(factory.create(1, 2, 3));
+    });
+    
+    alignas(Calculator) char buffer[sizeof(Calculator)];
+    bench::measure("construct and destruct in place", 1000000, [&]()
+    {
+        factory.destruct(factory.construct(ponder::Args(1, 2), buffer));
+    });
+    
+    ponder::Class::undeclare<Calculator>();
+}
@@ -0,0 +1,118 @@
+/****************************************************************************
+**
+** This file is part of the CAMP library.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+#define PONDER_USES_RUNTIME_IMPL
+#include "bench.hpp"
+#include <ponder/classbuilder.hpp>
+#include <ponder/uses/runtime.hpp>
+#include <ponder/uses/ponder_c.h>
+
+// Property access and function calls through the C interface, compared with the
+// equivalent calls through the C++ interface.
+
+namespace CApiBench
+{
+    struct Body
+    {
+        Body() : mass(1.), x(0.) {}
+        
+        double mass;
+        double x;
+        
+        double push(double dx) {x += dx / mass; return x;}
+    };
+}
+
+PONDER_TYPE(CApiBench::Body)
+
+void benchCApi()
+{
+    using namespace CApiBench;
+    
+    ponder::Class::declare<Body>("CApiBench::Body")
+        .property("mass", &Body::mass)
+        .property("x", &Body::x)
+        .function("push", &Body::push);
+    
+    bench::suite("C interface");
+    
+    Body body;
+    
+    const ponder::Class& metaclass = ponder::classByType<Body>();
+    const ponder::Property& mass = metaclass.property("mass");
+    const ponder::Function& push = metaclass.function("push");
+    
+    const ponder_class* cls = nullptr;
+    const ponder_property* cmass = nullptr;
+    const ponder_function* cpush = nullptr;
+    ponder_class_find("CApiBench::Body", &cls);
+    ponder_class_property(cls, "mass", &cmass);
+    ponder_class_function(cls, "push", &cpush);
+    
+    bench::measure("C++ Property::get", 10000000, [&]()
+    {
+        bench::keep(mass.get(body).to<double>());
+    });
+    
+    bench::measure("ponder_property_get", 10000000, [&]()
+    {
+        ponder_value value;
+        ponder_property_get(cmass, cls, &body, &value);
+        bench::keep(value.u.r);
+    });
+    
+    bench::measure("C++ Property::set", 10000000, [&]()
+    {
+        mass.set(body, 2.);
+    });
+    
+    bench::measure("ponder_property_set", 10000000, [&]()
+    {
+        ponder_value value;
+        value.type = PONDER_TYPE_REAL;
+        value.u.r = 2.;
+        ponder_property_set(cmass, cls, &body, &value);
+    });
+    
+    bench::measure("C++ runtime::call", 1000000, [&]()
+    {
+        bench::keep(ponder::runtime::call(push, body, 1.).to<double>());
+    });
+    
+    bench::measure("ponder_function_call", 1000000, [&]()
+    {
+        ponder_value arg, result;
+        arg.type = PONDER_TYPE_REAL;
+        arg.u.r = 1.;
+        ponder_function_call(cpush, cls, &body, &arg, 1, &result);
+        bench::keep(result.u.r);
+    });
+    
+    ponder::Class::undeclare<Body>();
+}
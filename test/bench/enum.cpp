@@ -0,0 +1,108 @@
+/****************************************************************************
+**
+** This file is part of the CAMP library.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+#include "bench.hpp"
+#include <ponder/enum.hpp>
+#include <ponder/enumobject.hpp>
+#include <ponder/value.hpp>
+#include <string>
+
+// Enum value -> name and name -> value lookups, as done by serializers and logs.
+
+namespace EnumBench
+{
+    enum Opcode : long {};
+    enum Flags : long {};
+}
+
+PONDER_TYPE(EnumBench::Opcode)
+PONDER_TYPE(EnumBench::Flags)
+
+void benchEnum()
+{
+    using namespace EnumBench;
+    
+    const long count = 64;
+    {
+        ponder::EnumBuilder builder = ponder::Enum::declare<Opcode>("EnumBench::Opcode");
+        for (long i = 0; i < count; ++i)
+            builder.value("op" + std::to_string(i), i * 3);
+    }
+    
+    bench::suite("Enum lookups (%ld values)", count);
+    
+    const ponder::Enum& metaenum = ponder::enumByType<Opcode>();
+    const Opcode last = static_cast<Opcode>((count - 1) * 3);
+    const ponder::String lastName = "op" + std::to_string(count - 1);
+    
+    bench::measure("Enum::name(value)", 10000000, [&]()
+    {
+        bench::keep(metaenum.name(last));
+    });
+    
+    bench::measure("Enum::value(name)", 10000000, [&]()
+    {
+        bench::keep(metaenum.value(lastName));
+    });
+    
+    bench::measure("Value(enum).to<String>()", 1000000, [&]()
+    {
+        bench::keep(ponder::Value(last).to<ponder::String>());
+    });
+    
+    bench::measure("Value(String).to<enum>()", 1000000, [&]()
+    {
+        bench::keep(ponder::Value(lastName).to<Opcode>());
+    });
+    
+    {
+        ponder::EnumBuilder builder = ponder::Enum::declare<Flags>("EnumBench::Flags").flags();
+        for (long i = 0; i < 16; ++i)
+            builder.value("flag" + std::to_string(i), 1L << i);
+    }
+    
+    const ponder::Enum& flags = ponder::enumByType<Flags>();
+    const long combined = (1L << 1) | (1L << 5) | (1L << 9) | (1L << 14);
+    char text[128];
+    flags.formatFlags(combined, text, sizeof(text));
+    const ponder::String flagsText(text);
+    
+    bench::measure("Enum::formatFlags (4 flags, buffer)", 1000000, [&]()
+    {
+        bench::keep(flags.formatFlags(combined, text, sizeof(text)));
+    });
+    
+    bench::measure("Enum::parseFlags (4 flags)", 1000000, [&]()
+    {
+        bench::keep(flags.parseFlags(flagsText));
+    });
+    
+    ponder::Enum::undeclare<Flags>();
+    ponder::Enum::undeclare<Opcode>();
+}
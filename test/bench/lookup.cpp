@@ -0,0 +1,119 @@
+/****************************************************************************
+**
+** This file is part of the CAMP library.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+#include "bench.hpp"
+#include "schema.hpp"
+#include <ponder/classget.hpp>
+#include <ponder/detail/classmanager.hpp>
+
+// Metaclass and member lookups, against schemas of increasing size.
+
+void benchLookup()
+{
+    bench::DeepHierarchy hierarchy;
+    
+    for (std::size_t count = 10; count <= bench::options().maxClasses; count *= 10)
+    {
+        bench::suite("Class lookup (%zu classes)", count);
+        
+        // Filled by the constructor, timed separately
+        bench::Schema* schema = nullptr;
+        bench::measureOnce("Class::declare, per class", static_cast<long>(count), [&]()
+        {
+            schema = new bench::Schema(count);
+        });
+        
+        const ponder::String first = schema->name(0);
+        const ponder::String last = schema->name(count - 1);
+        const ponder::String missing = "SynthMissing";
+        
+        bench::measure("classByName, first class", 1000000, [&]()
+        {
+            bench::keep(ponder::classByName(first));
+        });
+        
+        bench::measure("classByName, last class", 1000000, [&]()
+        {
+            bench::keep(ponder::classByName(last));
+        });
+        
+        bench::measure("ClassManager::getByIdSafe, missing class", 1000000, [&]()
+        {
+            bench::keep(ponder::detail::ClassManager::instance().getByIdSafe(missing));
+        });
+        
+        bench::measure("classByType", 1000000, [&]()
+        {
+            bench::keep(ponder::classByType<bench::Deep<bench::deepDepth>>());
+        });
+        
+        const std::size_t lastIndex = ponder::classCount() - 1;
+        bench::measure("classByIndex, last class", 10000000 / static_cast<long>(count), [&]()
+        {
+            bench::keep(ponder::classByIndex(lastIndex));
+        });
+        
+        bench::measureOnce("Class::undeclare, per class", static_cast<long>(count), [&]()
+        {
+            delete schema;
+        });
+    }
+    
+    bench::suite("Member lookup");
+    
+    const ponder::Class& deep = ponder::classByType<bench::Deep<bench::deepDepth>>();
+    const ponder::String own = "v" + std::to_string(bench::deepDepth);
+    const ponder::String inherited = "v0";
+    const ponder::String function = "f" + std::to_string(bench::deepDepth);
+    
+    bench::measure("Class::property, declared", 10000000, [&]()
+    {
+        bench::keep(deep.property(own));
+    });
+    
+    bench::measure("Class::property, inherited 16 levels up", 10000000, [&]()
+    {
+        bench::keep(deep.property(inherited));
+    });
+    
+    bench::measure("Class::hasProperty, missing", 10000000, [&]()
+    {
+        bench::keep(deep.hasProperty("missing"));
+    });
+    
+    bench::measure("Class::function", 10000000, [&]()
+    {
+        bench::keep(deep.function(function));
+    });
+    
+    bench::measure("Class::property(index)", 10000000, [&]()
+    {
+        bench::keep(deep.property(deep.propertyCount() - 1));
+    });
+}
@@ -0,0 +1,153 @@
+/****************************************************************************
+**
+** This file is part of the CAMP library.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+#include "bench.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+void benchLookup();
+void benchProperty();
+void benchValue();
+void benchUserObject();
+void benchCall();
+void benchXml();
+void benchRefCount();
+void benchPolymorphic();
+void benchCApi();
+void benchEnum();
+void benchTags();
+
+namespace
+{
+    struct Suite
+    {
+        const char* name;
+        void (*run)();
+    };
+    
+    const Suite suites[] =
+    {
+        {"lookup", &benchLookup},
+        {"property", &benchProperty},
+        {"value", &benchValue},
+        {"userobject", &benchUserObject},
+        {"call", &benchCall},
+        {"xml", &benchXml},
+        {"refcount", &benchRefCount},
+        {"polymorphic", &benchPolymorphic},
+        {"capi", &benchCApi},
+        {"enum", &benchEnum},
+        {"tags", &benchTags},
+    };
+    
+    void usage(const char* program)
+    {
+        std::printf("Usage: %s [options] [suite...]\n"
+                    "  --json <file>       write the results as JSON\n"
+                    "  --csv <file>        write the results as CSV\n"
+                    "  --scale <factor>    multiply the number of iterations (default 1)\n"
+                    "  --max-classes <n>   size of the largest synthetic schema (default 10000)\n"
+                    "Suites:", program);
+        for (const Suite& suite : suites)
+            std::printf(" %s", suite.name);
+        std::printf("\n");
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const char* json = nullptr;
+    const char* csv = nullptr;
+    std::vector<const char*> selected;
+    
+    for (int i = 1; i < argc; ++i)
+    {
+        const char* arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(arg, "--json") == 0 && hasValue)
+            json = argv[++i];
+        else if (std::strcmp(arg, "--csv") == 0 && hasValue)
+            csv = argv[++i];
+        else if (std::strcmp(arg, "--scale") == 0 && hasValue)
+            bench::options().scale = std::atof(argv[++i]);
+        else if (std::strcmp(arg, "--max-classes") == 0 && hasValue)
+            bench::options().maxClasses = std::strtoul(argv[++i], nullptr, 10);
+        else if (arg[0] != '-')
+            selected.push_back(arg);
+        else
+        {
+            usage(argv[0]);
+            return std::strcmp(arg, "--help") == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    
+    for (const char* name : selected)
+    {
+        bool found = false;
+        for (const Suite& suite : suites)
+            found = found || std::strcmp(suite.name, name) == 0;
+        if (!found)
+        {
+            std::printf("Unknown suite: %s\n", name);
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    
+    std::printf("Ponder benchmarks\n");
+    
+    // Some standard libraries skip atomic operations until a thread has been started.
+    // Start one so that the std:: reference points are those of a multi-threaded process.
+    std::thread([]{}).join();
+    
+    for (const Suite& suite : suites)
+    {
+        bool run = selected.empty();
+        for (const char* name : selected)
+            run = run || std::strcmp(suite.name, name) == 0;
+        if (run)
+            suite.run();
+    }
+    
+    if (json && !bench::writeJson(json))
+    {
+        std::printf("Can't write %s\n", json);
+        return EXIT_FAILURE;
+    }
+    
+    if (csv && !bench::writeCsv(csv))
+    {
+        std::printf("Can't write %s\n", csv);
+        return EXIT_FAILURE;
+    }
+    
+    return EXIT_SUCCESS;
+}
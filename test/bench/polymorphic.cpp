@@ -0,0 +1,83 @@
+/****************************************************************************
+**
+** This file is part of the CAMP library.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+#include "bench.hpp"
+#include <ponder/classbuilder.hpp>
+
+// Finding the dynamic metaclass of polymorphic objects, as done by each UserObject
+// construction from a base pointer.
+
+namespace PolymorphicBench
+{
+    struct Entity
+    {
+        virtual ~Entity() {}
+        PONDER_POLYMORPHIC()
+    };
+    
+    struct Monster : Entity
+    {
+        PONDER_POLYMORPHIC()
+    };
+}
+
+PONDER_TYPE(PolymorphicBench::Entity)
+PONDER_TYPE(PolymorphicBench::Monster)
+
+void benchPolymorphic()
+{
+    using namespace PolymorphicBench;
+    
+    ponder::Class::declare<Entity>("PolymorphicBench::Entity");
+    ponder::Class::declare<Monster>("PolymorphicBench::Monster")
+        .base<Entity>();
+    
+    bench::suite("Dynamic metaclass lookup");
+    
+    Monster monster;
+    Entity* entity = &monster;
+    
+    bench::measure("classByName(ponderClassId())", 10000000, [&]()
+    {
+        bench::keep(ponder::classByName(entity->ponderClassId()));
+    });
+    
+    bench::measure("classByObject (cached)", 10000000, [&]()
+    {
+        bench::keep(ponder::classByObject(entity));
+    });
+    
+    bench::measure("UserObject::makeRef from base pointer", 10000000, [&]()
+    {
+        bench::keep(ponder::UserObject::makeRef(entity));
+    });
+    
+    ponder::Class::undeclare<Monster>();
+    ponder::Class::undeclare<Entity>();
+}
@@ -0,0 +1,179 @@
+/****************************************************************************
+**
+** This file is part of the CAMP library.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+#include "bench.hpp"
+#include <ponder/classbuilder.hpp>
+#include <ponder/enumbuilder.hpp>
+#include <ponder/detail/util.hpp>
+#include <string>
+#include <vector>
+
+// Property reads and writes for each kind of property, and array element access.
+
+namespace PropertyBench
+{
+    enum Color {red, green, blue};
+    
+    struct Point
+    {
+        double x, y;
+    };
+    
+    struct Record
+    {
+        Record() : integer(0), real(0.), color(red), point{0., 0.}, list(64, 0), fixed(), accessed(0) {}
+        
+        int integer;
+        double real;
+        std::string text;
+        Color color;
+        Point point;
+        std::vector<int> list;
+        int fixed[16];
+        
+        int getAccessed() const {return accessed;}
+        void setAccessed(int value) {accessed = value;}
+        int accessed;
+    };
+}
+
+PONDER_TYPE(PropertyBench::Color)
+PONDER_TYPE(PropertyBench::Point)
+PONDER_TYPE(PropertyBench::Record)
+
+void benchProperty()
+{
+    using namespace PropertyBench;
+    
+    ponder::Enum::declare<Color>("PropertyBench::Color")
+        .value("red", red)
+        .value("green", green)
+        .value("blue", blue);
+    
+    ponder::Class::declare<Point>("PropertyBench::Point")
+        .property("x", &Point::x)
+        .property("y", &Point::y);
+    
+    ponder::Class::declare<Record>("PropertyBench::Record")
+        .property("integer", &Record::integer)
+        .property("real", &Record::real)
+        .property("text", &Record::text)
+        .property("color", &Record::color)
+        .property("point", &Record::point)
+        .property("list", &Record::list)
+        .property("fixed", &Record::fixed)
+        .property("accessed", &Record::getAccessed, &Record::setAccessed)
+        .property("lambda",
+                  [](const Record& r) {return r.accessed;},
+                  [](Record& r, int value) {r.accessed = value;});
+    
+    Record record;
+    const ponder::UserObject object(record);
+    const ponder::Class& metaclass = ponder::classByType<Record>();
+    
+    bench::suite("Property get");
+    
+    const char* const names[] = {"integer", "real", "text", "color", "point", "accessed", "lambda"};
+    for (const char* name : names)
+    {
+        const ponder::Property& property = metaclass.property(name);
+        const std::string title = std::string(name) + " (" + ponder::detail::valueTypeAsString(property.kind()) + ")";
+        bench::measure(title.c_str(), 1000000, [&]()
+        {
+            bench::keep(property.get(object));
+        });
+    }
+    
+    bench::suite("Property set");
+    
+    const ponder::Value values[] = {ponder::Value(42), ponder::Value(4.2), ponder::Value("text"),
+                                    ponder::Value(blue), ponder::Value(Point{1., 2.}),
+                                    ponder::Value(42), ponder::Value(42)};
+    for (std::size_t i = 0; i < sizeof(names) / sizeof(names[0]); ++i)
+    {
+        const ponder::Property& property = metaclass.property(names[i]);
+        const ponder::Value& value = values[i];
+        const std::string title = std::string(names[i]) + " (" + ponder::detail::valueTypeAsString(property.kind()) + ")";
+        bench::measure(title.c_str(), 1000000, [&]()
+        {
+            property.set(object, value);
+        });
+    }
+    
+    bench::measure("integer, from a string", 1000000, [&]()
+    {
+        static const ponder::Value text("42");
+        metaclass.property("integer").set(object, text);
+    });
+    
+    bench::suite("Array property");
+    
+    const char* const arrays[] = {"list", "fixed"};
+    for (const char* name : arrays)
+    {
+        const ponder::ArrayProperty& array =
+            static_cast<const ponder::ArrayProperty&>(metaclass.property(name));
+        const std::string prefix = std::string(name) + ", ";
+        
+        bench::measure((prefix + "size").c_str(), 1000000, [&]()
+        {
+            bench::keep(array.size(object));
+        });
+        
+        bench::measure((prefix + "get element").c_str(), 1000000, [&]()
+        {
+            bench::keep(array.get(object, 7));
+        });
+        
+        const ponder::Value element(5);
+        bench::measure((prefix + "set element").c_str(), 1000000, [&]()
+        {
+            array.set(object, 7, element);
+        });
+        
+        bench::measure((prefix + "get all elements").c_str(), 100000, [&]()
+        {
+            const std::size_t size = array.size(object);
+            for (std::size_t i = 0; i < size; ++i)
+                bench::keep(array.get(object, i));
+        });
+    }
+    
+    const ponder::ArrayProperty& list =
+        static_cast<const ponder::ArrayProperty&>(metaclass.property("list"));
+    bench::measure("list, insert and remove", 1000000, [&]()
+    {
+        list.insert(object, 0, 1);
+        list.remove(object, 0);
+    });
+    
+    ponder::Class::undeclare<Record>();
+    ponder::Class::undeclare<Point>();
+    ponder::Enum::undeclare<Color>();
+}
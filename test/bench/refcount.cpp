@@ -0,0 +1,103 @@
+/****************************************************************************
+**
+** This file is part of the CAMP library.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+#include "bench.hpp"
+#include <ponder/classbuilder.hpp>
+#include <memory>
+#include <vector>
+
+// Copy-heavy workloads dominated by reference counting of UserObject holders.
+// Build with and without PONDER_SINGLE_THREADED to compare.
+
+namespace RefCountBench
+{
+    struct Item
+    {
+        int x;
+    };
+    
+    struct Counted : ponder::detail::RefCounted
+    {
+        virtual ~Counted() {}
+    };
+}
+
+PONDER_TYPE(RefCountBench::Item)
+
+void benchRefCount()
+{
+    using namespace RefCountBench;
+    
+    ponder::Class::declare<Item>("RefCountBench::Item")
+        .property("x", &Item::x);
+    
+    bench::suite("Reference counts (%s)",
+                 PONDER_SINGLE_THREADED ? "single-threaded" : "atomic");
+    
+    Item item = {1};
+    const ponder::UserObject object(item);
+    
+    bench::measure("UserObject copy", 10000000, [&]()
+    {
+        ponder::UserObject copy(object);
+        bench::keep(copy);
+    });
+    
+    bench::measure("Args building (8 user objects)", 1000000, [&]()
+    {
+        ponder::Args args;
+        for (int i = 0; i < 8; ++i)
+            args += object;
+        bench::keep(args);
+    });
+    
+    std::vector<ponder::Value> values(256, ponder::Value(object));
+    bench::measure("std::vector<Value> copy (256 objects)", 100000, [&]()
+    {
+        std::vector<ponder::Value> copy(values);
+        bench::keep(copy);
+    });
+    
+    // Reference points, independent of the build configuration
+    std::shared_ptr<int> shared(new int(0));
+    bench::measure("std::shared_ptr copy", 10000000, [&]()
+    {
+        std::shared_ptr<int> copy(shared);
+        bench::keep(copy);
+    });
+    
+    ponder::detail::RefPtr<Counted> intrusive(new Counted);
+    bench::measure("detail::RefPtr copy", 10000000, [&]()
+    {
+        ponder::detail::RefPtr<Counted> copy(intrusive);
+        bench::keep(copy);
+    });
+    
+    ponder::Class::undeclare<Item>();
+}
@@ -0,0 +1,62 @@
+/****************************************************************************
+**
+** This file is part of the CAMP library.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+#include "schema.hpp"
+
+namespace bench
+{
+    Schema::Schema(std::size_t classCount, std::size_t propertyCount, std::size_t functionCount)
+    {
+        if (propertyCount > maxProperties)
+            propertyCount = maxProperties;
+        
+        m_names.reserve(classCount);
+        for (std::size_t i = 0; i < classCount; ++i)
+        {
+            m_names.push_back("Synth" + std::to_string(i));
+            
+            ponder::ClassBuilder<SynthObject> builder =
+                ponder::Class::declare<SynthObject>(m_names.back());
+            for (std::size_t j = 0; j < propertyCount; ++j)
+            {
+                builder.property("p" + std::to_string(j),
+                                 [j](const SynthObject& object) {return object.p[j];},
+                                 [j](SynthObject& object, int value) {object.p[j] = value;});
+            }
+            for (std::size_t j = 0; j < functionCount; ++j)
+                builder.function("f" + std::to_string(j), &SynthObject::sum);
+        }
+    }
+    
+    Schema::~Schema()
+    {
+        for (auto it = m_names.rbegin(); it != m_names.rend(); ++it)
+            ponder::Class::undeclare<SynthObject>(*it);
+    }
+}
@@ -0,0 +1,167 @@
+/****************************************************************************
+**
+** This file is part of the CAMP library.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+#ifndef PONDERBENCH_SCHEMA_HPP
+#define PONDERBENCH_SCHEMA_HPP
+
+#include <ponder/classbuilder.hpp>
+#include <string>
+#include <vector>
+
+namespace bench
+{
+    // Object bound to every metaclass of a synthetic schema
+    struct SynthObject
+    {
+        SynthObject() : p() {}
+        
+        int p[8];
+        
+        int sum(int x) const {return p[0] + x;}
+    };
+    
+    /*
+     * Synthetic schema: classCount metaclasses named "Synth0", "Synth1"... declared on
+     * construction and undeclared on destruction. They are all bound to SynthObject, so
+     * they can only be found by name, but they are as large as hand written classes.
+     */
+    class Schema
+    {
+    public:
+        
+        static const std::size_t maxProperties = 8;
+        
+        Schema(std::size_t classCount, std::size_t propertyCount = 4,
+               std::size_t functionCount = 2);
+        ~Schema();
+        
+        std::size_t size() const {return m_names.size();}
+        const std::string& name(std::size_t index) const {return m_names[index];}
+        
+    private:
+        
+        Schema(const Schema&) = delete;
+        Schema& operator = (const Schema&) = delete;
+        
+        std::vector<std::string> m_names;
+    };
+    
+    /*
+     * Deep single inheritance chain: Deep<N> derives from Deep<N - 1> and adds the
+     * property "v<N>" and the function "f<N>".
+     */
+    template <int N>
+    struct Deep : Deep<N - 1>
+    {
+        int v = N;
+        
+        int f() const {return v;}
+    };
+    
+    template <>
+    struct Deep<0>
+    {
+        virtual ~Deep() {}
+        
+        int v = 0;
+        
+        int f() const {return v;}
+    };
+}
+
+PONDER_TYPE(bench::SynthObject)
+
+namespace ponder {
+namespace detail {
+    
+template <int N>
+struct StaticTypeId<bench::Deep<N>>
+{
+    static const char* get(bool = true)
+    {
+        static const std::string name = "bench::Deep<" + std::to_string(N) + ">";
+        return name.c_str();
+    }
+    
+    enum {defined = true, copyable = true};
+};
+    
+} // namespace detail
+} // namespace ponder
+
+namespace bench
+{
+    static const int deepDepth = 16;
+    
+    template <int N>
+    struct DeepDeclaration
+    {
+        static void declare()
+        {
+            DeepDeclaration<N - 1>::declare();
+            ponder::Class::declare<Deep<N>>()
+                .template base<Deep<N - 1>>()
+                .constructor()
+                .property("v" + std::to_string(N), &Deep<N>::v)
+                .function("f" + std::to_string(N), &Deep<N>::f);
+        }
+        
+        static void undeclare()
+        {
+            ponder::Class::undeclare<Deep<N>>();
+            DeepDeclaration<N - 1>::undeclare();
+        }
+    };
+    
+    template <>
+    struct DeepDeclaration<0>
+    {
+        static void declare()
+        {
+            ponder::Class::declare<Deep<0>>()
+                .constructor()
+                .property("v0", &Deep<0>::v)
+                .function("f0", &Deep<0>::f);
+        }
+        
+        static void undeclare()
+        {
+            ponder::Class::undeclare<Deep<0>>();
+        }
+    };
+    
+    // Declare Deep<0> to Deep<deepDepth> for the lifetime of the object
+    struct DeepHierarchy
+    {
+        DeepHierarchy() {DeepDeclaration<deepDepth>::declare();}
+        ~DeepHierarchy() {DeepDeclaration<deepDepth>::undeclare();}
+    };
+}
+
+#endif // PONDERBENCH_SCHEMA_HPP
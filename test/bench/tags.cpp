@@ -0,0 +1,85 @@
+/****************************************************************************
+**
+** This file is part of the CAMP library.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+#include "bench.hpp"
+#include <ponder/classbuilder.hpp>
+
+// Filtering the properties of a class by tag, as done by serializers excluding properties.
+
+namespace TagBench
+{
+    struct Record
+    {
+        int p[16];
+    };
+}
+
+PONDER_TYPE(TagBench::Record)
+
+void benchTags()
+{
+    using namespace TagBench;
+    
+    {
+        ponder::ClassBuilder<Record> builder = ponder::Class::declare<Record>("TagBench::Record");
+        for (int i = 0; i < 16; ++i)
+        {
+            builder.property("p" + std::to_string(i),
+                             [i](const Record& r) {return r.p[i];},
+                             [i](Record& r, int v) {r.p[i] = v;});
+            builder.tag("category", i).tag(i);
+            if (i % 4 == 0)
+                builder.tag("transient");
+        }
+    }
+    
+    bench::suite("Tags (16 properties)");
+    
+    const ponder::Class& metaclass = ponder::classByType<Record>();
+    const ponder::Value exclude("transient");
+    
+    bench::measure("Property::hasTag, all properties", 1000000, [&]()
+    {
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < metaclass.propertyCount(); ++i)
+            count += metaclass.property(i).hasTag(exclude);
+        bench::keep(count);
+    });
+    
+    bench::measure("Class::propertiesWithTag, all properties", 1000000, [&]()
+    {
+        const auto excluded = metaclass.propertiesWithTag(exclude);
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < metaclass.propertyCount(); ++i)
+            count += (*excluded)[i];
+        bench::keep(count);
+    });
+    
+    ponder::Class::undeclare<Record>();
+}
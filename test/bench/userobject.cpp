@@ -0,0 +1,98 @@
+/****************************************************************************
+**
+** This file is part of the CAMP library.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+#include "bench.hpp"
+#include "schema.hpp"
+#include <ponder/classget.hpp>
+#include <ponder/userobject.hpp>
+
+// Wrapping C++ objects in UserObjects and casting them back, across a deep hierarchy.
+
+void benchUserObject()
+{
+    using bench::Deep;
+    using bench::deepDepth;
+    
+    bench::DeepHierarchy hierarchy;
+    
+    bench::suite("UserObject (%d levels of inheritance)", deepDepth);
+    
+    Deep<deepDepth> leaf;
+    Deep<0>* root = &leaf;
+    
+    bench::measure("makeRef", 10000000, [&]()
+    {
+        bench::keep(ponder::UserObject::makeRef(leaf));
+    });
+    
+    bench::measure("makeRef, from the root class", 10000000, [&]()
+    {
+        bench::keep(ponder::UserObject::makeRef(*root));
+    });
+    
+    bench::measure("makeCopy", 1000000, [&]()
+    {
+        bench::keep(ponder::UserObject::makeCopy(leaf));
+    });
+    
+    const ponder::UserObject object = ponder::UserObject::makeRef(leaf);
+    
+    bench::measure("get<T>, same class", 10000000, [&]()
+    {
+        bench::keep(object.get<Deep<deepDepth>>().v);
+    });
+    
+    bench::measure("get<T>, base 1 level up", 10000000, [&]()
+    {
+        bench::keep(object.get<Deep<deepDepth - 1>>().v);
+    });
+    
+    bench::measure("get<T>, base 16 levels up", 10000000, [&]()
+    {
+        bench::keep(object.get<Deep<0>>().v);
+    });
+    
+    const ponder::Class& leafClass = ponder::classByType<Deep<deepDepth>>();
+    const ponder::Class& rootClass = ponder::classByType<Deep<0>>();
+    
+    bench::measure("classCast, down 16 levels", 10000000, [&]()
+    {
+        bench::keep(ponder::classCast(root, rootClass, leafClass));
+    });
+    
+    bench::measure("UserObject::getClass", 10000000, [&]()
+    {
+        bench::keep(object.getClass());
+    });
+    
+    bench::measure("UserObject::get(property), inherited", 1000000, [&]()
+    {
+        bench::keep(object.get("v0"));
+    });
+}
@@ -0,0 +1,172 @@
+/****************************************************************************
+**
+** This file is part of the CAMP library.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+#include "bench.hpp"
+#include <ponder/classbuilder.hpp>
+#include <ponder/enumbuilder.hpp>
+#include <ponder/value.hpp>
+
+// Value construction, copy and conversions between the value kinds.
+
+namespace ValueBench
+{
+    enum Mode {off, on};
+    
+    struct Blob
+    {
+        int id;
+    };
+}
+
+PONDER_TYPE(ValueBench::Mode)
+PONDER_TYPE(ValueBench::Blob)
+
+void benchValue()
+{
+    using namespace ValueBench;
+    
+    ponder::Enum::declare<Mode>("ValueBench::Mode")
+        .value("off", off)
+        .value("on", on);
+    ponder::Class::declare<Blob>("ValueBench::Blob");
+    
+    bench::suite("Value construction");
+    
+    const ponder::String text = "a short string";
+    Blob blob = {1};
+    const ponder::UserObject object(blob);
+    
+    bench::measure("Value()", 10000000, [&]()
+    {
+        bench::keep(ponder::Value());
+    });
+    
+    bench::measure("Value(bool)", 10000000, [&]()
+    {
+        bench::keep(ponder::Value(true));
+    });
+    
+    bench::measure("Value(int)", 10000000, [&]()
+    {
+        bench::keep(ponder::Value(42));
+    });
+    
+    bench::measure("Value(double)", 10000000, [&]()
+    {
+        bench::keep(ponder::Value(4.2));
+    });
+    
+    bench::measure("Value(String)", 10000000, [&]()
+    {
+        bench::keep(ponder::Value(text));
+    });
+    
+    bench::measure("Value(enum)", 10000000, [&]()
+    {
+        bench::keep(ponder::Value(on));
+    });
+    
+    bench::measure("Value(UserObject)", 10000000, [&]()
+    {
+        bench::keep(ponder::Value(object));
+    });
+    
+    const ponder::Value integer(42);
+    const ponder::Value real(4.2);
+    const ponder::Value string(ponder::String("42"));
+    const ponder::Value enumeration(on);
+    const ponder::Value user(object);
+    
+    bench::measure("Value copy, int", 10000000, [&]()
+    {
+        ponder::Value copy(integer);
+        bench::keep(copy);
+    });
+    
+    bench::measure("Value copy, String", 10000000, [&]()
+    {
+        ponder::Value copy(string);
+        bench::keep(copy);
+    });
+    
+    bench::suite("Value conversion");
+    
+    bench::measure("int -> int", 10000000, [&]()
+    {
+        bench::keep(integer.to<int>());
+    });
+    
+    bench::measure("int -> double", 10000000, [&]()
+    {
+        bench::keep(integer.to<double>());
+    });
+    
+    bench::measure("double -> int", 10000000, [&]()
+    {
+        bench::keep(real.to<int>());
+    });
+    
+    bench::measure("int -> String", 1000000, [&]()
+    {
+        bench::keep(integer.to<ponder::String>());
+    });
+    
+    bench::measure("double -> String", 1000000, [&]()
+    {
+        bench::keep(real.to<ponder::String>());
+    });
+    
+    bench::measure("String -> int", 1000000, [&]()
+    {
+        bench::keep(string.to<int>());
+    });
+    
+    bench::measure("enum -> long", 10000000, [&]()
+    {
+        bench::keep(enumeration.to<long>());
+    });
+    
+    bench::measure("UserObject -> UserObject", 10000000, [&]()
+    {
+        bench::keep(user.to<ponder::UserObject>());
+    });
+    
+    bench::measure("UserObject -> Blob&", 10000000, [&]()
+    {
+        bench::keep(user.to<ponder::UserObject>().get<Blob>().id);
+    });
+    
+    bench::measure("isCompatible<int>, String", 10000000, [&]()
+    {
+        bench::keep(string.isCompatible<int>());
+    });
+    
+    ponder::Class::undeclare<Blob>();
+    ponder::Enum::undeclare<Mode>();
+}
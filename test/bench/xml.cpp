@@ -0,0 +1,185 @@
+/****************************************************************************
+**
+** This file is part of the CAMP library.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+#include "bench.hpp"
+#include <ponder/classbuilder.hpp>
+#include <ponder-xml/common.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+// ponder-xml serialization round trips. The nodes are kept in a minimal in-memory tree so
+// that the results measure Ponder and not a particular XML library.
+
+namespace XmlBench
+{
+    struct Node
+    {
+        Node(const std::string& name_, Node* parent_) : name(name_), parent(parent_) {}
+        
+        std::string name;
+        std::string text;
+        Node* parent;
+        std::vector<std::unique_ptr<Node>> children;
+    };
+    
+    struct TreeProxy
+    {
+        typedef Node* NodeType;
+        
+        static NodeType addChild(NodeType node, const std::string& name)
+        {
+            node->children.emplace_back(new Node(name, node));
+            return node->children.back().get();
+        }
+        
+        static void setText(NodeType node, const ponder::Value& value)
+        {
+            node->text = value.to<std::string>();
+        }
+        
+        static NodeType findFirstChild(NodeType node, const std::string& name)
+        {
+            for (const auto& child : node->children)
+            {
+                if (child->name == name)
+                    return child.get();
+            }
+            return nullptr;
+        }
+        
+        static NodeType findNextSibling(NodeType node, const std::string& name)
+        {
+            const auto& siblings = node->parent->children;
+            auto it = siblings.begin();
+            while (it->get() != node)
+                ++it;
+            for (++it; it != siblings.end(); ++it)
+            {
+                if ((*it)->name == name)
+                    return it->get();
+            }
+            return nullptr;
+        }
+        
+        static std::string getText(NodeType node)
+        {
+            return node->text;
+        }
+        
+        static bool isValid(NodeType node)
+        {
+            return node != nullptr;
+        }
+    };
+    
+    struct Address
+    {
+        std::string street;
+        int number;
+    };
+    
+    struct Person
+    {
+        std::string name;
+        int age;
+        double height;
+        bool active;
+        Address address;
+        std::vector<int> scores;
+        std::string cache;
+    };
+}
+
+PONDER_TYPE(XmlBench::Address)
+PONDER_TYPE(XmlBench::Person)
+
+void benchXml()
+{
+    using namespace XmlBench;
+    
+    ponder::Class::declare<Address>("XmlBench::Address")
+        .property("street", &Address::street)
+        .property("number", &Address::number);
+    
+    ponder::Class::declare<Person>("XmlBench::Person")
+        .property("name", &Person::name)
+        .property("age", &Person::age)
+        .property("height", &Person::height)
+        .property("active", &Person::active)
+        .property("address", &Person::address)
+        .property("scores", &Person::scores)
+        .property("cache", &Person::cache).tag("transient");
+    
+    bench::suite("ponder-xml (7 properties, 16 array elements)");
+    
+    Person person = {"Ada", 36, 1.65, true, {"Baker Street", 221}, {}, "ignored"};
+    for (int i = 0; i < 16; ++i)
+        person.scores.push_back(i * 10);
+    const ponder::UserObject source(person);
+    
+    bench::measure("serialize", 100000, [&]()
+    {
+        Node root("person", nullptr);
+        ponder::xml::detail::serialize<TreeProxy>(source, &root, ponder::Value::nothing);
+        bench::keep(root);
+    });
+    
+    const ponder::Value transient("transient");
+    bench::measure("serialize, excluding a tag", 100000, [&]()
+    {
+        Node root("person", nullptr);
+        ponder::xml::detail::serialize<TreeProxy>(source, &root, transient);
+        bench::keep(root);
+    });
+    
+    Node document("person", nullptr);
+    ponder::xml::detail::serialize<TreeProxy>(source, &document, ponder::Value::nothing);
+    
+    bench::measure("deserialize", 100000, [&]()
+    {
+        Person copy = Person();
+        ponder::xml::detail::deserialize<TreeProxy>(ponder::UserObject::makeRef(copy),
+                                                    &document, ponder::Value::nothing);
+        bench::keep(copy);
+    });
+    
+    bench::measure("round trip", 100000, [&]()
+    {
+        Node root("person", nullptr);
+        ponder::xml::detail::serialize<TreeProxy>(source, &root, ponder::Value::nothing);
+        Person copy = Person();
+        ponder::xml::detail::deserialize<TreeProxy>(ponder::UserObject::makeRef(copy),
+                                                    &root, ponder::Value::nothing);
+        bench::keep(copy);
+    });
+    
+    ponder::Class::undeclare<Person>();
+    ponder::Class::undeclare<Address>();
+}
@@ -31,8 +31,10 @@
 #include <ponder/class.hpp>
 #include <ponder/detail/format.hpp>
 #include <ponder/classbuilder.hpp>
+#include <ponder/instances.hpp>
 #include <ponder/uses/lua.hpp>
 #include <list>
+#include <map>
 
 extern "C" {
 #include <lualib.h>
@@ -155,6 +157,19 @@ namespace lib
         }
     };
     
+    struct Scores
+    {
+        std::map<std::string, int> scores;
+    };
+    
+    struct Unit
+    {
+        int health = 10;
+        ponder::EventSource<int> damaged;
+        
+        void hit(int amount) {health -= amount; damaged.fire(amount);}
+    };
+    
     void declare()
     {
         using namespace ponder;
@@ -211,6 +226,18 @@ namespace lib
             .property("a", &Parsing::a)
             .property("b", &Parsing::b)
             ;
+        
+        ponder::Class::declare<Scores>()
+            .constructor()
+            .property("scores", &Scores::scores)
+            ;
+        
+        ponder::Class::declare<Unit>()
+            .constructor()
+            .property("health", &Unit::health)
+            .function("hit", &Unit::hit)
+            .event("damaged", &Unit::damaged)
+            ;
     }
     
 } // namespace lib
@@ -223,6 +250,8 @@ PONDER_TYPE(lib::Types::Obj)
 PONDER_TYPE(lib::Dummy)
 PONDER_TYPE(lib::Colour)
 PONDER_TYPE(lib::Parsing)
+PONDER_TYPE(lib::Scores)
+PONDER_TYPE(lib::Unit)
 
 static bool luaTest(lua_State *L, const char *source, int lineNb, bool success = true)
 {
@@ -256,6 +285,8 @@ int main()
     ponder::lua::expose<lib::Dummy>(L, "Dummy");
     ponder::lua::expose<lib::Colour>(L, "Colour");
     ponder::lua::expose<lib::Parsing>(L, "Parsing");
+    ponder::lua::expose<lib::Scores>(L, "Scores");
+    ponder::lua::expose<lib::Unit>(L, "Unit");
     
     //------------------------------------------------------------------
 
@@ -353,6 +384,34 @@ int main()
     LUA_PASS("p = Parsing(); assert(type(p)=='userdata')");
     LUA_PASS("p:init{a=77, b='w00t'}; assert(p.a == 77 and p.b == 'w00t')");
 
+    //------------------------------------------------------------------
+    
+    // Dictionary property
+    LUA_PASS("s = Scores(); assert(#s.scores == 0 and s.scores.bob == nil)");
+    LUA_PASS("s.scores.bob = 3; s.scores.amy = 5; assert(#s.scores == 2 and s.scores.bob == 3)");
+    LUA_PASS("n = 0; for k,v in pairs(s.scores) do n = n + v end; assert(n == 8)");
+    LUA_PASS("s.scores.bob = nil; assert(#s.scores == 1 and s.scores.bob == nil)");
+    LUA_FAIL("s.scores.bob = 'fail'");
+
+    //------------------------------------------------------------------
+    
+    // Events
+    LUA_PASS("u = Unit(); total = 0; h = u.damaged:subscribe(function(n) total = total + n end)");
+    LUA_PASS("u:hit(3); u.damaged:fire(4); assert(total == 7 and u.health == 7)");
+    LUA_PASS("assert(u.damaged:unsubscribe(h)); assert(not u.damaged:unsubscribe(h))");
+    LUA_PASS("u:hit(1); assert(total == 7)");
+
+    //------------------------------------------------------------------
+    
+    // Instances created by Lua are destroyed when collected
+    if (ponder::instances::enabled())
+    {
+        const ponder::Class& vec = ponder::classByType<lib::Vec>();
+        PASSERT(ponder::instances::stats(vec).live > 0);
+        LUA_PASS("v, l, a, b, c, up, r, t = nil; collectgarbage()");
+        PASSERT(ponder::instances::stats(vec).live == 0);
+    }
+
     return EXIT_SUCCESS;
 }
 
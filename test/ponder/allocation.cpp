@@ -0,0 +1,399 @@
+/****************************************************************************
+**
+** This file is part of the CAMP library.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+
+#include <ponder/classget.hpp>
+#include <ponder/classbuilder.hpp>
+#include <ponder/allocator.hpp>
+#include <ponder/scratch.hpp>
+#include <ponder/trace.hpp>
+#include <ponder/uses/runtime.hpp>
+#include "test.hpp"
+#include <cstdlib>
+#include <new>
+#include <thread>
+
+namespace AllocationTest
+{
+    // Allocations made by the standard library on this thread, while counting
+    thread_local bool counting = false;
+    thread_local std::size_t globalAllocations = 0;
+    
+    struct Allocations
+    {
+        std::size_t ponder; ///< Through Ponder's allocator
+        std::size_t global; ///< Through the global operator new (std::string, containers...)
+    };
+    
+    // Count the allocations of the second call of func (the first one may fill caches)
+    template <typename F>
+    Allocations allocations(F func)
+    {
+        func();
+        
+        ponder::AllocationCounter counter;
+        globalAllocations = 0;
+        counting = true;
+        func();
+        counting = false;
+        
+        // The counter forwards to the default allocator, which uses the global operator new
+        return Allocations{counter.allocations(), globalAllocations - counter.allocations()};
+    }
+    
+    struct Point
+    {
+        int x, y;
+        
+        int add(int a, int b) const {return x + a + b;}
+        static int twice(int a) {return 2 * a;}
+    };
+    
+    struct Tracker
+    {
+        std::size_t allocations = 0;
+        std::size_t deallocations = 0;
+        std::size_t bytes = 0;
+        
+        static void* allocate(std::size_t size, void* context)
+        {
+            Tracker& tracker = *static_cast<Tracker*>(context);
+            ++tracker.allocations;
+            tracker.bytes += size;
+            return std::malloc(size);
+        }
+        
+        static void deallocate(void* pointer, std::size_t size, void* context)
+        {
+            Tracker& tracker = *static_cast<Tracker*>(context);
+            ++tracker.deallocations;
+            tracker.bytes -= size;
+            std::free(pointer);
+        }
+    };
+    
+    static void declare()
+    {
+        ponder::Class::declare<Point>("AllocationTest::Point")
+            .property("x", &Point::x)
+            .property("y", &Point::y)
+            .function("add", &Point::add)
+            .function("twice", &Point::twice);
+    }
+}
+
+PONDER_AUTO_TYPE(AllocationTest::Point, &AllocationTest::declare)
+
+// Count the allocations of the standard library as well as Ponder's
+void* operator new(std::size_t size)
+{
+    if (AllocationTest::counting)
+        ++AllocationTest::globalAllocations;
+    if (void* pointer = std::malloc(size ? size : 1))
+        return pointer;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+//-----------------------------------------------------------------------------
+//                         Tests for ponder::setAllocator
+//-----------------------------------------------------------------------------
+
+TEST_CASE("Ponder allocates through a replaceable allocator")
+{
+    using namespace AllocationTest;
+    
+    ponder::classByType<Point>();
+    
+    SECTION("the allocator can be replaced")
+    {
+        Tracker tracker;
+        const ponder::Allocator previous = ponder::allocator();
+        ponder::setAllocator(ponder::Allocator{&Tracker::allocate, &Tracker::deallocate, &tracker});
+        
+        {
+            ponder::UserObject copy = ponder::UserObject::makeCopy(Point{1, 2});
+            REQUIRE(tracker.allocations == 1);
+            REQUIRE(tracker.bytes >= sizeof(Point));
+            REQUIRE(copy.get<Point>().y == 2);
+        }
+        REQUIRE(tracker.deallocations == 1);
+        REQUIRE(tracker.bytes == 0);
+        
+        ponder::setAllocator(previous);
+        REQUIRE(ponder::allocator().context == previous.context);
+    }
+    
+    SECTION("allocations can be counted")
+    {
+        ponder::AllocationCounter counter;
+        {
+            ponder::Args args(1, 2);
+            args += 3;
+        }
+        REQUIRE(counter.allocations() > 0);
+        REQUIRE(counter.deallocations() == counter.allocations());
+        REQUIRE(counter.bytes() >= 3 * sizeof(ponder::Value));
+        
+        counter.reset();
+        REQUIRE(counter.allocations() == 0);
+        REQUIRE(counter.bytes() == 0);
+    }
+    
+    SECTION("argument lists can reference values without allocating")
+    {
+        const ponder::Value values[] = {ponder::Value(1), ponder::Value("two")};
+        
+        const ponder::Value* second = nullptr;
+        const Allocations counted = allocations([&]()
+        {
+            const ponder::Args args = ponder::Args::reference(values, 2);
+            second = &args[1];
+        });
+        REQUIRE(second == &values[1]);
+        REQUIRE(counted.ponder == 0);
+        REQUIRE(counted.global == 0);
+        
+        // Copies own their values
+        ponder::Args copy(ponder::Args::reference(values, 2));
+        copy += 3;
+        REQUIRE(copy.count() == 3);
+        REQUIRE(&copy[1] != &values[1]);
+        REQUIRE(copy[1] == values[1]);
+    }
+}
+
+//-----------------------------------------------------------------------------
+//                         Zero-allocation budgets of the hot paths
+//-----------------------------------------------------------------------------
+
+TEST_CASE("Hot paths don't allocate")
+{
+    using namespace AllocationTest;
+    
+    const ponder::Class& metaclass = ponder::classByType<Point>();
+    const ponder::Property& x = metaclass.property("x");
+    const ponder::Function& add = metaclass.function("add");
+    const ponder::Function& twice = metaclass.function("twice");
+    const ponder::String name = "AllocationTest::Point";
+    
+    Point point = {1, 2};
+    const ponder::UserObject object(point);
+    
+    SECTION("wrapping an object by reference")
+    {
+        void* pointers[3] = {};
+        const Allocations counted = allocations([&]()
+        {
+            pointers[0] = ponder::UserObject::makeRef(point).pointer();
+            pointers[1] = ponder::UserObject::makeRef(static_cast<const Point&>(point)).pointer();
+            pointers[2] = ponder::UserObject(point).pointer();
+        });
+        REQUIRE(pointers[0] == &point);
+        REQUIRE(pointers[1] == &point);
+        REQUIRE(pointers[2] == &point);
+        REQUIRE(counted.ponder == 0);
+        REQUIRE(counted.global == 0);
+    }
+    
+    SECTION("reading and writing an int property")
+    {
+        int values[2] = {};
+        const Allocations counted = allocations([&]()
+        {
+            x.set(object, 5);
+            values[0] = x.get(object).to<int>();
+            values[1] = x.get(point).to<int>();
+        });
+        REQUIRE(values[0] == 5);
+        REQUIRE(values[1] == 5);
+        REQUIRE(counted.ponder == 0);
+        REQUIRE(counted.global == 0);
+    }
+    
+    SECTION("calling a function with 2 arguments")
+    {
+        int results[2] = {};
+        const Allocations counted = allocations([&]()
+        {
+            results[0] = ponder::runtime::call(add, object, 2, 3).to<int>();
+            results[1] = ponder::runtime::callStatic(twice, 4).to<int>();
+        });
+        REQUIRE(results[0] == 6);
+        REQUIRE(results[1] == 8);
+        REQUIRE(counted.ponder == 0);
+        REQUIRE(counted.global == 0);
+    }
+    
+    SECTION("looking up a class")
+    {
+        const ponder::Class* found[3] = {};
+        const Allocations counted = allocations([&]()
+        {
+            found[0] = &ponder::classByType<Point>();
+            found[1] = &ponder::classByName(name);
+            found[2] = &ponder::classByObject(point);
+        });
+        REQUIRE(found[0] == &metaclass);
+        REQUIRE(found[1] == &metaclass);
+        REQUIRE(found[2] == &metaclass);
+        REQUIRE(counted.ponder == 0);
+        REQUIRE(counted.global == 0);
+    }
+}
+
+//-----------------------------------------------------------------------------
+//                         Tests for ponder::ScratchScope
+//-----------------------------------------------------------------------------
+
+TEST_CASE("Temporary allocations can be redirected to a scratch arena")
+{
+    using namespace AllocationTest;
+    
+    ponder::classByType<Point>();
+    
+    SECTION("allocations within a scope don't reach the allocator")
+    {
+        REQUIRE_FALSE(ponder::ScratchScope::active());
+        
+        bool active = false;
+        int y = 0;
+        std::size_t used = 0;
+        const Allocations counted = allocations([&]()
+        {
+            ponder::ScratchScope scope;
+            active = ponder::ScratchScope::active();
+            
+            ponder::Args args(1, 2);
+            args += 3;
+            ponder::UserObject copy = ponder::UserObject::makeCopy(Point{1, 2});
+            y = copy.get<Point>().y;
+            used = scope.used();
+        });
+        REQUIRE(active);
+        REQUIRE(y == 2);
+        REQUIRE(used >= sizeof(Point) + 3 * sizeof(ponder::Value));
+        REQUIRE(counted.ponder == 0);
+        REQUIRE(counted.global == 0);
+        REQUIRE_FALSE(ponder::ScratchScope::active());
+    }
+    
+    SECTION("scopes are rewound in the reverse order of their creation")
+    {
+        ponder::ScratchScope outer;
+        ponder::UserObject first = ponder::UserObject::makeCopy(Point{1, 2});
+        const std::size_t used = outer.used();
+        {
+            ponder::ScratchScope inner;
+            ponder::UserObject second = ponder::UserObject::makeCopy(Point{3, 4});
+            REQUIRE(inner.used() > 0);
+            REQUIRE(outer.used() > used);
+        }
+        REQUIRE(outer.used() == used);
+        REQUIRE(first.get<Point>().x == 1);
+    }
+    
+    SECTION("large blocks get their own chunk")
+    {
+        ponder::ScratchScope scope;
+        ponder::Args args;
+        for (int i = 0; i < 1000; ++i)
+            args += i;
+        REQUIRE(args.count() == 1000);
+        REQUIRE(args[999] == 999);
+    }
+    
+    SECTION("escaping values are promoted to the allocator")
+    {
+        ponder::UserObject object;
+        ponder::Value value;
+        ponder::Args args;
+        
+        ponder::AllocationCounter counter;
+        {
+            ponder::ScratchScope scope;
+            ponder::UserObject copy = ponder::UserObject::makeCopy(Point{5, 6});
+            object = ponder::ScratchScope::promote(copy);
+            value = ponder::ScratchScope::promote(ponder::Value(copy));
+            args = ponder::ScratchScope::promote(ponder::Args(copy, 7));
+            REQUIRE(object.pointer() != copy.pointer());
+        }
+        REQUIRE(counter.allocations() > 0);
+        
+        // Overwrite the memory released by the scope
+        {
+            ponder::ScratchScope scope;
+            ponder::UserObject copy = ponder::UserObject::makeCopy(Point{0, 0});
+            ponder::Args other(0, 0);
+        }
+        
+        REQUIRE(object.get<Point>().x == 5);
+        REQUIRE(value.to<ponder::UserObject>().get<Point>().y == 6);
+        REQUIRE(args[0].to<ponder::UserObject>().get<Point>().x == 5);
+        REQUIRE(args[1] == 7);
+    }
+    
+    SECTION("long-lived blocks ignore the scope")
+    {
+        ponder::ScratchScope scope;
+        void* block = ponder::detail::allocate(64);
+        REQUIRE_FALSE(ponder::detail::scratchOwns(block));
+        ponder::detail::deallocate(block, 64);
+        
+        // The first span of a thread allocates its trace buffer
+        std::size_t used = 1;
+        std::thread thread([&used]()
+        {
+            ponder::ScratchScope threadScope;
+            ponder::trace::detail::record(ponder::trace::Category::Call, "Point", "x", 0, 1);
+            used = threadScope.used();
+        });
+        thread.join();
+        ponder::trace::clear();
+        
+        REQUIRE(used == 0);
+        REQUIRE(scope.used() == 0);
+    }
+    
+    SECTION("objects stored by reference are promoted unchanged")
+    {
+        Point point = {1, 2};
+        ponder::ScratchScope scope;
+        REQUIRE(ponder::ScratchScope::promote(ponder::UserObject(point)).pointer() == &point);
+    }
+}
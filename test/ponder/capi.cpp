@@ -0,0 +1,266 @@
+/****************************************************************************
+**
+** This file is part of the CAMP library.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+#include <ponder/classget.hpp>
+#include <ponder/classbuilder.hpp>
+#include <ponder/uses/ponder_c.h>
+#include "test.hpp"
+#include <cstring>
+#include <stdexcept>
+
+
+namespace CApiTest
+{
+    struct Vec
+    {
+        Vec(double x_ = 0., double y_ = 0.) : x(x_), y(y_) {}
+        double x, y;
+    };
+    
+    struct Ship
+    {
+        Ship() : speed(1), name("ship"), hull(100), range(0) {}
+        
+        int speed;
+        ponder::String name;
+        Vec position;
+        int hull;
+        long long range;
+        
+        int getHull() const {return hull;}
+        void setHull(int h) {if (h < 0) throw std::runtime_error("negative hull"); hull = h;}
+        
+        double move(double dx, double dy) {position.x += dx; position.y += dy; return position.x;}
+        ponder::String describe() const {return name + "!";}
+        static int twice(int x) {return x * 2;}
+        static long long farther(long long x) {return x + 1;}
+    };
+    
+    static void declare()
+    {
+        ponder::Class::declare<Vec>("CApiTest::Vec")
+            .property("x", &Vec::x)
+            .property("y", &Vec::y);
+        
+        ponder::Class::declare<Ship>("CApiTest::Ship")
+            .property("speed", &Ship::speed)
+            .property("name", &Ship::name)
+            .property("position", &Ship::position)
+            .property("hull", &Ship::getHull, &Ship::setHull)
+            .property("range", &Ship::range)
+            .function("move", &Ship::move)
+            .function("describe", &Ship::describe)
+            .function("twice", &Ship::twice)
+            .function("farther", &Ship::farther);
+    }
+}
+
+PONDER_AUTO_TYPE(CApiTest::Vec, &CApiTest::declare)
+PONDER_AUTO_TYPE(CApiTest::Ship, &CApiTest::declare)
+
+//-----------------------------------------------------------------------------
+//                         Tests for the C interface
+//-----------------------------------------------------------------------------
+
+TEST_CASE("Registered data can be used through the C interface")
+{
+    using namespace CApiTest;
+    
+    ponder::classByType<Ship>(); // declare
+    
+    const ponder_class* cls = nullptr;
+    REQUIRE(ponder_class_find("CApiTest::Ship", &cls) == PONDER_OK);
+    REQUIRE(std::strcmp(ponder_class_name(cls), "CApiTest::Ship") == 0);
+    REQUIRE(ponder_class_property_count(cls) == 5);
+    REQUIRE(ponder_class_function_count(cls) == 4);
+    
+    Ship ship;
+    ponder_value value;
+    
+    SECTION("errors are reported with status codes")
+    {
+        const ponder_class* unknown = nullptr;
+        REQUIRE(ponder_class_find("CApiTest::Unknown", &unknown) == PONDER_NOT_FOUND);
+        REQUIRE(std::strlen(ponder_last_error()) > 0);
+        
+        const ponder_property* property = nullptr;
+        REQUIRE(ponder_class_property(cls, "unknown", &property) == PONDER_NOT_FOUND);
+        REQUIRE(ponder_class_property(cls, "hull", &property) == PONDER_OK);
+        REQUIRE(std::strlen(ponder_last_error()) == 0);
+        REQUIRE(ponder_property_get(property, cls, nullptr, &value) == PONDER_NULL_OBJECT);
+        
+        // Checked beforehand, without raising errors
+        const ponder_property* speed = nullptr;
+        REQUIRE(ponder_class_property(cls, "speed", &speed) == PONDER_OK);
+        value.type = PONDER_TYPE_STRING;
+        value.u.s.data = "abc";
+        value.u.s.size = 3;
+        REQUIRE(ponder_property_set(speed, cls, &ship, &value) == PONDER_BAD_TYPE);
+        REQUIRE(ship.speed == 1);
+        
+        const ponder_class* vecClass = nullptr;
+        REQUIRE(ponder_class_find("CApiTest::Vec", &vecClass) == PONDER_OK);
+        Vec vec;
+        REQUIRE(ponder_property_get(speed, vecClass, &vec, &value) == PONDER_ERROR);
+        REQUIRE(ponder_property_get(property, vecClass, &vec, &value) == PONDER_ERROR);
+        
+        const ponder_function* move = nullptr;
+        REQUIRE(ponder_class_function(cls, "unknown", &move) == PONDER_NOT_FOUND);
+        REQUIRE(ponder_class_function(cls, "move", &move) == PONDER_OK);
+        ponder_value args[2];
+        args[0].type = PONDER_TYPE_STRING;
+        args[0].u.s.data = "abc";
+        args[0].u.s.size = 3;
+        args[1] = args[0];
+        REQUIRE(ponder_function_call(move, cls, &ship, args, 2, &value) == PONDER_BAD_ARGUMENT);
+        REQUIRE(ponder_function_call(move, vecClass, &vec, args, 2, &value) == PONDER_BAD_ARGUMENT);
+        
+#if !PONDER_NO_EXCEPTIONS
+        // Exceptions of the reflected code can only be caught with exceptions
+        value.type = PONDER_TYPE_INT;
+        value.u.i = -1;
+        REQUIRE(ponder_property_set(property, cls, &ship, &value) == PONDER_UNKNOWN_ERROR);
+        REQUIRE(std::strcmp(ponder_last_error(), "negative hull") == 0);
+#endif
+    }
+    
+    SECTION("data members are read and written directly")
+    {
+        const ponder_property* speed = nullptr;
+        const ponder_property* name = nullptr;
+        REQUIRE(ponder_class_property(cls, "speed", &speed) == PONDER_OK);
+        REQUIRE(ponder_class_property(cls, "name", &name) == PONDER_OK);
+        REQUIRE(ponder_property_type(speed) == PONDER_TYPE_INT);
+        REQUIRE(ponder_property_type(name) == PONDER_TYPE_STRING);
+        
+        REQUIRE(ponder_property_get(speed, cls, &ship, &value) == PONDER_OK);
+        REQUIRE(value.type == PONDER_TYPE_INT);
+        REQUIRE(value.u.i == 1);
+        
+        value.type = PONDER_TYPE_REAL;
+        value.u.r = 7.;
+        REQUIRE(ponder_property_set(speed, cls, &ship, &value) == PONDER_OK);
+        REQUIRE(ship.speed == 7);
+        
+        value.type = PONDER_TYPE_STRING;
+        value.u.s.data = "42";
+        value.u.s.size = 2;
+        REQUIRE(ponder_property_set(speed, cls, &ship, &value) == PONDER_OK); // through Value
+        REQUIRE(ship.speed == 42);
+        
+        REQUIRE(ponder_property_set(name, cls, &ship, &value) == PONDER_OK);
+        REQUIRE(ship.name == "42");
+        REQUIRE(ponder_property_get(name, cls, &ship, &value) == PONDER_OK);
+        REQUIRE(value.u.s.data == ship.name.c_str());
+    }
+    
+    SECTION("other properties go through values")
+    {
+        const ponder_property* hull = nullptr;
+        const ponder_property* position = nullptr;
+        REQUIRE(ponder_class_property(cls, "hull", &hull) == PONDER_OK);
+        REQUIRE(ponder_class_property(cls, "position", &position) == PONDER_OK);
+        
+        value.type = PONDER_TYPE_INT;
+        value.u.i = 50;
+        REQUIRE(ponder_property_set(hull, cls, &ship, &value) == PONDER_OK);
+        REQUIRE(ship.hull == 50);
+        
+        ship.position = Vec(3., 4.);
+        REQUIRE(ponder_property_get(position, cls, &ship, &value) == PONDER_OK);
+        REQUIRE(value.type == PONDER_TYPE_OBJECT);
+        
+        const ponder_property* y = nullptr;
+        REQUIRE(ponder_class_property(value.u.o.cls, "y", &y) == PONDER_OK);
+        ponder_value coord;
+        REQUIRE(ponder_property_get(y, value.u.o.cls, value.u.o.ptr, &coord) == PONDER_OK);
+        REQUIRE(coord.u.r == 4.);
+    }
+    
+    SECTION("functions are called with packed arguments")
+    {
+        const ponder_function* move = nullptr;
+        const ponder_function* describe = nullptr;
+        const ponder_function* twice = nullptr;
+        REQUIRE(ponder_class_function(cls, "move", &move) == PONDER_OK);
+        REQUIRE(ponder_class_function(cls, "describe", &describe) == PONDER_OK);
+        REQUIRE(ponder_class_function(cls, "twice", &twice) == PONDER_OK);
+        REQUIRE(ponder_function_param_count(move) == 2);
+        
+        ponder_value args[2];
+        args[0].type = PONDER_TYPE_REAL;
+        args[0].u.r = 1.5;
+        args[1].type = PONDER_TYPE_INT;
+        args[1].u.i = 2;
+        REQUIRE(ponder_function_call(move, cls, &ship, args, 2, &value) == PONDER_OK);
+        REQUIRE(value.type == PONDER_TYPE_REAL);
+        REQUIRE(value.u.r == 1.5);
+        REQUIRE(ship.position.y == 2.);
+        
+        REQUIRE(ponder_function_call(move, cls, &ship, args, 1, &value) == PONDER_BAD_ARGUMENT);
+        
+        REQUIRE(ponder_function_call(describe, cls, &ship, nullptr, 0, &value) == PONDER_OK);
+        REQUIRE(value.type == PONDER_TYPE_STRING);
+        REQUIRE(ponder::String(value.u.s.data, value.u.s.size) == "ship!");
+        
+        args[0].type = PONDER_TYPE_INT;
+        args[0].u.i = 21;
+        REQUIRE(ponder_function_call(twice, nullptr, nullptr, args, 1, &value) == PONDER_OK);
+        REQUIRE(value.u.i == 42);
+    }
+    
+    SECTION("64-bit integers are not truncated")
+    {
+        const int64_t big = (int64_t(1) << 40) + 3;
+        
+        const ponder_property* range = nullptr;
+        REQUIRE(ponder_class_property(cls, "range", &range) == PONDER_OK);
+        value.type = PONDER_TYPE_INT;
+        value.u.i = big;
+        REQUIRE(ponder_property_set(range, cls, &ship, &value) == PONDER_OK);
+        REQUIRE(ship.range == big);
+        REQUIRE(ponder_property_get(range, cls, &ship, &value) == PONDER_OK);
+        REQUIRE(value.u.i == big);
+        
+        // Through Value: refused rather than truncated where long has 32 bits
+        const ponder_function* farther = nullptr;
+        REQUIRE(ponder_class_function(cls, "farther", &farther) == PONDER_OK);
+        const ponder_value arg = value;
+        const int status = ponder_function_call(farther, nullptr, nullptr, &arg, 1, &value);
+        if (sizeof(long) >= sizeof(int64_t))
+        {
+            REQUIRE(status == PONDER_OK);
+            REQUIRE(value.u.i == big + 1);
+        }
+        else
+        {
+            REQUIRE(status == PONDER_BAD_TYPE);
+        }
+    }
+}
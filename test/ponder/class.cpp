@@ -386,6 +386,19 @@ TEST_CASE("Classes can have hierarchies")
         REQUIRE(ponder::classByObject(*nortti).name() == "ClassTest::Base");
     }
 
+    SECTION("with rtti the metaclass is cached")
+    {
+        const ponder::Class& metaclass = ponder::classByType<Derived>();
+        IS_TRUE(derived->ponderClass() == &metaclass);
+        IS_TRUE(&ponder::classByObject(derived) == &metaclass);
+        
+        // the cache is refreshed when the registry changes
+        ponder::Class::declare<TemporaryRegistration>();
+        IS_TRUE(derived->ponderClass() == &metaclass);
+        ponder::Class::undeclare<TemporaryRegistration>();
+        IS_TRUE(&ponder::classByObject(*derived) == &metaclass);
+    }
+
    SECTION("allows polymorphism")
    {
        Base* genericBase = derived;
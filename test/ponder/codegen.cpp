@@ -0,0 +1,136 @@
+/****************************************************************************
+**
+** This file is part of the CAMP library.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+#include <ponder/uses/codegen.hpp>
+#include <ponder/classbuilder.hpp>
+#include <ponder/module.hpp>
+#include "test.hpp"
+#include <cstddef>
+#include <sstream>
+
+
+namespace CodegenTest
+{
+    struct Point
+    {
+        int x;
+        float y;
+        int length() const {return x;}
+    };
+    
+    static void declare()
+    {
+        ponder::Class::declare<Point>("CodegenTest::Point")
+            .property("x", &Point::x)
+            .property("y", &Point::y)
+            .property("class", &Point::x)
+            .function("length", &Point::length);
+    }
+}
+
+PONDER_AUTO_TYPE(CodegenTest::Point, &CodegenTest::declare)
+
+//-----------------------------------------------------------------------------
+//                         Tests for ponder::uses code generation
+//-----------------------------------------------------------------------------
+
+TEST_CASE("Metaclasses have a schema hash")
+{
+    const ponder::Class& metaclass = ponder::classByType<CodegenTest::Point>();
+    const std::uint64_t hash = ponder::uses::schemaHash(metaclass);
+    
+    REQUIRE(ponder::uses::schemaHash(metaclass) == hash);
+    
+    SECTION("which changes with the declaration")
+    {
+        ponder::Module module("CodegenTest");
+        ponder::Module::Scope scope(module);
+        
+        ponder::Class::declare<CodegenTest::Point>("CodegenTest::Point2")
+            .property("x", &CodegenTest::Point::x)
+            .property("y", &CodegenTest::Point::y)
+            .property("class", &CodegenTest::Point::x)
+            .function("length", &CodegenTest::Point::length);
+        
+        IS_TRUE(ponder::uses::schemaHash(ponder::classByName("CodegenTest::Point2")) != hash);
+    }
+}
+
+TEST_CASE("Code can be generated from metaclasses")
+{
+    const ponder::Class& metaclass = ponder::classByType<CodegenTest::Point>();
+    std::ostringstream out;
+    ponder::uses::generateCode(out, metaclass);
+    const std::string code = out.str();
+    
+    IS_TRUE(code.find("namespace CodegenTest_Point {") != std::string::npos);
+    IS_TRUE(code.find("const char* const name = \"CodegenTest::Point\";") != std::string::npos);
+    IS_TRUE(code.find("const std::size_t class_ = 0;") != std::string::npos);
+    IS_TRUE(code.find("const std::size_t length = 0;") != std::string::npos);
+    IS_TRUE(code.find("SchemaHandles<3, 1>") != std::string::npos);
+    IS_TRUE(code.find("luaGet_x") != std::string::npos);
+    
+    SECTION("which accesses data members directly")
+    {
+        const std::string y = "(base + " + std::to_string(offsetof(CodegenTest::Point, y)) + ")";
+        IS_TRUE(code.find("out += *reinterpret_cast<const float*>" + y + ";") != std::string::npos);
+        IS_TRUE(code.find("*reinterpret_cast<float*>" + y + " = in[2].to<float>();")
+                != std::string::npos);
+        IS_TRUE(code.find("ponder::SequencedWrite write(object);") != std::string::npos);
+        IS_TRUE(code.find(".get(object)") == std::string::npos);
+    }
+    
+    SECTION("with namespaces which don't depend on the other classes")
+    {
+        ponder::Module module("CodegenTest");
+        ponder::Module::Scope scope(module);
+        
+        ponder::Class::declare<CodegenTest::Point>("CodegenTest_Point")
+            .property("x", &CodegenTest::Point::x);
+        
+        std::ostringstream other;
+        ponder::uses::generateCode(other, ponder::classByName("CodegenTest_Point"));
+        IS_TRUE(other.str().find("namespace CodegenTest_Point_0x") != std::string::npos);
+    }
+}
+
+TEST_CASE("Schema handles check the generated hash")
+{
+    const ponder::Class& metaclass = ponder::classByType<CodegenTest::Point>();
+    const std::uint64_t hash = ponder::uses::schemaHash(metaclass);
+    
+    ponder::uses::SchemaHandles<3, 1> handles("CodegenTest::Point", hash);
+    IS_TRUE(&handles.check().metaclass() == &metaclass);
+    IS_TRUE(handles.property(2).name() == "y");
+    IS_TRUE(handles.function(0).name() == "length");
+    
+    typedef ponder::uses::SchemaHandles<3, 1> Handles;
+    REQUIRE_THROWS_AS(Handles("CodegenTest::Point", hash + 1), ponder::SchemaMismatch);
+    REQUIRE_THROWS_AS(Handles("CodegenTest::Nothing", hash), ponder::ClassNotFound);
+}
@@ -0,0 +1,317 @@
+/****************************************************************************
+**
+** This file is part of the CAMP library.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+#include <ponder/classget.hpp>
+#include <ponder/errors.hpp>
+#include <ponder/dictionaryproperty.hpp>
+#include <ponder/classvisitor.hpp>
+#include <ponder/class.hpp>
+#include <ponder/classbuilder.hpp>
+#include <ponder-xml/common.hpp>
+#include "test.hpp"
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace DictionaryPropertyTest
+{
+    struct MyType
+    {
+        MyType() : x(-1) {}
+        MyType(int x_) : x(x_) {}
+        int x;
+    };
+    
+    struct MyClass
+    {
+        MyClass()
+        {
+            ints[1] = 10;
+            ints[2] = 20;
+            ints[3] = 30;
+            
+            names["one"] = "un";
+            names["two"] = "deux";
+            
+            objects["a"] = MyType(1);
+        }
+        
+        std::map<int, int> ints;
+        std::unordered_map<std::string, ponder::String> names;
+        std::map<std::string, MyType> objects;
+    };
+    
+    struct Visitor : public ponder::ClassVisitor
+    {
+        int dictionaries = 0;
+        void visit(const ponder::DictionaryProperty&) override {++dictionaries;}
+    };
+    
+    // Minimal in-memory XML tree for the ponder-xml round trip
+    struct Node
+    {
+        Node(const std::string& name_, Node* parent_) : name(name_), parent(parent_) {}
+        std::string name;
+        std::string text;
+        Node* parent;
+        std::vector<std::unique_ptr<Node>> children;
+    };
+    
+    struct TreeProxy
+    {
+        typedef Node* NodeType;
+        
+        static NodeType addChild(NodeType node, const std::string& name)
+        {
+            node->children.emplace_back(new Node(name, node));
+            return node->children.back().get();
+        }
+        
+        static void setText(NodeType node, const ponder::Value& value)
+        {
+            node->text = value.to<std::string>();
+        }
+        
+        static NodeType findFirstChild(NodeType node, const std::string& name)
+        {
+            for (const auto& child : node->children)
+            {
+                if (child->name == name)
+                    return child.get();
+            }
+            return nullptr;
+        }
+        
+        static NodeType findNextSibling(NodeType node, const std::string& name)
+        {
+            const auto& siblings = node->parent->children;
+            std::size_t i = 0;
+            while (siblings[i].get() != node)
+                ++i;
+            for (++i; i < siblings.size(); ++i)
+            {
+                if (siblings[i]->name == name)
+                    return siblings[i].get();
+            }
+            return nullptr;
+        }
+        
+        static std::string getText(NodeType node) {return node->text;}
+        static bool isValid(NodeType node) {return node != nullptr;}
+    };
+    
+    void declare()
+    {
+        ponder::Class::declare<MyType>("DictionaryPropertyTest::MyType")
+            .property("x", &MyType::x);
+        
+        ponder::Class::declare<MyClass>("DictionaryPropertyTest::MyClass")
+            .property("ints", &MyClass::ints)
+            .property("names", &MyClass::names)
+            .property("objects", &MyClass::objects);
+    }
+}
+
+PONDER_AUTO_TYPE(DictionaryPropertyTest::MyType, &DictionaryPropertyTest::declare)
+PONDER_AUTO_TYPE(DictionaryPropertyTest::MyClass, &DictionaryPropertyTest::declare)
+
+using namespace DictionaryPropertyTest;
+
+struct DictionaryPropertyFixture
+{
+    DictionaryPropertyFixture()
+    {
+        const ponder::Class& metaclass = ponder::classByType<MyClass>();
+        ints    = &static_cast<const ponder::DictionaryProperty&>(metaclass.property("ints"));
+        names   = &static_cast<const ponder::DictionaryProperty&>(metaclass.property("names"));
+        objects = &static_cast<const ponder::DictionaryProperty&>(metaclass.property("objects"));
+    }
+    
+    const ponder::DictionaryProperty* ints;
+    const ponder::DictionaryProperty* names;
+    const ponder::DictionaryProperty* objects;
+    MyClass object;
+};
+
+//-----------------------------------------------------------------------------
+//                         Tests for ponder::DictionaryProperty
+//-----------------------------------------------------------------------------
+
+TEST_CASE_METHOD(DictionaryPropertyFixture, "Dictionary property can be inspected")
+{
+    SECTION("should be dictionary type")
+    {
+        REQUIRE(ints->kind() == ponder::ValueKind::Dictionary);
+        REQUIRE(names->kind() == ponder::ValueKind::Dictionary);
+        REQUIRE(objects->kind() == ponder::ValueKind::Dictionary);
+        
+        static_assert(ponder_ext::ValueMapper<std::map<int, int>>::kind
+                      == ponder::ValueKind::Dictionary, "");
+    }
+    
+    SECTION("have key and element types")
+    {
+        REQUIRE(ints->keyType() == ponder::ValueKind::Integer);
+        REQUIRE(ints->elementType() == ponder::ValueKind::Integer);
+        REQUIRE(names->keyType() == ponder::ValueKind::String);
+        REQUIRE(names->elementType() == ponder::ValueKind::String);
+        REQUIRE(objects->elementType() == ponder::ValueKind::User);
+    }
+    
+    SECTION("are visited")
+    {
+        Visitor visitor;
+        ponder::classByType<MyClass>().visit(visitor);
+        REQUIRE(visitor.dictionaries == 3);
+    }
+}
+
+TEST_CASE_METHOD(DictionaryPropertyFixture, "Dictionary property elements can be accessed by key")
+{
+    SECTION("size")
+    {
+        REQUIRE(ints->size(object) == 3);
+        REQUIRE(names->size(object) == 2);
+        REQUIRE(objects->size(object) == 1);
+    }
+    
+    SECTION("find")
+    {
+        REQUIRE(ints->contains(object, 2));
+        REQUIRE_FALSE(ints->contains(object, 4));
+        REQUIRE(ints->get(object, 2) == ponder::Value(20));
+        REQUIRE(names->get(object, "two") == ponder::Value("deux"));
+        REQUIRE(objects->get(object, "a").to<MyType>().x == 1);
+        
+        REQUIRE_THROWS_AS(ints->get(object, 4), ponder::KeyNotFound);
+        REQUIRE_THROWS_AS(names->get(object, "three"), ponder::KeyNotFound);
+    }
+    
+    SECTION("insert and assign")
+    {
+        ints->set(object, 4, 40);
+        ints->set(object, 1, 11);
+        REQUIRE(object.ints.size() == 4);
+        REQUIRE(object.ints[4] == 40);
+        REQUIRE(object.ints[1] == 11);
+        
+        names->set(object, "three", "trois");
+        REQUIRE(object.names["three"] == "trois");
+        
+        objects->set(object, "b", MyType(2));
+        REQUIRE(object.objects["b"].x == 2);
+    }
+    
+    SECTION("erase")
+    {
+        REQUIRE(ints->remove(object, 2));
+        REQUIRE_FALSE(ints->remove(object, 2));
+        REQUIRE(object.ints.size() == 2);
+        REQUIRE(object.ints.count(2) == 0);
+        
+        REQUIRE(names->remove(object, "one"));
+        REQUIRE(object.names.size() == 1);
+    }
+    
+    SECTION("iterate")
+    {
+        std::vector<int> keys, values;
+        ponder::Value key, value;
+        while (ints->next(object, key, value))
+        {
+            keys.push_back(key.to<int>());
+            values.push_back(value.to<int>());
+        }
+        REQUIRE(keys == (std::vector<int>{1, 2, 3}));
+        REQUIRE(values == (std::vector<int>{10, 20, 30}));
+        
+        std::map<std::string, std::string> copy;
+        key = ponder::Value();
+        while (names->next(object, key, value))
+            copy[key.to<std::string>()] = value.to<std::string>();
+        REQUIRE(copy.size() == 2);
+        REQUIRE(copy["one"] == "un");
+        REQUIRE(copy["two"] == "deux");
+    }
+    
+    SECTION("iterate in a single pass")
+    {
+        std::vector<int> keys, values;
+        ints->forEach(object, [&](const ponder::Value& key, const ponder::Value& value)
+        {
+            keys.push_back(key.to<int>());
+            values.push_back(value.to<int>());
+        });
+        REQUIRE(keys == (std::vector<int>{1, 2, 3}));
+        REQUIRE(values == (std::vector<int>{10, 20, 30}));
+    }
+    
+    SECTION("insert default elements")
+    {
+        REQUIRE(ints->insert(object, 2));
+        REQUIRE(object.ints[2] == 20);  // existing elements are kept
+        REQUIRE(ints->insert(object, 4));
+        REQUIRE(object.ints.size() == 4);
+        REQUIRE(object.ints[4] == 0);
+    }
+    
+    SECTION("cannot be read or written as a single value")
+    {
+        const ponder::Property& property = *ints;
+        REQUIRE_THROWS_AS(property.get(object), ponder::ForbiddenRead);
+        REQUIRE_THROWS_AS(property.set(object, 0), ponder::ForbiddenWrite);
+    }
+}
+
+TEST_CASE("Dictionary properties are serialized by ponder-xml")
+{
+    MyClass source;
+    source.ints[4] = 40;
+    source.names["three"] = "trois";
+    source.objects["a"].x = 7;
+    source.objects["b"].x = 8;
+    
+    Node root("root", nullptr);
+    ponder::xml::detail::serialize<TreeProxy>(ponder::UserObject::makeRef(source), &root,
+                                              ponder::Value::nothing);
+    
+    MyClass target;
+    target.ints.clear();
+    target.names.clear();
+    target.objects.clear();
+    ponder::xml::detail::deserialize<TreeProxy>(ponder::UserObject::makeRef(target), &root,
+                                                ponder::Value::nothing);
+    
+    REQUIRE(target.ints == source.ints);
+    REQUIRE(target.names == source.names);
+    REQUIRE(target.objects.size() == 2);
+    REQUIRE(target.objects["a"].x == 7);
+    REQUIRE(target.objects["b"].x == 8);
+}
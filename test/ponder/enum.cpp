@@ -30,6 +30,7 @@
 #include <ponder/enumget.hpp>
 #include <ponder/errors.hpp>
 #include <ponder/enum.hpp>
+#include <ponder/value.hpp>
 #include "test.hpp"
 
 namespace EnumTest
@@ -58,6 +59,22 @@ namespace EnumTest
         Apple, Banana, Durian, Strawberry
     };
     
+    enum SparseEnum : long
+    {
+        Low = -1000000,
+        Minus = -1,
+        Mid = 12345,
+        High = 1L << 30
+    };
+    
+    enum Access
+    {
+        Read = 1,
+        Write = 2,
+        Exec = 8,
+        ReadWrite = Read | Write
+    };
+    
     static void declare()
     {
         ponder::Enum::declare<MyEnum>("EnumTest::MyEnum")
@@ -66,6 +83,19 @@ namespace EnumTest
             .value("Two", Two);
         
         ponder::Enum::declare<MyEnum2>("EnumTest::MyEnum2");
+        
+        ponder::Enum::declare<SparseEnum>("EnumTest::SparseEnum")
+            .value("Mid", Mid)
+            .value("Low", Low)
+            .value("High", High)
+            .value("Minus", Minus);
+        
+        ponder::Enum::declare<Access>("EnumTest::Access")
+            .flags()
+            .value("Read", Read)
+            .value("Write", Write)
+            .value("Exec", Exec)
+            .value("ReadWrite", ReadWrite);
     }
     
     static void declare_temp()
@@ -87,6 +117,8 @@ PONDER_TYPE(EnumTest::MyUndeclaredEnum /* never declared */)
 PONDER_TYPE(EnumTest::MyExplicitylyDeclaredEnum /* declared during tests */)
 PONDER_AUTO_TYPE(EnumTest::MyEnum, &EnumTest::declare)
 PONDER_AUTO_TYPE(EnumTest::MyEnum2, &EnumTest::declare)
+PONDER_AUTO_TYPE(EnumTest::SparseEnum, &EnumTest::declare)
+PONDER_AUTO_TYPE(EnumTest::Access, &EnumTest::declare)
 PONDER_TYPE(EnumTest::TempEnum)
 
 using namespace EnumTest;
@@ -202,6 +234,28 @@ TEST_CASE("Enum values can be read")
         REQUIRE(metaenum->value("Two") == Two);
         
         REQUIRE_THROWS_AS(metaenum->value("xxx"), ponder::EnumNameNotFound);
+        
+        ponder::Enum::EnumValue value = 0;
+        IS_TRUE(metaenum->tryValue("Two", value));
+        REQUIRE(value == Two);
+        IS_FALSE(metaenum->tryValue("Tw", value));
+    }
+    
+    SECTION("with sparse and negative values")
+    {
+        const ponder::Enum& sparse = ponder::enumByType<SparseEnum>();
+        
+        REQUIRE(sparse.size() == 4U);
+        REQUIRE(sparse.name(Low) == "Low");
+        REQUIRE(sparse.name(Minus) == "Minus");
+        REQUIRE(sparse.name(Mid) == "Mid");
+        REQUIRE(sparse.name(High) == "High");
+        REQUIRE(sparse.value("Low") == Low);
+        REQUIRE(sparse.value("High") == High);
+        IS_FALSE(sparse.hasValue(0));
+        IS_FALSE(sparse.hasValue(-1000001));
+        IS_FALSE(sparse.hasName("Mi"));
+        REQUIRE_THROWS_AS(sparse.name(1), ponder::EnumValueNotFound);
     }
 }
 
@@ -228,3 +282,61 @@ TEST_CASE("Enum can be undeclared")
     }
 }
 
+
+TEST_CASE("Enums of flags can be combined")
+{
+    const ponder::Enum& metaenum = ponder::enumByType<Access>();
+    
+    IS_TRUE(metaenum.isFlags());
+    IS_FALSE(ponder::enumByType<MyEnum>().isFlags());
+    REQUIRE(metaenum.flagMask() == (Read | Write | Exec));
+    
+    SECTION("combinations are formatted")
+    {
+        char text[32];
+        REQUIRE(metaenum.formatFlags(Read | Exec, text, sizeof(text)) == 9U);
+        REQUIRE(std::string(text) == "Read|Exec");
+        REQUIRE(metaenum.formatFlags(ReadWrite, text, sizeof(text)) == 9U);
+        REQUIRE(std::string(text) == "ReadWrite");
+        REQUIRE(metaenum.formatFlags(ReadWrite | Exec, text, sizeof(text)) == 15U);
+        REQUIRE(std::string(text) == "Read|Write|Exec");
+        REQUIRE(metaenum.formatFlags(0, text, sizeof(text)) == 0U);
+        REQUIRE(std::string(text) == "");
+        
+        // truncated like snprintf
+        REQUIRE(metaenum.formatFlags(Read | Exec, text, 6) == 9U);
+        REQUIRE(std::string(text) == "Read|");
+        
+        ponder::String str("mode=");
+        metaenum.formatFlags(Write | Exec, str);
+        REQUIRE(str == "mode=Write|Exec");
+        
+        REQUIRE_THROWS_AS(metaenum.formatFlags(Read | 4, text, sizeof(text)),
+                          ponder::EnumValueNotFound);
+    }
+    
+    SECTION("combinations are parsed")
+    {
+        REQUIRE(metaenum.parseFlags("Exec|Read") == (Read | Exec));
+        REQUIRE(metaenum.parseFlags(" Write | ReadWrite ") == ReadWrite);
+        REQUIRE(metaenum.parseFlags("") == 0);
+        
+        ponder::Enum::EnumValue value = 0;
+        IS_FALSE(metaenum.tryParseFlags("Read|Delete", value));
+        REQUIRE_THROWS_AS(metaenum.parseFlags("Read||Exec"), ponder::EnumNameNotFound);
+        REQUIRE_THROWS_AS(metaenum.parseFlags("Read|"), ponder::EnumNameNotFound);
+        REQUIRE_THROWS_AS(metaenum.parseFlags("|Read"), ponder::EnumNameNotFound);
+        REQUIRE_THROWS_AS(metaenum.parseFlags("Read| "), ponder::EnumNameNotFound);
+    }
+    
+    SECTION("combinations are converted to and from strings")
+    {
+        const ponder::Value value(static_cast<Access>(Write | Exec));
+        REQUIRE(value.to<ponder::String>() == "Write|Exec");
+        
+        REQUIRE(ponder::Value("Read|Exec").to<Access>() == (Read | Exec));
+        REQUIRE(ponder::Value("10").to<Access>() == (Write | Exec));
+        REQUIRE_THROWS_AS(ponder::Value("4").to<Access>(), ponder::BadType);
+        REQUIRE(ponder::Value("Two").to<MyEnum>() == Two);
+    }
+}
@@ -0,0 +1,189 @@
+/****************************************************************************
+**
+** This file is part of the CAMP library.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+#include <ponder/classget.hpp>
+#include <ponder/classbuilder.hpp>
+#include <ponder/errors.hpp>
+#include <ponder/uses/runtime.hpp>
+#include "test.hpp"
+#include <string>
+#include <vector>
+
+
+namespace ErrorTest
+{
+    struct Base {int b = 0; std::vector<int> list;};
+    struct Derived : Base
+    {
+        int d = 0;
+        int getD() const {return d;}
+        void setD(int x) {d = x;}
+        int add(int x) const {return d + x;}
+    };
+    struct Other {int o = 0;};
+    
+    // Errors seen by the handler, which forwards to the previous one
+    int raised = 0;
+    std::string lastMessage;
+    ponder::ErrorHandler previous = nullptr;
+    
+    void record(const ponder::Error& error)
+    {
+        ++raised;
+        lastMessage = error.what();
+        if (previous)
+            previous(error);
+    }
+    
+    static void declare()
+    {
+        ponder::Class::declare<Base>("ErrorTest::Base")
+            .property("b", &Base::b)
+            .property("list", &Base::list);
+        ponder::Class::declare<Derived>("ErrorTest::Derived")
+            .base<Base>()
+            .property("d", &Derived::getD, &Derived::setD)
+            .function("add", &Derived::add);
+        ponder::Class::declare<Other>("ErrorTest::Other");
+    }
+}
+
+PONDER_AUTO_TYPE(ErrorTest::Base, &ErrorTest::declare)
+PONDER_AUTO_TYPE(ErrorTest::Derived, &ErrorTest::declare)
+PONDER_AUTO_TYPE(ErrorTest::Other, &ErrorTest::declare)
+
+using namespace ErrorTest;
+
+//-----------------------------------------------------------------------------
+//                         Tests for ponder::setErrorHandler
+//-----------------------------------------------------------------------------
+
+TEST_CASE("Errors go through the error handler")
+{
+    ponder::classByType<Derived>();
+    ponder::classByType<Other>();
+    
+    previous = ponder::setErrorHandler(&record);
+    REQUIRE(ponder::errorHandler() == &record);
+    raised = 0;
+    
+    SECTION("the handler sees every error")
+    {
+        REQUIRE_THROWS_AS(ponder::classByName("ErrorTest::Unknown"), ponder::ClassNotFound);
+        REQUIRE(raised == 1);
+        REQUIRE(lastMessage.find("ErrorTest::Unknown") != std::string::npos);
+    }
+    
+    SECTION("compatibility checks don't raise errors")
+    {
+        Derived derived;
+        const ponder::Value number = 12;
+        const ponder::Value text = "twelve";
+        const ponder::Value object = ponder::UserObject(derived);
+        
+        REQUIRE(number.isCompatible<double>());
+        REQUIRE(ponder::Value("12").isCompatible<int>());
+        REQUIRE_FALSE(text.isCompatible<int>());
+        REQUIRE_FALSE(text.isCompatible<bool>());
+        REQUIRE_FALSE(number.isCompatible<ponder::UserObject>());
+        REQUIRE(object.isCompatible<const Base&>());
+        REQUIRE_FALSE(object.isCompatible<const Other&>());
+        REQUIRE_FALSE(ponder::Value(ponder::UserObject()).isCompatible<const Base&>());
+        REQUIRE_FALSE(ponder::Value().isCompatible<int>());
+        REQUIRE(raised == 0);
+    }
+    
+    SECTION("unrelated metaclasses can be checked without raising errors")
+    {
+        Derived derived;
+        void* pointer = &derived;
+        const ponder::Class& derivedClass = ponder::classByType<Derived>();
+        
+        REQUIRE(derivedClass.tryApplyOffset(pointer, ponder::classByType<Base>()));
+        REQUIRE(pointer == static_cast<Base*>(&derived));
+        REQUIRE_FALSE(ponder::tryClassCast(pointer, derivedClass, ponder::classByType<Other>()));
+        REQUIRE(raised == 0);
+        
+        REQUIRE_THROWS_AS(derivedClass.applyOffset(&derived, ponder::classByType<Other>()),
+                          ponder::ClassUnrelated);
+        REQUIRE(raised == 1);
+    }
+    
+    SECTION("failures can be checked before acting, without raising errors")
+    {
+        int number = 0;
+        REQUIRE(ponder::Value("12").tryTo(number));
+        REQUIRE(number == 12);
+        REQUIRE_FALSE(ponder::Value("twelve").tryTo(number));
+        REQUIRE(number == 12);
+        
+        REQUIRE(ponder::classByNameSafe("ErrorTest::Derived") == &ponder::classByType<Derived>());
+        REQUIRE(ponder::classByNameSafe("ErrorTest::Unknown") == nullptr);
+        
+        Derived derived;
+        Other other;
+        const ponder::Class& derivedClass = ponder::classByType<Derived>();
+        const ponder::UserObject object(derived);
+        const ponder::Property& b = derivedClass.property("b");
+        const ponder::Property& d = derivedClass.property("d");
+        const ponder::Property& list = derivedClass.property("list");
+        ponder::Value value;
+        
+        REQUIRE(b.appliesTo(object));
+        REQUIRE_FALSE(b.appliesTo(ponder::UserObject(other)));
+        REQUIRE_FALSE(d.appliesTo(ponder::UserObject(other)));
+        REQUIRE_FALSE(d.appliesTo(ponder::UserObject()));
+        REQUIRE_FALSE(d.tryGet(ponder::UserObject(other), value));
+        
+        REQUIRE(b.trySet(object, 3));
+        REQUIRE(d.trySet(object, "4"));
+        REQUIRE_FALSE(d.trySet(object, "four"));
+        REQUIRE(d.tryGet(object, value));
+        REQUIRE(value.to<int>() == 4);
+        REQUIRE(derived.b == 3);
+        
+        REQUIRE_FALSE(list.tryGet(object, value));
+        REQUIRE_FALSE(list.trySet(object, 5));
+        derived.list.push_back(1);
+        REQUIRE(list.trySet(object, 5));
+        REQUIRE(list.tryGet(object, value));
+        REQUIRE(value.to<int>() == 5);
+        
+        ponder::runtime::ObjectCaller add(derivedClass.function("add"));
+        REQUIRE(add.tryCall(object, ponder::Args(2), value));
+        REQUIRE(value.to<int>() == 6);
+        REQUIRE_FALSE(add.tryCall(object, ponder::Args("two"), value));
+        REQUIRE_FALSE(add.tryCall(object, ponder::Args(), value));
+        REQUIRE_FALSE(add.tryCall(ponder::UserObject(other), ponder::Args(2), value));
+        REQUIRE_FALSE(add.tryCall(ponder::UserObject(), ponder::Args(2), value));
+        REQUIRE(raised == 0);
+    }
+    
+    ponder::setErrorHandler(previous);
+}
@@ -0,0 +1,279 @@
+/****************************************************************************
+**
+** This file is part of the CAMP library.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+#include <ponder/classget.hpp>
+#include <ponder/classbuilder.hpp>
+#include <ponder/classvisitor.hpp>
+#include <ponder/event.hpp>
+#include "test.hpp"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+namespace EventTest
+{
+    struct Unit
+    {
+        int health = 100;
+        ponder::EventSource<int> damaged;
+        ponder::EventSource<> died;
+        
+        void hit(int amount)
+        {
+            health -= amount;
+            damaged.fire(amount);
+            if (health <= 0)
+                died.fire();
+        }
+    };
+    
+    struct Vehicle : Unit
+    {
+        ponder::EventSource<float, float> moved;
+        ponder::EventSource<std::string> named;
+    };
+    
+    struct EventCounter : ponder::ClassVisitor
+    {
+        std::vector<std::string> names;
+        
+        void visit(const ponder::Event& event) override
+        {
+            names.push_back(event.name());
+        }
+    };
+    
+    static void declare()
+    {
+        ponder::Class::declare<Unit>("EventTest::Unit")
+            .function("hit", &Unit::hit)
+            .event<int>("damaged", &Unit::damaged)
+                .tag("category", "combat")
+            .event("died", &Unit::died);
+        
+        ponder::Class::declare<Vehicle>("EventTest::Vehicle")
+            .base<Unit>()
+            .event("moved", &Vehicle::moved)
+            .event("named", &Vehicle::named);
+    }
+}
+
+PONDER_AUTO_TYPE(EventTest::Unit, &EventTest::declare)
+PONDER_AUTO_TYPE(EventTest::Vehicle, &EventTest::declare)
+
+using namespace EventTest;
+
+//-----------------------------------------------------------------------------
+//                         Tests for ponder::EventSource
+//-----------------------------------------------------------------------------
+
+TEST_CASE("Event sources call their subscribers")
+{
+    Unit unit;
+    std::vector<int> received;
+    
+    SECTION("subscribers are called in the order of their subscription")
+    {
+        const ponder::EventHandle a = unit.damaged.subscribe([&](int v) {received.push_back(v);});
+        const ponder::EventHandle b = unit.damaged.subscribe([&](int v) {received.push_back(-v);});
+        IS_TRUE(a != 0 && b != 0 && a != b);
+        REQUIRE(unit.damaged.subscriberCount() == 2);
+        
+        unit.hit(5);
+        REQUIRE(received == std::vector<int>({5, -5}));
+        
+        IS_TRUE(unit.damaged.unsubscribe(a));
+        IS_FALSE(unit.damaged.unsubscribe(a));
+        unit.hit(3);
+        REQUIRE(received == std::vector<int>({5, -5, -3}));
+        
+        IS_TRUE(unit.damaged.unsubscribe(b));
+        REQUIRE(unit.damaged.subscriberCount() == 0);
+        unit.hit(1);
+        REQUIRE(received.size() == 3);
+    }
+    
+    SECTION("subscribers can unsubscribe while the event is fired")
+    {
+        ponder::EventHandle once = 0;
+        once = unit.damaged.subscribe([&](int v)
+        {
+            received.push_back(v);
+            unit.damaged.unsubscribe(once);
+        });
+        
+        unit.hit(1);
+        unit.hit(2);
+        REQUIRE(received == std::vector<int>({1}));
+    }
+    
+    SECTION("subscribers can be added while other threads fire the event")
+    {
+        std::atomic<int> calls(0);
+        std::atomic<bool> stop(false);
+        std::thread firing([&] {
+            while (!stop)
+                unit.damaged.fire(1);
+        });
+        
+        for (int i = 0; i < 1000; ++i)
+        {
+            const ponder::EventHandle h = unit.damaged.subscribe([&](int v) {calls += v;});
+            unit.damaged.unsubscribe(h);
+        }
+        const ponder::EventHandle h = unit.damaged.subscribe([&](int v) {calls += v;});
+        while (calls == 0)
+            std::this_thread::yield();
+        
+        stop = true;
+        firing.join();
+        IS_TRUE(unit.damaged.unsubscribe(h));
+    }
+    
+    SECTION("replaced subscriber lists are deleted while other threads fire the event")
+    {
+        unit.damaged.subscribe([](int) {});
+        std::atomic<bool> stop(false);
+        std::thread firing([&] {
+            while (!stop)
+                unit.damaged.fire(1);
+        });
+        
+        // The handler, and its token, only live in the list replaced by the unsubscription
+        auto token = std::make_shared<int>(0);
+        const ponder::EventHandle h = unit.damaged.subscribe([token](int) {});
+        IS_TRUE(unit.damaged.unsubscribe(h));
+        
+        const std::weak_ptr<int> watched = token;
+        token.reset();
+        while (!watched.expired())
+            std::this_thread::yield();
+        
+        stop = true;
+        firing.join();
+    }
+}
+
+//-----------------------------------------------------------------------------
+//                         Tests for ponder::Event
+//-----------------------------------------------------------------------------
+
+TEST_CASE("Classes can have events")
+{
+    const ponder::Class& unitClass = ponder::classByType<Unit>();
+    const ponder::Class& vehicleClass = ponder::classByType<Vehicle>();
+    
+    SECTION("events are declared and inherited")
+    {
+        REQUIRE(unitClass.eventCount() == 2);
+        REQUIRE(vehicleClass.eventCount() == 4);
+        IS_TRUE(vehicleClass.hasEvent("damaged"));
+        IS_FALSE(unitClass.hasEvent("moved"));
+        REQUIRE(&vehicleClass.event("damaged") == &unitClass.event("damaged"));
+        
+        const ponder::Event* event = nullptr;
+        IS_TRUE(vehicleClass.tryEvent("moved", event));
+        REQUIRE(event->paramCount() == 2);
+        IS_TRUE(event->paramType(0) == ponder::ValueKind::Real);
+        IS_TRUE(unitClass.event("damaged").paramType(0) == ponder::ValueKind::Integer);
+        REQUIRE(unitClass.event("died").paramCount() == 0);
+        REQUIRE(unitClass.event("damaged").tag("category") == ponder::Value("combat"));
+        
+        REQUIRE_THROWS_AS(unitClass.event("moved"), ponder::EventNotFound);
+        REQUIRE_THROWS_AS(unitClass.event(2), ponder::OutOfRange);
+        REQUIRE_THROWS_AS(event->paramType(2), ponder::OutOfRange);
+    }
+    
+    SECTION("events are visited")
+    {
+        EventCounter visitor;
+        vehicleClass.visit(visitor);
+        REQUIRE(visitor.names == std::vector<std::string>({"damaged", "died", "moved", "named"}));
+    }
+    
+    SECTION("subscribers receive the arguments as values")
+    {
+        Vehicle vehicle;
+        const ponder::UserObject object(&vehicle);
+        const ponder::Event& damaged = vehicleClass.event("damaged");
+        const ponder::Event& moved = vehicleClass.event("moved");
+        
+        std::vector<ponder::Value> received;
+        const ponder::EventHandle h = damaged.subscribe(object, [&](const ponder::Args& args)
+        {
+            received.push_back(args[0]);
+        });
+        moved.subscribe(object, [&](const ponder::Args& args)
+        {
+            received.push_back(args[0]);
+            received.push_back(args[1]);
+        });
+        REQUIRE(damaged.subscriberCount(object) == 1);
+        
+        // Fired from C++
+        vehicle.hit(7);
+        vehicle.moved.fire(1.5f, 2.f);
+        
+        // Fired through the metaclass
+        damaged.fire(object, ponder::Args(4));
+        moved.fire(object, ponder::Args(3, "4"));
+        
+        REQUIRE(received == std::vector<ponder::Value>({7, 1.5f, 2.f, 4, 3.f, 4.f}));
+        
+        IS_TRUE(damaged.unsubscribe(object, h));
+        IS_FALSE(damaged.unsubscribe(object, h));
+        vehicle.hit(1);
+        REQUIRE(received.size() == 6);
+    }
+    
+    SECTION("strings and objects can be passed")
+    {
+        Vehicle vehicle;
+        std::string name;
+        vehicleClass.event("named").subscribe(vehicle, [&](const ponder::Args& args)
+        {
+            name = args[0].to<std::string>();
+        });
+        vehicle.named.fire("rover");
+        REQUIRE(name == "rover");
+    }
+    
+    SECTION("firing checks the arguments")
+    {
+        Unit unit;
+        const ponder::Event& damaged = unitClass.event("damaged");
+        
+        REQUIRE_THROWS_AS(damaged.fire(unit), ponder::NotEnoughArguments);
+        REQUIRE_THROWS_AS(damaged.fire(unit, ponder::Args(ponder::UserObject())), ponder::BadArgument);
+        REQUIRE_THROWS_AS(damaged.fire(ponder::UserObject(), ponder::Args(1)), ponder::NullObject);
+    }
+}
@@ -0,0 +1,153 @@
+/****************************************************************************
+**
+** This file is part of the CAMP library.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+#include <ponder/classget.hpp>
+#include <ponder/classbuilder.hpp>
+#include <ponder/detail/fieldproperty.hpp>
+#include "test.hpp"
+
+
+namespace FieldPropertyTest
+{
+    struct Padding
+    {
+        virtual ~Padding() {}
+        double pad[3];
+    };
+    
+    struct Fields
+    {
+        bool b;
+        char c;
+        unsigned short us;
+        int i;
+        unsigned long ul;
+        long long ll;
+        float f;
+        double d;
+        ponder::String s;
+        const int ci;
+        
+        Fields() : b(false), c('a'), us(1), i(2), ul(3), ll(4), f(5.f), d(6.), s("7"), ci(8) {}
+    };
+    
+    struct Derived : Padding, Fields
+    {
+        PONDER_POLYMORPHIC()
+    };
+    
+    static void declare()
+    {
+        ponder::Class::declare<Fields>("FieldPropertyTest::Fields")
+            .property("b", &Fields::b)
+            .property("c", &Fields::c)
+            .property("us", &Fields::us)
+            .property("i", &Fields::i)
+            .property("ul", &Fields::ul)
+            .property("ll", &Fields::ll)
+            .property("f", &Fields::f)
+            .property("d", &Fields::d)
+            .property("s", &Fields::s)
+            .property("ci", &Fields::ci);
+        
+        ponder::Class::declare<Padding>("FieldPropertyTest::Padding");
+        
+        ponder::Class::declare<Derived>("FieldPropertyTest::Derived")
+            .base<Padding>()
+            .base<Fields>();
+    }
+}
+
+PONDER_AUTO_TYPE(FieldPropertyTest::Fields, &FieldPropertyTest::declare)
+PONDER_AUTO_TYPE(FieldPropertyTest::Padding, &FieldPropertyTest::declare)
+PONDER_AUTO_TYPE(FieldPropertyTest::Derived, &FieldPropertyTest::declare)
+
+//-----------------------------------------------------------------------------
+//                         Tests for data member properties
+//-----------------------------------------------------------------------------
+
+TEST_CASE("Data members of fundamental types share one implementation")
+{
+    using namespace FieldPropertyTest;
+    
+    const ponder::Class& metaclass = ponder::classByType<Fields>();
+    
+    for (std::size_t i = 0; i < metaclass.propertyCount(); ++i)
+    {
+        IS_TRUE(dynamic_cast<const ponder::detail::FieldProperty*>(&metaclass.property(i))
+                != nullptr);
+    }
+    
+    REQUIRE(metaclass.property("b").kind() == ponder::ValueKind::Boolean);
+    REQUIRE(metaclass.property("ll").kind() == ponder::ValueKind::Integer);
+    REQUIRE(metaclass.property("f").kind() == ponder::ValueKind::Real);
+    REQUIRE(metaclass.property("s").kind() == ponder::ValueKind::String);
+    
+    SECTION("values can be read and written")
+    {
+        Fields object;
+        REQUIRE(metaclass.property("c").get(object).to<char>() == 'a');
+        REQUIRE(metaclass.property("us").get(object).to<int>() == 1);
+        REQUIRE(metaclass.property("ul").get(object).to<int>() == 3);
+        REQUIRE(metaclass.property("d").get(object).to<double>() == 6.);
+        REQUIRE(metaclass.property("s").get(object).to<ponder::String>() == "7");
+        
+        metaclass.property("b").set(object, true);
+        metaclass.property("i").set(object, 42);
+        metaclass.property("ll").set(object, "123456789012");
+        metaclass.property("f").set(object, 0.5);
+        metaclass.property("s").set(object, "text");
+        REQUIRE(object.b == true);
+        REQUIRE(object.i == 42);
+        REQUIRE(object.ll == 123456789012LL);
+        REQUIRE(object.f == 0.5f);
+        REQUIRE(object.s == "text");
+    }
+    
+    SECTION("const members are read-only")
+    {
+        Fields object;
+        const ponder::Property& property = metaclass.property("ci");
+        REQUIRE(property.get(object).to<int>() == 8);
+        IS_FALSE(property.writable(object));
+        REQUIRE_THROWS_AS(property.set(object, 1), ponder::ForbiddenWrite);
+    }
+    
+    SECTION("members are found through derived classes")
+    {
+        Derived object;
+        const ponder::Class& derived = ponder::classByType<Derived>();
+        
+        derived.property("i").set(object, 24);
+        REQUIRE(object.i == 24);
+        REQUIRE(derived.property("d").get(object).to<double>() == 6.);
+        REQUIRE(metaclass.property("s").get(ponder::UserObject::makeRef(object))
+                    .to<ponder::String>() == "7");
+    }
+}
@@ -32,6 +32,7 @@
 #include <ponder/class.hpp>
 #include <ponder/classbuilder.hpp>
 #include "test.hpp"
+#include <vector>
 
 namespace InheritanceTest
 {
@@ -82,6 +83,16 @@ namespace InheritanceTest
         PONDER_POLYMORPHIC();
     };
     
+    struct TemporaryBase
+    {
+        int inherited = 0;
+    };
+    
+    struct TemporaryDerived : TemporaryBase
+    {
+        int own = 0;
+    };
+    
     void declare()
     {
         ponder::Class::declare<MyClass1>("InheritanceTest::MyClass1")
@@ -118,6 +129,8 @@ PONDER_AUTO_TYPE(InheritanceTest::MyClass1, &InheritanceTest::declare)
 PONDER_AUTO_TYPE(InheritanceTest::MyClass2, &InheritanceTest::declare)
 PONDER_AUTO_TYPE(InheritanceTest::MyClass3, &InheritanceTest::declare)
 PONDER_AUTO_TYPE(InheritanceTest::MyClass4, &InheritanceTest::declare)
+PONDER_TYPE(InheritanceTest::TemporaryBase)
+PONDER_TYPE(InheritanceTest::TemporaryDerived)
 
 using namespace InheritanceTest;
 
@@ -245,6 +258,48 @@ TEST_CASE("Classes support inheritence")
         REQUIRE(class1->property("overridden").get(object4) == ponder::Value(10));
         REQUIRE(class2->property("overridden").get(object4) == ponder::Value(20));
         REQUIRE(class3->property("overridden").get(object4) == ponder::Value(30));
-    }    
+    }
+
+    SECTION("share inherited members with their base")
+    {
+        REQUIRE(&class3->property("p1") == &class1->property("p1"));
+        REQUIRE(&class4->property("p2") == &class2->property("p2"));
+        REQUIRE(&class4->function("f3") == &class3->function("f3"));
+        REQUIRE(&class4->property("overridden") != &class3->property("overridden"));
+
+        // p1, p2, p3, p4, overridden
+        REQUIRE(class4->propertyCount() == 5);
+        REQUIRE(class4->functionCount() == 6);
+
+        // Inherited members come first, in the order of the base, then own members by name
+        std::vector<ponder::String> names;
+        for (auto&& prop : class4->propertyIterator())
+            names.push_back(ponder::String(prop.name()));
+        const std::vector<ponder::String> expected = {"p1", "p2", "p3", "overridden", "p4"};
+        REQUIRE(names == expected);
+        for (std::size_t i = 0; i < names.size(); ++i)
+            REQUIRE(class4->property(i).name() == names[i]);
+        
+        // Inherited members keep their index
+        REQUIRE(&class4->property(0) == &class3->property(0));
+        REQUIRE(&class4->property(1) == &class3->property(1));
+    }
+    
+    SECTION("keep inherited members alive when their base is undeclared")
+    {
+        ponder::Class::declare<TemporaryBase>("InheritanceTest::TemporaryBase")
+            .property("inherited", &TemporaryBase::inherited);
+        ponder::Class::declare<TemporaryDerived>("InheritanceTest::TemporaryDerived")
+            .base<TemporaryBase>()
+            .property("own", &TemporaryDerived::own);
+        const ponder::Class& derived = ponder::classByType<TemporaryDerived>();
+        
+        ponder::Class::undeclare<TemporaryBase>("InheritanceTest::TemporaryBase");
+        REQUIRE(derived.propertyCount() == 2);
+        REQUIRE(derived.property("inherited").name() == "inherited");
+        REQUIRE(derived.property(0).kind() == ponder::ValueKind::Integer);
+        
+        ponder::Class::undeclare<TemporaryDerived>("InheritanceTest::TemporaryDerived");
+    }
 }
 
@@ -0,0 +1,153 @@
+/****************************************************************************
+**
+** This file is part of the CAMP library.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+#include <ponder/classget.hpp>
+#include <ponder/classbuilder.hpp>
+#include <ponder/instances.hpp>
+#include <ponder/uses/runtime.hpp>
+#include "test.hpp"
+
+
+namespace InstancesTest
+{
+    struct Session
+    {
+        Session(int i = 0) : id(i) {}
+        
+        int id;
+        char buffer[60];
+    };
+    
+    static void declare()
+    {
+        ponder::Class::declare<Session>("InstancesTest::Session")
+            .constructor()
+            .constructor<int>()
+            .property("id", &Session::id);
+    }
+}
+
+PONDER_AUTO_TYPE(InstancesTest::Session, &InstancesTest::declare)
+
+using namespace InstancesTest;
+
+//-----------------------------------------------------------------------------
+//                         Tests for ponder::instances
+//-----------------------------------------------------------------------------
+
+TEST_CASE("Live instances are counted per metaclass")
+{
+    const ponder::Class& metaclass = ponder::classByType<Session>();
+    const ponder::instances::Stats before = ponder::instances::stats(metaclass);
+    
+    SECTION("objects created and destroyed by the factory")
+    {
+        ponder::UserObject a = ponder::runtime::create(metaclass);
+        ponder::UserObject b = ponder::runtime::create(metaclass, 2);
+        ponder::UserObject c = ponder::runtime::create(metaclass, 3);
+        ponder::runtime::destroy(c);
+        
+        const ponder::instances::Stats during = ponder::instances::stats(metaclass);
+        ponder::runtime::destroy(a);
+        ponder::runtime::destroy(b);
+        const ponder::instances::Stats after = ponder::instances::stats(metaclass);
+        
+        if (ponder::instances::enabled())
+        {
+            REQUIRE(during.live == before.live + 2);
+            REQUIRE(during.bytes == during.live * sizeof(Session));
+            REQUIRE(during.peak >= before.live + 3);
+            REQUIRE(after.created == before.created + 3);
+            REQUIRE(after.live == before.live);
+            REQUIRE(after.peak == during.peak);
+        }
+        else
+        {
+            REQUIRE(during.live == 0);
+            REQUIRE(after.created == 0);
+        }
+    }
+    
+    SECTION("objects constructed in place")
+    {
+        alignas(Session) char storage[sizeof(Session)];
+        ponder::runtime::ObjectFactory factory(metaclass);
+        ponder::UserObject object = factory.construct(ponder::Args(7), storage);
+        const std::size_t live = ponder::instances::stats(metaclass).live;
+        factory.destruct(object);
+        
+        if (ponder::instances::enabled())
+            REQUIRE(live == before.live + 1);
+        REQUIRE(ponder::instances::stats(metaclass).live == before.live);
+    }
+    
+    SECTION("copies held by user objects")
+    {
+        std::size_t live = 0;
+        {
+            ponder::UserObject copy = ponder::UserObject::makeCopy(Session(4));
+            ponder::UserObject shared = copy;
+            live = ponder::instances::stats(metaclass).live;
+        }
+        
+        if (ponder::instances::enabled())
+            REQUIRE(live == before.live + 1);
+        REQUIRE(ponder::instances::stats(metaclass).live == before.live);
+    }
+    
+    SECTION("objects created outside Ponder don't underflow the counter")
+    {
+        ponder::runtime::destroy(ponder::UserObject::makeRef(new Session));
+        REQUIRE(ponder::instances::stats(metaclass).live == before.live);
+    }
+    
+    SECTION("creation sites can be recorded")
+    {
+        ponder::instances::recordSites(true);
+        ponder::UserObject a = ponder::runtime::create(metaclass);
+        ponder::UserObject b = ponder::runtime::create(metaclass);
+        ponder::instances::recordSites(false);
+        ponder::UserObject c = ponder::runtime::create(metaclass); // not recorded
+        
+        const std::vector<ponder::instances::Site> sites = ponder::instances::sites(metaclass);
+        std::size_t recorded = 0;
+        for (auto& site : sites)
+            recorded += site.live;
+        
+        ponder::runtime::destroy(a);
+        ponder::runtime::destroy(b);
+        ponder::runtime::destroy(c);
+        
+        if (ponder::instances::enabled())
+            REQUIRE(recorded == 2);
+        else
+            REQUIRE(sites.empty());
+        REQUIRE(ponder::instances::sites(metaclass).empty());
+    }
+}
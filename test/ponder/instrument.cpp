@@ -0,0 +1,170 @@
+/****************************************************************************
+**
+** This file is part of the CAMP library.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+#include <ponder/classget.hpp>
+#include <ponder/classbuilder.hpp>
+#include <ponder/instrument.hpp>
+#include <ponder/uses/runtime.hpp>
+#include "test.hpp"
+#include <thread>
+
+
+namespace InstrumentTest
+{
+    struct Counter
+    {
+        Counter(int start = 0) : value(start) {}
+        
+        int value;
+        
+        int add(int x) {value += x; return value;}
+    };
+    
+    struct Temporary
+    {
+        int value = 0;
+    };
+    
+    static void declare()
+    {
+        ponder::Class::declare<Counter>("InstrumentTest::Counter")
+            .constructor()
+            .constructor<int>()
+            .property("value", &Counter::value)
+            .function("add", &Counter::add);
+    }
+}
+
+PONDER_AUTO_TYPE(InstrumentTest::Counter, &InstrumentTest::declare)
+PONDER_TYPE(InstrumentTest::Temporary)
+
+using namespace ponder::instrument;
+
+//-----------------------------------------------------------------------------
+//                         Tests for ponder::instrument
+//-----------------------------------------------------------------------------
+
+TEST_CASE("Latencies are recorded in logarithmic buckets")
+{
+    Stats stats;
+    stats.record(0);
+    stats.record(1);
+    stats.record(3);
+    stats.record(1000);
+    
+    REQUIRE(stats.calls == 4);
+    REQUIRE(stats.totalNs == 1004);
+    REQUIRE(stats.maxNs == 1000);
+    REQUIRE(stats.meanNs() == 251);
+    REQUIRE(stats.buckets[0] == 2);     // 0 and 1
+    REQUIRE(stats.buckets[1] == 1);     // 2..3
+    REQUIRE(stats.buckets[9] == 1);     // 512..1023
+    
+    REQUIRE(stats.percentile(0.5) == 1);
+    REQUIRE(stats.percentile(0.75) == 3);
+    REQUIRE(stats.percentile(1.0) == 1000); // bucket bound is clamped to the max
+    REQUIRE(Stats().percentile(0.5) == 0);
+    
+    Stats other;
+    other.record(5000);
+    stats.merge(other);
+    REQUIRE(stats.calls == 5);
+    REQUIRE(stats.maxNs == 5000);
+    REQUIRE(stats.buckets[12] == 1);    // 4096..8191
+}
+
+TEST_CASE("Member operations are counted when instrumentation is enabled")
+{
+    using namespace InstrumentTest;
+    
+    const ponder::Class& metaclass = ponder::classByType<Counter>();
+    const ponder::Property& value = metaclass.property("value");
+    const ponder::Function& add = metaclass.function("add");
+    
+    reset();
+    
+    ponder::UserObject object = ponder::runtime::create(metaclass, 2);
+    value.set(object, 5);
+    value.get(object);
+    value.get(object);
+    ponder::runtime::call(add, object, 3);
+    
+    // Operations done by other threads are aggregated, even after they have exited
+    std::thread([&value, &object] { value.get(object); }).join();
+    
+    const Snapshot snap = snapshot();
+    if (enabled())
+    {
+        REQUIRE(snap.get(value, Operation::Get).calls == 3);
+        REQUIRE(snap.get(value, Operation::Set).calls == 1);
+        REQUIRE(snap.get(add).calls == 1);
+        REQUIRE(snap.get(*metaclass.constructor(1)).calls == 1);
+        REQUIRE(snap.get(*metaclass.constructor(0)).calls == 0);
+        
+        reset();
+        REQUIRE(snapshot().get(value, Operation::Get).calls == 0);
+    }
+    else
+    {
+        REQUIRE(snap.size() == 0);
+    }
+    
+    ponder::runtime::destroy(object);
+}
+
+TEST_CASE("Statistics of a member are cleared when its class is undeclared")
+{
+    using namespace InstrumentTest;
+    
+    reset();
+    
+    ponder::Class::declare<Temporary>("InstrumentTest::Temporary")
+        .property("value", &Temporary::value);
+    Temporary object;
+    ponder::classByType<Temporary>().property("value").get(object);
+    ponder::classByType<Temporary>().property("value").get(object);
+    
+    if (enabled())
+        REQUIRE(snapshot().get(ponder::classByType<Temporary>().property("value"),
+                               Operation::Get).calls == 2);
+    
+    ponder::Class::undeclare<Temporary>("InstrumentTest::Temporary");
+    REQUIRE(snapshot().size() == 0);
+    
+    // A new member reusing the slot starts afresh
+    ponder::Class::declare<Temporary>("InstrumentTest::Temporary")
+        .property("value", &Temporary::value);
+    const ponder::Property& value = ponder::classByType<Temporary>().property("value");
+    REQUIRE(snapshot().get(value, Operation::Get).calls == 0);
+    value.get(object);
+    if (enabled())
+        REQUIRE(snapshot().get(value, Operation::Get).calls == 1);
+    
+    ponder::Class::undeclare<Temporary>("InstrumentTest::Temporary");
+}
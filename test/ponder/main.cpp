@@ -36,3 +36,52 @@
 #define CATCH_CONFIG_MAIN
 #include "test.hpp"
 
+#if PONDER_NO_EXCEPTIONS
+
+#include <ponder/errors.hpp>
+
+// Ponder is built without exceptions: the tests are not, and rethrow its errors with their
+// type so that they can be checked as usual. The exceptions then unwind through library code
+// built with -fno-exceptions, which only works with the unwind tables the compiler emits anyway,
+// and skips the destructors of its frames: this is not the real no-exceptions mode, which is
+// covered by the separate noexceptions test
+namespace
+{
+    template <typename T>
+    void rethrowAs(const ponder::Error& error)
+    {
+        if (const T* e = dynamic_cast<const T*>(&error))
+            throw *e;
+    }
+
+    void rethrow(const ponder::Error& error)
+    {
+        // Derived errors first
+        rethrowAs<ponder::BadArgument>(error);
+        rethrowAs<ponder::BadType>(error);
+        rethrowAs<ponder::ClassAlreadyCreated>(error);
+        rethrowAs<ponder::ClassNotFound>(error);
+        rethrowAs<ponder::ClassUnrelated>(error);
+        rethrowAs<ponder::EnumAlreadyCreated>(error);
+        rethrowAs<ponder::EnumNameNotFound>(error);
+        rethrowAs<ponder::EnumNotFound>(error);
+        rethrowAs<ponder::EnumValueNotFound>(error);
+        rethrowAs<ponder::EventNotFound>(error);
+        rethrowAs<ponder::ForbiddenCall>(error);
+        rethrowAs<ponder::ForbiddenRead>(error);
+        rethrowAs<ponder::ForbiddenWrite>(error);
+        rethrowAs<ponder::FunctionNotFound>(error);
+        rethrowAs<ponder::KeyNotFound>(error);
+        rethrowAs<ponder::NotEnoughArguments>(error);
+        rethrowAs<ponder::NullObject>(error);
+        rethrowAs<ponder::OutOfRange>(error);
+        rethrowAs<ponder::PropertyNotFound>(error);
+        rethrowAs<ponder::SchemaMismatch>(error);
+        throw error;
+    }
+
+    const ponder::ErrorHandler previousHandler = ponder::setErrorHandler(&rethrow);
+}
+
+#endif // PONDER_NO_EXCEPTIONS
+
@@ -0,0 +1,200 @@
+/****************************************************************************
+**
+** This file is part of the CAMP library.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+#include <ponder/classget.hpp>
+#include <ponder/classbuilder.hpp>
+#include <ponder/enum.hpp>
+#include <ponder/memoryreport.hpp>
+#include "test.hpp"
+#include <array>
+
+
+namespace MemoryReportTest
+{
+    struct Base
+    {
+        virtual ~Base() {}
+        int id;
+        bool locked;
+        int getId() const {return id;}
+    };
+    
+    struct Derived : Base
+    {
+        Derived(int i = 0) : extra(i) {}
+        int extra;
+        int twice(int x) const {return x * 2;}
+    };
+    
+    enum Mode {ModeA, ModeB};
+    
+    struct Captured
+    {
+        int value = 0;
+    };
+    
+    static void declare()
+    {
+        ponder::Class::declare<Base>("MemoryReportTest::Base")
+            .property("id", &Base::id)
+                .readable(&Base::locked)
+            .property("aPropertyWithAVeryLongName", &Base::getId)
+                .tag("aTagIdentifierLongerThanInlineStrings");
+        
+        ponder::Class::declare<Derived>("MemoryReportTest::Derived")
+            .base<Base>()
+            .constructor<int>()
+            .property("extra", &Derived::extra)
+            .function("twice", &Derived::twice);
+        
+        ponder::Enum::declare<Mode>("MemoryReportTest::Mode")
+            .value("ModeA", ModeA)
+            .value("ModeB", ModeB);
+    }
+}
+
+PONDER_AUTO_TYPE(MemoryReportTest::Base, &MemoryReportTest::declare)
+PONDER_AUTO_TYPE(MemoryReportTest::Derived, &MemoryReportTest::declare)
+PONDER_AUTO_TYPE(MemoryReportTest::Mode, &MemoryReportTest::declare)
+PONDER_TYPE(MemoryReportTest::Captured)
+
+using ponder::MemoryCategory;
+using ponder::MetadataKind;
+
+//-----------------------------------------------------------------------------
+//                         Tests for ponder::metadataMemoryReport
+//-----------------------------------------------------------------------------
+
+TEST_CASE("The memory used by metadata can be reported")
+{
+    using namespace MemoryReportTest;
+    
+    const ponder::Class& base = ponder::classByType<Base>();
+    const ponder::Class& derived = ponder::classByType<Derived>();
+    
+    const ponder::MetadataMemoryReport report = ponder::metadataMemoryReport();
+    REQUIRE(report.classes.size() == ponder::classCount());
+    
+    const ponder::ClassMemoryUsage* baseUsage = nullptr;
+    const ponder::ClassMemoryUsage* derivedUsage = nullptr;
+    std::size_t classesTotal = 0, objects = 0;
+    for (auto& usage : report.classes)
+    {
+        if (usage.metaclass == &base)
+            baseUsage = &usage;
+        if (usage.metaclass == &derived)
+            derivedUsage = &usage;
+        classesTotal += usage.total();
+        for (auto& kind : usage.kinds)
+            objects += kind[MemoryCategory::Objects];
+    }
+    REQUIRE(baseUsage != nullptr);
+    REQUIRE(derivedUsage != nullptr);
+    
+    SECTION("members are counted by the allocator")
+    {
+        const ponder::MemoryUsage& properties = (*baseUsage)[MetadataKind::Property];
+        REQUIRE(properties[MemoryCategory::Objects] >= 2 * sizeof(ponder::Property));
+        REQUIRE(properties[MemoryCategory::Accessors] > 0); // readable(&Base::locked)
+        REQUIRE(properties[MemoryCategory::Names] > 0);
+        REQUIRE(properties[MemoryCategory::Tags] > 0);
+        
+        REQUIRE((*derivedUsage)[MetadataKind::Function][MemoryCategory::Objects]
+                >= sizeof(ponder::Function));
+        REQUIRE((*derivedUsage)[MetadataKind::Function][MemoryCategory::Callers] > 0);
+        REQUIRE((*derivedUsage)[MetadataKind::Constructor][MemoryCategory::Objects]
+                >= sizeof(ponder::Constructor));
+        REQUIRE((*derivedUsage)[MetadataKind::Class][MemoryCategory::Tables]
+                >= sizeof(ponder::Class));
+    }
+    
+    SECTION("inherited members are shared with the base")
+    {
+        // A single base without overridden members: its index is shared as is
+        const ponder::MemoryUsage& inherited = (*derivedUsage)[MetadataKind::Property];
+        REQUIRE(inherited[MemoryCategory::Inherited] == 0);
+        REQUIRE(inherited[MemoryCategory::Tables]
+                < (*baseUsage)[MetadataKind::Property][MemoryCategory::Tables]);
+        REQUIRE(inherited[MemoryCategory::Objects]
+                < (*baseUsage)[MetadataKind::Property][MemoryCategory::Objects]);
+        REQUIRE((*baseUsage)[MetadataKind::Property][MemoryCategory::Inherited] == 0);
+    }
+    
+    SECTION("members are allocated from the metadata arena")
+    {
+        REQUIRE(report.arenaReserved > 0);
+        REQUIRE(report.arenaReserved % 16384 == 0); // whole chunks
+        
+        // Freed blocks are recycled
+        void* block = ponder::detail::arenaAllocate(40);
+        ponder::detail::arenaDeallocate(block, 40);
+        void* again = ponder::detail::arenaAllocate(48); // same size class
+        REQUIRE(again == block);
+        ponder::detail::arenaDeallocate(again, 48);
+        
+        // Large blocks bypass the arena
+        const std::size_t reserved = ponder::detail::arenaReservedBytes();
+        void* large = ponder::detail::arenaAllocate(4096);
+        REQUIRE(ponder::detail::arenaReservedBytes() == reserved);
+        ponder::detail::arenaDeallocate(large, 4096);
+    }
+    
+    SECTION("totals add up")
+    {
+        REQUIRE(report[MetadataKind::Enum][MemoryCategory::Tables] >= sizeof(ponder::Enum));
+        REQUIRE(report.total.total()
+                == classesTotal + report[MetadataKind::Enum].total());
+        REQUIRE(report.allocated[MemoryCategory::Objects] >= objects);
+    }
+}
+
+TEST_CASE("The heap blocks of accessor functors are counted")
+{
+    using namespace MemoryReportTest;
+    
+    const std::size_t before = ponder::metadataMemoryReport().allocated[MemoryCategory::Accessors];
+    
+    // A capture larger than the inline storage of std::function is allocated on the heap
+    std::array<char, 64> padding = {};
+    ponder::Class::declare<Captured>("MemoryReportTest::Captured")
+        .property("value", [padding](const Captured& c) {return c.value + padding[0];})
+        .property("plain", &Captured::value);
+    
+    const ponder::Class& metaclass = ponder::classByType<Captured>();
+    const ponder::MetadataMemoryReport report = ponder::metadataMemoryReport();
+    for (auto& usage : report.classes)
+    {
+        if (usage.metaclass == &metaclass)
+            REQUIRE(usage[MetadataKind::Property][MemoryCategory::Accessors] >= sizeof(padding));
+    }
+    REQUIRE(report.allocated[MemoryCategory::Accessors] >= before + sizeof(padding));
+    
+    ponder::Class::undeclare<Captured>("MemoryReportTest::Captured");
+    REQUIRE(ponder::metadataMemoryReport().allocated[MemoryCategory::Accessors] == before);
+}
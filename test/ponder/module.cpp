@@ -0,0 +1,193 @@
+/****************************************************************************
+**
+** This file is part of the CAMP library.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+#include <ponder/module.hpp>
+#include <ponder/classget.hpp>
+#include <ponder/enumget.hpp>
+#include <ponder/classbuilder.hpp>
+#include <ponder/enumbuilder.hpp>
+#include <ponder/observer.hpp>
+#include <ponder/userproperty.hpp>
+#include "test.hpp"
+
+
+namespace ModuleTest
+{
+    struct Inner
+    {
+        int x;
+    };
+    
+    struct Outer
+    {
+        Inner inner;
+    };
+    
+    enum Colour
+    {
+        Red,
+        Green
+    };
+    
+    // Record the generation seen while metaclasses are being removed
+    struct GenerationObserver : ponder::Observer
+    {
+        std::size_t seen = 0;
+        
+        void classRemoved(const ponder::Class&) override {seen = ponder::registryGeneration();}
+        void enumRemoved(const ponder::Enum&) override {seen = ponder::registryGeneration();}
+    };
+    
+    static void declare()
+    {
+        ponder::Class::declare<Inner>("ModuleTest::Inner")
+            .property("x", &Inner::x);
+        ponder::Class::declare<Outer>("ModuleTest::Outer")
+            .property("inner", &Outer::inner);
+        ponder::Enum::declare<Colour>("ModuleTest::Colour")
+            .value("red", Red)
+            .value("green", Green);
+    }
+}
+
+PONDER_TYPE(ModuleTest::Inner)
+PONDER_TYPE(ModuleTest::Outer)
+PONDER_TYPE(ModuleTest::Colour)
+
+//-----------------------------------------------------------------------------
+//                         Tests for ponder::Module
+//-----------------------------------------------------------------------------
+
+TEST_CASE("Modules group declarations")
+{
+    ponder::Module module("ModuleTest");
+    REQUIRE(module.name() == "ModuleTest");
+    IS_TRUE(ponder::Module::current() == nullptr);
+    
+    const std::size_t classes = ponder::classCount();
+    const std::size_t enums = ponder::enumCount();
+    
+    {
+        ponder::Module::Scope scope(module);
+        IS_TRUE(ponder::Module::current() == &module);
+        ModuleTest::declare();
+    }
+    IS_TRUE(ponder::Module::current() == nullptr);
+    
+    REQUIRE(module.classCount() == 2);
+    REQUIRE(module.enumCount() == 1);
+    REQUIRE(ponder::classCount() == classes + 2);
+    REQUIRE(ponder::enumCount() == enums + 1);
+    
+    SECTION("and unload them in one go")
+    {
+        const std::size_t generation = ponder::registryGeneration();
+        
+        module.unload();
+        
+        REQUIRE(module.classCount() == 0);
+        REQUIRE(module.enumCount() == 0);
+        REQUIRE(ponder::classCount() == classes);
+        REQUIRE(ponder::enumCount() == enums);
+        IS_TRUE(ponder::registryGeneration() != generation);
+        REQUIRE_THROWS_AS(ponder::classByName("ModuleTest::Outer"), ponder::ClassNotFound);
+        REQUIRE_THROWS_AS(ponder::enumByName("ModuleTest::Colour"), ponder::EnumNotFound);
+    }
+    
+    SECTION("and invalidate the caches once they are deleted")
+    {
+        ModuleTest::GenerationObserver observer;
+        ponder::addObserver(&observer);
+        
+        ponder::Class::undeclare<ModuleTest::Inner>();
+        IS_TRUE(ponder::registryGeneration() != observer.seen);
+        ponder::Enum::undeclare<ModuleTest::Colour>();
+        IS_TRUE(ponder::registryGeneration() != observer.seen);
+        
+        ponder::removeObserver(&observer);
+        module.unload();
+    }
+    
+    SECTION("which can be undeclared individually")
+    {
+        ponder::Class::undeclare<ModuleTest::Inner>();
+        REQUIRE(module.classCount() == 1);
+        
+        module.unload();
+        REQUIRE(ponder::classCount() == classes);
+    }
+    
+    SECTION("and nested scopes record into the innermost module")
+    {
+        ponder::Module other("Other");
+        {
+            ponder::Module::Scope outer(module);
+            ponder::Module::Scope inner(other);
+            ponder::Class::undeclare<ModuleTest::Inner>();
+            ponder::Class::declare<ModuleTest::Inner>("ModuleTest::Inner");
+        }
+        REQUIRE(module.classCount() == 1);
+        REQUIRE(other.classCount() == 1);
+        
+        module.unload();
+        REQUIRE(ponder::classCount() == classes + 1);
+        // other is destroyed here, which unloads the rest
+    }
+    
+    SECTION("and cached metaclasses are resolved again when redeclared")
+    {
+        const ponder::UserProperty& prop = static_cast<const ponder::UserProperty&>(
+            ponder::classByType<ModuleTest::Outer>().property("inner"));
+        
+        IS_TRUE(prop.getClass().name() == "ModuleTest::Inner");
+        
+        ponder::Class::undeclare<ModuleTest::Inner>();
+        REQUIRE_THROWS_AS(prop.getClass(), ponder::ClassNotFound);
+        
+        {
+            ponder::Module::Scope scope(module);
+            ponder::Class::declare<ModuleTest::Inner>("ModuleTest::Inner");
+        }
+        IS_TRUE(&prop.getClass() == &ponder::classByType<ModuleTest::Inner>());
+    }
+    
+    // module destructor unloads whatever is left
+}
+
+TEST_CASE("Destroying a module unloads its declarations")
+{
+    const std::size_t classes = ponder::classCount();
+    {
+        ponder::Module module("ModuleTest");
+        ponder::Module::Scope scope(module);
+        ModuleTest::declare();
+        REQUIRE(ponder::classCount() == classes + 2);
+    }
+    REQUIRE(ponder::classCount() == classes);
+}
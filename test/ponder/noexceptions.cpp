@@ -0,0 +1,171 @@
+/****************************************************************************
+**
+** This file is part of the Ponder library, formerly CAMP.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+// Tests of the real no-exceptions mode: this program is built with -fno-exceptions, like
+// Ponder, and installs no error handler, so any error raised aborts it. Catch needs
+// exceptions, failed checks are reported by hand.
+
+#include <ponder/classbuilder.hpp>
+#include <ponder/classget.hpp>
+#include <ponder/uses/ponder_c.h>
+
+#define PONDER_USES_RUNTIME_IMPL
+#include <ponder/uses/runtime.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#define CHECK(expr) \
+    do { \
+        if (!(expr)) { \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #expr); \
+            std::abort(); \
+        } \
+    } while (0)
+
+
+namespace NoExceptionsTest
+{
+    struct Point
+    {
+        int x = 0;
+        std::vector<int> list;
+
+        int getY() const {return y;}
+        void setY(int value) {y = value;}
+        int add(int value) const {return x + value;}
+
+        int y = 0;
+    };
+
+    struct Other {int o = 0;};
+
+    static void declare()
+    {
+        ponder::Class::declare<Point>("NoExceptionsTest::Point")
+            .property("x", &Point::x)
+            .property("y", &Point::getY, &Point::setY)
+            .property("list", &Point::list)
+            .function("add", &Point::add);
+        ponder::Class::declare<Other>("NoExceptionsTest::Other")
+            .property("o", &Other::o);
+    }
+}
+
+PONDER_AUTO_TYPE(NoExceptionsTest::Point, &NoExceptionsTest::declare)
+PONDER_AUTO_TYPE(NoExceptionsTest::Other, &NoExceptionsTest::declare)
+
+using namespace NoExceptionsTest;
+
+namespace
+{
+    void testCApi()
+    {
+        ponder::classByType<Point>(); // declare
+        ponder::classByType<Other>();
+
+        const ponder_class* cls = nullptr;
+        const ponder_class* otherClass = nullptr;
+        CHECK(ponder_class_find("NoExceptionsTest::Unknown", &cls) == PONDER_NOT_FOUND);
+        CHECK(ponder_class_find("NoExceptionsTest::Point", &cls) == PONDER_OK);
+        CHECK(ponder_class_find("NoExceptionsTest::Other", &otherClass) == PONDER_OK);
+
+        const ponder_property* x = nullptr;
+        const ponder_property* y = nullptr;
+        const ponder_property* list = nullptr;
+        CHECK(ponder_class_property(cls, "unknown", &x) == PONDER_NOT_FOUND);
+        CHECK(ponder_class_property(cls, "x", &x) == PONDER_OK);
+        CHECK(ponder_class_property(cls, "y", &y) == PONDER_OK);
+        CHECK(ponder_class_property(cls, "list", &list) == PONDER_OK);
+
+        Point point;
+        Other other;
+        ponder_value value;
+
+        value.type = PONDER_TYPE_STRING;
+        value.u.s.data = "abc";
+        value.u.s.size = 3;
+        CHECK(ponder_property_set(x, cls, &point, &value) == PONDER_BAD_TYPE);
+        CHECK(ponder_property_set(y, cls, &point, &value) == PONDER_BAD_TYPE);
+        CHECK(ponder_property_get(x, otherClass, &other, &value) == PONDER_ERROR);
+        CHECK(ponder_property_get(y, otherClass, &other, &value) == PONDER_ERROR);
+        CHECK(ponder_property_get(list, cls, &point, &value) == PONDER_OUT_OF_RANGE);
+
+        value.type = PONDER_TYPE_INT;
+        value.u.i = 5;
+        CHECK(ponder_property_set(list, cls, &point, &value) == PONDER_OUT_OF_RANGE);
+        CHECK(ponder_property_set(y, cls, &point, &value) == PONDER_OK);
+        CHECK(point.y == 5);
+
+        const ponder_function* add = nullptr;
+        CHECK(ponder_class_function(cls, "unknown", &add) == PONDER_NOT_FOUND);
+        CHECK(ponder_class_function(cls, "add", &add) == PONDER_OK);
+        CHECK(ponder_function_call(add, cls, &point, &value, 0, &value) == PONDER_BAD_ARGUMENT);
+        CHECK(ponder_function_call(add, otherClass, &other, &value, 1, &value)
+              == PONDER_BAD_ARGUMENT);
+        CHECK(ponder_function_call(add, cls, &point, &value, 1, &value) == PONDER_OK);
+        CHECK(value.u.i == 5);
+    }
+
+    void testTryVariants()
+    {
+        int number = 0;
+        CHECK(!ponder::Value("twelve").tryTo(number));
+        CHECK(ponder::Value("12").tryTo(number) && number == 12);
+        CHECK(ponder::classByNameSafe("NoExceptionsTest::Unknown") == nullptr);
+
+        const ponder::Class& cls = ponder::classByType<Point>();
+        const ponder::Property* y = nullptr;
+        CHECK(!cls.tryProperty("unknown", y));
+        CHECK(cls.tryProperty("y", y));
+
+        Point point;
+        Other other;
+        ponder::Value value;
+        CHECK(!y->tryGet(ponder::UserObject(other), value));
+        CHECK(!y->trySet(ponder::UserObject(point), "four"));
+        CHECK(y->trySet(ponder::UserObject(point), 4) && point.y == 4);
+
+        const ponder::Function* add = nullptr;
+        CHECK(cls.tryFunction("add", add));
+        ponder::runtime::ObjectCaller caller(*add);
+        CHECK(!caller.tryCall(ponder::UserObject(point), ponder::Args("two"), value));
+        CHECK(!caller.tryCall(ponder::UserObject(other), ponder::Args(2), value));
+        CHECK(caller.tryCall(ponder::UserObject(point), ponder::Args(2), value));
+        CHECK(value.to<int>() == 2);
+    }
+}
+
+int main()
+{
+    testCApi();
+    testTryVariants();
+    std::printf("no-exceptions tests passed\n");
+    return 0;
+}
@@ -0,0 +1,156 @@
+/****************************************************************************
+**
+** This file is part of the CAMP library.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+#include <ponder/classget.hpp>
+#include <ponder/classbuilder.hpp>
+#include <ponder/perfmap.hpp>
+#include <ponder/uses/runtime.hpp>
+#include "test.hpp"
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
+
+namespace PerfMapTest
+{
+    struct Item
+    {
+        Item(int v = 0) : value(v) {}
+        
+        int getValue() const {return value;}
+        void setValue(int v) {value = v;}
+        int add(int x) {return value += x;}
+        
+        int value;
+        std::vector<int> list;
+    };
+    
+    static void declare()
+    {
+        ponder::Class::declare<Item>("PerfMapTest::Item")
+            .constructor<int>()
+            .property("value", &Item::getValue, &Item::setValue)
+            .property("list", &Item::list)
+            .function("add", &Item::add);
+    }
+    
+    static const ponder::perfmap::Symbol* findName(const ponder::perfmap::SymbolTable& table,
+                                                   const std::string& name)
+    {
+        for (auto& symbol : table.symbols())
+        {
+            if (symbol.name.find(name) != std::string::npos)
+                return &symbol;
+        }
+        return nullptr;
+    }
+}
+
+PONDER_AUTO_TYPE(PerfMapTest::Item, &PerfMapTest::declare)
+
+using namespace PerfMapTest;
+
+//-----------------------------------------------------------------------------
+//                         Tests for ponder::perfmap
+//-----------------------------------------------------------------------------
+
+TEST_CASE("Code of reflected members can be symbolized")
+{
+    ponder::classByType<Item>(); // declare
+    
+    const ponder::perfmap::SymbolTable table;
+    const std::vector<ponder::perfmap::Symbol>& symbols = table.symbols();
+    
+#if defined(__GNUC__) && !defined(_WIN32)
+    SECTION("members are labeled")
+    {
+        REQUIRE(findName(table, "PerfMapTest::Item::value (get)") != nullptr);
+        REQUIRE(findName(table, "PerfMapTest::Item::value (set)") != nullptr);
+        REQUIRE(findName(table, "PerfMapTest::Item::list (get element)") != nullptr);
+        REQUIRE(findName(table, "PerfMapTest::Item::add (call)") != nullptr);
+        REQUIRE(findName(table, "PerfMapTest::Item (construct)") != nullptr);
+    }
+    
+    SECTION("symbols are sorted and don't overlap")
+    {
+        REQUIRE(!symbols.empty());
+        for (std::size_t i = 1; i < symbols.size(); ++i)
+        {
+            const char* previous = static_cast<const char*>(symbols[i - 1].address);
+            REQUIRE(previous + symbols[i - 1].size <= symbols[i].address);
+        }
+    }
+    
+    SECTION("addresses are found in their symbol")
+    {
+        const ponder::perfmap::Symbol* symbol = findName(table, "PerfMapTest::Item::add (call)");
+#if defined(__linux__) && defined(__GLIBC__)
+        // Sizes come from the symbol table (the test executable exports its symbols)
+        REQUIRE(symbol->size > 0);
+#endif
+        if (symbol->size == 0)
+            return;
+        REQUIRE(table.find(symbol->address) == symbol);
+        
+        const char* inside = static_cast<const char*>(symbol->address) + symbol->size - 1;
+        REQUIRE(table.find(inside) == symbol);
+        
+        REQUIRE(table.find(nullptr) == nullptr);
+    }
+#endif
+    
+    SECTION("symbols are written in the perf map format")
+    {
+        std::ostringstream stream;
+        table.write(stream);
+        
+        const std::string map = stream.str();
+        const std::size_t known = static_cast<std::size_t>(std::count_if(symbols.begin(),
+            symbols.end(), [](const ponder::perfmap::Symbol& symbol) {return symbol.size > 0;}));
+        REQUIRE(static_cast<std::size_t>(std::count(map.begin(), map.end(), '\n')) == known);
+        
+        for (auto& symbol : symbols)
+        {
+            if (symbol.size == 0)
+                continue;
+
+            std::ostringstream line;
+            line << std::hex << reinterpret_cast<std::uintptr_t>(symbol.address) << ' '
+                 << symbol.size << ' ' << symbol.name << '\n';
+            REQUIRE(map.find(line.str()) != std::string::npos);
+        }
+    }
+    
+    SECTION("the default file is named after the process")
+    {
+        const std::string path = ponder::perfmap::defaultPath();
+        REQUIRE(path.find("/tmp/perf-") == 0);
+        REQUIRE(path.substr(path.size() - 4) == ".map");
+    }
+}
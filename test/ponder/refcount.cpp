@@ -0,0 +1,105 @@
+/****************************************************************************
+**
+** This file is part of the CAMP library.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+#include <ponder/detail/refcount.hpp>
+#include "test.hpp"
+
+
+namespace RefCountTest
+{
+    struct Counted : ponder::detail::RefCounted
+    {
+        static int instances;
+        Counted() {++instances;}
+        Counted(const Counted& other) : RefCounted(other) {++instances;}
+        virtual ~Counted() {--instances;}
+    };
+    
+    struct Derived : Counted
+    {
+        int value = 5;
+    };
+    
+    int Counted::instances = 0;
+}
+
+//-----------------------------------------------------------------------------
+//                         Tests for ponder::detail::RefPtr
+//-----------------------------------------------------------------------------
+
+TEST_CASE("RefPtr shares ownership of intrusively counted objects")
+{
+    using namespace RefCountTest;
+    typedef ponder::detail::RefPtr<Counted> Ptr;
+    
+    SECTION("the object is deleted with the last pointer")
+    {
+        {
+            Ptr a(new Counted);
+            REQUIRE(Counted::instances == 1);
+            {
+                Ptr b(a);
+                Ptr c;
+                c = b;
+                IS_TRUE(c == a);
+                REQUIRE(Counted::instances == 1);
+            }
+            REQUIRE(Counted::instances == 1);
+        }
+        REQUIRE(Counted::instances == 0);
+    }
+    
+    SECTION("pointers can be moved, reset and converted")
+    {
+        ponder::detail::RefPtr<Derived> derived(new Derived);
+        Ptr base(derived);
+        IS_TRUE(base.get() == derived.get());
+        
+        Ptr moved(std::move(base));
+        IS_FALSE(base);
+        IS_TRUE(moved);
+        
+        derived.reset();
+        REQUIRE(Counted::instances == 1);
+        REQUIRE(static_cast<Derived&>(*moved).value == 5);
+        
+        moved.reset(new Counted);
+        REQUIRE(Counted::instances == 1);
+        moved.reset();
+        REQUIRE(Counted::instances == 0);
+    }
+    
+    SECTION("copying an object doesn't copy its count")
+    {
+        Ptr a(new Counted);
+        Counted copy(*a);
+        a.reset();
+        REQUIRE(Counted::instances == 1); // only the copy, which is not owned
+    }
+}
@@ -0,0 +1,210 @@
+/****************************************************************************
+**
+** This file is part of the CAMP library.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+#include <ponder/classget.hpp>
+#include <ponder/classbuilder.hpp>
+#include <ponder/seqlock.hpp>
+#include "test.hpp"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+
+namespace SeqLockTest
+{
+    struct Body
+    {
+        int x = 0;
+        int y = 0;
+        
+        int getX() const {return x;}
+        void setBoth(int v) {x = v; y = -v;}
+        
+        ponder::String name;
+    };
+    
+    struct Satellite : Body
+    {
+        int orbit = 0;
+    };
+    
+    struct Plain
+    {
+        int x = 0;
+        int y = 0;
+    };
+    
+    static void declare()
+    {
+        ponder::Class::declare<Body>("SeqLockTest::Body")
+            .concurrency(ponder::Concurrency::SeqLock)
+            .property("x", &Body::x)
+            .property("y", &Body::y)
+            .property("both", &Body::getX, &Body::setBoth)
+            .property("name", &Body::name);
+        
+        ponder::Class::declare<Satellite>("SeqLockTest::Satellite")
+            .base<Body>()
+            .property("orbit", &Satellite::orbit);
+        
+        ponder::Class::declare<Plain>("SeqLockTest::Plain")
+            .property("x", &Plain::x)
+            .property("y", &Plain::y);
+    }
+    
+    // Read the object while another thread writes it, return the number of torn reads
+    template <typename W>
+    int tornReads(const ponder::UserObject& object, W write)
+    {
+        std::atomic<bool> stop(false);
+        std::thread writer([&] {
+            for (int i = 1; !stop.load(); ++i)
+                write(i);
+        });
+        
+        int torn = 0;
+        for (int i = 0; i < 20000; ++i)
+        {
+            const std::array<ponder::Value, 2> v = ponder::readConsistent(object, "x", "y");
+            if (v[0].to<int>() != -v[1].to<int>())
+                ++torn;
+        }
+        
+        stop = true;
+        writer.join();
+        return torn;
+    }
+}
+
+PONDER_AUTO_TYPE(SeqLockTest::Body, &SeqLockTest::declare)
+PONDER_AUTO_TYPE(SeqLockTest::Satellite, &SeqLockTest::declare)
+PONDER_AUTO_TYPE(SeqLockTest::Plain, &SeqLockTest::declare)
+
+using namespace SeqLockTest;
+
+//-----------------------------------------------------------------------------
+//                         Tests for ponder::readConsistent
+//-----------------------------------------------------------------------------
+
+TEST_CASE("Classes can sequence the writes to their instances")
+{
+    SECTION("the policy is declared and inherited")
+    {
+        IS_TRUE(ponder::classByType<Body>().concurrency() == ponder::Concurrency::SeqLock);
+        IS_TRUE(ponder::classByType<Satellite>().concurrency() == ponder::Concurrency::SeqLock);
+        IS_TRUE(ponder::classByType<Plain>().concurrency() == ponder::Concurrency::None);
+    }
+    
+    SECTION("properties can be read by name or reference")
+    {
+        Satellite satellite;
+        satellite.setBoth(4);
+        satellite.orbit = 2;
+        
+        const ponder::UserObject object(&satellite);
+        const ponder::Property& orbit = ponder::classByType<Satellite>().property("orbit");
+        const std::array<ponder::Value, 3> v = ponder::readConsistent(object, "x", orbit, "y");
+        REQUIRE(v[0] == ponder::Value(4));
+        REQUIRE(v[1] == ponder::Value(2));
+        REQUIRE(v[2] == ponder::Value(-4));
+        
+        REQUIRE_THROWS_AS(ponder::readConsistent(object, "mass"), ponder::PropertyNotFound);
+    }
+    
+    SECTION("only booleans, numbers and enums can be read")
+    {
+        Body body;
+        const ponder::UserObject object(&body);
+        
+        REQUIRE_THROWS_AS(ponder::readConsistent(object, "x", "name"), ponder::ForbiddenRead);
+    }
+    
+    SECTION("classes without the policy are read once")
+    {
+        Plain plain;
+        plain.x = 3;
+        
+        const std::array<ponder::Value, 2> v =
+            ponder::readConsistent(ponder::UserObject(&plain), "x", "y");
+        REQUIRE(v[0] == ponder::Value(3));
+        REQUIRE(v[1] == ponder::Value(0));
+    }
+    
+    SECTION("a write through a property is never seen partially")
+    {
+        Body body;
+        const ponder::UserObject object(&body);
+        const ponder::Property& both = ponder::classByType<Body>().property("both");
+        
+        REQUIRE(tornReads(object, [&](int i) {both.set(object, i);}) == 0);
+    }
+    
+    SECTION("grouped writes are never seen partially")
+    {
+        Satellite satellite;
+        const ponder::UserObject object(&satellite);
+        const ponder::UserObject asBody(static_cast<Body*>(&satellite));
+        
+        REQUIRE(tornReads(object, [&](int i) {
+            ponder::SequencedWrite write(asBody);
+            asBody.set("x", i);
+            asBody.set("y", -i);
+        }) == 0);
+    }
+    
+    SECTION("writers of different objects never wait for each other")
+    {
+        // Nested writes in opposite orders, whichever counters the objects map to
+        std::vector<Body> bodies(64);
+        std::atomic<bool> stop(false);
+        std::thread writer([&] {
+            while (!stop.load())
+                for (std::size_t i = 0; i + 1 < bodies.size(); ++i)
+                {
+                    ponder::SequencedWrite first{ponder::UserObject(&bodies[i + 1])};
+                    ponder::SequencedWrite second{ponder::UserObject(&bodies[i])};
+                }
+        });
+        
+        for (int n = 0; n < 200; ++n)
+            for (std::size_t i = 0; i + 1 < bodies.size(); ++i)
+            {
+                ponder::SequencedWrite first{ponder::UserObject(&bodies[i])};
+                ponder::SequencedWrite second{ponder::UserObject(&bodies[i + 1])};
+            }
+        
+        stop = true;
+        writer.join();
+        
+        // Reads from inside a write are not blocked by the writer itself
+        ponder::SequencedWrite write{ponder::UserObject(&bodies[0])};
+        bodies[0].setBoth(5);
+        REQUIRE(ponder::readConsistent(ponder::UserObject(&bodies[0]), "x")[0] == ponder::Value(5));
+    }
+}
@@ -0,0 +1,128 @@
+/****************************************************************************
+**
+** This file is part of the CAMP library.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+#include <ponder/staticclass.hpp>
+#include <ponder/classget.hpp>
+#include <ponder/classbuilder.hpp>
+#include "test.hpp"
+#include <string>
+
+
+namespace StaticClassTest
+{
+    struct Point
+    {
+        int x;
+        float y;
+        std::string label;
+    };
+    
+    struct Collector
+    {
+        std::string names;
+        double sum;
+        
+        void operator()(const char* name, int value) {names += name; sum += value;}
+        void operator()(const char* name, float value) {names += name; sum += value;}
+        void operator()(const char* name, const std::string& value) {names += name; names += value;}
+    };
+    
+    struct Scaler
+    {
+        template <typename T>
+        void operator()(const char*, T& value) {value = value * 2;}
+        void operator()(const char*, std::string& value) {value += value;}
+    };
+    
+    static void declare()
+    {
+        ponder::Class::declare<Point>("StaticClassTest::Point")
+            .staticProperties();
+    }
+}
+
+PONDER_STATIC_CLASS(StaticClassTest::Point,
+                    ponder::field("x", &StaticClassTest::Point::x),
+                    ponder::field("y", &StaticClassTest::Point::y),
+                    ponder::field("label", &StaticClassTest::Point::label))
+
+PONDER_AUTO_TYPE(StaticClassTest::Point, &StaticClassTest::declare)
+
+//-----------------------------------------------------------------------------
+//                         Tests for ponder::StaticClass
+//-----------------------------------------------------------------------------
+
+TEST_CASE("Classes can have a static description")
+{
+    using StaticClassTest::Point;
+    
+    static_assert(ponder::StaticClass<Point>::count == 3, "Wrong field count");
+    
+    SECTION("fields are described at compile time")
+    {
+        auto fields = ponder::staticClass<Point>();
+        REQUIRE(std::string(std::get<0>(fields).name) == "x");
+        REQUIRE(std::string(std::get<2>(fields).name) == "label");
+        IS_TRUE(std::get<1>(fields).member == &Point::y);
+        
+        static_assert(std::is_same<std::tuple_element<1, decltype(fields)>::type::Type, float>::value,
+                      "Field type is kept");
+    }
+    
+    SECTION("properties can be iterated on const objects")
+    {
+        const Point p = {3, 1.5f, "abc"};
+        StaticClassTest::Collector collector = {"", 0.0};
+        ponder::forEachProperty(p, collector);
+        REQUIRE(collector.names == "xylabelabc");
+        REQUIRE(collector.sum == 4.5);
+    }
+    
+    SECTION("properties can be modified")
+    {
+        Point p = {3, 1.5f, "ab"};
+        ponder::forEachProperty(p, StaticClassTest::Scaler());
+        REQUIRE(p.x == 6);
+        REQUIRE(p.y == 3.0f);
+        REQUIRE(p.label == "abab");
+    }
+    
+    SECTION("the runtime metaclass shares the declaration")
+    {
+        const ponder::Class& metaclass = ponder::classByType<Point>();
+        REQUIRE(metaclass.propertyCount() == 3);
+        
+        Point p = {7, 2.5f, "xyz"};
+        REQUIRE(metaclass.property("x").get(p).to<int>() == 7);
+        REQUIRE(metaclass.property("y").get(p).to<float>() == 2.5f);
+        
+        metaclass.property("label").set(p, std::string("uvw"));
+        REQUIRE(p.label == "uvw");
+    }
+}
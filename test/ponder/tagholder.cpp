@@ -31,6 +31,7 @@
 #include <ponder/class.hpp>
 #include <ponder/classbuilder.hpp>
 #include "test.hpp"
+#include <algorithm>
 #include <string>
 
 namespace TagHolderTest
@@ -54,6 +55,11 @@ namespace TagHolderTest
         Ten = 10
     };
     
+    struct Record
+    {
+        int id, secret, cache, name;
+    };
+    
     MyType object1(1);
     MyType object2(2);
     
@@ -86,12 +92,22 @@ namespace TagHolderTest
             .function("func", &MyClass::func)
             .tag("a")
             .tag("b", 0);
+        
+        ponder::Class::declare<Record>("TagHolderTest::Record")
+            .property("id", &Record::id)
+            .property("secret", &Record::secret)
+                .tag("transient")
+                .tag(10)
+            .property("cache", &Record::cache)
+                .tag("transient")
+            .property("name", &Record::name);
     }
 }
 
 PONDER_AUTO_TYPE(TagHolderTest::MyClass, &TagHolderTest::declare)
 PONDER_AUTO_TYPE(TagHolderTest::MyType,  &TagHolderTest::declare)
 PONDER_AUTO_TYPE(TagHolderTest::MyEnum,  &TagHolderTest::declare)
+PONDER_AUTO_TYPE(TagHolderTest::Record,  &TagHolderTest::declare)
 
 using namespace TagHolderTest;
 
@@ -150,3 +166,56 @@ TEST_CASE("Objects can be assigned tags")
 }
 
 
+
+TEST_CASE("Metaclasses index the properties carrying a tag")
+{
+    const ponder::Class& metaclass = ponder::classByType<Record>();
+    
+    SECTION("values used as tags can be hashed")
+    {
+        std::hash<ponder::Value> hash;
+        REQUIRE(hash(ponder::Value("transient")) == hash(ponder::Value(ponder::String("transient"))));
+        REQUIRE(hash(ponder::Value(10)) == hash(ponder::Value(10L)));
+        REQUIRE(hash(ponder::Value(object1)) == hash(ponder::Value(object1)));
+        REQUIRE(hash(ponder::Value::nothing) == hash(ponder::Value()));
+    }
+    
+    SECTION("as a bitset")
+    {
+        const std::vector<bool>& transient = *metaclass.propertiesWithTag("transient");
+        REQUIRE(transient.size() == metaclass.propertyCount());
+        for (std::size_t i = 0; i < metaclass.propertyCount(); ++i)
+        {
+            const ponder::Property& property = metaclass.property(i);
+            REQUIRE(transient[i] == (property.name() == "secret" || property.name() == "cache"));
+        }
+        
+        const std::vector<bool>& ten = *metaclass.propertiesWithTag(10);
+        REQUIRE(std::count(ten.begin(), ten.end(), true) == 1);
+        
+        const std::vector<bool>& none = *metaclass.propertiesWithTag("unknown");
+        REQUIRE(none.size() == metaclass.propertyCount());
+        REQUIRE(std::count(none.begin(), none.end(), true) == 0);
+    }
+    
+    SECTION("updated when properties are tagged")
+    {
+        const std::shared_ptr<const std::vector<bool>> before = metaclass.propertiesWithTag("key");
+        REQUIRE(std::count(before->begin(), before->end(), true) == 0);
+        
+        const ponder::Class& other = ponder::classByType<TagHolderTest::MyClass>();
+        const std::shared_ptr<const std::vector<bool>> untouched = other.propertiesWithTag("key");
+        
+        ponder::ClassBuilder<Record>(const_cast<ponder::Class&>(metaclass))
+            .property("key", &Record::id)
+                .tag("key");
+        
+        const std::vector<bool>& key = *metaclass.propertiesWithTag("key");
+        REQUIRE(key.size() == 5);
+        REQUIRE(std::count(key.begin(), key.end(), true) == 1);
+        
+        // Snapshots already taken are not modified, other metaclasses are not reindexed
+        REQUIRE(before->size() == 4);
+        REQUIRE(other.propertiesWithTag("key") == untouched);
+    }
+}
@@ -0,0 +1,152 @@
+/****************************************************************************
+**
+** This file is part of the CAMP library.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+#include <ponder/classget.hpp>
+#include <ponder/classbuilder.hpp>
+#include <ponder/trace.hpp>
+#include <ponder/uses/runtime.hpp>
+#include "test.hpp"
+#include <sstream>
+#include <thread>
+
+
+namespace TraceTest
+{
+    struct Counter
+    {
+        Counter(int start = 0) : value(start) {}
+        
+        int value;
+        
+        int add(int x) {value += x; return value;}
+    };
+    
+    static int twice(int x) {return x * 2;}
+    
+    static void declare()
+    {
+        ponder::Class::declare<Counter>("TraceTest::Counter")
+            .constructor<int>()
+            .function("add", &Counter::add)
+            .function("\"twice\"", &twice);
+    }
+    
+    static std::string written()
+    {
+        std::ostringstream stream;
+        ponder::trace::write(stream);
+        return stream.str();
+    }
+    
+    static bool contains(const std::string& text, const std::string& part)
+    {
+        return text.find(part) != std::string::npos;
+    }
+}
+
+PONDER_AUTO_TYPE(TraceTest::Counter, &TraceTest::declare)
+
+using namespace TraceTest;
+
+//-----------------------------------------------------------------------------
+//                         Tests for ponder::trace
+//-----------------------------------------------------------------------------
+
+TEST_CASE("Reflected calls can be traced")
+{
+    const ponder::Class& metaclass = ponder::classByType<Counter>();
+    const ponder::Function& add = metaclass.function("add");
+    const ponder::Function& twice = metaclass.function("\"twice\"");
+    
+    ponder::trace::clear();
+    
+    SECTION("nothing is recorded while tracing is stopped")
+    {
+        ponder::UserObject object = ponder::runtime::create(metaclass, 1);
+        ponder::runtime::call(add, object, 2);
+        ponder::runtime::destroy(object);
+        
+        REQUIRE(ponder::trace::active() == false);
+        REQUIRE(ponder::trace::eventCount() == 0);
+        REQUIRE(written() == "{\"traceEvents\":[\n],\"displayTimeUnit\":\"ns\"}\n");
+    }
+    
+    SECTION("calls and constructions are written as complete events")
+    {
+        ponder::trace::start();
+        REQUIRE(ponder::trace::active());
+        
+        ponder::UserObject object = ponder::runtime::create(metaclass, 1);
+        ponder::runtime::call(add, object, 2);
+        ponder::runtime::callStatic(twice, 3);
+        
+        ponder::trace::stop();
+        ponder::runtime::call(add, object, 2); // not recorded
+        ponder::runtime::destroy(object);
+        
+        REQUIRE(ponder::trace::eventCount() == 3);
+        
+        const std::string json = written();
+        REQUIRE(contains(json, "{\"name\":\"TraceTest::Counter\",\"cat\":\"construct\",\"ph\":\"X\""));
+        REQUIRE(contains(json, "{\"name\":\"TraceTest::Counter::add\",\"cat\":\"call\",\"ph\":\"X\""));
+        
+        // Quotes in names are escaped
+        REQUIRE(contains(json, "{\"name\":\"\\\"twice\\\"\",\"cat\":\"call\",\"ph\":\"X\""));
+        REQUIRE(contains(json, "\"pid\":1,\"tid\":"));
+        
+        ponder::trace::clear();
+        REQUIRE(ponder::trace::eventCount() == 0);
+    }
+    
+    SECTION("events of other threads are kept after they exit")
+    {
+        const int eventsPerThread = 5000; // more than a buffer chunk
+        
+        ponder::trace::start();
+        std::thread threads[2];
+        for (auto& thread : threads)
+        {
+            thread = std::thread([&twice] {
+                for (int i = 0; i < eventsPerThread; ++i)
+                    ponder::runtime::callStatic(twice, i);
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+        ponder::trace::stop();
+        
+        REQUIRE(ponder::trace::eventCount() == 2 * eventsPerThread);
+        
+        const std::string json = written();
+        REQUIRE(contains(json, "\"tid\":"));
+        REQUIRE(json.find("\"tid\":") != json.rfind("\"tid\":"));
+        
+        ponder::trace::clear();
+    }
+}
@@ -714,6 +714,13 @@ TEST_CASE("Types supporting array interface are supported")
 
 TEST_CASE("Lexical cast is used")
 {
+#if PONDER_NO_EXCEPTIONS
+    // Without exceptions, failed conversions raise BadType through the error handler
+    typedef ponder::BadType ConversionError;
+#else
+    typedef ponder::detail::bad_conversion ConversionError;
+#endif
+
     SECTION("lexical_cast_to_string")
     {
         const unsigned int ui = 234;
@@ -753,16 +760,16 @@ TEST_CASE("Lexical cast is used")
         REQUIRE(ponder::detail::convert<char>(ponder::String("0")) == '0');
         REQUIRE(ponder::detail::convert<char>(ponder::String("g")) == 'g');
         REQUIRE_THROWS_AS(ponder::detail::convert<char>(ponder::String()),
-                          ponder::detail::bad_conversion);
+                          ConversionError);
         REQUIRE_THROWS_AS(ponder::detail::convert<char>(ponder::String("27")),
-                          ponder::detail::bad_conversion);
+                          ConversionError);
     
         REQUIRE(ponder::detail::convert<unsigned char>(ponder::String("0")) == '0');
         REQUIRE(ponder::detail::convert<unsigned char>(ponder::String("g")) == 'g');
         REQUIRE_THROWS_AS(ponder::detail::convert<unsigned char>(ponder::String()),
-                          ponder::detail::bad_conversion);
+                          ConversionError);
         REQUIRE_THROWS_AS(ponder::detail::convert<unsigned char>(ponder::String("27")),
-                          ponder::detail::bad_conversion);
+                          ConversionError);
     }
 
     SECTION("lexical_cast_to_short")
@@ -789,7 +796,7 @@ TEST_CASE("Lexical cast is used")
                 == static_cast<unsigned int>(-27));
     
         REQUIRE_THROWS_AS(ponder::detail::convert<int>(ponder::String("bad number")),
-                          ponder::detail::bad_conversion);
+                          ConversionError);
     }
 
     SECTION("lexical_cast_to_long")
@@ -0,0 +1,248 @@
+/****************************************************************************
+**
+** This file is part of the CAMP library.
+**
+** The MIT License (MIT)
+**
+** Copyright (C) 2009-2014 TEGESO/TEGESOFT and/or its subsidiary(-ies) and mother company.
+** Copyright (C) 2015-2017 Nick Trout.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+** 
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+** 
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+** THE SOFTWARE.
+**
+****************************************************************************/
+
+#include <ponder/classget.hpp>
+#include <ponder/classbuilder.hpp>
+#include <ponder/validation.hpp>
+#include "test.hpp"
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+
+namespace ValidationTest
+{
+    struct Record
+    {
+        int age = 30;
+        double score = 0.5;
+        unsigned char level = 1;
+        std::string name = "ada";
+        std::string code = "ABC1";
+        std::vector<int> items = {1};
+        int free = -1000;
+        
+        int getTotal() const {return age * 2;}
+    };
+    
+    struct Padding
+    {
+        double padding = 0;
+    };
+    
+    struct Employee : Padding, Record
+    {
+        int badge = 0;
+    };
+    
+    struct Unrelated
+    {
+        int x = 0;
+    };
+    
+    struct Limits
+    {
+        long long low = 0;
+        long long high = 0;
+        std::string code = "A";
+    };
+    
+    static void declare()
+    {
+        ponder::Class::declare<Record>("ValidationTest::Record")
+            .property("age", &Record::age).tag("min", 0).tag("max", 150)
+            .property("score", &Record::score).tag("min", 0.0).tag("max", 1.0)
+            .property("level", &Record::level).tag("min", -5).tag("max", 9.5)
+            .property("name", &Record::name).tag("nonEmpty")
+            .property("code", &Record::code).tag("regex", "[A-Z]{3}[0-9]+")
+            .property("items", &Record::items).tag("nonEmpty")
+            .property("free", &Record::free).tag("regex", "ignored")
+            .property("total", &Record::getTotal).tag("max", 200);
+        
+        ponder::Class::declare<Padding>("ValidationTest::Padding");
+        
+        ponder::Class::declare<Employee>("ValidationTest::Employee")
+            .base<Padding>()
+            .base<Record>()
+            .property("badge", &Employee::badge);
+        
+        ponder::Class::declare<Unrelated>("ValidationTest::Unrelated")
+            .property("x", &Unrelated::x);
+        
+        // max() of long long rounds up to 2^63 as a double
+        const double beyond = static_cast<double>(std::numeric_limits<long long>::max());
+        ponder::Class::declare<Limits>("ValidationTest::Limits")
+            .property("low", &Limits::low).tag("min", beyond)
+            .property("high", &Limits::high).tag("max", beyond)
+            .property("code", &Limits::code).tag("regex", "[A-Z");
+    }
+}
+
+PONDER_AUTO_TYPE(ValidationTest::Record, &ValidationTest::declare)
+PONDER_AUTO_TYPE(ValidationTest::Padding, &ValidationTest::declare)
+PONDER_AUTO_TYPE(ValidationTest::Employee, &ValidationTest::declare)
+PONDER_AUTO_TYPE(ValidationTest::Unrelated, &ValidationTest::declare)
+PONDER_AUTO_TYPE(ValidationTest::Limits, &ValidationTest::declare)
+
+using namespace ValidationTest;
+
+// Regex constraints are ignored without exceptions
+static const std::size_t regexRule = PONDER_NO_EXCEPTIONS ? 0 : 1;
+
+//-----------------------------------------------------------------------------
+//                         Tests for ponder::Validator
+//-----------------------------------------------------------------------------
+
+TEST_CASE("Constraints declared as tags are validated")
+{
+    const ponder::Validator validator(ponder::classByType<Record>());
+    const ponder::Class& metaclass = ponder::classByType<Record>();
+    std::vector<ponder::Violation> violations;
+    
+    SECTION("only the constraints which apply are compiled")
+    {
+        REQUIRE(&validator.getClass() == &metaclass);
+        REQUIRE(validator.ruleCount() == 6 + regexRule);
+        REQUIRE(std::string(ponder::constraintTag(ponder::Constraint::NonEmpty)) == "nonEmpty");
+        
+        const ponder::Validator none(ponder::classByType<Unrelated>());
+        REQUIRE(none.ruleCount() == 0);
+    }
+    
+    SECTION("a valid object has no violation")
+    {
+        Record record;
+        REQUIRE(validator.validate(ponder::UserObject::makeRef(record), violations));
+        REQUIRE(violations.empty());
+    }
+    
+    SECTION("each broken constraint is reported")
+    {
+        Record record;
+        record.age = 160;
+        record.name.clear();
+        record.code = "AB12";
+        record.items.clear();
+        
+        REQUIRE_FALSE(validator.validate(ponder::UserObject::makeRef(record), violations));
+        REQUIRE(violations.size() == 4 + regexRule);
+        
+        auto broken = [&](const char* property, ponder::Constraint constraint) {
+            for (const ponder::Violation& v : violations)
+                if (v.property->name() == property && v.constraint == constraint && v.index == 0)
+                    return true;
+            return false;
+        };
+        IS_TRUE(broken("age", ponder::Constraint::Max));
+        IS_TRUE(broken("name", ponder::Constraint::NonEmpty));
+        IS_TRUE(broken("code", ponder::Constraint::Regex) == (regexRule == 1));
+        IS_TRUE(broken("items", ponder::Constraint::NonEmpty));
+        IS_TRUE(broken("total", ponder::Constraint::Max));
+    }
+    
+    SECTION("ranges are checked over spans of objects")
+    {
+        std::vector<Record> records(200);
+        records[3].age = -1;
+        records[70].score = 1.5;
+        records[70].level = 10;
+        records[199].score = std::nan("");
+        
+        REQUIRE_FALSE(validator.validate(records.data(), records.size(), violations));
+        REQUIRE(violations.size() == 4);
+        
+        // Reported in the order of the objects
+        REQUIRE(violations[0].index == 3);
+        REQUIRE(violations[0].property->name() == "age");
+        IS_TRUE(violations[0].constraint == ponder::Constraint::Min);
+        REQUIRE(violations[1].index == 70);
+        REQUIRE(violations[2].index == 70);
+        REQUIRE(violations[3].index == 199);
+        REQUIRE(violations[3].property->name() == "score");
+        IS_TRUE(violations[3].constraint == ponder::Constraint::Min);
+    }
+    
+    SECTION("violations are appended")
+    {
+        std::vector<Record> records(2);
+        records[1].name.clear();
+        
+        violations.push_back({42, nullptr, ponder::Constraint::Max});
+        REQUIRE_FALSE(validator.validate(records.data(), records.size(), violations));
+        REQUIRE(violations.size() == 2);
+        REQUIRE(violations[1].index == 1);
+        
+        REQUIRE(validator.validate(records.data(), 1, violations));
+        REQUIRE(validator.validate(records.data(), 0, violations));
+        REQUIRE(violations.size() == 2);
+    }
+    
+    SECTION("derived objects are validated through their base")
+    {
+        std::vector<Employee> employees(3);
+        employees[2].age = -1;
+        employees[0].code = "";
+        
+        REQUIRE_FALSE(validator.validate(employees.data(), employees.size(), violations));
+        REQUIRE(violations.size() == 1 + regexRule);
+        if (regexRule)
+        {
+            REQUIRE(violations[0].index == 0);
+            IS_TRUE(violations[0].constraint == ponder::Constraint::Regex);
+        }
+        REQUIRE(violations.back().index == 2);
+        IS_TRUE(violations.back().constraint == ponder::Constraint::Min);
+        
+        violations.clear();
+        employees[2].age = 151;
+        REQUIRE_FALSE(validator.validate(ponder::UserObject::makeRef(employees[2]), violations));
+        REQUIRE(violations.size() == 2); // age and total
+    }
+    
+    SECTION("objects of unrelated classes are rejected")
+    {
+        Unrelated unrelated;
+        REQUIRE_THROWS_AS(validator.validate(&unrelated, 1, violations), ponder::ClassUnrelated);
+    }
+    
+    SECTION("bounds beyond the type of a field and malformed patterns are handled")
+    {
+        const ponder::Validator limits(ponder::classByType<Limits>());
+        REQUIRE(limits.ruleCount() == 2 + regexRule);
+        
+        Limits objects[2];
+        objects[1].high = std::numeric_limits<long long>::max();
+        REQUIRE_FALSE(limits.validate(objects, 2, violations));
+        REQUIRE(violations.size() == 2 * (1 + regexRule)); // low and code, for each object
+        for (const ponder::Violation& v : violations)
+            IS_TRUE(v.constraint == (v.property->name() == "low" ? ponder::Constraint::Min
+                                                                   : ponder::Constraint::Regex));
+    }
+}
@@ -0,0 +1,56 @@
+###############################################################################
+##
+## This file is part of the Ponder library.
+##
+## The MIT License (MIT)
+##
+## Copyright (C) 2015-2017 Nick Trout.
+##
+## Permission is hereby granted, free of charge, to any person obtaining a copy
+## of this software and associated documentation files (the "Software"), to deal
+## in the Software without restriction, including without limitation the rights
+## to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+## copies of the Software, and to permit persons to whom the Software is
+## furnished to do so, subject to the following conditions:
+##
+## The above copyright notice and this permission notice shall be included in
+## all copies or substantial portions of the Software.
+##
+## THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+## IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+## FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+## AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+## LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+## OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+## THE SOFTWARE.
+##
+###############################################################################
+
+
+# Script run by the size_report target: print the code size per registered member.
+# Uses the text + data sizes reported by the "size" tool when available, otherwise the
+# object file sizes (which include symbols and debug information).
+
+function(object_size object result)
+    if(SIZE_TOOL)
+        execute_process(COMMAND ${SIZE_TOOL} ${object} OUTPUT_VARIABLE out)
+        string(REGEX MATCH "\n[ \t]*([0-9]+)[ \t]+([0-9]+)" line "${out}")
+        math(EXPR bytes "${CMAKE_MATCH_1} + ${CMAKE_MATCH_2}")
+    else()
+        file(SIZE ${object} bytes)
+    endif()
+    set(${result} ${bytes} PARENT_SCOPE)
+endfunction()
+
+object_size(${BASE} baseSize)
+object_size(${FIELDS} fieldsSize)
+object_size(${FUNCTIONS} functionsSize)
+
+math(EXPR count "${CLASSES} * ${MEMBERS}")
+math(EXPR perField "(${fieldsSize} - ${baseSize}) / ${count}")
+math(EXPR perFunction "(${functionsSize} - ${baseSize}) / ${count}")
+
+message("Ponder registration size (${CLASSES} classes x ${MEMBERS} members):")
+message("  base:      ${baseSize} bytes")
+message("  fields:    ${fieldsSize} bytes, ${perField} bytes per property")
+message("  functions: ${functionsSize} bytes, ${perFunction} bytes per function")
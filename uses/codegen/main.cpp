@@ -0,0 +1,117 @@
+/****************************************************************************
+ **
+ ** This file is part of the Ponder library.
+ **
+ ** The MIT License (MIT)
+ **
+ ** Copyright (C) 2017 Nick Trout.
+ **
+ ** Permission is hereby granted, free of charge, to any person obtaining a copy
+ ** of this software and associated documentation files (the "Software"), to deal
+ ** in the Software without restriction, including without limitation the rights
+ ** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ ** copies of the Software, and to permit persons to whom the Software is
+ ** furnished to do so, subject to the following conditions:
+ **
+ ** The above copyright notice and this permission notice shall be included in
+ ** all copies or substantial portions of the Software.
+ **
+ ** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ ** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ ** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ ** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ ** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ ** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ ** THE SOFTWARE.
+ **
+ ****************************************************************************/
+
+// ponder-codegen: load a library which declares metaclasses, call its registration
+// function, then write C++ code generated from the declared metaclasses.
+//
+//   ponder-codegen <library> <registration function> [output file]
+//
+// The registration function must have C linkage and the signature void(). Ponder must be
+// built as a shared library, so that the tool and the loaded library share the registry.
+
+#include <ponder/uses/codegen.hpp>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#   include <windows.h>
+#else
+#   include <dlfcn.h>
+#endif
+
+namespace {
+
+typedef void (*RegisterFunc)();
+
+RegisterFunc loadRegistration(const char* library, const char* function)
+{
+#ifdef _WIN32
+    HMODULE handle = LoadLibraryA(library);
+    if (!handle)
+    {
+        std::cerr << "Cannot load " << library << "\n";
+        return nullptr;
+    }
+    RegisterFunc func = reinterpret_cast<RegisterFunc>(GetProcAddress(handle, function));
+#else
+    void* handle = dlopen(library, RTLD_NOW | RTLD_GLOBAL);
+    if (!handle)
+    {
+        std::cerr << "Cannot load " << library << ": " << dlerror() << "\n";
+        return nullptr;
+    }
+    RegisterFunc func = reinterpret_cast<RegisterFunc>(dlsym(handle, function));
+#endif
+    if (!func)
+        std::cerr << "Cannot find function " << function << " in " << library << "\n";
+
+    // The library is never unloaded: the metaclasses it declared refer to its code
+    return func;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3 || argc > 4)
+    {
+        std::cerr << "Usage: " << argv[0] << " <library> <registration function> [output file]\n";
+        return 1;
+    }
+
+    RegisterFunc registration = loadRegistration(argv[1], argv[2]);
+    if (!registration)
+        return 1;
+
+    try
+    {
+        registration();
+
+        if (argc == 4)
+        {
+            std::ofstream out(argv[3]);
+            if (!out)
+            {
+                std::cerr << "Cannot write " << argv[3] << "\n";
+                return 1;
+            }
+            ponder::uses::generateCode(out);
+        }
+        else
+        {
+            ponder::uses::generateCode(std::cout);
+        }
+    }
+    catch (const ponder::Error& error)
+    {
+        std::cerr << "Error: " << error.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}